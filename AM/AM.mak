@@ -4,7 +4,7 @@
 AM_INCLUDE_DIR = AM/include
 AM_SRC_DIR = AM/src
 AM_HEADER_DIR = ${AM_INCLUDE_DIR}/mtf/AM
-AM_BASE_HEADERS =  ${AM_HEADER_DIR}/AppearanceModel.h  ${AM_HEADER_DIR}/ImageBase.h ${AM_HEADER_DIR}/AMParams.h ${AM_HEADER_DIR}/IlluminationModel.h  ${UTILITIES_HEADER_DIR}/excpUtils.h 
+AM_BASE_HEADERS =  ${AM_HEADER_DIR}/AppearanceModel.h  ${AM_HEADER_DIR}/ImageBase.h ${AM_HEADER_DIR}/AMParams.h ${AM_HEADER_DIR}/IlluminationModel.h  ${UTILITIES_HEADER_DIR}/excpUtils.h ${UTILITIES_HEADER_DIR}/parallelUtils.h
 
 MTF_INCLUDE_DIRS += ${AM_INCLUDE_DIR}
 
@@ -34,12 +34,6 @@ dfm_cpu ?= 0
 pca ?= 1
 mil ?= 0
 mid ?= 0
-mitbb ?= 0
-miomp ?= 0
-ccretbb ?= 0
-ccreomp ?= 0
-ncctbb ?= 0
-nccomp ?= 0
 sg ?= 0
 lscd ?= 0
 ctch ?= 1
@@ -71,39 +65,6 @@ else
 MTF_COMPILETIME_FLAGS += -D DISABLE_PCA
 MTF_RUNTIME_FLAGS += -D DISABLE_PCA
 endif
-ifeq (${mitbb}, 1)
-MI_FLAGS += -D ENABLE_TBB
-MTF_RUNTIME_FLAGS += -D ENABLE_PARALLEL
-endif
-
-ifeq (${miomp}, 1)
-MI_FLAGS += -D ENABLE_OMP -fopenmp
-MTF_RUNTIME_FLAGS += -D ENABLE_PARALLEL -fopenmp
-MTF_LIBS += -fopenmp
-endif
-
-ifeq (${ccretbb}, 1)
-CCRE_FLAGS += -D ENABLE_TBB
-MTF_RUNTIME_FLAGS += -D ENABLE_PARALLEL
-else
-ifeq (${ccreomp}, 1)
-CCRE_FLAGS += -D ENABLE_OMP -fopenmp
-MTF_RUNTIME_FLAGS += -D ENABLE_PARALLEL -fopenmp
-MTF_LIBS += -fopenmp
-endif
-endif
-
-ifeq (${ncctbb}, 1)
-NCC_FLAGS += -D ENABLE_TBB
-MTF_RUNTIME_FLAGS += -D ENABLE_PARALLEL
-else
-ifeq (${nccomp}, 1)
-NCC_FLAGS += -D ENABLE_OMP -fopenmp
-MTF_RUNTIME_FLAGS += -D ENABLE_PARALLEL -fopenmp
-MTF_LIBS += -fopenmp
-endif
-endif
-
 ifeq (${mid}, 1)
 MI_FLAGS = -D LOG_MI_DATA
 endif
@@ -126,7 +87,7 @@ ${BUILD_DIR}/AMParams.o: ${AM_SRC_DIR}/AMParams.cc  ${AM_HEADER_DIR}/AMParams.h
 ${BUILD_DIR}/ImageBase.o: ${AM_SRC_DIR}/ImageBase.cc  ${AM_HEADER_DIR}/ImageBase.h ${MACROS_HEADER_DIR}/common.h ${UTILITIES_HEADER_DIR}/imgUtils.h ${UTILITIES_HEADER_DIR}/excpUtils.h
 	${CXX} -c ${MTF_PIC_FLAG} ${WARNING_FLAGS} ${OPT_FLAGS} ${PROF_FLAGS} ${MTF_COMPILETIME_FLAGS} ${MTF_INCLUDE_FLAGS} ${SSD_FLAGS} $< -o $@
 	
-${BUILD_DIR}/SSDBase.o: ${AM_SRC_DIR}/SSDBase.cc ${AM_HEADER_DIR}/SSDBase.h ${AM_BASE_HEADERS}  ${MACROS_HEADER_DIR}/common.h ${UTILITIES_HEADER_DIR}/imgUtils.h ${UTILITIES_HEADER_DIR}/spiUtils.h
+${BUILD_DIR}/SSDBase.o: ${AM_SRC_DIR}/SSDBase.cc ${AM_HEADER_DIR}/SSDBase.h ${AM_BASE_HEADERS}  ${MACROS_HEADER_DIR}/common.h ${UTILITIES_HEADER_DIR}/simdUtils.h ${UTILITIES_HEADER_DIR}/imgUtils.h ${UTILITIES_HEADER_DIR}/spiUtils.h
 	${CXX} -c ${MTF_PIC_FLAG} ${WARNING_FLAGS} ${OPT_FLAGS} ${PROF_FLAGS} ${MTF_COMPILETIME_FLAGS} ${MTF_INCLUDE_FLAGS} ${SSD_FLAGS} $< -o $@	
 	
 ${BUILD_DIR}/SSD.o: ${AM_SRC_DIR}/SSD.cc ${AM_HEADER_DIR}/SSD.h ${AM_HEADER_DIR}/SSDBase.h ${AM_BASE_HEADERS}  ${MACROS_HEADER_DIR}/common.h ${UTILITIES_HEADER_DIR}/excpUtils.h
@@ -168,22 +129,22 @@ ${BUILD_DIR}/MI.o: ${AM_SRC_DIR}/MI.cc ${AM_HEADER_DIR}/MI.h ${AM_BASE_HEADERS}
 ${BUILD_DIR}/CCRE.o: ${AM_SRC_DIR}/CCRE.cc ${AM_HEADER_DIR}/CCRE.h ${AM_BASE_HEADERS}  ${MACROS_HEADER_DIR}/common.h ${UTILITIES_HEADER_DIR}/histUtils.h ${UTILITIES_HEADER_DIR}/imgUtils.h ${UTILITIES_HEADER_DIR}/miscUtils.h
 	${CXX} -c ${MTF_PIC_FLAG} ${WARNING_FLAGS} ${OPT_FLAGS} ${PROF_FLAGS} ${MTF_COMPILETIME_FLAGS} ${MTF_INCLUDE_FLAGS} ${CCRE_FLAGS} $< -o $@	
 
-${BUILD_DIR}/SSIM.o: ${AM_SRC_DIR}/SSIM.cc ${AM_HEADER_DIR}/SSIM.h ${AM_BASE_HEADERS}  ${MACROS_HEADER_DIR}/common.h ${UTILITIES_HEADER_DIR}/imgUtils.h
+${BUILD_DIR}/SSIM.o: ${AM_SRC_DIR}/SSIM.cc ${AM_HEADER_DIR}/SSIM.h ${AM_BASE_HEADERS}  ${MACROS_HEADER_DIR}/common.h ${UTILITIES_HEADER_DIR}/simdUtils.h ${UTILITIES_HEADER_DIR}/imgUtils.h
 	${CXX} -c ${MTF_PIC_FLAG} ${WARNING_FLAGS} ${OPT_FLAGS} ${PROF_FLAGS} ${MTF_COMPILETIME_FLAGS} ${MTF_INCLUDE_FLAGS} ${SSIM_FLAGS} $< -o $@
 	
-${BUILD_DIR}/SPSS.o: ${AM_SRC_DIR}/SPSS.cc ${AM_HEADER_DIR}/SPSS.h ${AM_BASE_HEADERS}  ${MACROS_HEADER_DIR}/common.h ${UTILITIES_HEADER_DIR}/imgUtils.h
+${BUILD_DIR}/SPSS.o: ${AM_SRC_DIR}/SPSS.cc ${AM_HEADER_DIR}/SPSS.h ${AM_BASE_HEADERS}  ${MACROS_HEADER_DIR}/common.h ${UTILITIES_HEADER_DIR}/simdUtils.h ${UTILITIES_HEADER_DIR}/imgUtils.h
 	${CXX} -c ${MTF_PIC_FLAG} ${WARNING_FLAGS} ${OPT_FLAGS} ${PROF_FLAGS} ${MTF_COMPILETIME_FLAGS} ${MTF_INCLUDE_FLAGS} ${SPSS_FLAGS} $< -o $@
 	
-${BUILD_DIR}/NCC.o: ${AM_SRC_DIR}/NCC.cc ${AM_HEADER_DIR}/NCC.h ${AM_BASE_HEADERS} ${MACROS_HEADER_DIR}/common.h ${UTILITIES_HEADER_DIR}/imgUtils.h ${UTILITIES_HEADER_DIR}/spiUtils.h
+${BUILD_DIR}/NCC.o: ${AM_SRC_DIR}/NCC.cc ${AM_HEADER_DIR}/NCC.h ${AM_BASE_HEADERS} ${MACROS_HEADER_DIR}/common.h ${UTILITIES_HEADER_DIR}/simdUtils.h ${UTILITIES_HEADER_DIR}/imgUtils.h ${UTILITIES_HEADER_DIR}/spiUtils.h
 	${CXX} -c ${MTF_PIC_FLAG} ${WARNING_FLAGS} ${OPT_FLAGS} ${PROF_FLAGS} ${MTF_COMPILETIME_FLAGS} ${MTF_INCLUDE_FLAGS} ${NCC_FLAGS} $< -o $@
 	
 ${BUILD_DIR}/RIU.o: ${AM_SRC_DIR}/RIU.cc ${AM_HEADER_DIR}/RIU.h ${AM_BASE_HEADERS} ${MACROS_HEADER_DIR}/common.h ${UTILITIES_HEADER_DIR}/imgUtils.h
 	${CXX} -c ${MTF_PIC_FLAG} ${WARNING_FLAGS} ${OPT_FLAGS} ${PROF_FLAGS} ${MTF_COMPILETIME_FLAGS} ${MTF_INCLUDE_FLAGS} ${RIU_FLAGS} $< -o $@	
 	
-${BUILD_DIR}/NGF.o: ${AM_SRC_DIR}/NGF.cc ${AM_HEADER_DIR}/NGF.h ${AM_BASE_HEADERS} ${MACROS_HEADER_DIR}/common.h ${UTILITIES_HEADER_DIR}/imgUtils.h
+${BUILD_DIR}/NGF.o: ${AM_SRC_DIR}/NGF.cc ${AM_HEADER_DIR}/NGF.h ${AM_BASE_HEADERS} ${MACROS_HEADER_DIR}/common.h ${UTILITIES_HEADER_DIR}/simdUtils.h ${UTILITIES_HEADER_DIR}/imgUtils.h
 	${CXX} -c ${MTF_PIC_FLAG} ${WARNING_FLAGS} ${OPT_FLAGS} ${PROF_FLAGS} ${MTF_COMPILETIME_FLAGS} ${MTF_INCLUDE_FLAGS} ${NGF_FLAGS} $< -o $@	
 	
-${BUILD_DIR}/SAD.o: ${AM_SRC_DIR}/SAD.cc ${AM_HEADER_DIR}/SAD.h ${AM_BASE_HEADERS} ${MACROS_HEADER_DIR}/common.h
+${BUILD_DIR}/SAD.o: ${AM_SRC_DIR}/SAD.cc ${AM_HEADER_DIR}/SAD.h ${AM_BASE_HEADERS} ${MACROS_HEADER_DIR}/common.h ${UTILITIES_HEADER_DIR}/simdUtils.h
 	${CXX} -c ${MTF_PIC_FLAG} ${WARNING_FLAGS} ${OPT_FLAGS} ${PROF_FLAGS} ${MTF_COMPILETIME_FLAGS} ${MTF_INCLUDE_FLAGS} ${SAD_FLAGS} $< -o $@
 	
 ${BUILD_DIR}/SumOfAMs.o: ${AM_SRC_DIR}/SumOfAMs.cc ${AM_HEADER_DIR}/SumOfAMs.h ${AM_BASE_HEADERS} ${MACROS_HEADER_DIR}/common.h
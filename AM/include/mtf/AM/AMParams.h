@@ -6,6 +6,9 @@
 #define AM_LIKELIHOOD_BETA 0
 #define AM_DIST_FROM_LIKELIHOOD false
 #define AM_LEARNING_RATE 0.5
+#define AM_FLOAT_JAC false
+#define AM_N_THREADS 1
+#define AM_GRAIN_SIZE 0
 
 _MTF_BEGIN_NAMESPACE
 
@@ -19,6 +22,18 @@ struct AMParams : ImgParams{
 	double learning_rate;
 	//! optional parametric function of pixel values that can account for lighting changes
 	ILM ilm;
+	/**
+	store the N x S pixel Jacobians in single precision in the SMs while
+	the 1 x S Jacobian and the S x S Hessian are still accumulated in double;
+	only used by AMs derived from SSDBase
+	*/
+	bool float_jac;
+	/**
+	no. of threads and the no. of pixels processed by each task in the AMs that process pixels in parallel;
+	n_threads <= 0 uses all the available cores while grain_size <= 0 divides the pixels evenly among the threads;
+	the library used for running the threads is decided by utils::TaskArena::setDefaultBackend
+	*/
+	int n_threads, grain_size;
 	AMParams(int _resx, int _resy,
 		double _grad_eps = GRAD_EPS,
 		double _hess_eps = HESS_EPS,
@@ -27,7 +42,11 @@ struct AMParams : ImgParams{
 		double _likelihood_beta = AM_LIKELIHOOD_BETA,
 		bool _dist_from_likelihood = AM_DIST_FROM_LIKELIHOOD,
 		double _learning_rate = AM_LEARNING_RATE,
-		IlluminationModel *_ilm = nullptr);
+		IlluminationModel *_ilm = nullptr,
+		bool _img_deriv_cache = IMG_DERIV_CACHE,
+		bool _float_jac = AM_FLOAT_JAC,
+		int _n_threads = AM_N_THREADS,
+		int _grain_size = AM_GRAIN_SIZE);
 	AMParams(const AMParams *am_params = nullptr);
 };
 _MTF_END_NAMESPACE
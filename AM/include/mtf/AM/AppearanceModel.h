@@ -7,7 +7,9 @@
 #include "ImageBase.h"
 #include "AMParams.h"
 #include "mtf/Utilities/excpUtils.h"
+#include "mtf/Utilities/parallelUtils.h"
 #include <memory>
+#include <functional>
 
 _MTF_BEGIN_NAMESPACE
 
@@ -34,6 +36,27 @@ struct AMStatus : ImgStatus{
 	}
 };
 
+/**
+quantities that an SM needs from the AM for the current patch in an iteration;
+sim_prereq only covers the prerequisites of the gradients of the similarity and not the similarity itself
+which can be considerably more expensive to compute for some AMs;
+the AM uses the same struct to keep track of which of these are still valid (see AppearanceModel::updateRequired)
+*/
+struct AMUpdateStatus : ImgStatus{
+	bool similarity, sim_prereq, curr_grad, init_grad;
+
+	AMUpdateStatus() : ImgStatus(){ clear(); }
+
+	void set(){
+		setPixState();
+		similarity = sim_prereq = curr_grad = init_grad = true;
+	}
+	void clear(){
+		clearPixState();
+		similarity = sim_prereq = curr_grad = init_grad = false;
+	}
+};
+
 /**
 Distance functor for FLANN
 */
@@ -69,7 +92,10 @@ public:
 	explicit AppearanceModel(const AMParams *params = nullptr, 
 		const int _n_channels = 1) :
 		ImageBase(params, _n_channels), f(0), state_size(0),
-		first_iter(false), spi_mask(nullptr){}
+		first_iter(false), spi_mask(nullptr),
+		task_arena(params ? new utils::TaskArena(params->n_threads, false,
+		utils::ParallelBackend::Default, params->grain_size) :
+		new utils::TaskArena(AM_N_THREADS)){}
 	/** destructor */
 	virtual ~AppearanceModel(){}
 
@@ -135,6 +161,59 @@ public:
 	virtual void updateInitGrad(){ am_func_not_implemeted(updateInitGrad); }
 	virtual void updateCurrGrad() { am_func_not_implemeted(updateCurrGrad); }
 	virtual void updateParamGrad() { am_func_not_implemeted(updateParamGrad); }
+	/**
+	request driven alternative to calling updatePixVals, updateSimilarity, updateCurrGrad, updateInitGrad,
+	updatePixGrad and updatePixHess in turn: computes the quantities set in required for the given points
+	along with only those that they depend on and skips any that are still valid from an earlier call;
+	everything becomes invalid when the points or the AM state change or a new frame starts (setFirstIter);
+	the pixel gradient and Hessian set in prefetch are also computed if the AM can obtain them in the same pass
+	as the pixel values (supportsFusedPixUpdate) so that they are already valid when required later
+	*/
+	void updateRequired(const PtsT &curr_pts, const AMUpdateStatus &required,
+		const ImgStatus &prefetch = ImgStatus()){
+		if(upd_status.pix_vals && (upd_pts.cols() != curr_pts.cols() || upd_pts != curr_pts ||
+			upd_p_am.size() != p_am.size() || upd_p_am != p_am)){
+			upd_status.clear();
+		}
+		if(required.similarity && !upd_status.similarity && upd_status.sim_prereq){
+			// updateSimilarity modifies the pixel values in place in some AMs (e.g. those with an ILM)
+			// so these must be resampled before it can be called again
+			upd_status.clear();
+		}
+		if(!upd_status.pix_vals){
+			ImgStatus pix_status;
+			pix_status.pix_grad = required.pix_grad || prefetch.pix_grad;
+			pix_status.pix_hess = required.pix_hess || prefetch.pix_hess;
+			updatePixAll(curr_pts, pix_status);
+			upd_status.pix_vals = true;
+			upd_status.pix_grad = pix_status.pix_grad;
+			upd_status.pix_hess = pix_status.pix_hess;
+			upd_pts = curr_pts;
+			upd_p_am = p_am;
+		}
+		bool sim_prereq = required.sim_prereq || required.curr_grad || required.init_grad;
+		if(required.similarity ? !upd_status.similarity : sim_prereq && !upd_status.sim_prereq){
+			updateSimilarity(!required.similarity);
+			upd_status.similarity = required.similarity;
+			upd_status.sim_prereq = true;
+		}
+		if(required.curr_grad && !upd_status.curr_grad){
+			updateCurrGrad();
+			upd_status.curr_grad = true;
+		}
+		if(required.init_grad && !upd_status.init_grad){
+			updateInitGrad();
+			upd_status.init_grad = true;
+		}
+		if(required.pix_grad && !upd_status.pix_grad){
+			updatePixGrad(curr_pts);
+			upd_status.pix_grad = true;
+		}
+		if(required.pix_hess && !upd_status.pix_hess){
+			updatePixHess(curr_pts);
+			upd_status.pix_hess = true;
+		}
+	}
 
 	//virtual void updateInitHess() { am_func_not_implemeted(updateInitHess); }
 	//virtual void updateCurrHess() { am_func_not_implemeted(updateCurrHess); }
@@ -190,32 +269,83 @@ public:
 		am_func_not_implemeted(cmptSelfHessian(second order));
 	}
 
+	/**
+	functor that writes the rows of the N x S pixel Jacobian corresponding to the n_block pixels
+	starting at start_id to the first n_block*n_channels rows of the provided matrix
+	*/
+	typedef std::function<void(MatrixXd &dI_dpssm_block, unsigned int start_id,
+		unsigned int n_block)> PixJacobianBlockFuncT;
+	/**
+	computes the Jacobian and the first order self Hessian of the error norm from a pixel Jacobian that is
+	provided one block of pixels at a time so that the ones that support it (supportsFusedJacobianAndHessian)
+	can accumulate both without ever storing the full N x S pixel Jacobian;
+	the default implementation simply generates the full Jacobian in dIt_dpssm and uses it with
+	cmptCurrJacobian and cmptSelfHessian;
+	this is currently only called by FCLK and only SSDBase and its derived AMs override it
+	while only Homography and Affine provide the pixel Jacobian in blocks
+	*/
+	virtual void cmptCurrJacobianAndSelfHessian(RowVectorXd &df_dp, MatrixXd &d2f_dp2,
+		const PixJacobianBlockFuncT &dIt_dpssm_func, MatrixXd &dIt_dpssm){
+		dIt_dpssm_func(dIt_dpssm, 0, n_pix);
+		cmptCurrJacobian(df_dp, dIt_dpssm);
+		cmptSelfHessian(d2f_dp2, dIt_dpssm);
+	}
+	virtual bool supportsFusedJacobianAndHessian() const { return false; }
+
 	/** analogous to cmptDifferenceOfJacobians except for computing the mean of the current and initial Hessians */
 	virtual void cmptSumOfHessians(MatrixXd &d2f_dp2_sum,
 		const MatrixXd &dI0_dpssm, const MatrixXd &dIt_dpssm){
 		int pssm_size = dIt_dpssm.cols();
 		assert(d2f_dp2_sum.rows() == pssm_size && d2f_dp2_sum.cols() == pssm_size);
-		MatrixXd d2f_dp2_0(pssm_size, pssm_size);
-		cmptInitHessian(d2f_dp2_0, dI0_dpssm);
+		cmptInitHessian(d2f_dp2_sum, dI0_dpssm);
 
-		MatrixXd d2f_dp2_t(pssm_size, pssm_size);
+		d2f_dp2_t.resize(pssm_size, pssm_size);
 		cmptCurrHessian(d2f_dp2_t, dIt_dpssm);
 
-		d2f_dp2_sum = d2f_dp2_0 + d2f_dp2_t;
+		d2f_dp2_sum += d2f_dp2_t;
 	}
 	virtual void cmptSumOfHessians(MatrixXd &d2f_dp2_sum,
 		const MatrixXd &dI0_dpssm, const MatrixXd &dIt_dpssm,
 		const MatrixXd &d2I0_dpssm2, const MatrixXd &d2It_dpssm2){
 		int pssm_size = dIt_dpssm.cols();
 		assert(d2f_dp2_sum.rows() == pssm_size && d2f_dp2_sum.cols() == pssm_size);
-		MatrixXd d2f_dp2_0(pssm_size, pssm_size);
-		cmptInitHessian(d2f_dp2_0, dI0_dpssm, d2I0_dpssm2);
+		cmptInitHessian(d2f_dp2_sum, dI0_dpssm, d2I0_dpssm2);
 
-		MatrixXd d2f_dp2_t(pssm_size, pssm_size);
+		d2f_dp2_t.resize(pssm_size, pssm_size);
 		cmptCurrHessian(d2f_dp2_t, dIt_dpssm, d2It_dpssm2);
 
-		d2f_dp2_sum = d2f_dp2_0 + d2f_dp2_t;
+		d2f_dp2_sum += d2f_dp2_t;
+	}
+	/**
+	variants of the first order functions above for N x S pixel Jacobians stored in single precision;
+	the products are computed in single precision for one block of pixels at a time but the resulting
+	1 x S and S x S matrices are accumulated in double precision; the Lucas Kanade type SMs store and
+	pass single precision pixel Jacobians only if the AM supports these (supportsFloatJacobian)
+	*/
+	virtual void cmptInitJacobianFloat(RowVectorXd &df_dp, const MatrixXf &dI0_dpssm){
+		am_func_not_implemeted(cmptInitJacobianFloat);
+	}
+	virtual void cmptCurrJacobianFloat(RowVectorXd &df_dp, const MatrixXf &dIt_dpssm){
+		am_func_not_implemeted(cmptCurrJacobianFloat);
+	}
+	virtual void cmptDifferenceOfJacobiansFloat(RowVectorXd &df_dp_diff,
+		const MatrixXf &dI0_dpssm, const MatrixXf &dIt_dpssm){
+		am_func_not_implemeted(cmptDifferenceOfJacobiansFloat);
+	}
+	virtual void cmptInitHessianFloat(MatrixXd &d2f_dp2, const MatrixXf &dI0_dpssm){
+		am_func_not_implemeted(cmptInitHessianFloat);
+	}
+	virtual void cmptCurrHessianFloat(MatrixXd &d2f_dp2, const MatrixXf &dIt_dpssm){
+		am_func_not_implemeted(cmptCurrHessianFloat);
+	}
+	virtual void cmptSelfHessianFloat(MatrixXd &d2f_dp2, const MatrixXf &dIt_dpssm){
+		am_func_not_implemeted(cmptSelfHessianFloat);
+	}
+	virtual void cmptSumOfHessiansFloat(MatrixXd &d2f_dp2_sum,
+		const MatrixXf &dI0_dpssm, const MatrixXf &dIt_dpssm){
+		am_func_not_implemeted(cmptSumOfHessiansFloat);
 	}
+	virtual bool supportsFloatJacobian() const { return false; }
 
 	virtual void estimateOpticalFlow(std::vector<cv::Point2f> &curr_pts,
 		const cv::Mat &prev_img, const std::vector<cv::Point2f> &prev_pts,
@@ -238,7 +368,12 @@ public:
 	should be called before performing the first iteration on a new image to indicate that the image
 	has changed since the last time the update funcvtions were called
 	*/
-	virtual void setFirstIter(){ first_iter = true; }
+	virtual void setFirstIter(){
+		first_iter = true;
+		upd_status.clear();
+		// the input pipeline usually writes each new frame into the same buffer
+		invalidateImgDerivatives();
+	}
 	/** should be called after the first iteration on a new frame is done */
 	virtual void clearFirstIter(){ first_iter = false; }
 
@@ -373,6 +508,11 @@ protected:
 	*/
 	MatrixXd d2f_dI02, d2f_dIt2;
 
+	/**
+	workspace for the current Hessian in cmptSumOfHessians so that it is only allocated once
+	*/
+	MatrixXd d2f_dp2_t;
+
 	/**
 	indicator variable that can be set by iterative search methods to indicate if the initial or first iteration is being run on the current image;
 	can be used to perform some costly operations/updates only once per frame rather than at every iteration
@@ -392,6 +532,20 @@ protected:
 	indicator variables used to keep track of which state variables have been initialized;
 	*/
 	AMStatus is_initialized;
+
+	/**
+	quantities computed by updateRequired that are still valid along with
+	the points and AM state for which they were computed
+	*/
+	AMUpdateStatus upd_status;
+	PtsT upd_pts;
+	VectorXd upd_p_am;
+
+	/**
+	runs the pixel level computations of AMs that are parallelized;
+	its threads are shared with all other AMs that use the same no. of threads
+	*/
+	std::shared_ptr<utils::TaskArena> task_arena;
 };
 
 _MTF_END_NAMESPACE
@@ -2,6 +2,7 @@
 #define MTF_CCRE_H
 
 #include "AppearanceModel.h"
+#include "mtf/Utilities/histUtils.h"
 
 _MTF_BEGIN_NAMESPACE
 
@@ -27,13 +28,16 @@ struct CCREParams : AMParams{
 	// with parallelization libraries like TBB and OpenMP; only matters if these are enabled during compilation;
 	// if set to 0 (default), this is set equal to the no. of pixels so that each block contains a single pixel
 	int n_blocks;	
+	//! no. of steps per bin in the lookup tables used for evaluating the BSpline functions 
+	//! and their derivatives; if set to 0, these are evaluated exactly;
+	int lut_steps;
 
 	bool debug_mode; 
 	//! value constructor
 	CCREParams(const AMParams *am_params,
 		int _n_bins, bool _partition_of_unity,
 		double _pre_seed, bool _symmetrical_grad,
-		int _n_blocks, 
+		int _n_blocks, int _lut_steps,
 		bool _debug_mode);
 	//! default and copy constructor
 	CCREParams(const CCREParams *params = nullptr);
@@ -167,9 +171,17 @@ protected:
 	MatrixXi linear_idx, linear_idx2;
 
 	MatrixX2i block_extents;
+
+	//! thread private current and cumulative joint histograms
+	utils::ParallelHist hist_accum;
+	//! thread private Hessians and joint histogram Jacobians
+	utils::ParallelHist hess_accum;
+	//! BSpline functions - either exact or from lookup tables depending on lut_steps
+	utils::BSpl3LUT bspl_lut;
 	char *log_fname;
 	char *time_fname;
 
+	void resizeHessAccum(int ssm_state_size);
 	void updateSymSimilarity(bool prereq_only);
 	void updateSymInitGrad();
 	void cmptSymInitHessian(MatrixXd &hessian, const MatrixXd &curr_pix_jacobian);
@@ -8,6 +8,7 @@
 #define GRAD_EPS 1e-8
 #define HESS_EPS 1
 #define UCHAR_INPUT false
+#define IMG_DERIV_CACHE false
 
 
 #define PIX_MAX 255.0
@@ -25,10 +26,14 @@ struct ImgParams{
 	//! using the method of finite differences
 	double grad_eps, hess_eps;
 	bool uchar_input;
+	//! compute the first and second order derivatives of each input image once when it is set
+	//! and interpolate these to get the image gradient and Hessian rather than using finite differences
+	bool img_deriv_cache;
 	ImgParams(int _resx, int _resy,
 		double _grad_eps = GRAD_EPS,
 		double _hess_eps = HESS_EPS,
-		bool _uchar_input = UCHAR_INPUT);
+		bool _uchar_input = UCHAR_INPUT,
+		bool _img_deriv_cache = IMG_DERIV_CACHE);
 	ImgParams(const ImgParams *img_params = nullptr);
 };
 
@@ -94,9 +99,17 @@ public:
 	virtual void setInitPixGrad(const PixGradT &pix_grad){ dI0_dx = pix_grad; }
 	virtual void setInitPixHess(const PixHessT &pix_hess){ d2I0_dx2 = pix_hess; }
 
-	virtual void setCurrPixVals(const PixValT &pix_vals){ It = pix_vals; }
+	//! accepts any contiguous vector expression, e.g. a row of the matrix filled by updatePixValsBatch, without copying it first
+	virtual void setCurrPixVals(const Ref<const PixValT> &pix_vals){ It = pix_vals; }
 	virtual void setCurrPixGrad(const PixGradT &pix_grad){ dIt_dx = pix_grad; }
 	virtual void setCurrPixHess(const PixHessT &pix_hess){ d2It_dx2 = pix_hess; }
+	/**
+	discards the cached image derivatives so that they are recomputed from the current image when next needed;
+	must be called whenever the contents of the current image change without setCurrImg being called,
+	as when the input pipeline overwrites the same frame buffer with each new frame;
+	this is done by AppearanceModel::setFirstIter and initializePixVals so SMs need not call it themselves
+	*/
+	virtual void invalidateImgDerivatives(){ img_deriv_updated = img_sec_deriv_updated = false; }
 
 	//! initialization methods - to be called once when the tracker is initialized
 	virtual void initializePixVals(const PtsT& init_pts);
@@ -121,6 +134,27 @@ public:
 
 	virtual void updatePixHess(const PtsT &curr_pts);
 	virtual void updatePixHess(const PtsT& curr_pts, const HessPtsT &warped_offset_pts);
+	/**
+	computes the pixel values and, if the corresponding flags are set, the warp of the image gradient and Hessian
+	at the same points in a single pass over them; this is only done if the AM supports it
+	(see supportsFusedPixUpdate), otherwise only the pixel values are computed;
+	the flags are updated to indicate what was actually computed so the caller can compute the rest separately
+	*/
+	virtual void updatePixAll(const PtsT &curr_pts, ImgStatus &flags);
+	//! true if the pixel values, gradient and Hessian do not depend on any intermediate
+	//! computations by the AM so that they can be computed together in updatePixAll
+	virtual bool supportsFusedPixUpdate() const{ return false; }
+	/**
+	samples the patches for K hypotheses in a single pass: row k of pix_vals_batch is filled with
+	the pixel values that updatePixVals would compute for columns k*N to (k+1)*N - 1 of pts_batch
+	and can be passed to setCurrPixVals; neither the pixel values nor any other state of the AM
+	are modified and no memory is allocated so any no. of threads can share the same AM;
+	only available if supportsPixValsBatch returns true
+	*/
+	virtual void updatePixValsBatch(Ref<MatrixXdr> pix_vals_batch, const Ref<const PtsT> &pts_batch) const;
+	//! true if the pixel values produced by updatePixVals are the raw normalized ones so
+	//! that they can be computed by updatePixValsBatch instead
+	virtual bool supportsPixValsBatch() const{ return false; }
 
 	//! general utility function to extract raw pixel values from the current image at the specified points; 
 	//! might be useful for visualization purposes as the curr_pix_vals might not have raw pixel values;
@@ -145,6 +179,7 @@ protected:
 	//! offsets to use for computing the numerical image gradient and hessian
 	const double grad_eps, hess_eps;
 	const InputType input_type;
+	const bool img_deriv_cache;
 
 	//! Eigen structure shaing memory with the OpenCV image used by default with grayscale inputs
 	EigImgT curr_img;
@@ -168,6 +203,15 @@ protected:
 	//! incremented once during initialization and thereafter everytime the template is updated
 	unsigned int frame_count;
 
+	//! first and second order derivatives of the current image used if img_deriv_cache is enabled;
+	//! these are computed only when first needed after each call to setCurrImg or invalidateImgDerivatives
+	cv::Mat curr_img_dx, curr_img_dy;
+	cv::Mat curr_img_dxx, curr_img_dxy, curr_img_dyy;
+	bool img_deriv_updated, img_sec_deriv_updated;
+
+	void updateImgDerivatives();
+	void updateImgSecondDerivatives();
+
 private:
 	InputType getInputType(const ImgParams *img_params){
 		bool uchar_input = img_params ? img_params->uchar_input : UCHAR_INPUT;
@@ -187,6 +231,9 @@ private:
 	double getHessEps(const ImgParams *img_params){
 		return img_params ? img_params->hess_eps : HESS_EPS;
 	}
+	bool getImgDerivCache(const ImgParams *img_params){
+		return img_params ? img_params->img_deriv_cache : IMG_DERIV_CACHE;
+	}
 
 };
 
@@ -2,6 +2,7 @@
 #define MTF_KLD_H
 
 #include "AppearanceModel.h"
+#include "mtf/Utilities/histUtils.h"
 
 _MTF_BEGIN_NAMESPACE
 
@@ -99,6 +100,8 @@ private:
 	MatrixXd init_hist_hess, curr_hist_hess;
 	VectorXd init_grad_factor, curr_grad_factor;
 	VectorXd init_hist_log, curr_hist_log;
+	//! accumulates the current histogram of different parts of the patch in parallel
+	utils::ParallelHist hist_accum;
 
 	int feat_size;
 	VectorXd feat_vec;
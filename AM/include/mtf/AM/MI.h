@@ -2,6 +2,7 @@
 #define MTF_MI_H
 
 #include "AppearanceModel.h"
+#include "mtf/Utilities/histUtils.h"
 
 _MTF_BEGIN_NAMESPACE
 
@@ -20,6 +21,9 @@ struct MIParams : AMParams{
 	//! if enabled, the pixel values will be normalized in the range [1, n_bins-2] so each pixel contributes to all 4 bins
 	bool partition_of_unity;
 	ImageBase *pix_mapper;
+	//! no. of steps per bin in the lookup tables used for evaluating the BSpline functions 
+	//! and their derivatives; if set to 0, these are evaluated exactly;
+	int lut_steps;
 
 	bool debug_mode; //! decides whether logging data will be printed for debugging purposes; 
 	//! only matters if logging is enabled at compile time
@@ -29,6 +33,7 @@ struct MIParams : AMParams{
 		int _n_bins, double _pre_seed,
 		bool _partition_of_unity,		
 		ImageBase *_pix_mapper,
+		int _lut_steps,
 		bool _debug_mode);
 	//! default/copy constructor
 	MIParams(const MIParams *params = nullptr);
@@ -146,6 +151,11 @@ private:
 	MatrixX2i curr_bspl_ids;
 	MatrixXi linear_idx;
 
+	//! thread private current and joint histograms
+	utils::ParallelHist curr_hist_accum;
+	//! BSpline functions - either exact or from lookup tables depending on lut_steps
+	utils::BSpl3LUT bspl_lut;
+
 	void cmptSelfHist();
 };
 
@@ -88,6 +88,9 @@ public:
 	}
 	const double* getDistFeat() override{ return curr_feat_vec.data(); }
 
+	bool supportsFusedPixUpdate() const override{ return true; }
+	bool supportsPixValsBatch() const override{ return true; }
+
 #ifndef DISABLE_SPI
 	bool supportsSPI() const override{ return n_channels == 1; }
 #endif
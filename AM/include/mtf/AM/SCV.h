@@ -2,6 +2,7 @@
 #define MTF_SCV_H
 
 #include "SSDBase.h"
+#include "mtf/Utilities/histUtils.h"
 
 _MTF_BEGIN_NAMESPACE
 
@@ -110,6 +111,8 @@ protected:
 	MatrixXd curr_joint_hist;
 	VectorXd init_hist, curr_hist;
 	MatrixXd init_hist_mat, curr_hist_mat;
+	//! accumulates the histograms of different parts of the patch in parallel
+	utils::ParallelHist hist_accum;
 
 private:
 	// only used internally to increase speed by offlining as many computations as possible;
@@ -42,6 +42,8 @@ public:
 		return exp(-params.likelihood_alpha * sqrt(-f / (static_cast<double>(patch_size))));
 	}
 	void updateModel(const Matrix2Xd& curr_pts) override;
+	bool supportsFusedPixUpdate() const override{ return true; }
+	bool supportsPixValsBatch() const override{ return true; }
 
 	/*Support for FLANN library*/
 	const DistType* getDistFunc() override{
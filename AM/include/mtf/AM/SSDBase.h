@@ -5,6 +5,7 @@
 
 #include <boost/random/linear_congruential.hpp>
 #include <boost/random/normal_distribution.hpp>
+#include <vector>
 
 _MTF_BEGIN_NAMESPACE
 
@@ -99,6 +100,10 @@ public:
 	void cmptSumOfHessians(MatrixXd &sum_of_hessians,
 		const MatrixXd &init_pix_jacobian,
 		const MatrixXd &curr_pix_jacobian) override;
+	void cmptCurrJacobianAndSelfHessian(RowVectorXd &df_dp, MatrixXd &self_hessian,
+		const PixJacobianBlockFuncT &curr_pix_jacobian_func,
+		MatrixXd &curr_pix_jacobian) override;
+	bool supportsFusedJacobianAndHessian() const override{ return ilm == nullptr; }
 	void cmptInitHessian(MatrixXd &init_hessian, const MatrixXd &init_pix_jacobian,
 		const MatrixXd &init_pix_hessian) override;
 	void cmptCurrHessian(MatrixXd &curr_hessian, const MatrixXd &curr_pix_jacobian,
@@ -107,6 +112,25 @@ public:
 		const MatrixXd &init_pix_jacobian, const MatrixXd &curr_pix_jacobian,
 		const MatrixXd &init_pix_hessian, const MatrixXd &curr_pix_hessian) override;
 
+	void cmptInitJacobianFloat(RowVectorXd &df_dp,
+		const MatrixXf &dI0_dpssm) override;
+	void cmptCurrJacobianFloat(RowVectorXd &df_dp,
+		const MatrixXf &dIt_dpssm) override;
+	void cmptDifferenceOfJacobiansFloat(RowVectorXd &diff_of_jacobians,
+		const MatrixXf &dI0_dpssm, const MatrixXf &dIt_dpssm) override;
+	void cmptInitHessianFloat(MatrixXd &init_hessian,
+		const MatrixXf &init_pix_jacobian) override;
+	void cmptCurrHessianFloat(MatrixXd &curr_hessian,
+		const MatrixXf &curr_pix_jacobian) override;
+	void cmptSelfHessianFloat(MatrixXd &self_hessian,
+		const MatrixXf &curr_pix_jacobian) override{
+		cmptCurrHessianFloat(self_hessian, curr_pix_jacobian);
+	}
+	void cmptSumOfHessiansFloat(MatrixXd &sum_of_hessians,
+		const MatrixXf &init_pix_jacobian,
+		const MatrixXf &curr_pix_jacobian) override;
+	bool supportsFloatJacobian() const override{ return float_jac && ilm == nullptr; }
+
 	/**
 	Support for FLANN library
 	*/
@@ -161,13 +185,33 @@ protected:
 	multiplicative factor for the exponent in the likelihood
 	*/
 	double likelihood_alpha;
+	/**
+	accept N x S pixel Jacobians stored in single precision from the SMs
+	*/
+	bool float_jac;
 
 	VectorXdM I_diff;
 	PixValT It_orig;
 	ILMPixHessT ilm_d2f_dIt_type;	
+	//! double precision copies of single precision pixel Jacobians for SPI
+	MatrixXd spi_dI0_dpssm, spi_dIt_dpssm;
+	//! per block partial sums of the fused Jacobian and Hessian computation
+	MatrixXd fused_df_dp, fused_d2f_dp2;
+	//! workspaces for the pixel Jacobian blocks and their products for each range of blocks processed in parallel
+	std::vector<MatrixXd> fused_dI_dpssm, fused_d2f_dp2_block;
+	//! workspaces for the illumination model
+	VectorXd p_am_old, df_dpam_0, df_dpam_t, d2f_dIt2_diag;
 
 	void cmptILMHessian(MatrixXd &d2f_dp2, const MatrixXd &dI_dpssm, 
 		const double* I, const double* df_dg = nullptr);
+	/**
+	computes -dI_dpssm^T * dI_dpssm and writes it to or, if accumulate is true,
+	adds it to d2f_dp2; this is the first order Hessian of the SSD
+	*/
+	void cmptJacobianProduct(MatrixXd &d2f_dp2, const MatrixXd &dI_dpssm,
+		bool accumulate = false);
+	void cmptJacobianProduct(MatrixXd &d2f_dp2, const MatrixXf &dI_dpssm,
+		bool accumulate = false);
 	// functions to provide support for SPI
 	virtual void getJacobian(RowVectorXd &jacobian, const bool *pix_mask,
 		const RowVectorXd &curr_grad, const MatrixXd &pix_jacobian);
@@ -11,14 +11,22 @@ double _likelihood_alpha,
 double _likelihood_beta,
 bool _dist_from_likelihood,
 double _forgetting_factor,
-IlluminationModel *_ilm) :
+IlluminationModel *_ilm,
+bool _img_deriv_cache,
+bool _float_jac,
+int _n_threads,
+int _grain_size) :
 ImgParams(_resx, _resy, 
-_grad_eps, _hess_eps, _use_uchar_input),
+_grad_eps, _hess_eps, _use_uchar_input,
+_img_deriv_cache),
 likelihood_alpha(_likelihood_alpha),
 likelihood_beta(_likelihood_beta),
 dist_from_likelihood(_dist_from_likelihood),
 learning_rate(_forgetting_factor),
-ilm(_ilm){}
+ilm(_ilm),
+float_jac(_float_jac),
+n_threads(_n_threads),
+grain_size(_grain_size){}
 
 AMParams::AMParams(const AMParams *am_params) :
 ImgParams(am_params),
@@ -26,13 +34,19 @@ likelihood_alpha(AM_LIKELIHOOD_ALPHA),
 likelihood_beta(AM_LIKELIHOOD_BETA),
 dist_from_likelihood(AM_DIST_FROM_LIKELIHOOD),
 learning_rate(AM_LEARNING_RATE),
-ilm(nullptr){
+ilm(nullptr),
+float_jac(AM_FLOAT_JAC),
+n_threads(AM_N_THREADS),
+grain_size(AM_GRAIN_SIZE){
 	if(am_params){
 		likelihood_alpha = am_params->likelihood_alpha;
 		likelihood_beta = am_params->likelihood_beta;
 		dist_from_likelihood = am_params->dist_from_likelihood;
 		learning_rate = am_params->learning_rate;
 		ilm = am_params->ilm;
+		float_jac = am_params->float_jac;
+		n_threads = am_params->n_threads;
+		grain_size = am_params->grain_size;
 	}
 }
 _MTF_END_NAMESPACE
@@ -5,16 +5,12 @@
 #include "mtf/Utilities/graphUtils.h"
 #include "opencv2/highgui/highgui.hpp"
 
-//! OpenMP scheduler
-#ifndef CCRE_OMP_SCHD
-#define CCRE_OMP_SCHD static
-#endif
-
 #define CCRE_N_BINS 8
 #define CCRE_PRE_SEED 10
 #define CCRE_POU false
 #define CCRE_SYMMETRICAL_GRAD false
 #define CCRE_N_BLOCKS 0
+#define CCRE_LUT_STEPS 0
 #define CCRE_DEBUG_MODE false
 
 _MTF_BEGIN_NAMESPACE
@@ -22,7 +18,7 @@ _MTF_BEGIN_NAMESPACE
 CCREParams::CCREParams(const AMParams *am_params,
 int _n_bins, bool _partition_of_unity,
 double _pre_seed, bool _symmetrical_grad,
-int _n_blocks,
+int _n_blocks, int _lut_steps,
 bool _debug_mode) :
 AMParams(am_params),
 n_bins(_n_bins),
@@ -30,6 +26,7 @@ partition_of_unity(_partition_of_unity),
 pre_seed(_pre_seed),
 symmetrical_grad(_symmetrical_grad),
 n_blocks(_n_blocks),
+lut_steps(_lut_steps),
 debug_mode(_debug_mode){}
 
 //! default and copy constructor
@@ -40,6 +37,7 @@ partition_of_unity(CCRE_POU),
 pre_seed(CCRE_PRE_SEED),
 symmetrical_grad(CCRE_SYMMETRICAL_GRAD),
 n_blocks(CCRE_N_BLOCKS),
+lut_steps(CCRE_LUT_STEPS),
 debug_mode(CCRE_DEBUG_MODE){
 	if(params){
 		n_bins = params->n_bins;
@@ -47,6 +45,7 @@ debug_mode(CCRE_DEBUG_MODE){
 		pre_seed = params->pre_seed;
 		symmetrical_grad = params->symmetrical_grad;
 		n_blocks = params->n_blocks;
+		lut_steps = params->lut_steps;
 		debug_mode = params->debug_mode;
 	}
 }
@@ -71,6 +70,7 @@ params(ccre_params){
 	printf("pre_seed: %f\n", params.pre_seed);
 	printf("partition_of_unity: %d\n", params.partition_of_unity);
 	printf("symmetrical_grad: %d\n", params.symmetrical_grad);
+	printf("lut_steps: %d\n", params.lut_steps);
 	if(params.n_blocks <= 0){
 		params.n_blocks = patch_size;
 	}
@@ -144,16 +144,35 @@ params(ccre_params){
 	printf("Using approximate cumulative histograms\n");
 #endif
 
-#ifdef ENABLE_TBB
-	printf(" ******* Parallelization enabled using TBB ******* \n");
-#elif defined ENABLE_OMP
-	printf(" ******* Parallelization enabled using OpenMP ******* \n");
-#endif
+	if(task_arena->getNThreads() > 1){
+		printf(" ******* Parallelization enabled using %s with %d threads ******* \n",
+			utils::TaskArena::toString(task_arena->getBackend()), task_arena->getNThreads());
+	}
+
+	if(params.lut_steps < 0){
+		throw utils::InvalidArgument(
+			cv::format("CCRE::Invalid no. of lookup table steps specified: %d", params.lut_steps));
+	}
+	bspl_lut.resize(params.lut_steps);
+	if(params.lut_steps > 0 && params.debug_mode){
+		utils::validateBSpl3LUT(bspl_lut);
+	}
+	//! the current histogram and the cumulative joint histogram are accumulated in one buffer per thread
+	unsigned int n_hist_parts = task_arena->getNThreads();
+	hist_accum.resize(params.n_bins + joint_hist_size, n_hist_parts);
 
 	//for functor support
 	feat_size = 9 * patch_size;
 }
 
+void CCRE::resizeHessAccum(int ssm_state_size){
+	//! the Hessian is followed by the joint histogram Jacobian in the same buffer
+	unsigned int n_hess_vals = ssm_state_size*(ssm_state_size + joint_hist_size);
+	if(hess_accum.getNVals() != n_hess_vals){
+		hess_accum.resize(n_hess_vals, hist_accum.getNParts());
+	}
+}
+
 //-----------------------------------functor support-----------------------------------//
 
 void CCRE::initializeSimilarity(){
@@ -179,7 +198,7 @@ void CCRE::initializeSimilarity(){
 		init_bspl_ids.row(pix_id) = std_bspl_ids.row(static_cast<int>(I0(pix_id)));
 		double curr_diff = init_bspl_ids(pix_id, 0) - I0(pix_id);
 		for(int hist_id = init_bspl_ids(pix_id, 0); hist_id <= init_bspl_ids(pix_id, 1); hist_id++) {
-			utils::bSpl3WithGrad(init_hist_mat(hist_id, pix_id), init_hist_grad(hist_id, pix_id), curr_diff);
+			bspl_lut.bSpl3WithGrad(init_hist_mat(hist_id, pix_id), init_hist_grad(hist_id, pix_id), curr_diff);
 			init_hist_grad(hist_id, pix_id) *= -hist_norm_mult;
 			init_hist(hist_id) += init_hist_mat(hist_id, pix_id);
 			++curr_diff;
@@ -204,7 +223,7 @@ void CCRE::initializeSimilarity(){
 			}
 			double curr_diff = cum_hist_id - I0(pix_id);
 			while(cum_hist_id <= init_bspl_ids(pix_id, 1)){
-				utils::cumBSpl3WithGrad(init_cum_hist_mat(cum_hist_id, pix_id), init_cum_hist_grad(cum_hist_id, pix_id), curr_diff);
+				bspl_lut.cumBSpl3WithGrad(init_cum_hist_mat(cum_hist_id, pix_id), init_cum_hist_grad(cum_hist_id, pix_id), curr_diff);
 				init_cum_hist_grad(cum_hist_id, pix_id) *= -hist_norm_mult;
 				init_cum_hist(cum_hist_id) += init_cum_hist_mat(cum_hist_id, pix_id);
 				++curr_diff;
@@ -322,81 +341,88 @@ void CCRE::updateSimilarity(bool prereq_only){
 		updateSymSimilarity(prereq_only);
 		return;
 	}
-	curr_cum_hist.fill(hist_pre_seed);
-	cum_joint_hist.fill(params.pre_seed);
-
+	/**
+	each thread accumulates the histograms of its own pixels into a separate buffer;
+	these are added together afterwards
+	*/
+	const double *hist_sums;
 	if(is_initialized.grad){
 		/**
 		compute both the histogram and its differential simultaneously
 		to take advantage of the many common computations involved
 		*/
-		curr_cum_hist_grad.setZero();
-#ifdef ENABLE_OMP
-#pragma omp parallel for schedule(CCRE_OMP_SCHD)
-#endif	
-		for(unsigned int pix_id = 0; pix_id < patch_size; ++pix_id){
-			curr_bspl_ids.row(pix_id) = std_bspl_ids.row(static_cast<int>(It(pix_id)));
-			int curr_id = 0;
-			while(curr_id < curr_bspl_ids(pix_id, 0)){
+		hist_sums = hist_accum.accumulate(patch_size,
+			[&](double *hist_data, unsigned int start_id, unsigned int end_id){
+			VectorXdM part_cum_hist(hist_data, params.n_bins);
+			MatrixXdM part_cum_joint_hist(hist_data + params.n_bins, params.n_bins, params.n_bins);
+			curr_cum_hist_grad.middleCols(start_id, end_id - start_id).setZero();
+			for(unsigned int pix_id = start_id; pix_id < end_id; ++pix_id){
+				curr_bspl_ids.row(pix_id) = std_bspl_ids.row(static_cast<int>(It(pix_id)));
+				int curr_id = 0;
+				while(curr_id < curr_bspl_ids(pix_id, 0)){
 #ifndef CCRE_DISABLE_TRUE_CUM_HIST
-				// curr_cum_hist_mat is unity and curr_cum_hist_grad is zero but the latter has already been zeroed
-				curr_cum_hist_mat(curr_id, pix_id) = 1;
-				++curr_cum_hist(curr_id);
-				for(int init_id = init_bspl_ids(pix_id, 0); init_id <= init_bspl_ids(pix_id, 1); init_id++) {
-					cum_joint_hist(curr_id, init_id) += init_hist_mat(init_id, pix_id);
-			}
+					// curr_cum_hist_mat is unity and curr_cum_hist_grad is zero but the latter has already been zeroed
+					curr_cum_hist_mat(curr_id, pix_id) = 1;
+					++part_cum_hist(curr_id);
+					for(int init_id = init_bspl_ids(pix_id, 0); init_id <= init_bspl_ids(pix_id, 1); init_id++) {
+						part_cum_joint_hist(curr_id, init_id) += init_hist_mat(init_id, pix_id);
+					}
 #else
-				curr_cum_hist_mat(curr_id, pix_id) = 0;
+					curr_cum_hist_mat(curr_id, pix_id) = 0;
 #endif
-				++curr_id;
-			}
-			double curr_diff = curr_id - It(pix_id);
-			while(curr_id <= curr_bspl_ids(pix_id, 1)){
-				utils::cumBSpl3WithGrad(curr_cum_hist_mat(curr_id, pix_id), curr_cum_hist_grad(curr_id, pix_id), curr_diff);
-				curr_cum_hist_grad(curr_id, pix_id) *= -hist_norm_mult;
-
-				curr_cum_hist(curr_id) += curr_cum_hist_mat(curr_id, pix_id);
-				for(int init_id = init_bspl_ids(pix_id, 0); init_id <= init_bspl_ids(pix_id, 1); init_id++) {
-					cum_joint_hist(curr_id, init_id) += curr_cum_hist_mat(curr_id, pix_id) * init_hist_mat(init_id, pix_id);
+					++curr_id;
+				}
+				double curr_diff = curr_id - It(pix_id);
+				while(curr_id <= curr_bspl_ids(pix_id, 1)){
+					bspl_lut.cumBSpl3WithGrad(curr_cum_hist_mat(curr_id, pix_id), curr_cum_hist_grad(curr_id, pix_id), curr_diff);
+					curr_cum_hist_grad(curr_id, pix_id) *= -hist_norm_mult;
+
+					part_cum_hist(curr_id) += curr_cum_hist_mat(curr_id, pix_id);
+					for(int init_id = init_bspl_ids(pix_id, 0); init_id <= init_bspl_ids(pix_id, 1); init_id++) {
+						part_cum_joint_hist(curr_id, init_id) += curr_cum_hist_mat(curr_id, pix_id) * init_hist_mat(init_id, pix_id);
+					}
+					++curr_diff;
+					++curr_id;
 				}
-				++curr_diff;
-				++curr_id;
 			}
-		}
+		}, task_arena.get());
 	} else{
-#ifdef ENABLE_OMP
-#pragma omp parallel for schedule(CCRE_OMP_SCHD)
-#endif	
-		for(unsigned int pix_id = 0; pix_id < patch_size; ++pix_id){
-			curr_bspl_ids.row(pix_id) = std_bspl_ids.row(static_cast<int>(It(pix_id)));
-			int curr_id = 0;
-			while(curr_id < curr_bspl_ids(pix_id, 0)){
+		hist_sums = hist_accum.accumulate(patch_size,
+			[&](double *hist_data, unsigned int start_id, unsigned int end_id){
+			VectorXdM part_cum_hist(hist_data, params.n_bins);
+			MatrixXdM part_cum_joint_hist(hist_data + params.n_bins, params.n_bins, params.n_bins);
+			for(unsigned int pix_id = start_id; pix_id < end_id; ++pix_id){
+				curr_bspl_ids.row(pix_id) = std_bspl_ids.row(static_cast<int>(It(pix_id)));
+				int curr_id = 0;
+				while(curr_id < curr_bspl_ids(pix_id, 0)){
 #ifndef CCRE_DISABLE_TRUE_CUM_HIST
-				//! curr_cum_hist_mat is unity
-				curr_cum_hist_mat(curr_id, pix_id) = 1;
-				++curr_cum_hist(curr_id);
-				for(int init_id = init_bspl_ids(pix_id, 0); init_id <= init_bspl_ids(pix_id, 1); init_id++) {
-					cum_joint_hist(curr_id, init_id) += init_hist_mat(init_id, pix_id);
-				}
+					//! curr_cum_hist_mat is unity
+					curr_cum_hist_mat(curr_id, pix_id) = 1;
+					++part_cum_hist(curr_id);
+					for(int init_id = init_bspl_ids(pix_id, 0); init_id <= init_bspl_ids(pix_id, 1); init_id++) {
+						part_cum_joint_hist(curr_id, init_id) += init_hist_mat(init_id, pix_id);
+					}
 #else
-				curr_cum_hist_mat(curr_id, pix_id) = 0;
+					curr_cum_hist_mat(curr_id, pix_id) = 0;
 #endif
-				++curr_id;
-			}
-			double curr_diff = curr_id - It(pix_id);
-			while(curr_id <= curr_bspl_ids(pix_id, 1)){
-				curr_cum_hist_mat(curr_id, pix_id) = utils::cumBSpl3(curr_diff);
-				curr_cum_hist(curr_id) += curr_cum_hist_mat(curr_id, pix_id);
-				for(int init_id = init_bspl_ids(pix_id, 0); init_id <= init_bspl_ids(pix_id, 1); init_id++) {
-					cum_joint_hist(curr_id, init_id) += curr_cum_hist_mat(curr_id, pix_id) * init_hist_mat(init_id, pix_id);
+					++curr_id;
+				}
+				double curr_diff = curr_id - It(pix_id);
+				while(curr_id <= curr_bspl_ids(pix_id, 1)){
+					curr_cum_hist_mat(curr_id, pix_id) = bspl_lut.cumBSpl3(curr_diff);
+					part_cum_hist(curr_id) += curr_cum_hist_mat(curr_id, pix_id);
+					for(int init_id = init_bspl_ids(pix_id, 0); init_id <= init_bspl_ids(pix_id, 1); init_id++) {
+						part_cum_joint_hist(curr_id, init_id) += curr_cum_hist_mat(curr_id, pix_id) * init_hist_mat(init_id, pix_id);
+					}
+					++curr_diff;
+					++curr_id;
 				}
-				++curr_diff;
-				++curr_id;
 			}
-		}
+		}, task_arena.get());
 	}
-	curr_cum_hist *= hist_norm_mult;
-	cum_joint_hist *= hist_norm_mult;
+	curr_cum_hist = (Map<const VectorXd>(hist_sums, params.n_bins).array() + hist_pre_seed) * hist_norm_mult;
+	cum_joint_hist = (Map<const MatrixXd>(hist_sums + params.n_bins, params.n_bins, params.n_bins).array() +
+		params.pre_seed) * hist_norm_mult;
 	curr_cum_hist_log = curr_cum_hist.array().log();
 	cum_joint_hist_log = cum_joint_hist.array().log();
 
@@ -430,37 +456,36 @@ void CCRE::updateInitGrad(){
 	// compute differential of the current joint histogram w.r.t. initial pixel values simultaneously with init_grad;
 	// this does not need to be normalized since init_hist_grad has already been normalized
 	init_cum_joint_hist_grad.setZero();
-#ifdef ENABLE_OMP
-#pragma omp parallel for schedule(CCRE_OMP_SCHD)
-#endif	
-	for(unsigned int pix_id = 0; pix_id < patch_size; ++pix_id){
-		df_dI0(pix_id) = 0;
-		for(int init_id = init_bspl_ids(pix_id, 0); init_id <= init_bspl_ids(pix_id, 1); init_id++) {
-			int curr_id = 0;
-			while(curr_id < curr_bspl_ids(pix_id, 0)){
+	task_arena->parallelFor(0, static_cast<int>(patch_size), [&](int start_id, int end_id){
+		for(int pix_id = start_id; pix_id < end_id; ++pix_id){
+			df_dI0(pix_id) = 0;
+			for(int init_id = init_bspl_ids(pix_id, 0); init_id <= init_bspl_ids(pix_id, 1); init_id++) {
+				int curr_id = 0;
+				while(curr_id < curr_bspl_ids(pix_id, 0)){
 #ifndef CCRE_DISABLE_TRUE_CUM_HIST
-				int joint_id = linear_idx(curr_id, init_id);
-				init_cum_joint_hist_grad(joint_id, pix_id) = init_hist_grad(init_id, pix_id);
-				df_dI0(pix_id) += init_cum_joint_hist_grad(joint_id, pix_id) * (1 + ccre_log_term(curr_id, init_id))
-					- cum_joint_hist(curr_id, init_id) * init_hist_grad_ratio(init_id, pix_id);
+					int joint_id = linear_idx(curr_id, init_id);
+					init_cum_joint_hist_grad(joint_id, pix_id) = init_hist_grad(init_id, pix_id);
+					df_dI0(pix_id) += init_cum_joint_hist_grad(joint_id, pix_id) * (1 + ccre_log_term(curr_id, init_id))
+						- cum_joint_hist(curr_id, init_id) * init_hist_grad_ratio(init_id, pix_id);
 #else
-				df_dI0(pix_id) -= cum_joint_hist(curr_id, init_id) * init_hist_grad_ratio(init_id, pix_id);
+					df_dI0(pix_id) -= cum_joint_hist(curr_id, init_id) * init_hist_grad_ratio(init_id, pix_id);
 #endif
-				++curr_id;
-			}
-			while(curr_id <= curr_bspl_ids(pix_id, 1)){
-				int joint_id = linear_idx(curr_id, init_id);
-				init_cum_joint_hist_grad(joint_id, pix_id) = curr_cum_hist_mat(curr_id, pix_id) * init_hist_grad(init_id, pix_id);
-				df_dI0(pix_id) += init_cum_joint_hist_grad(joint_id, pix_id) * (1 + ccre_log_term(curr_id, init_id))
-					- cum_joint_hist(curr_id, init_id) * init_hist_grad_ratio(init_id, pix_id);
-				++curr_id;
-			}
-			while(curr_id < params.n_bins){
-				df_dI0(pix_id) -= cum_joint_hist(curr_id, init_id) * init_hist_grad_ratio(init_id, pix_id);
-				++curr_id;
+					++curr_id;
+				}
+				while(curr_id <= curr_bspl_ids(pix_id, 1)){
+					int joint_id = linear_idx(curr_id, init_id);
+					init_cum_joint_hist_grad(joint_id, pix_id) = curr_cum_hist_mat(curr_id, pix_id) * init_hist_grad(init_id, pix_id);
+					df_dI0(pix_id) += init_cum_joint_hist_grad(joint_id, pix_id) * (1 + ccre_log_term(curr_id, init_id))
+						- cum_joint_hist(curr_id, init_id) * init_hist_grad_ratio(init_id, pix_id);
+					++curr_id;
+				}
+				while(curr_id < params.n_bins){
+					df_dI0(pix_id) -= cum_joint_hist(curr_id, init_id) * init_hist_grad_ratio(init_id, pix_id);
+					++curr_id;
+				}
 			}
 		}
-	}
+	});
 }
 void CCRE::updateCurrGrad(){
 	curr_cum_joint_hist_grad.setZero();
@@ -525,6 +550,7 @@ void  CCRE::cmptInitHessian(MatrixXd &hessian, const MatrixXd &init_pix_jacobian
 	}
 	assert(hessian.rows() == hessian.cols() && hessian.cols() == init_pix_jacobian.cols());
 	assert(init_pix_jacobian.rows() == patch_size);
+	int ssm_state_size = init_pix_jacobian.cols();
 
 	MatrixXd cum_joint_hist_jac = init_cum_joint_hist_grad*init_pix_jacobian;
 	MatrixXd init_hist_grad_ratio_jac = init_hist_grad_ratio*init_pix_jacobian;
@@ -543,20 +569,24 @@ void  CCRE::cmptInitHessian(MatrixXd &hessian, const MatrixXd &init_pix_jacobian
 		}
 		hessian += cum_joint_hist_sum(init_id)*init_hist_grad_ratio_jac.row(init_id).transpose()*init_hist_grad_ratio_jac.row(init_id);
 	}
-#ifdef ENABLE_OMP
-#pragma omp parallel for schedule(CCRE_OMP_SCHD)
-#endif	
-	for(unsigned int pix_id = 0; pix_id < patch_size; ++pix_id){
-		double scalar_term = 0;
-		for(int init_id = init_bspl_ids(pix_id, 0); init_id <= init_bspl_ids(pix_id, 1); init_id++) {
-			for(int curr_id = 0; curr_id < params.n_bins; curr_id++) {
-				double joint_hist_hess = init_hist_hess(init_id, pix_id) * curr_cum_hist_mat(curr_id, pix_id);
-				scalar_term += joint_hist_hess*(ccre_log_term(curr_id, init_id) + 1);
+	//! each thread accumulates the contribution of its own pixels in a separate buffer
+	resizeHessAccum(ssm_state_size);
+	const double *hess_sums = hess_accum.accumulate(patch_size,
+		[&](double *hess_data, unsigned int start_id, unsigned int end_id){
+		MatrixXdM part_hessian(hess_data, ssm_state_size, ssm_state_size);
+		for(unsigned int pix_id = start_id; pix_id < end_id; ++pix_id){
+			double scalar_term = 0;
+			for(int init_id = init_bspl_ids(pix_id, 0); init_id <= init_bspl_ids(pix_id, 1); init_id++) {
+				for(int curr_id = 0; curr_id < params.n_bins; curr_id++) {
+					double joint_hist_hess = init_hist_hess(init_id, pix_id) * curr_cum_hist_mat(curr_id, pix_id);
+					scalar_term += joint_hist_hess*(ccre_log_term(curr_id, init_id) + 1);
+				}
+				scalar_term -= init_hist_hess_ratio(init_id, pix_id)*cum_joint_hist_sum(init_id);
 			}
-			scalar_term -= init_hist_hess_ratio(init_id, pix_id)*cum_joint_hist_sum(init_id);
+			part_hessian += scalar_term * init_pix_jacobian.row(pix_id).transpose() * init_pix_jacobian.row(pix_id);
 		}
-		hessian += scalar_term * init_pix_jacobian.row(pix_id).transpose() * init_pix_jacobian.row(pix_id);
-	}
+	}, task_arena.get());
+	hessian += Map<const MatrixXd>(hess_sums, ssm_state_size, ssm_state_size);
 }
 /*
 Prerequisites: curr_cum_joint_hist_grad, ccre_log_term, init_hist_mat, cum_joint_hist, curr_cum_hist
@@ -568,29 +598,35 @@ void  CCRE::cmptCurrHessian(MatrixXd &hessian, const MatrixXd &curr_pix_jacobian
 
 	// compute curr_cum_hist_hess simultaneously with the hessian
 	MatrixXd joint_hist_jacobian(joint_hist_size, ssm_state_size);
-	hessian.setZero();
-	joint_hist_jacobian.setZero();
 	curr_cum_hist_hess.setZero();
 
-#ifdef ENABLE_OMP
-#pragma omp parallel for schedule(CCRE_OMP_SCHD)
-#endif	
-	for(unsigned int pix_id = 0; pix_id < patch_size; ++pix_id){
-		double curr_diff = curr_bspl_ids(pix_id, 0) - It(pix_id);
-		double hist_hess_term = 0;
-		for(int curr_id = curr_bspl_ids(pix_id, 0); curr_id <= curr_bspl_ids(pix_id, 1); curr_id++) {
-			double inner_term = 0;
-			for(int init_id = init_bspl_ids(pix_id, 0); init_id <= init_bspl_ids(pix_id, 1); init_id++) {
-				int joint_id = linear_idx(curr_id, init_id);
-				joint_hist_jacobian.row(joint_id) += curr_cum_joint_hist_grad(joint_id, pix_id)*curr_pix_jacobian.row(pix_id);
-				inner_term += init_hist_mat(init_id, pix_id) * ccre_log_term(curr_id, init_id);
+	//! each thread accumulates the contribution of its own pixels in a separate buffer
+	resizeHessAccum(ssm_state_size);
+	const double *hess_sums = hess_accum.accumulate(patch_size,
+		[&](double *hess_data, unsigned int start_id, unsigned int end_id){
+		MatrixXdM part_hessian(hess_data, ssm_state_size, ssm_state_size);
+		MatrixXdM part_joint_hist_jacobian(hess_data + ssm_state_size*ssm_state_size,
+			joint_hist_size, ssm_state_size);
+		for(unsigned int pix_id = start_id; pix_id < end_id; ++pix_id){
+			double curr_diff = curr_bspl_ids(pix_id, 0) - It(pix_id);
+			double hist_hess_term = 0;
+			for(int curr_id = curr_bspl_ids(pix_id, 0); curr_id <= curr_bspl_ids(pix_id, 1); curr_id++) {
+				double inner_term = 0;
+				for(int init_id = init_bspl_ids(pix_id, 0); init_id <= init_bspl_ids(pix_id, 1); init_id++) {
+					int joint_id = linear_idx(curr_id, init_id);
+					part_joint_hist_jacobian.row(joint_id) += curr_cum_joint_hist_grad(joint_id, pix_id)*curr_pix_jacobian.row(pix_id);
+					inner_term += init_hist_mat(init_id, pix_id) * ccre_log_term(curr_id, init_id);
+				}
+				curr_cum_hist_hess(curr_id, pix_id) = hist_norm_mult*bspl_lut.cumBSpl3Hess(curr_diff);
+				++curr_diff;
+				hist_hess_term += curr_cum_hist_hess(curr_id, pix_id)*inner_term;
 			}
-			curr_cum_hist_hess(curr_id, pix_id) = hist_norm_mult*utils::cumBSpl3Hess(curr_diff);
-			++curr_diff;
-			hist_hess_term += curr_cum_hist_hess(curr_id, pix_id)*inner_term;
+			part_hessian += hist_hess_term * curr_pix_jacobian.row(pix_id).transpose() * curr_pix_jacobian.row(pix_id);
 		}
-		hessian += hist_hess_term * curr_pix_jacobian.row(pix_id).transpose() * curr_pix_jacobian.row(pix_id);
-	}
+	}, task_arena.get());
+	hessian = Map<const MatrixXd>(hess_sums, ssm_state_size, ssm_state_size);
+	joint_hist_jacobian = Map<const MatrixXd>(hess_sums + ssm_state_size*ssm_state_size,
+		joint_hist_size, ssm_state_size);
 
 	for(int curr_id = 0; curr_id < params.n_bins; curr_id++){
 		for(int init_id = 0; init_id < params.n_bins; init_id++){
@@ -603,35 +639,35 @@ void  CCRE::cmptCurrHessian(MatrixXd &hessian, const MatrixXd &curr_pix_jacobian
 
 void CCRE::cmptCumSelfHist(){
 	// compute curr_hist, curr_hist_mat, curr_cum_hist_hess and self_cum_joint_hist in a single pass over the pixels;
-	curr_hist.fill(hist_pre_seed);
-	self_cum_joint_hist.fill(params.pre_seed);
-	curr_hist_mat.setZero();
-	curr_cum_hist_hess.setZero();
-
-#ifdef ENABLE_OMP
-#pragma omp parallel for schedule(CCRE_OMP_SCHD)
-#endif	
-	for(unsigned int pix_id = 0; pix_id < patch_size; ++pix_id) {
-		double curr_diff = curr_bspl_ids(pix_id, 0) - It(pix_id);
-		for(int hist_id = curr_bspl_ids(pix_id, 0); hist_id <= curr_bspl_ids(pix_id, 1); ++hist_id) {
-			curr_hist_mat(hist_id, pix_id) = utils::bSpl3(curr_diff);
-			curr_cum_hist_hess(hist_id, pix_id) = hist_norm_mult*utils::cumBSpl3Hess(curr_diff);
-			++curr_diff;
-			curr_hist(hist_id) += curr_hist_mat(hist_id, pix_id);
+	const double *hist_sums = hist_accum.accumulate(patch_size,
+		[&](double *hist_data, unsigned int start_id, unsigned int end_id){
+		VectorXdM part_hist(hist_data, params.n_bins);
+		MatrixXdM part_self_cum_joint_hist(hist_data + params.n_bins, params.n_bins, params.n_bins);
+		curr_hist_mat.middleCols(start_id, end_id - start_id).setZero();
+		curr_cum_hist_hess.middleCols(start_id, end_id - start_id).setZero();
+		for(unsigned int pix_id = start_id; pix_id < end_id; ++pix_id){
+			double curr_diff = curr_bspl_ids(pix_id, 0) - It(pix_id);
+			for(int hist_id = curr_bspl_ids(pix_id, 0); hist_id <= curr_bspl_ids(pix_id, 1); ++hist_id) {
+				curr_hist_mat(hist_id, pix_id) = bspl_lut.bSpl3(curr_diff);
+				curr_cum_hist_hess(hist_id, pix_id) = hist_norm_mult*bspl_lut.cumBSpl3Hess(curr_diff);
+				++curr_diff;
+				part_hist(hist_id) += curr_hist_mat(hist_id, pix_id);
 
-			int cum_hist_id = 0;
-			while(cum_hist_id < curr_bspl_ids(pix_id, 0)){
-				self_cum_joint_hist(cum_hist_id, hist_id) += curr_hist_mat(hist_id, pix_id);
-				++cum_hist_id;
-			}
-			while(cum_hist_id <= curr_bspl_ids(pix_id, 1)){
-				self_cum_joint_hist(cum_hist_id, hist_id) += curr_cum_hist_mat(cum_hist_id, pix_id) * curr_hist_mat(hist_id, pix_id);
-				++cum_hist_id;
+				int cum_hist_id = 0;
+				while(cum_hist_id < curr_bspl_ids(pix_id, 0)){
+					part_self_cum_joint_hist(cum_hist_id, hist_id) += curr_hist_mat(hist_id, pix_id);
+					++cum_hist_id;
+				}
+				while(cum_hist_id <= curr_bspl_ids(pix_id, 1)){
+					part_self_cum_joint_hist(cum_hist_id, hist_id) += curr_cum_hist_mat(cum_hist_id, pix_id) * curr_hist_mat(hist_id, pix_id);
+					++cum_hist_id;
+				}
 			}
 		}
-	}
-	curr_hist *= hist_norm_mult;
-	self_cum_joint_hist *= hist_norm_mult;
+	}, task_arena.get());
+	curr_hist = (Map<const VectorXd>(hist_sums, params.n_bins).array() + hist_pre_seed) * hist_norm_mult;
+	self_cum_joint_hist = (Map<const MatrixXd>(hist_sums + params.n_bins, params.n_bins, params.n_bins).array() +
+		params.pre_seed) * hist_norm_mult;
 	curr_hist_log = curr_hist.array().log();
 	self_cum_joint_hist_log = self_cum_joint_hist.array().log();
 
@@ -649,25 +685,31 @@ void CCRE::cmptSelfHessian(MatrixXd &self_hessian, const MatrixXd &curr_pix_jaco
 
 	cmptCumSelfHist();
 	MatrixXd joint_hist_jacobian(joint_hist_size, ssm_state_size);
-	self_hessian.setZero();
-	joint_hist_jacobian.setZero();
-#ifdef ENABLE_OMP
-#pragma omp parallel for schedule(CCRE_OMP_SCHD)
-#endif	
-	for(unsigned int pix_id = 0; pix_id < patch_size; ++pix_id){
-		double hist_hess_term = 0;
-		for(int cum_hist_id = curr_bspl_ids(pix_id, 0); cum_hist_id <= curr_bspl_ids(pix_id, 1); ++cum_hist_id) {
-			double inner_term = 0;
-			for(int hist_id = curr_bspl_ids(pix_id, 0); hist_id <= curr_bspl_ids(pix_id, 1); ++hist_id) {
-				int joint_id = linear_idx(cum_hist_id, hist_id);
-				joint_hist_jacobian.row(joint_id) += curr_cum_hist_grad(cum_hist_id, pix_id) * curr_hist_mat(hist_id, pix_id) *
-					curr_pix_jacobian.row(pix_id);
-				inner_term += curr_hist_mat(hist_id, pix_id) * self_ccre_log_term(cum_hist_id, hist_id);
+	//! each thread accumulates the contribution of its own pixels in a separate buffer
+	resizeHessAccum(ssm_state_size);
+	const double *hess_sums = hess_accum.accumulate(patch_size,
+		[&](double *hess_data, unsigned int start_id, unsigned int end_id){
+		MatrixXdM part_hessian(hess_data, ssm_state_size, ssm_state_size);
+		MatrixXdM part_joint_hist_jacobian(hess_data + ssm_state_size*ssm_state_size,
+			joint_hist_size, ssm_state_size);
+		for(unsigned int pix_id = start_id; pix_id < end_id; ++pix_id){
+			double hist_hess_term = 0;
+			for(int cum_hist_id = curr_bspl_ids(pix_id, 0); cum_hist_id <= curr_bspl_ids(pix_id, 1); ++cum_hist_id) {
+				double inner_term = 0;
+				for(int hist_id = curr_bspl_ids(pix_id, 0); hist_id <= curr_bspl_ids(pix_id, 1); ++hist_id) {
+					int joint_id = linear_idx(cum_hist_id, hist_id);
+					part_joint_hist_jacobian.row(joint_id) += curr_cum_hist_grad(cum_hist_id, pix_id) * curr_hist_mat(hist_id, pix_id) *
+						curr_pix_jacobian.row(pix_id);
+					inner_term += curr_hist_mat(hist_id, pix_id) * self_ccre_log_term(cum_hist_id, hist_id);
+				}
+				hist_hess_term += curr_cum_hist_hess(cum_hist_id, pix_id)*inner_term;
 			}
-			hist_hess_term += curr_cum_hist_hess(cum_hist_id, pix_id)*inner_term;
+			part_hessian += hist_hess_term * curr_pix_jacobian.row(pix_id).transpose() * curr_pix_jacobian.row(pix_id);
 		}
-		self_hessian += hist_hess_term * curr_pix_jacobian.row(pix_id).transpose() * curr_pix_jacobian.row(pix_id);
-	}
+	}, task_arena.get());
+	self_hessian = Map<const MatrixXd>(hess_sums, ssm_state_size, ssm_state_size);
+	joint_hist_jacobian = Map<const MatrixXd>(hess_sums + ssm_state_size*ssm_state_size,
+		joint_hist_size, ssm_state_size);
 	for(int r = 0; r < params.n_bins; ++r){
 		for(int t = 0; t < params.n_bins; ++t){
 			int idx = linear_idx(r, t);
@@ -681,31 +723,35 @@ void CCRE::cmptSelfHessian(MatrixXd &self_hessian, const MatrixXd &curr_pix_jaco
 
 
 void CCRE::updateSymSimilarity(bool prereq_only){
-	curr_hist.fill(hist_pre_seed);
-	curr_hist_mat.setZero();
-	cum_joint_hist.fill(params.pre_seed);
-	for(unsigned int pix_id = 0; pix_id < patch_size; ++pix_id) {
-		double curr_diff = curr_bspl_ids(pix_id, 0) - It(pix_id);
-		for(int curr_id = curr_bspl_ids(pix_id, 0); curr_id <= curr_bspl_ids(pix_id, 1); ++curr_id) {
-			curr_hist_mat(curr_id, pix_id) = utils::bSpl3(curr_diff);
-			++curr_diff;
-			curr_hist(curr_id) += curr_hist_mat(curr_id, pix_id);
-			int init_id = 0;
-			while(init_id < init_bspl_ids(pix_id, 0)){
+	const double *hist_sums = hist_accum.accumulate(patch_size,
+		[&](double *hist_data, unsigned int start_id, unsigned int end_id){
+		VectorXdM part_hist(hist_data, params.n_bins);
+		MatrixXdM part_cum_joint_hist(hist_data + params.n_bins, params.n_bins, params.n_bins);
+		curr_hist_mat.middleCols(start_id, end_id - start_id).setZero();
+		for(unsigned int pix_id = start_id; pix_id < end_id; ++pix_id){
+			double curr_diff = curr_bspl_ids(pix_id, 0) - It(pix_id);
+			for(int curr_id = curr_bspl_ids(pix_id, 0); curr_id <= curr_bspl_ids(pix_id, 1); ++curr_id) {
+				curr_hist_mat(curr_id, pix_id) = bspl_lut.bSpl3(curr_diff);
+				++curr_diff;
+				part_hist(curr_id) += curr_hist_mat(curr_id, pix_id);
+				int init_id = 0;
+				while(init_id < init_bspl_ids(pix_id, 0)){
 #ifndef CCRE_DISABLE_TRUE_CUM_HIST
-				// init_cum_hist_mat is unity
-				cum_joint_hist(init_id, curr_id) += curr_hist_mat(curr_id, pix_id);
+					// init_cum_hist_mat is unity
+					part_cum_joint_hist(init_id, curr_id) += curr_hist_mat(curr_id, pix_id);
 #endif
-				++init_id;
-			}
-			while(init_id <= init_bspl_ids(pix_id, 1)){
-				cum_joint_hist(init_id, curr_id) += init_cum_hist_mat(init_id, pix_id) * curr_hist_mat(curr_id, pix_id);
-				++init_id;
+					++init_id;
+				}
+				while(init_id <= init_bspl_ids(pix_id, 1)){
+					part_cum_joint_hist(init_id, curr_id) += init_cum_hist_mat(init_id, pix_id) * curr_hist_mat(curr_id, pix_id);
+					++init_id;
+				}
 			}
 		}
-	}
-	cum_joint_hist *= hist_norm_mult;
-	curr_hist *= hist_norm_mult;
+	}, task_arena.get());
+	cum_joint_hist = (Map<const MatrixXd>(hist_sums + params.n_bins, params.n_bins, params.n_bins).array() +
+		params.pre_seed) * hist_norm_mult;
+	curr_hist = (Map<const VectorXd>(hist_sums, params.n_bins).array() + hist_pre_seed) * hist_norm_mult;
 	cum_joint_hist_log = cum_joint_hist.array().log();
 	curr_hist_log = curr_hist.array().log();
 
@@ -739,24 +785,30 @@ void  CCRE::cmptSymInitHessian(MatrixXd &hessian, const MatrixXd &init_pix_jacob
 
 	int ssm_state_size = init_pix_jacobian.cols();
 	MatrixXd joint_hist_jacobian(joint_hist_size, ssm_state_size);
-	joint_hist_jacobian.setZero();
-	hessian.setZero();
-#ifdef ENABLE_OMP
-#pragma omp parallel for schedule(CCRE_OMP_SCHD)
-#endif	
-	for(unsigned int pix_id = 0; pix_id < patch_size; ++pix_id){
-		double hist_hess_term = 0;
-		for(int init_id = init_bspl_ids(pix_id, 0); init_id <= init_bspl_ids(pix_id, 1); init_id++) {
-			double inner_term = 0;
-			for(int curr_id = curr_bspl_ids(pix_id, 0); curr_id <= curr_bspl_ids(pix_id, 1); curr_id++) {
-				int joint_id = linear_idx(init_id, curr_id);
-				joint_hist_jacobian.row(joint_id) += init_cum_joint_hist_grad(joint_id, pix_id)*init_pix_jacobian.row(pix_id);
-				inner_term += curr_hist_mat(curr_id, pix_id) * ccre_log_term(init_id, curr_id);
+	//! each thread accumulates the contribution of its own pixels in a separate buffer
+	resizeHessAccum(ssm_state_size);
+	const double *hess_sums = hess_accum.accumulate(patch_size,
+		[&](double *hess_data, unsigned int start_id, unsigned int end_id){
+		MatrixXdM part_hessian(hess_data, ssm_state_size, ssm_state_size);
+		MatrixXdM part_joint_hist_jacobian(hess_data + ssm_state_size*ssm_state_size,
+			joint_hist_size, ssm_state_size);
+		for(unsigned int pix_id = start_id; pix_id < end_id; ++pix_id){
+			double hist_hess_term = 0;
+			for(int init_id = init_bspl_ids(pix_id, 0); init_id <= init_bspl_ids(pix_id, 1); init_id++) {
+				double inner_term = 0;
+				for(int curr_id = curr_bspl_ids(pix_id, 0); curr_id <= curr_bspl_ids(pix_id, 1); curr_id++) {
+					int joint_id = linear_idx(init_id, curr_id);
+					part_joint_hist_jacobian.row(joint_id) += init_cum_joint_hist_grad(joint_id, pix_id)*init_pix_jacobian.row(pix_id);
+					inner_term += curr_hist_mat(curr_id, pix_id) * ccre_log_term(init_id, curr_id);
+				}
+				hist_hess_term += init_cum_hist_hess(init_id, pix_id)*inner_term;
 			}
-			hist_hess_term += init_cum_hist_hess(init_id, pix_id)*inner_term;
+			part_hessian += hist_hess_term * init_pix_jacobian.row(pix_id).transpose() * init_pix_jacobian.row(pix_id);
 		}
-		hessian += hist_hess_term * init_pix_jacobian.row(pix_id).transpose() * init_pix_jacobian.row(pix_id);
-	}
+	}, task_arena.get());
+	hessian = Map<const MatrixXd>(hess_sums, ssm_state_size, ssm_state_size);
+	joint_hist_jacobian = Map<const MatrixXd>(hess_sums + ssm_state_size*ssm_state_size,
+		joint_hist_size, ssm_state_size);
 	for(int init_id = 0; init_id < params.n_bins; init_id++){
 		for(int curr_id = 0; curr_id < params.n_bins; curr_id++){
 			int joint_id = linear_idx(init_id, curr_id);
@@ -771,25 +823,24 @@ void  CCRE::cmptSymInitHessian(MatrixXd &hessian, const MatrixXd &init_pix_jacob
 void CCRE::updateDistFeat(double* feat_addr){
 	MatrixXdMr cum_hist_mat(feat_addr, 9, patch_size);
 
-#ifdef ENABLE_OMP
-#pragma omp parallel for schedule(CCRE_OMP_SCHD)
-#endif	
-	for(size_t patch_id = 0; patch_id < patch_size; patch_id++) {
-		int pix_val_floor = static_cast<int>(It(patch_id));
-		double pix_diff = std_bspl_ids(pix_val_floor, 0) - It(patch_id);
-		cum_hist_mat(0, patch_id) = pix_val_floor;
-		cum_hist_mat(1, patch_id) = utils::cumBSpl3(pix_diff);
-		cum_hist_mat(5, patch_id) = utils::bSpl3(pix_diff++);
+	task_arena->parallelFor(0, static_cast<int>(patch_size), [&](int start_id, int end_id){
+		for(int patch_id = start_id; patch_id < end_id; patch_id++) {
+			int pix_val_floor = static_cast<int>(It(patch_id));
+			double pix_diff = std_bspl_ids(pix_val_floor, 0) - It(patch_id);
+			cum_hist_mat(0, patch_id) = pix_val_floor;
+			cum_hist_mat(1, patch_id) = bspl_lut.cumBSpl3(pix_diff);
+			cum_hist_mat(5, patch_id) = bspl_lut.bSpl3(pix_diff++);
 
-		cum_hist_mat(2, patch_id) = utils::cumBSpl3(pix_diff);
-		cum_hist_mat(6, patch_id) = utils::bSpl3(pix_diff++);
+			cum_hist_mat(2, patch_id) = bspl_lut.cumBSpl3(pix_diff);
+			cum_hist_mat(6, patch_id) = bspl_lut.bSpl3(pix_diff++);
 
-		cum_hist_mat(3, patch_id) = utils::cumBSpl3(pix_diff);
-		cum_hist_mat(7, patch_id) = utils::bSpl3(pix_diff++);
+			cum_hist_mat(3, patch_id) = bspl_lut.cumBSpl3(pix_diff);
+			cum_hist_mat(7, patch_id) = bspl_lut.bSpl3(pix_diff++);
 
-		cum_hist_mat(4, patch_id) = utils::cumBSpl3(pix_diff);
-		cum_hist_mat(8, patch_id) = utils::bSpl3(pix_diff);
-	}
+			cum_hist_mat(4, patch_id) = bspl_lut.cumBSpl3(pix_diff);
+			cum_hist_mat(8, patch_id) = bspl_lut.bSpl3(pix_diff);
+		}
+	});
 }
 
 //----------------------------------- Second order Hessians -----------------------------------//
@@ -835,26 +886,32 @@ void CCRE::cmptSelfHessian(MatrixXd &self_hessian, const MatrixXd &curr_pix_jaco
 	cmptCumSelfHist();
 
 	MatrixXd joint_hist_jacobian(joint_hist_size, ssm_state_size);
-	self_hessian.setZero();
-	joint_hist_jacobian.setZero();
-#ifdef ENABLE_OMP
-#pragma omp parallel for schedule(CCRE_OMP_SCHD)
-#endif	
-	for(unsigned int pix_id = 0; pix_id < patch_size; ++pix_id){
-		double hist_hess_term = 0, hist_grad_term = 0;
-		for(int r = curr_bspl_ids(pix_id, 0); r <= curr_bspl_ids(pix_id, 1); r++) {
-			double inner_term = 0;
-			for(int t = curr_bspl_ids(pix_id, 0); t <= curr_bspl_ids(pix_id, 1); t++) {
-				int idx = linear_idx(r, t);
-				joint_hist_jacobian.row(idx) += curr_cum_hist_grad(r, pix_id) * curr_hist_mat(t, pix_id)*curr_pix_jacobian.row(pix_id);
-				inner_term += curr_hist_mat(t, pix_id) * self_ccre_log_term(r, t);
+	//! each thread accumulates the contribution of its own pixels in a separate buffer
+	resizeHessAccum(ssm_state_size);
+	const double *hess_sums = hess_accum.accumulate(patch_size,
+		[&](double *hess_data, unsigned int start_id, unsigned int end_id){
+		MatrixXdM part_hessian(hess_data, ssm_state_size, ssm_state_size);
+		MatrixXdM part_joint_hist_jacobian(hess_data + ssm_state_size*ssm_state_size,
+			joint_hist_size, ssm_state_size);
+		for(unsigned int pix_id = start_id; pix_id < end_id; ++pix_id){
+			double hist_hess_term = 0, hist_grad_term = 0;
+			for(int r = curr_bspl_ids(pix_id, 0); r <= curr_bspl_ids(pix_id, 1); r++) {
+				double inner_term = 0;
+				for(int t = curr_bspl_ids(pix_id, 0); t <= curr_bspl_ids(pix_id, 1); t++) {
+					int idx = linear_idx(r, t);
+					part_joint_hist_jacobian.row(idx) += curr_cum_hist_grad(r, pix_id) * curr_hist_mat(t, pix_id)*curr_pix_jacobian.row(pix_id);
+					inner_term += curr_hist_mat(t, pix_id) * self_ccre_log_term(r, t);
+				}
+				hist_hess_term += curr_cum_hist_hess(r, pix_id)*inner_term;
+				hist_grad_term += curr_cum_hist_grad(r, pix_id)*inner_term;
 			}
-			hist_hess_term += curr_cum_hist_hess(r, pix_id)*inner_term;
-			hist_grad_term += curr_cum_hist_grad(r, pix_id)*inner_term;
+			part_hessian += hist_hess_term * curr_pix_jacobian.row(pix_id).transpose() * curr_pix_jacobian.row(pix_id)
+				+ hist_grad_term * Map<const MatrixXd>(curr_pix_hessian.col(pix_id).data(), ssm_state_size, ssm_state_size);
 		}
-		self_hessian += hist_hess_term * curr_pix_jacobian.row(pix_id).transpose() * curr_pix_jacobian.row(pix_id)
-			+ hist_grad_term * Map<const MatrixXd>(curr_pix_hessian.col(pix_id).data(), ssm_state_size, ssm_state_size);
-	}
+	}, task_arena.get());
+	self_hessian = Map<const MatrixXd>(hess_sums, ssm_state_size, ssm_state_size);
+	joint_hist_jacobian = Map<const MatrixXd>(hess_sums + ssm_state_size*ssm_state_size,
+		joint_hist_size, ssm_state_size);
 	for(int r = 0; r < params.n_bins; r++){
 		for(int t = 0; t < params.n_bins; t++){
 			int idx = linear_idx(r, t);
@@ -885,9 +942,7 @@ double CCREDist::operator()(const double* hist1_mat_addr, const double* hist2_ma
 
 	//utils::printMatrixToFile(hist1_mat, "hist1_mat", "log/ccre_log.txt");
 	//utils::printMatrixToFile(hist2_mat, "hist2_mat", "log/ccre_log.txt");
-#ifdef ENABLE_OMP
-#pragma omp parallel for schedule(CCRE_OMP_SCHD)
-#endif	
+	//! all pixels update the same histograms so this loop is kept serial
 	for(size_t patch_id = 0; patch_id < patch_size; ++patch_id) {
 		int pix1_floor = static_cast<int>(cum_hist_mat(0, patch_id));
 		int pix2_floor = static_cast<int>(hist_mat(0, patch_id));
@@ -1,25 +1,29 @@
 #include "mtf/AM/ImageBase.h"
 #include "mtf/Utilities/imgUtils.h"
+#include "mtf/Utilities/simdUtils.h"
 
 _MTF_BEGIN_NAMESPACE
 
 ImgParams::ImgParams(int _resx, int _resy,
 double _grad_eps, double _hess_eps,
-bool _use_uchar_input) :
+bool _use_uchar_input, bool _img_deriv_cache) :
 resx(_resx), resy(_resy),
 grad_eps(_grad_eps), hess_eps(_hess_eps),
-uchar_input(_use_uchar_input){}
+uchar_input(_use_uchar_input),
+img_deriv_cache(_img_deriv_cache){}
 
 ImgParams::ImgParams(const ImgParams *img_params) :
 resx(MTF_RES), resy(MTF_RES),
 grad_eps(GRAD_EPS), hess_eps(HESS_EPS),
-uchar_input(UCHAR_INPUT){
+uchar_input(UCHAR_INPUT),
+img_deriv_cache(IMG_DERIV_CACHE){
 	if(img_params){
 		resx = img_params->resx;
 		resy = img_params->resy;
 		grad_eps = img_params->grad_eps;
 		hess_eps = img_params->hess_eps;
 		uchar_input = img_params->uchar_input;
+		img_deriv_cache = img_params->img_deriv_cache;
 	}
 }
 
@@ -28,8 +32,10 @@ resx(getResX(params)), resy(getResY(params)), n_pix(resx*resy),
 n_channels(_n_channels), patch_size(n_pix*n_channels), 
 grad_eps(getGradEps(params)), hess_eps(getHessEps(params)),
 input_type(getInputType(params)),
+img_deriv_cache(getImgDerivCache(params)),
 curr_img(nullptr, 0, 0), img_height(0), img_width(0),
-pix_norm_add(0.0), pix_norm_mult(1.0), frame_count(0){
+pix_norm_add(0.0), pix_norm_mult(1.0), frame_count(0),
+img_deriv_updated(false), img_sec_deriv_updated(false){
 	if(resx == 0 || resy == 0) {
 		throw utils::InvalidArgument("ImageBase::Invalid sampling resolution provided");
 	}
@@ -57,6 +63,21 @@ void ImageBase::setCurrImg(const cv::Mat &cv_img){
 		// not really necessary but remains as a relic from the past
 		new (&curr_img) EigImgT((EigPixT*)(cv_img.data), img_height, img_width);
 	}
+	invalidateImgDerivatives();
+}
+
+void ImageBase::updateImgDerivatives(){
+	if(!img_deriv_updated){
+		utils::getImgDerivatives(curr_img_dx, curr_img_dy, curr_img_cv);
+		img_deriv_updated = true;
+	}
+}
+
+void ImageBase::updateImgSecondDerivatives(){
+	if(!img_sec_deriv_updated){
+		utils::getImgSecondDerivatives(curr_img_dxx, curr_img_dxy, curr_img_dyy, curr_img_cv);
+		img_sec_deriv_updated = true;
+	}
 }
 
 void ImageBase::initializePixVals(const Matrix2Xd& init_pts){
@@ -72,6 +93,8 @@ void ImageBase::initializePixVals(const Matrix2Xd& init_pts){
 #endif
 	}
 	++frame_count;
+	// (re)initialization and template updates happen on a new frame
+	invalidateImgDerivatives();
 	switch(input_type){
 	case InputType::MTF_8UC1:
 		utils::sc::getPixVals<uchar>(I0, curr_img_cv, init_pts, n_pix,
@@ -105,25 +128,31 @@ void ImageBase::initializePixGrad(const Matrix2Xd &init_pts){
 		dI0_dx.resize(patch_size, Eigen::NoChange);
 		dIt_dx.resize(patch_size, Eigen::NoChange);
 	}
-	switch(input_type){
-	case InputType::MTF_8UC1:
-		utils::sc::getImgGrad<uchar>(dI0_dx, curr_img_cv, init_pts, grad_eps, n_pix,
-			img_height, img_width, pix_norm_mult);
-		break;
-	case InputType::MTF_8UC3:
-		utils::mc::getImgGrad<uchar>(dI0_dx, curr_img_cv, init_pts, grad_eps, n_pix,
-			img_height, img_width, pix_norm_mult);
-		break;
-	case InputType::MTF_32FC1:
-		utils::getImgGrad(dI0_dx, curr_img, init_pts, grad_eps, n_pix,
-			img_height, img_width, pix_norm_mult);
-		break;
-	case InputType::MTF_32FC3:
-		utils::mc::getImgGrad<float>(dI0_dx, curr_img_cv, init_pts, grad_eps, n_pix,
+	if(img_deriv_cache){
+		updateImgDerivatives();
+		utils::getImgGrad(dI0_dx, curr_img_dx, curr_img_dy, init_pts, n_pix,
 			img_height, img_width, pix_norm_mult);
-		break;
-	default:
-		throw utils::InvalidArgument("ImageBase::Invalid input type found");
+	} else{
+		switch(input_type){
+		case InputType::MTF_8UC1:
+			utils::sc::getImgGrad<uchar>(dI0_dx, curr_img_cv, init_pts, grad_eps, n_pix,
+				img_height, img_width, pix_norm_mult);
+			break;
+		case InputType::MTF_8UC3:
+			utils::mc::getImgGrad<uchar>(dI0_dx, curr_img_cv, init_pts, grad_eps, n_pix,
+				img_height, img_width, pix_norm_mult);
+			break;
+		case InputType::MTF_32FC1:
+			utils::getImgGrad(dI0_dx, curr_img, init_pts, grad_eps, n_pix,
+				img_height, img_width, pix_norm_mult);
+			break;
+		case InputType::MTF_32FC3:
+			utils::mc::getImgGrad<float>(dI0_dx, curr_img_cv, init_pts, grad_eps, n_pix,
+				img_height, img_width, pix_norm_mult);
+			break;
+		default:
+			throw utils::InvalidArgument("ImageBase::Invalid input type found");
+		}
 	}
 	if(!isInitialized()->pix_grad){
 		setCurrPixGrad(getInitPixGrad());
@@ -141,29 +170,35 @@ void ImageBase::initializePixGrad(const Matrix8Xd &warped_offset_pts){
 		dI0_dx.resize(patch_size, Eigen::NoChange);
 		dIt_dx.resize(patch_size, Eigen::NoChange);
 	}
-	switch(input_type){
-	case InputType::MTF_8UC1:
-		utils::sc::getWarpedImgGrad<uchar>(dI0_dx,
-			curr_img_cv, warped_offset_pts, grad_eps, n_pix,
-			img_height, img_width, pix_norm_mult);
-		break;
-	case InputType::MTF_8UC3:
-		utils::mc::getWarpedImgGrad<uchar>(dI0_dx,
-			curr_img_cv, warped_offset_pts, grad_eps, n_pix,
-			img_height, img_width, pix_norm_mult);
-		break;
-	case InputType::MTF_32FC1:
-		utils::getWarpedImgGrad(dI0_dx,
-			curr_img, warped_offset_pts, grad_eps, n_pix,
-			img_height, img_width, pix_norm_mult);
-		break;
-	case InputType::MTF_32FC3:
-		utils::mc::getWarpedImgGrad<float>(dI0_dx,
-			curr_img_cv, warped_offset_pts, grad_eps, n_pix,
-			img_height, img_width, pix_norm_mult);
-		break;
-	default:
-		throw utils::InvalidArgument("ImageBase::Invalid input type found");
+	if(img_deriv_cache){
+		updateImgDerivatives();
+		utils::getWarpedImgGrad(dI0_dx, curr_img_dx, curr_img_dy, warped_offset_pts,
+			grad_eps, n_pix, img_height, img_width, pix_norm_mult);
+	} else{
+		switch(input_type){
+		case InputType::MTF_8UC1:
+			utils::sc::getWarpedImgGrad<uchar>(dI0_dx,
+				curr_img_cv, warped_offset_pts, grad_eps, n_pix,
+				img_height, img_width, pix_norm_mult);
+			break;
+		case InputType::MTF_8UC3:
+			utils::mc::getWarpedImgGrad<uchar>(dI0_dx,
+				curr_img_cv, warped_offset_pts, grad_eps, n_pix,
+				img_height, img_width, pix_norm_mult);
+			break;
+		case InputType::MTF_32FC1:
+			utils::getWarpedImgGrad(dI0_dx,
+				curr_img, warped_offset_pts, grad_eps, n_pix,
+				img_height, img_width, pix_norm_mult);
+			break;
+		case InputType::MTF_32FC3:
+			utils::mc::getWarpedImgGrad<float>(dI0_dx,
+				curr_img_cv, warped_offset_pts, grad_eps, n_pix,
+				img_height, img_width, pix_norm_mult);
+			break;
+		default:
+			throw utils::InvalidArgument("ImageBase::Invalid input type found");
+		}
 	}
 	if(!isInitialized()->pix_grad){
 		setCurrPixGrad(getInitPixGrad());
@@ -178,25 +213,33 @@ void ImageBase::initializePixHess(const Matrix2Xd& init_pts,
 		d2I0_dx2.resize(Eigen::NoChange, patch_size);
 		d2It_dx2.resize(Eigen::NoChange, patch_size);
 	}
-	switch(input_type){
-	case InputType::MTF_8UC1:
-		utils::sc::getWarpedImgHess<uchar>(d2I0_dx2, curr_img_cv, init_pts, warped_offset_pts,
-			hess_eps, n_pix, img_height, img_width, pix_norm_mult);
-		break;
-	case InputType::MTF_8UC3:
-		utils::mc::getWarpedImgHess<uchar>(d2I0_dx2, curr_img_cv, init_pts, warped_offset_pts,
+	if(img_deriv_cache){
+		updateImgDerivatives();
+		updateImgSecondDerivatives();
+		utils::getWarpedImgHess(d2I0_dx2, curr_img_dx, curr_img_dy,
+			curr_img_dxx, curr_img_dxy, curr_img_dyy, init_pts, warped_offset_pts,
 			hess_eps, n_pix, img_height, img_width, pix_norm_mult);
-		break;
-	case InputType::MTF_32FC1:
-		utils::getWarpedImgHess(d2I0_dx2, curr_img, init_pts, warped_offset_pts,
-			hess_eps, n_pix, img_height, img_width, pix_norm_mult);
-		break;
-	case InputType::MTF_32FC3:
-		utils::mc::getWarpedImgHess<float>(d2I0_dx2, curr_img_cv, init_pts, warped_offset_pts,
-			hess_eps, n_pix, img_height, img_width, pix_norm_mult);
-		break;
-	default:
-		throw utils::InvalidArgument("ImageBase::Invalid input type found");
+	} else{
+		switch(input_type){
+		case InputType::MTF_8UC1:
+			utils::sc::getWarpedImgHess<uchar>(d2I0_dx2, curr_img_cv, init_pts, warped_offset_pts,
+				hess_eps, n_pix, img_height, img_width, pix_norm_mult);
+			break;
+		case InputType::MTF_8UC3:
+			utils::mc::getWarpedImgHess<uchar>(d2I0_dx2, curr_img_cv, init_pts, warped_offset_pts,
+				hess_eps, n_pix, img_height, img_width, pix_norm_mult);
+			break;
+		case InputType::MTF_32FC1:
+			utils::getWarpedImgHess(d2I0_dx2, curr_img, init_pts, warped_offset_pts,
+				hess_eps, n_pix, img_height, img_width, pix_norm_mult);
+			break;
+		case InputType::MTF_32FC3:
+			utils::mc::getWarpedImgHess<float>(d2I0_dx2, curr_img_cv, init_pts, warped_offset_pts,
+				hess_eps, n_pix, img_height, img_width, pix_norm_mult);
+			break;
+		default:
+			throw utils::InvalidArgument("ImageBase::Invalid input type found");
+		}
 	}
 	if(!isInitialized()->pix_hess){
 		setCurrPixHess(getInitPixHess());
@@ -213,25 +256,31 @@ void ImageBase::initializePixHess(const Matrix2Xd &init_pts){
 		d2I0_dx2.resize(Eigen::NoChange, patch_size);
 		d2It_dx2.resize(Eigen::NoChange, patch_size);
 	}
-	switch(input_type){
-	case InputType::MTF_8UC1:
-		utils::sc::getImgHess<uchar>(d2I0_dx2, curr_img_cv, init_pts,
-			hess_eps, n_pix, img_height, img_width, pix_norm_mult);
-		break;
-	case InputType::MTF_8UC3:
-		utils::mc::getImgHess<uchar>(d2I0_dx2, curr_img_cv, init_pts,
-			hess_eps, n_pix, img_height, img_width, pix_norm_mult);
-		break;
-	case InputType::MTF_32FC1:
-		utils::getImgHess(d2I0_dx2, curr_img, init_pts,
-			hess_eps, n_pix, img_height, img_width, pix_norm_mult);
-		break;
-	case InputType::MTF_32FC3:
-		utils::mc::getImgHess<float>(d2I0_dx2, curr_img_cv, init_pts,
-			hess_eps, n_pix, img_height, img_width, pix_norm_mult);
-		break;
-	default:
-		throw utils::InvalidArgument("ImageBase::Invalid input type found");
+	if(img_deriv_cache){
+		updateImgSecondDerivatives();
+		utils::getImgHess(d2I0_dx2, curr_img_dxx, curr_img_dxy, curr_img_dyy,
+			init_pts, n_pix, img_height, img_width, pix_norm_mult);
+	} else{
+		switch(input_type){
+		case InputType::MTF_8UC1:
+			utils::sc::getImgHess<uchar>(d2I0_dx2, curr_img_cv, init_pts,
+				hess_eps, n_pix, img_height, img_width, pix_norm_mult);
+			break;
+		case InputType::MTF_8UC3:
+			utils::mc::getImgHess<uchar>(d2I0_dx2, curr_img_cv, init_pts,
+				hess_eps, n_pix, img_height, img_width, pix_norm_mult);
+			break;
+		case InputType::MTF_32FC1:
+			utils::getImgHess(d2I0_dx2, curr_img, init_pts,
+				hess_eps, n_pix, img_height, img_width, pix_norm_mult);
+			break;
+		case InputType::MTF_32FC3:
+			utils::mc::getImgHess<float>(d2I0_dx2, curr_img_cv, init_pts,
+				hess_eps, n_pix, img_height, img_width, pix_norm_mult);
+			break;
+		default:
+			throw utils::InvalidArgument("ImageBase::Invalid input type found");
+		}
 	}
 	if(!isInitialized()->pix_hess){
 		setCurrPixHess(getInitPixHess());
@@ -289,100 +338,192 @@ void ImageBase::updatePixVals(const Matrix2Xd& curr_pts){
 	}
 }
 
-void ImageBase::updatePixGrad(const Matrix2Xd &curr_pts){
-	assert(curr_pts.cols() == n_pix);
+void ImageBase::updatePixValsBatch(Ref<MatrixXdr> pix_vals_batch, const Ref<const PtsT> &pts_batch) const{
+	const unsigned int n_pts = static_cast<unsigned int>(pts_batch.cols());
+	assert(pix_vals_batch.cols() == patch_size && n_pts == pix_vals_batch.rows()*n_pix);
+	// all the patches are written back to back so they can be sampled as one long patch
+	assert(pix_vals_batch.outerStride() == patch_size);
+	double *pix_data = pix_vals_batch.data();
+	const double *pts_data = pts_batch.data();
 	switch(input_type){
 	case InputType::MTF_8UC1:
-		utils::sc::getImgGrad<uchar>(dIt_dx, curr_img_cv, curr_pts,
-			grad_eps, n_pix, img_height, img_width, pix_norm_mult);
-		break;
-	case InputType::MTF_8UC3:
-		utils::mc::getImgGrad<uchar>(dIt_dx, curr_img_cv, curr_pts,
-			grad_eps, n_pix, img_height, img_width, pix_norm_mult);
+		for(unsigned int pt_id = 0; pt_id < n_pts; ++pt_id){
+			pix_data[pt_id] = pix_norm_mult * utils::sc::PixVal<uchar, PIX_INTERP_TYPE, PIX_BORDER_TYPE>::
+				get(curr_img_cv, pts_batch(0, pt_id), pts_batch(1, pt_id), img_height, img_width) + pix_norm_add;
+		}
 		break;
 	case InputType::MTF_32FC1:
-		utils::getImgGrad(dIt_dx, curr_img, curr_pts,
-			grad_eps, n_pix, img_height, img_width, pix_norm_mult);
+		if(PIX_INTERP_TYPE == utils::InterpType::Linear && PIX_BORDER_TYPE == utils::BorderType::Constant){
+			utils::simd::getPixValsLinear(pix_data, curr_img, pts_data, n_pts,
+				img_height, img_width, pix_norm_mult, pix_norm_add);
+		} else{
+			for(unsigned int pt_id = 0; pt_id < n_pts; ++pt_id){
+				pix_data[pt_id] = pix_norm_mult * utils::getPixVal<PIX_INTERP_TYPE, PIX_BORDER_TYPE>(
+					curr_img, pts_batch(0, pt_id), pts_batch(1, pt_id), img_height, img_width) + pix_norm_add;
+			}
+		}
 		break;
+	case InputType::MTF_8UC3:
 	case InputType::MTF_32FC3:
-		utils::mc::getImgGrad<float>(dIt_dx, curr_img_cv, curr_pts,
-			grad_eps, n_pix, img_height, img_width, pix_norm_mult);
+		for(unsigned int pt_id = 0; pt_id < n_pts; ++pt_id){
+			if(input_type == InputType::MTF_8UC3){
+				utils::mc::PixVal<uchar, GRAD_INTERP_TYPE, PIX_BORDER_TYPE>::get(pix_data, curr_img_cv,
+					pts_batch(0, pt_id), pts_batch(1, pt_id), img_height, img_width);
+			} else{
+				utils::mc::PixVal<float, GRAD_INTERP_TYPE, PIX_BORDER_TYPE>::get(pix_data, curr_img_cv,
+					pts_batch(0, pt_id), pts_batch(1, pt_id), img_height, img_width);
+			}
+			pix_data[0] = pix_norm_mult*pix_data[0] + pix_norm_add;
+			pix_data[1] = pix_norm_mult*pix_data[1] + pix_norm_add;
+			pix_data[2] = pix_norm_mult*pix_data[2] + pix_norm_add;
+			pix_data += 3;
+		}
 		break;
 	default:
 		throw utils::InvalidArgument("ImageBase::Invalid input type found");
 	}
 }
 
+void ImageBase::updatePixAll(const Matrix2Xd& curr_pts, ImgStatus &flags){
+	assert(curr_pts.cols() == n_pix);
+	flags.pix_vals = true;
+	if(!supportsFusedPixUpdate() || !(flags.pix_grad || flags.pix_hess)){
+		updatePixVals(curr_pts);
+		flags.pix_grad = flags.pix_hess = false;
+		return;
+	}
+	if(input_type == InputType::MTF_32FC1 && !img_deriv_cache){
+		utils::getPixValsGradHess(It, flags.pix_grad ? &dIt_dx : nullptr,
+			flags.pix_hess ? &d2It_dx2 : nullptr, curr_img, curr_pts,
+			grad_eps, hess_eps, n_pix, img_height, img_width,
+			pix_norm_mult, pix_norm_add);
+	} else{
+		updatePixVals(curr_pts);
+		if(flags.pix_grad){ updatePixGrad(curr_pts); }
+		if(flags.pix_hess){ updatePixHess(curr_pts); }
+	}
+}
+
+void ImageBase::updatePixGrad(const Matrix2Xd &curr_pts){
+	assert(curr_pts.cols() == n_pix);
+	if(img_deriv_cache){
+		updateImgDerivatives();
+		utils::getImgGrad(dIt_dx, curr_img_dx, curr_img_dy, curr_pts, n_pix,
+			img_height, img_width, pix_norm_mult);
+	} else{
+		switch(input_type){
+		case InputType::MTF_8UC1:
+			utils::sc::getImgGrad<uchar>(dIt_dx, curr_img_cv, curr_pts,
+				grad_eps, n_pix, img_height, img_width, pix_norm_mult);
+			break;
+		case InputType::MTF_8UC3:
+			utils::mc::getImgGrad<uchar>(dIt_dx, curr_img_cv, curr_pts,
+				grad_eps, n_pix, img_height, img_width, pix_norm_mult);
+			break;
+		case InputType::MTF_32FC1:
+			utils::getImgGrad(dIt_dx, curr_img, curr_pts,
+				grad_eps, n_pix, img_height, img_width, pix_norm_mult);
+			break;
+		case InputType::MTF_32FC3:
+			utils::mc::getImgGrad<float>(dIt_dx, curr_img_cv, curr_pts,
+				grad_eps, n_pix, img_height, img_width, pix_norm_mult);
+			break;
+		default:
+			throw utils::InvalidArgument("ImageBase::Invalid input type found");
+		}
+	}
+}
+
 void ImageBase::updatePixHess(const Matrix2Xd &curr_pts){
 	assert(curr_pts.cols() == n_pix);
-	switch(input_type){
-	case InputType::MTF_8UC1:
-		utils::sc::getImgHess<uchar>(d2It_dx2, curr_img_cv, curr_pts,
-			hess_eps, n_pix, img_height, img_width, pix_norm_mult);
-		break;
-	case InputType::MTF_8UC3:
-		utils::mc::getImgHess<uchar>(d2It_dx2, curr_img_cv, curr_pts,
-			hess_eps, n_pix, img_height, img_width, pix_norm_mult);
-		break;
-	case InputType::MTF_32FC1:
-		utils::getImgHess(d2It_dx2, curr_img, curr_pts,
-			hess_eps, n_pix, img_height, img_width, pix_norm_mult);
-		break;
-	case InputType::MTF_32FC3:
-		utils::mc::getImgHess<float>(d2It_dx2, curr_img_cv, curr_pts,
-			hess_eps, n_pix, img_height, img_width, pix_norm_mult);
-		break;
-	default:
-		throw utils::InvalidArgument("ImageBase::Invalid input type found");
+	if(img_deriv_cache){
+		updateImgSecondDerivatives();
+		utils::getImgHess(d2It_dx2, curr_img_dxx, curr_img_dxy, curr_img_dyy,
+			curr_pts, n_pix, img_height, img_width, pix_norm_mult);
+	} else{
+		switch(input_type){
+		case InputType::MTF_8UC1:
+			utils::sc::getImgHess<uchar>(d2It_dx2, curr_img_cv, curr_pts,
+				hess_eps, n_pix, img_height, img_width, pix_norm_mult);
+			break;
+		case InputType::MTF_8UC3:
+			utils::mc::getImgHess<uchar>(d2It_dx2, curr_img_cv, curr_pts,
+				hess_eps, n_pix, img_height, img_width, pix_norm_mult);
+			break;
+		case InputType::MTF_32FC1:
+			utils::getImgHess(d2It_dx2, curr_img, curr_pts,
+				hess_eps, n_pix, img_height, img_width, pix_norm_mult);
+			break;
+		case InputType::MTF_32FC3:
+			utils::mc::getImgHess<float>(d2It_dx2, curr_img_cv, curr_pts,
+				hess_eps, n_pix, img_height, img_width, pix_norm_mult);
+			break;
+		default:
+			throw utils::InvalidArgument("ImageBase::Invalid input type found");
+		}
 	}
 }
 
 void ImageBase::updatePixGrad(const Matrix8Xd &warped_offset_pts){
 	assert(warped_offset_pts.cols() == n_pix);
-	switch(input_type){
-	case InputType::MTF_8UC1:
-		utils::sc::getWarpedImgGrad<uchar>(dIt_dx, curr_img_cv, warped_offset_pts,
-			grad_eps, n_pix, img_height, img_width, pix_norm_mult);
-		break;
-	case InputType::MTF_8UC3:
-		utils::mc::getWarpedImgGrad<uchar>(dIt_dx, curr_img_cv, warped_offset_pts,
-			grad_eps, n_pix, img_height, img_width, pix_norm_mult);
-		break;
-	case InputType::MTF_32FC1:
-		utils::getWarpedImgGrad(dIt_dx, curr_img, warped_offset_pts,
+	if(img_deriv_cache){
+		updateImgDerivatives();
+		utils::getWarpedImgGrad(dIt_dx, curr_img_dx, curr_img_dy, warped_offset_pts,
 			grad_eps, n_pix, img_height, img_width, pix_norm_mult);
-		break;
-	case InputType::MTF_32FC3:
-		utils::mc::getWarpedImgGrad<float>(dIt_dx, curr_img_cv, warped_offset_pts,
-			grad_eps, n_pix, img_height, img_width, pix_norm_mult);
-		break;
-	default:
-		throw utils::InvalidArgument("ImageBase::Invalid input type found");
+	} else{
+		switch(input_type){
+		case InputType::MTF_8UC1:
+			utils::sc::getWarpedImgGrad<uchar>(dIt_dx, curr_img_cv, warped_offset_pts,
+				grad_eps, n_pix, img_height, img_width, pix_norm_mult);
+			break;
+		case InputType::MTF_8UC3:
+			utils::mc::getWarpedImgGrad<uchar>(dIt_dx, curr_img_cv, warped_offset_pts,
+				grad_eps, n_pix, img_height, img_width, pix_norm_mult);
+			break;
+		case InputType::MTF_32FC1:
+			utils::getWarpedImgGrad(dIt_dx, curr_img, warped_offset_pts,
+				grad_eps, n_pix, img_height, img_width, pix_norm_mult);
+			break;
+		case InputType::MTF_32FC3:
+			utils::mc::getWarpedImgGrad<float>(dIt_dx, curr_img_cv, warped_offset_pts,
+				grad_eps, n_pix, img_height, img_width, pix_norm_mult);
+			break;
+		default:
+			throw utils::InvalidArgument("ImageBase::Invalid input type found");
+		}
 	}
 }
 
 void ImageBase::updatePixHess(const Matrix2Xd& curr_pts,
 	const Matrix16Xd &warped_offset_pts){
 	assert(curr_pts.cols() == n_pix && warped_offset_pts.cols() == n_pix);
-	switch(input_type){
-	case InputType::MTF_8UC1:
-		utils::sc::getWarpedImgHess<uchar>(d2It_dx2, curr_img_cv, curr_pts, warped_offset_pts,
-			hess_eps, n_pix, img_height, img_width, pix_norm_mult);
-		break;
-	case InputType::MTF_8UC3:
-		utils::mc::getWarpedImgHess<uchar>(d2It_dx2, curr_img_cv, curr_pts, warped_offset_pts,
-			hess_eps, n_pix, img_height, img_width, pix_norm_mult);
-		break;
-	case InputType::MTF_32FC1:
-		utils::getWarpedImgHess(d2It_dx2, curr_img, curr_pts, warped_offset_pts,
-			hess_eps, n_pix, img_height, img_width, pix_norm_mult);
-		break;
-	case InputType::MTF_32FC3:
-		utils::mc::getWarpedImgHess<float>(d2It_dx2, curr_img_cv, curr_pts, warped_offset_pts,
+	if(img_deriv_cache){
+		updateImgDerivatives();
+		updateImgSecondDerivatives();
+		utils::getWarpedImgHess(d2It_dx2, curr_img_dx, curr_img_dy,
+			curr_img_dxx, curr_img_dxy, curr_img_dyy, curr_pts, warped_offset_pts,
 			hess_eps, n_pix, img_height, img_width, pix_norm_mult);
-		break;
-	default:
-		throw utils::InvalidArgument("ImageBase::Invalid input type found");
+	} else{
+		switch(input_type){
+		case InputType::MTF_8UC1:
+			utils::sc::getWarpedImgHess<uchar>(d2It_dx2, curr_img_cv, curr_pts, warped_offset_pts,
+				hess_eps, n_pix, img_height, img_width, pix_norm_mult);
+			break;
+		case InputType::MTF_8UC3:
+			utils::mc::getWarpedImgHess<uchar>(d2It_dx2, curr_img_cv, curr_pts, warped_offset_pts,
+				hess_eps, n_pix, img_height, img_width, pix_norm_mult);
+			break;
+		case InputType::MTF_32FC1:
+			utils::getWarpedImgHess(d2It_dx2, curr_img, curr_pts, warped_offset_pts,
+				hess_eps, n_pix, img_height, img_width, pix_norm_mult);
+			break;
+		case InputType::MTF_32FC3:
+			utils::mc::getWarpedImgHess<float>(d2It_dx2, curr_img_cv, curr_pts, warped_offset_pts,
+				hess_eps, n_pix, img_height, img_width, pix_norm_mult);
+			break;
+		default:
+			throw utils::InvalidArgument("ImageBase::Invalid input type found");
+		}
 	}
 }
 
@@ -72,6 +72,7 @@ params(kld_params){
 		_std_bspl_ids(i, 0) = max(0, i - 1);
 		_std_bspl_ids(i, 1) = min(params.n_bins - 1, i + 2);
 	}
+	hist_accum.resize(params.n_bins, task_arena->getNThreads());
 }
 
 /**
@@ -164,7 +165,7 @@ void KLD::updateSimilarity(bool prereq_only){
 	// to take advantage of the many common computations involved
 	utils::getBSplHistWithGrad(curr_hist, curr_hist_mat,
 		curr_hist_grad, _curr_bspl_ids,	It, _std_bspl_ids,
-		params.pre_seed, n_pix, hist_norm_mult);
+		params.pre_seed, n_pix, hist_norm_mult, hist_accum, task_arena.get());
 
 	curr_hist_log = curr_hist.array().log();
 
@@ -7,6 +7,7 @@
 #define MI_PRE_SEED 10
 #define MI_POU false
 #define MI_PIX_MAPPER nullptr
+#define MI_LUT_STEPS 0
 #define MI_DEBUG_MODE false
 
 _MTF_BEGIN_NAMESPACE
@@ -17,12 +18,14 @@ int _n_bins, double _pre_seed,
 bool _partition_of_unity,
 
 ImageBase *_pix_mapper,
+int _lut_steps,
 bool _debug_mode) :
 AMParams(am_params),
 n_bins(_n_bins),
 pre_seed(_pre_seed),
 partition_of_unity(_partition_of_unity),
 pix_mapper(_pix_mapper),
+lut_steps(_lut_steps),
 debug_mode(_debug_mode){}
 
 //! default/copy constructor
@@ -32,12 +35,14 @@ n_bins(MI_N_BINS),
 pre_seed(MI_PRE_SEED),
 partition_of_unity(MI_POU),
 pix_mapper(MI_PIX_MAPPER),
+lut_steps(MI_LUT_STEPS),
 debug_mode(MI_DEBUG_MODE){
 	if(params){
 		n_bins = params->n_bins;
 		pre_seed = params->pre_seed;
 		partition_of_unity = params->partition_of_unity;
 		pix_mapper = params->pix_mapper;		
+		lut_steps = params->lut_steps;
 		debug_mode = params->debug_mode;
 	}
 }
@@ -60,6 +65,7 @@ AppearanceModel(mi_params, _n_channels), params(mi_params){
 	printf("pre_seed: %f\n", params.pre_seed);
 	printf("partition_of_unity: %d\n", params.partition_of_unity);
 	printf("likelihood_alpha: %f\n", params.likelihood_alpha);
+	printf("lut_steps: %d\n", params.lut_steps);
 	printf("debug_mode: %d\n", params.debug_mode);
 
 	name = "mi";
@@ -118,6 +124,18 @@ AppearanceModel(mi_params, _n_channels), params(mi_params){
 			linear_idx(i, j) = i * params.n_bins + j;
 		}
 	}
+	if(params.lut_steps < 0){
+		throw utils::InvalidArgument(
+			cv::format("MI::Invalid no. of lookup table steps specified: %d", params.lut_steps));
+	}
+	bspl_lut.resize(params.lut_steps);
+	if(params.lut_steps > 0 && params.debug_mode){
+		utils::validateBSpl3LUT(bspl_lut);
+	}
+	//! the current histogram and the joint histogram are accumulated in one buffer per thread
+	unsigned int n_hist_parts = task_arena->getNThreads();
+	curr_hist_accum.resize(params.n_bins + joint_hist_size, n_hist_parts);
+
 	//for functor support
 	feat_size = 5 * patch_size;
 }
@@ -234,7 +252,7 @@ void MI::initializeSimilarity(){
 		init_bspl_ids.row(pix_id) = std_bspl_ids.row(static_cast<int>(I0(pix_id)));
 		double curr_diff = init_bspl_ids(pix_id, 0) - I0(pix_id);
 		for(int id1 = init_bspl_ids(pix_id, 0); id1 <= init_bspl_ids(pix_id, 1); id1++) {
-			utils::bSpl3WithGrad(init_hist_mat(id1, pix_id), init_hist_grad(id1, pix_id), curr_diff);
+			bspl_lut.bSpl3WithGrad(init_hist_mat(id1, pix_id), init_hist_grad(id1, pix_id), curr_diff);
 			init_hist_grad(id1, pix_id) *= -hist_norm_mult;
 			init_hist(id1) += init_hist_mat(id1, pix_id);
 			// since the ids of all bins affected by a pixel are sequential, repeated computation
@@ -347,27 +365,31 @@ void MI::updateSimilarity(bool prereq_only){
 
 	// compute both the histogram and its differential simultaneously
 	// to take advantage of the many common computations involved
-	curr_hist.fill(hist_pre_seed);
-	joint_hist.fill(params.pre_seed);
-	curr_hist_mat.setZero();
-	curr_hist_grad.setZero();
-	for(unsigned int pix_id = 0; pix_id < patch_size; pix_id++) {
-		curr_bspl_ids.row(pix_id) = std_bspl_ids.row(static_cast<int>(It(pix_id)));
-		double curr_diff = curr_bspl_ids(pix_id, 0) - It(pix_id);
-		for(int curr_id = curr_bspl_ids(pix_id, 0); curr_id <= curr_bspl_ids(pix_id, 1); curr_id++) {
-			utils::bSpl3WithGrad(curr_hist_mat(curr_id, pix_id), curr_hist_grad(curr_id, pix_id), curr_diff);
-			++curr_diff;
-			curr_hist_grad(curr_id, pix_id) *= -hist_norm_mult;
-			curr_hist(curr_id) += curr_hist_mat(curr_id, pix_id);
-			for(int init_id = init_bspl_ids(pix_id, 0); init_id <= init_bspl_ids(pix_id, 1); init_id++) {
-				joint_hist(curr_id, init_id) += curr_hist_mat(curr_id, pix_id) * init_hist_mat(init_id, pix_id);
+	// each thread accumulates the histograms of its own pixels which are added together afterwards
+	const double *hist_sums = curr_hist_accum.accumulate(patch_size,
+		[&](double *hist_data, unsigned int start_id, unsigned int end_id){
+		VectorXdM part_hist(hist_data, params.n_bins);
+		MatrixXdM part_joint_hist(hist_data + params.n_bins, params.n_bins, params.n_bins);
+		curr_hist_mat.middleCols(start_id, end_id - start_id).setZero();
+		curr_hist_grad.middleCols(start_id, end_id - start_id).setZero();
+		for(unsigned int pix_id = start_id; pix_id < end_id; pix_id++) {
+			curr_bspl_ids.row(pix_id) = std_bspl_ids.row(static_cast<int>(It(pix_id)));
+			double curr_diff = curr_bspl_ids(pix_id, 0) - It(pix_id);
+			for(int curr_id = curr_bspl_ids(pix_id, 0); curr_id <= curr_bspl_ids(pix_id, 1); curr_id++) {
+				bspl_lut.bSpl3WithGrad(curr_hist_mat(curr_id, pix_id), curr_hist_grad(curr_id, pix_id), curr_diff);
+				++curr_diff;
+				curr_hist_grad(curr_id, pix_id) *= -hist_norm_mult;
+				part_hist(curr_id) += curr_hist_mat(curr_id, pix_id);
+				for(int init_id = init_bspl_ids(pix_id, 0); init_id <= init_bspl_ids(pix_id, 1); init_id++) {
+					part_joint_hist(curr_id, init_id) += curr_hist_mat(curr_id, pix_id) * init_hist_mat(init_id, pix_id);
+				}
 			}
 		}
-	}
-
-	// normalize the histograms and compute their log
-	curr_hist *= hist_norm_mult;
-	joint_hist *= hist_norm_mult;
+	}, task_arena.get());
+	// preseed and normalize the histograms and compute their log
+	curr_hist = (Map<const VectorXd>(hist_sums, params.n_bins).array() + hist_pre_seed) * hist_norm_mult;
+	joint_hist = (Map<const MatrixXd>(hist_sums + params.n_bins, params.n_bins, params.n_bins).array() +
+		params.pre_seed) * hist_norm_mult;
 	curr_hist_log = curr_hist.array().log();
 	joint_hist_log = joint_hist.array().log();
 
@@ -404,16 +426,18 @@ void MI::updateInitGrad(){
 	// differential of the current joint histogram w.r.t. initial pixel values; this does not need to be normalized 
 	// since init_hist_grad has already been normalized and the computed differential will thus be implicitly normalized
 	init_joint_hist_grad.setZero();
-	for(unsigned int pix_id = 0; pix_id < patch_size; pix_id++) {
-		df_dI0(pix_id) = 0;
-		for(int init_id = init_bspl_ids(pix_id, 0); init_id <= init_bspl_ids(pix_id, 1); init_id++) {
-			for(int curr_id = curr_bspl_ids(pix_id, 0); curr_id <= curr_bspl_ids(pix_id, 1); curr_id++) {
-				int joint_id = linear_idx(init_id, curr_id);
-				init_joint_hist_grad(joint_id, pix_id) = init_hist_grad(init_id, pix_id) * curr_hist_mat(curr_id, pix_id);
-				df_dI0(pix_id) += init_joint_hist_grad(joint_id, pix_id) * init_grad_factor(init_id, curr_id);
+	task_arena->parallelFor(0, static_cast<int>(patch_size), [&](int start_id, int end_id){
+		for(int pix_id = start_id; pix_id < end_id; pix_id++) {
+			df_dI0(pix_id) = 0;
+			for(int init_id = init_bspl_ids(pix_id, 0); init_id <= init_bspl_ids(pix_id, 1); init_id++) {
+				for(int curr_id = curr_bspl_ids(pix_id, 0); curr_id <= curr_bspl_ids(pix_id, 1); curr_id++) {
+					int joint_id = linear_idx(init_id, curr_id);
+					init_joint_hist_grad(joint_id, pix_id) = init_hist_grad(init_id, pix_id) * curr_hist_mat(curr_id, pix_id);
+					df_dI0(pix_id) += init_joint_hist_grad(joint_id, pix_id) * init_grad_factor(init_id, curr_id);
+				}
 			}
 		}
-	}
+	});
 }
 /**
 * updateCurrGrad
@@ -430,16 +454,18 @@ void MI::updateCurrGrad(){
 		}
 	}
 	curr_joint_hist_grad.setZero();
-	for(unsigned int pix_id = 0; pix_id < patch_size; pix_id++){
-		df_dIt(pix_id) = 0;
-		for(int curr_id = curr_bspl_ids(pix_id, 0); curr_id <= curr_bspl_ids(pix_id, 1); curr_id++) {
-			for(int init_id = init_bspl_ids(pix_id, 0); init_id <= init_bspl_ids(pix_id, 1); init_id++) {
-				int joint_id = linear_idx(curr_id, init_id);
-				curr_joint_hist_grad(joint_id, pix_id) = curr_hist_grad(curr_id, pix_id) * init_hist_mat(init_id, pix_id);
-				df_dIt(pix_id) += curr_joint_hist_grad(joint_id, pix_id) * curr_grad_factor(curr_id, init_id);
+	task_arena->parallelFor(0, static_cast<int>(patch_size), [&](int start_id, int end_id){
+		for(int pix_id = start_id; pix_id < end_id; pix_id++){
+			df_dIt(pix_id) = 0;
+			for(int curr_id = curr_bspl_ids(pix_id, 0); curr_id <= curr_bspl_ids(pix_id, 1); curr_id++) {
+				for(int init_id = init_bspl_ids(pix_id, 0); init_id <= init_bspl_ids(pix_id, 1); init_id++) {
+					int joint_id = linear_idx(curr_id, init_id);
+					curr_joint_hist_grad(joint_id, pix_id) = curr_hist_grad(curr_id, pix_id) * init_hist_mat(init_id, pix_id);
+					df_dIt(pix_id) += curr_joint_hist_grad(joint_id, pix_id) * curr_grad_factor(curr_id, init_id);
+				}
 			}
 		}
-	}
+	});
 }
 void MI::initializeHess(){
 	if(!is_initialized.hess){
@@ -569,7 +595,7 @@ void MI::cmptSelfHessian(MatrixXd &self_hessian, const MatrixXd &curr_pix_jacobi
 		double curr_diff = curr_bspl_ids(pix_id, 0) - It(pix_id);
 		double hist_hess_term = 0;
 		for(int curr_id = curr_bspl_ids(pix_id, 0); curr_id <= curr_bspl_ids(pix_id, 1); curr_id++) {
-			curr_hist_hess(curr_id, pix_id) = hist_norm_mult*utils::bSpl3Hess(curr_diff);
+			curr_hist_hess(curr_id, pix_id) = hist_norm_mult*bspl_lut.bSpl3Hess(curr_diff);
 			++curr_diff;
 			double inner_term = 0;
 			for(int init_id = curr_bspl_ids(pix_id, 0); init_id <= curr_bspl_ids(pix_id, 1); init_id++) {
@@ -615,7 +641,7 @@ void  MI::cmptCurrHessian(MatrixXd &hessian, const MatrixXd &curr_pix_jacobian){
 		double curr_diff = curr_bspl_ids(pix_id, 0) - It(pix_id);
 		double hist_hess_term = 0;
 		for(int curr_id = curr_bspl_ids(pix_id, 0); curr_id <= curr_bspl_ids(pix_id, 1); curr_id++) {
-			curr_hist_hess(curr_id, pix_id) = hist_norm_mult*utils::bSpl3Hess(curr_diff);
+			curr_hist_hess(curr_id, pix_id) = hist_norm_mult*bspl_lut.bSpl3Hess(curr_diff);
 			++curr_diff;
 			double inner_term = 0;
 			for(int init_id = init_bspl_ids(pix_id, 0); init_id <= init_bspl_ids(pix_id, 1); init_id++) {
@@ -709,7 +735,7 @@ void MI::cmptSelfHessian(MatrixXd &self_hessian, const MatrixXd &curr_pix_jacobi
 		double curr_diff = curr_bspl_ids(pix_id, 0) - It(pix_id);
 		double hist_hess_term = 0, hist_grad_term = 0;
 		for(int r = curr_bspl_ids(pix_id, 0); r <= curr_bspl_ids(pix_id, 1); r++) {
-			curr_hist_hess(r, pix_id) = hist_norm_mult*utils::bSpl3Hess(curr_diff++);
+			curr_hist_hess(r, pix_id) = hist_norm_mult*bspl_lut.bSpl3Hess(curr_diff++);
 			double inner_term = 0;
 			for(int t = curr_bspl_ids(pix_id, 0); t <= curr_bspl_ids(pix_id, 1); t++) {
 				int idx = linear_idx(r, t);
@@ -739,10 +765,10 @@ void MI::updateDistFeat(double* feat_addr){
 		int pix_val_floor = static_cast<int>(It(pix_id));
 		double pix_diff = std_bspl_ids(pix_val_floor, 0) - It(pix_id);
 		hist_mat(0, pix_id) = pix_val_floor;
-		hist_mat(1, pix_id) = utils::bSpl3(pix_diff);
-		hist_mat(2, pix_id) = utils::bSpl3(++pix_diff);
-		hist_mat(3, pix_id) = utils::bSpl3(++pix_diff);
-		hist_mat(4, pix_id) = utils::bSpl3(++pix_diff);
+		hist_mat(1, pix_id) = bspl_lut.bSpl3(pix_diff);
+		hist_mat(2, pix_id) = bspl_lut.bSpl3(++pix_diff);
+		hist_mat(3, pix_id) = bspl_lut.bSpl3(++pix_diff);
+		hist_mat(4, pix_id) = bspl_lut.bSpl3(++pix_diff);
 	}
 }
 
@@ -2,18 +2,11 @@
 #include "mtf/Utilities/imgUtils.h"
 #include "mtf/Utilities/miscUtils.h"
 #include "mtf/Utilities/spiUtils.h"
+#include "mtf/Utilities/simdUtils.h"
 #include "mtf/Utilities/excpUtils.h"
 
-#ifdef ENABLE_TBB
-#include "tbb/tbb.h" 
-#endif
-
 
 #define NCC_FAST_HESS 0
-//! OpenMP scheduler
-#ifndef NCC_OMP_SCHD
-#define NCC_OMP_SCHD dynamic
-#endif
 
 _MTF_BEGIN_NAMESPACE
 
@@ -431,16 +424,7 @@ void NCC::estimateOpticalFlow(std::vector<cv::Point2f> &curr_pts, const cv::Mat
 		win_y[pt_id] = VectorXd::LinSpaced(win_size.height,
 			prev_pts[pt_id].y - half_height, prev_pts[pt_id].y + half_height);
 	}
-#ifdef ENABLE_TBB
-	parallel_for(tbb::blocked_range<size_t>(0, n_pts),
-		[&](const tbb::blocked_range<size_t>& r){
-		for(size_t pt_id = r.begin(); pt_id != r.end(); ++pt_id){
-#else
-#ifdef ENABLE_OMP
-#pragma omp parallel for schedule(NCC_OMP_SCHD)
-#endif	
-	for(unsigned int pt_id = 0; pt_id < n_pts; ++pt_id){
-#endif	
+	task_arena->run(static_cast<int>(n_pts), [&](int pt_id){
 		VectorXd _I0(srch_size),_I0_cntr(srch_size);		
 		PixGradT _dIt_dx(srch_size, 2);
 		RowVector2d _dIt_dx_mean;
@@ -519,10 +503,7 @@ void NCC::estimateOpticalFlow(std::vector<cv::Point2f> &curr_pts, const cv::Mat
 			win_y[pt_id].array() += opt_flow[1];
 			if(opt_flow.squaredNorm() < term_eps){ break; }
 		}
-	}
-#ifdef ENABLE_TBB
 	});
-#endif	
 }
 
 /*Support for FLANN library*/
@@ -568,26 +549,7 @@ void NCC::updateModel(const Matrix2Xd& curr_pts){
 double NCCDist::operator()(const double* a, const double* b,
 	size_t size, double worst_dist) const {
 	assert(size == patch_size);
-
-	double num = 0;
-	const double* last = a + size;
-	const double* lastgroup = last - 3;
-
-	/* Process 4 items with each loop for efficiency. */
-	while(a < lastgroup) {
-
-		num += a[0] * b[0] + a[1] * b[1] + a[2] * b[2] + a[3] * b[3];
-		a += 4;
-		b += 4;
-	}
-	/* Process last 0-3 pixels.  Not needed for standard vector lengths. */
-	while(a < last) {
-
-		num += *a * *b;
-		a++;
-		b++;
-	}
-	return -num;
+	return -utils::simd::getDotProduct(a, b, size);
 }
 
 _MTF_END_NAMESPACE
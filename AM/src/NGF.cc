@@ -1,5 +1,6 @@
 #include "mtf/AM/NGF.h"
 #include "mtf/Utilities/miscUtils.h"
+#include "mtf/Utilities/simdUtils.h"
 
 #define NGF_USE_SSD false
 #define NGF_ETA 5.0
@@ -704,29 +705,7 @@ double NGFDist::operator()(const double* a, const double* b, size_t size, double
 	assert(size == patch_size * 2);
 	double dist = 0;
 	if(use_ssd){
-		double diff0, diff1, diff2, diff3;
-		const double* last = a + size;
-		const double* lastgroup = last - 3;
-
-		/* Process 4 items with each loop for efficiency. */
-		while(a < lastgroup){
-			diff0 = (a[0] - b[0]);
-			diff1 = (a[1] - b[1]);
-			diff2 = (a[2] - b[2]);
-			diff3 = (a[3] - b[3]);
-			dist += diff0 * diff0 + diff1 * diff1 + diff2 * diff2 + diff3 * diff3;
-			a += 4;
-			b += 4;
-
-			if((worst_dist > 0) && (dist > worst_dist)){
-				return dist;
-			}
-		}
-		/* Process last 0-3 pixels.  Not needed for standard vector lengths. */
-		while(a < last){
-			diff0 = (*a++ - *b++);
-			dist += diff0 * diff0;
-		}
+		dist = utils::simd::getSSD(a, b, size, worst_dist);
 	} else{
 		for(size_t patch_id = 0; patch_id < patch_size; ++patch_id) {
 			double dot_prod = a[2 * patch_id] * b[2 * patch_id] + a[2 * patch_id + 1] * b[2 * patch_id + 1];
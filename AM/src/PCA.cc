@@ -162,7 +162,7 @@ void PCA::updateModel(const Matrix2Xd& curr_pts){
 
 
 void PCA::setFirstIter() {
-	first_iter = true;
+	SSDBase::setFirstIter();
 	++frame_count;
 #ifdef DEBUG
 	printf("It's the first particle at frame %d\n", frame_count);
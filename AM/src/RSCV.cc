@@ -118,6 +118,9 @@ SSDBase(rscv_params, _n_channels), params(rscv_params){
 			_std_bspl_ids(bin_id, 1) = min(params.n_bins - 1, bin_id + 2);
 		}
 	}
+	//! the BSpline histogram of the initial pixels is only computed on initialization
+	int n_hists = params.use_bspl ? 1 : 2;
+	hist_accum.resize(params.n_bins*(params.n_bins + n_hists), task_arena->getNThreads());
 
 }
 
@@ -198,13 +201,13 @@ void RSCV::updatePixVals(const Matrix2Xd& curr_pts){
 	if(params.use_bspl){
 		utils::getBSplJointHist(curr_joint_hist, curr_hist, curr_hist_mat, _curr_bspl_ids,
 			It_orig, _init_bspl_ids, init_hist_mat, _std_bspl_ids,
-			hist_pre_seed, params.pre_seed, patch_size);
+			hist_pre_seed, params.pre_seed, patch_size, hist_accum, task_arena.get());
 		//utils::getBSplJointHist(curr_joint_hist, curr_hist, init_hist,
 		//	curr_pix_vals, init_pix_vals, hist_pre_seed, params.pre_seed, patch_size);
 	} else{
 		//utils::printMatrixToFile(init_pix_vals, "init_pix_vals", "log/mtf_log.txt");
 		utils::getDiracJointHist(curr_joint_hist, curr_hist, init_hist,
-			It_orig, I0, 0, 0, patch_size, params.n_bins);
+			It_orig, I0, 0, 0, patch_size, params.n_bins, hist_accum, task_arena.get());
 	}
 	//if (params.debug_mode){
 	//	utils::printMatrixToFile(curr_joint_hist, "curr_joint_hist", "log/mtf_log.txt");
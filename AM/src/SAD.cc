@@ -1,4 +1,5 @@
 #include "mtf/AM/SAD.h"
+#include "mtf/Utilities/simdUtils.h"
 
 
 _MTF_BEGIN_NAMESPACE
@@ -37,25 +38,7 @@ void SAD::updateSimilarity(bool prereq_only){
 }
 double SADDist::operator()(const double* a, const double* b,
 	size_t size, double worst_dist) const{
-	double result = 0;
-	const double* last = a + size;
-	const double* lastgroup = last - 3;
-
-	/* Process 4 items with each loop for efficiency. */
-	while(a < lastgroup){
-		result += fabs(a[0] - b[0]) + fabs(a[1] - b[1]) + fabs(a[2] - b[2]) + fabs(a[3] - b[3]);
-		a += 4;
-		b += 4;
-
-		if((worst_dist > 0) && (result > worst_dist)){
-			return result;
-		}
-	}
-	/* Process last 0-3 pixels.  Not needed for standard vector lengths. */
-	while(a < last){
-		result += fabs(*a++ - *b++);
-	}
-	return result;
+	return utils::simd::getSAD(a, b, size, worst_dist);
 }
 
 _MTF_END_NAMESPACE
@@ -129,6 +129,9 @@ SSDBase(scv_params, _n_channels), params(scv_params), init_img(0, 0, 0){
 			_std_bspl_ids(i, 1) = min(params.n_bins - 1, i + 2);
 		}
 	}
+	//! the BSpline histogram of the initial pixels is only computed on initialization
+	int n_hists = params.hist_type == HistType::BSpline ? 1 : 2;
+	hist_accum.resize(params.n_bins*(params.n_bins + n_hists), task_arena->getNThreads());
 }
 
 void SCV::initializePixVals(const Matrix2Xd& init_pts){
@@ -184,16 +187,16 @@ void SCV::updateSimilarity(bool prereq_only){
 	switch(params.hist_type){
 	case HistType::Dirac:
 		utils::getDiracJointHist(curr_joint_hist, curr_hist, init_hist,
-			It, I0_orig, 0, 0, patch_size, params.n_bins);
+			It, I0_orig, 0, 0, patch_size, params.n_bins, hist_accum, task_arena.get());
 		break;
 	case HistType::Bilinear:
 		utils::getBilinearJointHist(curr_joint_hist, curr_hist, init_hist,
-			It, I0_orig, 0, 0, patch_size, params.n_bins);
+			It, I0_orig, 0, 0, patch_size, params.n_bins, hist_accum, task_arena.get());
 		break;
 	case HistType::BSpline:
 		utils::getBSplJointHist(curr_joint_hist, curr_hist, curr_hist_mat, _curr_bspl_ids,
 			It, _init_bspl_ids, init_hist_mat, _std_bspl_ids,
-			hist_pre_seed, params.pre_seed, patch_size);
+			hist_pre_seed, params.pre_seed, patch_size, hist_accum, task_arena.get());
 		break;
 	default:
 		throw utils::InvalidArgument("Invalid histogram type provided");
@@ -1,5 +1,6 @@
 #include "mtf/AM/SPSS.h"
 #include "mtf/Utilities/imgUtils.h"
+#include "mtf/Utilities/simdUtils.h"
 
 #define SPSS_K 0.01
 #define SPSS_PIX_MAPPER nullptr
@@ -236,29 +237,7 @@ void SPSS::cmptSelfHessian(MatrixXd &self_hessian, const MatrixXd &curr_pix_jaco
 }
 
 double SPSSDist::operator()(const double* a, const double* b, size_t size, double worst_dist) const{
-	double result = double();
-	double diff0, diff1, diff2, diff3;
-	const double* last = a + size;
-	const double* lastgroup = last - 3;
-
-	/* Process 4 items with each loop for efficiency. */
-	while(a < lastgroup) {
-		diff0 = ((2 * a[0] * b[0] + c) / (a[0] * a[0] + b[0] * b[0] + c));
-		diff1 = ((2 * a[1] * b[1] + c) / (a[1] * a[1] + b[1] * b[1] + c));
-		diff2 = ((2 * a[2] * b[2] + c) / (a[2] * a[2] + b[2] * b[2] + c));
-		diff3 = ((2 * a[3] * b[3] + c) / (a[3] * a[3] + b[3] * b[3] + c));
-		result -= (diff0 + diff1 + diff2 + diff3);
-		a += 4;
-		b += 4;
-	}
-	/* Process last 0-3 pixels.  Not needed for standard vector lengths. */
-	while(a < last) {
-		diff0 = ((2 * (*a) * (*b) + c) / ((*a) * (*a) + (*b) * (*b) + c));
-		a++;
-		b++;
-		result -= diff0;
-	}
-	return result;
+	return -utils::simd::getSPSS(a, b, size, c);
 }
 
 void SPSS::updateDistFeat(double* feat_addr){
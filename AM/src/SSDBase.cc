@@ -1,18 +1,25 @@
 #include "mtf/AM/SSDBase.h"
 #include "mtf/Utilities/miscUtils.h"
 #include "mtf/Utilities/spiUtils.h"
+#include "mtf/Utilities/simdUtils.h"
 
 #include <boost/random/random_device.hpp>
 #include <boost/random/seed_seq.hpp>
 
+#ifndef SSD_FUSED_BLOCK_SIZE
+//! no. of pixels whose Jacobian rows are generated and consumed together by the fused Jacobian/Hessian computation
+#define SSD_FUSED_BLOCK_SIZE 256
+#endif
+
 _MTF_BEGIN_NAMESPACE
 
 SSDBase::SSDBase(const AMParams *am_params, const int _n_channels) :
-AppearanceModel(am_params, _n_channels), ilm(nullptr), likelihood_alpha(1),
+AppearanceModel(am_params, _n_channels), ilm(nullptr), likelihood_alpha(1), float_jac(AM_FLOAT_JAC),
 I_diff(0, 0){
 	if(am_params){
 		ilm = am_params->ilm;
 		likelihood_alpha = am_params->likelihood_alpha;
+		float_jac = am_params->float_jac;
 	}
 	if(ilm){
 		ilm->setPixHessType(ILMPixHessT::Constant);
@@ -38,6 +45,7 @@ void SSDBase::initializeSimilarity(){
 		It_orig.resize(patch_size);
 		It_orig = It;
 		p_am.resize(state_size);
+		p_am_old.resize(state_size);
 		ilm->initialize(p_am.data());
 	}
 	is_initialized.similarity = true;
@@ -52,6 +60,8 @@ void SSDBase::initializeGrad(){
 
 	if(ilm){
 		df_dpam.resize(state_size);
+		df_dpam_0.resize(state_size);
+		df_dpam_t.resize(state_size);
 		df_dgt.resize(patch_size);
 		df_dg0.resize(patch_size);
 		df_dg0 = df_dI0;
@@ -83,8 +93,7 @@ void SSDBase::updateSimilarity(bool prereq_only){
 	if(prereq_only){ return; }
 #ifndef DISABLE_SPI
 	if(spi_mask){
-		VectorXd masked_err_vec = Map<const VectorXb>(spi_mask, n_pix).select(I_diff, 0);
-		f = -masked_err_vec.squaredNorm() / 2;
+		f = -Map<const VectorXb>(spi_mask, n_pix).select(I_diff, 0).squaredNorm() / 2;
 	} else{
 #endif
 		f = -I_diff.squaredNorm() / 2;
@@ -97,7 +106,7 @@ void SSDBase::updateSimilarity(bool prereq_only){
 void SSDBase::updateState(const VectorXd& state_update){
 	if(ilm){
 		assert(state_update.size() == state_size);
-		VectorXd p_am_old = p_am;
+		p_am_old = p_am;
 		ilm->update(p_am.data(), p_am_old.data(), state_update.data());
 		//utils::printMatrix(state_update.transpose(), "state_update");
 		//utils::printMatrix(p_am_old.transpose(), "p_am before update");
@@ -173,7 +182,6 @@ void SSDBase::cmptDifferenceOfJacobians(RowVectorXd &df_dp_diff,
 	assert(dIt_dpssm.rows() == patch_size && dI0_dpssm.rows() == patch_size);
 	if(ilm){
 		df_dp_diff.head(dIt_dpssm.cols()).noalias() = df_dIt * (dI0_dpssm + dIt_dpssm);
-		VectorXd df_dpam_0(state_size), df_dpam_t(state_size);
 		ilm->cmptParamJacobian(df_dpam_0.data(), df_dg0.data(), I0.data(), p_am.data());
 		ilm->cmptParamJacobian(df_dpam_t.data(), df_dgt.data(), It_orig.data(), p_am.data());
 		df_dp_diff.tail(state_size) = df_dpam_t - df_dpam_0;
@@ -197,7 +205,6 @@ void SSDBase::cmptILMHessian(MatrixXd &d2f_dp2, const MatrixXd &dI_dpssm,
 	assert(d2f_dp2.rows() == state_size + ssm_state_size);
 	assert(d2f_dp2.cols() == state_size + ssm_state_size);
 
-	MatrixXd d2f_dpam2(state_size, state_size);
 	ilm->cmptParamHessian(d2f_dpam2.data(), nullptr, df_dg, I, p_am.data());
 	d2f_dp2.bottomRightCorner(state_size, state_size) = -d2f_dpam2;
 	switch(ilm_d2f_dIt_type){
@@ -215,7 +222,7 @@ void SSDBase::cmptILMHessian(MatrixXd &d2f_dp2, const MatrixXd &dI_dpssm,
 	}
 	case  ILMPixHessT::Diagonal:
 	{
-		VectorXd d2f_dIt2_diag(patch_size);
+		d2f_dIt2_diag.resize(patch_size);
 		if(df_dg){
 			ilm->cmptPixHessian(d2f_dIt2_diag.data(), nullptr, df_dg, I, p_am.data());
 		} else{
@@ -248,6 +255,94 @@ void SSDBase::cmptILMHessian(MatrixXd &d2f_dp2, const MatrixXd &dI_dpssm,
 		d2f_dp2.bottomLeftCorner(state_size, ssm_state_size) = -d2f_dpam_dIt*dI_dpssm;
 }
 
+void SSDBase::cmptJacobianProduct(MatrixXd &d2f_dp2, const MatrixXd &dI_dpssm,
+	bool accumulate){
+	utils::getJacobianProduct(d2f_dp2, dI_dpssm, -1, accumulate);
+}
+void SSDBase::cmptJacobianProduct(MatrixXd &d2f_dp2, const MatrixXf &dI_dpssm,
+	bool accumulate){
+	utils::getJacobianProduct(d2f_dp2, dI_dpssm, -1, accumulate);
+}
+/**
+the single precision variants fall back to the double precision ones with a converted copy
+of the Jacobian when SPI is in use since SPI is not performance critical;
+no ILM is in use since supportsFloatJacobian would return false otherwise
+*/
+void SSDBase::cmptInitJacobianFloat(RowVectorXd &df_dp,
+	const MatrixXf &dI0_dpssm){
+	assert(df_dp.size() == dI0_dpssm.cols() && dI0_dpssm.rows() == patch_size);
+#ifndef DISABLE_SPI
+	if(spi_mask){
+		spi_dI0_dpssm = dI0_dpssm.cast<double>();
+		cmptInitJacobian(df_dp, spi_dI0_dpssm);
+		return;
+	}
+#endif
+	utils::getJacobianVecProduct(df_dp, df_dI0, dI0_dpssm);
+}
+void SSDBase::cmptCurrJacobianFloat(RowVectorXd &df_dp,
+	const MatrixXf &dIt_dpssm){
+	assert(df_dp.size() == dIt_dpssm.cols() && dIt_dpssm.rows() == patch_size);
+#ifndef DISABLE_SPI
+	if(spi_mask){
+		spi_dIt_dpssm = dIt_dpssm.cast<double>();
+		cmptCurrJacobian(df_dp, spi_dIt_dpssm);
+		return;
+	}
+#endif
+	utils::getJacobianVecProduct(df_dp, df_dIt, dIt_dpssm);
+}
+void SSDBase::cmptDifferenceOfJacobiansFloat(RowVectorXd &df_dp_diff,
+	const MatrixXf &dI0_dpssm, const MatrixXf &dIt_dpssm){
+	assert(df_dp_diff.size() == dIt_dpssm.cols() && dI0_dpssm.cols() == dIt_dpssm.cols());
+#ifndef DISABLE_SPI
+	if(spi_mask){
+		spi_dI0_dpssm = dI0_dpssm.cast<double>();
+		spi_dIt_dpssm = dIt_dpssm.cast<double>();
+		cmptDifferenceOfJacobians(df_dp_diff, spi_dI0_dpssm, spi_dIt_dpssm);
+		return;
+	}
+#endif
+	utils::getJacobianVecProduct(df_dp_diff, df_dIt, dI0_dpssm);
+	utils::getJacobianVecProduct(df_dp_diff, df_dIt, dIt_dpssm, 1, true);
+}
+void SSDBase::cmptInitHessianFloat(MatrixXd &d2f_dp2, const MatrixXf &dI0_dpssm){
+	assert(d2f_dp2.rows() == dI0_dpssm.cols() && d2f_dp2.rows() == d2f_dp2.cols());
+#ifndef DISABLE_SPI
+	if(spi_mask){
+		spi_dI0_dpssm = dI0_dpssm.cast<double>();
+		cmptInitHessian(d2f_dp2, spi_dI0_dpssm);
+		return;
+	}
+#endif
+	cmptJacobianProduct(d2f_dp2, dI0_dpssm);
+}
+void SSDBase::cmptCurrHessianFloat(MatrixXd &d2f_dp2, const MatrixXf &dIt_dpssm){
+	assert(d2f_dp2.rows() == dIt_dpssm.cols() && d2f_dp2.rows() == d2f_dp2.cols());
+#ifndef DISABLE_SPI
+	if(spi_mask){
+		spi_dIt_dpssm = dIt_dpssm.cast<double>();
+		cmptCurrHessian(d2f_dp2, spi_dIt_dpssm);
+		return;
+	}
+#endif
+	cmptJacobianProduct(d2f_dp2, dIt_dpssm);
+}
+void SSDBase::cmptSumOfHessiansFloat(MatrixXd &d2f_dp2_sum,
+	const MatrixXf &dI0_dpssm, const MatrixXf &dIt_dpssm){
+	assert(d2f_dp2_sum.rows() == dIt_dpssm.cols() && d2f_dp2_sum.rows() == d2f_dp2_sum.cols());
+#ifndef DISABLE_SPI
+	if(spi_mask){
+		spi_dI0_dpssm = dI0_dpssm.cast<double>();
+		spi_dIt_dpssm = dIt_dpssm.cast<double>();
+		cmptSumOfHessians(d2f_dp2_sum, spi_dI0_dpssm, spi_dIt_dpssm);
+		return;
+	}
+#endif
+	cmptJacobianProduct(d2f_dp2_sum, dI0_dpssm);
+	cmptJacobianProduct(d2f_dp2_sum, dIt_dpssm, true);
+}
+
 void SSDBase::cmptInitHessian(MatrixXd &d2f_dp2, const MatrixXd &dI0_dpssm){
 	assert(d2f_dp2.rows() == dI0_dpssm.cols() + state_size && d2f_dp2.rows() == d2f_dp2.cols());
 	assert(dI0_dpssm.rows() == patch_size);
@@ -259,7 +354,7 @@ void SSDBase::cmptInitHessian(MatrixXd &d2f_dp2, const MatrixXd &dI0_dpssm){
 			getHessian(d2f_dp2, spi_mask, dI0_dpssm);
 		} else{
 #endif
-			d2f_dp2.noalias() = -dI0_dpssm.transpose() * dI0_dpssm;
+			cmptJacobianProduct(d2f_dp2, dI0_dpssm);
 #ifndef DISABLE_SPI
 		}
 #endif
@@ -277,12 +372,67 @@ void SSDBase::cmptCurrHessian(MatrixXd &d2f_dp2,
 			getHessian(d2f_dp2, spi_mask, dIt_dpssm);
 		} else{
 #endif
-			d2f_dp2.noalias() = -dIt_dpssm.transpose() * dIt_dpssm;
+			cmptJacobianProduct(d2f_dp2, dIt_dpssm);
 #ifndef DISABLE_SPI
 		}
 #endif
 	}
 }
+/**
+accumulates both df_dp and the first order Hessian one block of pixel Jacobian rows at a time so that
+the full N x S pixel Jacobian is never stored; partial sums are kept separately for each block
+and added in a fixed order at the end so that the result does not depend on the number of threads;
+the SMs only use this with double precision pixel Jacobians
+*/
+void SSDBase::cmptCurrJacobianAndSelfHessian(RowVectorXd &df_dp, MatrixXd &d2f_dp2,
+	const PixJacobianBlockFuncT &dIt_dpssm_func, MatrixXd &dIt_dpssm){
+	bool use_full_jacobian = static_cast<bool>(ilm);
+#ifndef DISABLE_SPI
+	use_full_jacobian = use_full_jacobian || spi_mask;
+#endif
+	if(use_full_jacobian){
+		AppearanceModel::cmptCurrJacobianAndSelfHessian(df_dp, d2f_dp2, dIt_dpssm_func, dIt_dpssm);
+		return;
+	}
+	const int ssm_state_size = df_dp.size();
+	assert(d2f_dp2.rows() == ssm_state_size && d2f_dp2.cols() == ssm_state_size);
+
+	const unsigned int block_size = SSD_FUSED_BLOCK_SIZE;
+	const int n_blocks = (n_pix + block_size - 1) / block_size;
+	fused_df_dp.resize(ssm_state_size, n_blocks);
+	fused_d2f_dp2.resize(ssm_state_size*ssm_state_size, n_blocks);
+	//! the blocks are divided into one contiguous range for each thread so that each has its own workspace
+	const int n_ranges = std::min(task_arena->getNThreads(), n_blocks);
+	if(static_cast<int>(fused_dI_dpssm.size()) < n_ranges){
+		fused_dI_dpssm.resize(n_ranges);
+		fused_d2f_dp2_block.resize(n_ranges);
+	}
+	for(int range_id = 0; range_id < n_ranges; ++range_id){
+		fused_dI_dpssm[range_id].resize(block_size*n_channels, ssm_state_size);
+		fused_d2f_dp2_block[range_id].resize(ssm_state_size, ssm_state_size);
+	}
+	task_arena->run(n_ranges, [&](int range_id){
+		MatrixXd &dIt_dpssm_block = fused_dI_dpssm[range_id];
+		MatrixXd &d2f_dp2_block = fused_d2f_dp2_block[range_id];
+		const int end_block_id = (range_id + 1)*n_blocks / n_ranges;
+		for(int block_id = range_id*n_blocks / n_ranges; block_id < end_block_id; ++block_id){
+			unsigned int start_id = block_id*block_size;
+			unsigned int n_block = std::min(block_size, n_pix - start_id);
+			if(n_block < block_size){
+				// the last block only fills the top rows so the rest must not contribute to the Hessian
+				dIt_dpssm_block.bottomRows((block_size - n_block)*n_channels).setZero();
+			}
+			dIt_dpssm_func(dIt_dpssm_block, start_id, n_block);
+			fused_df_dp.col(block_id).noalias() = dIt_dpssm_block.topRows(n_block*n_channels).transpose() *
+				df_dIt.segment(start_id*n_channels, n_block*n_channels).transpose();
+			utils::getJacobianProduct(d2f_dp2_block, dIt_dpssm_block, -1);
+			fused_d2f_dp2.col(block_id) = Map<const VectorXd>(d2f_dp2_block.data(),
+				ssm_state_size*ssm_state_size);
+		}
+	});
+	df_dp = fused_df_dp.rowwise().sum().transpose();
+	Map<VectorXd>(d2f_dp2.data(), ssm_state_size*ssm_state_size) = fused_d2f_dp2.rowwise().sum();
+}
 //! analogous to cmptDifferenceOfJacobians except for computing the difference between the current and initial Hessians
 void SSDBase::cmptSumOfHessians(MatrixXd &d2f_dp2_sum,
 	const MatrixXd &dI0_dpssm,	const MatrixXd &dIt_dpssm){
@@ -290,11 +440,10 @@ void SSDBase::cmptSumOfHessians(MatrixXd &d2f_dp2_sum,
 	assert(dI0_dpssm.rows() == patch_size && dIt_dpssm.rows() == patch_size);
 
 	if(ilm){
-		MatrixXd d2f_dp2t(d2f_dp2_sum.rows(), d2f_dp2_sum.cols());
-		cmptILMHessian(d2f_dp2t, dIt_dpssm, It_orig.data());
-		MatrixXd d2f_dp20(d2f_dp2_sum.rows(), d2f_dp2_sum.cols());
-		cmptILMHessian(d2f_dp20, dI0_dpssm, I0.data());
-		d2f_dp2_sum.noalias() = d2f_dp2t + d2f_dp20;
+		d2f_dp2_t.resize(d2f_dp2_sum.rows(), d2f_dp2_sum.cols());
+		cmptILMHessian(d2f_dp2_t, dIt_dpssm, It_orig.data());
+		cmptILMHessian(d2f_dp2_sum, dI0_dpssm, I0.data());
+		d2f_dp2_sum += d2f_dp2_t;
 	} else{
 #ifndef DISABLE_SPI
 		if(spi_mask){
@@ -302,8 +451,8 @@ void SSDBase::cmptSumOfHessians(MatrixXd &d2f_dp2_sum,
 				dI0_dpssm, dIt_dpssm);
 		} else{
 #endif
-			d2f_dp2_sum.noalias() = -(dI0_dpssm.transpose() * dI0_dpssm
-				+ dIt_dpssm.transpose() * dIt_dpssm);
+			cmptJacobianProduct(d2f_dp2_sum, dI0_dpssm);
+			cmptJacobianProduct(d2f_dp2_sum, dIt_dpssm, true);
 #ifndef DISABLE_SPI
 		}
 #endif
@@ -326,7 +475,7 @@ void SSDBase::cmptInitHessian(MatrixXd &d2f_dp2, const MatrixXd &dI0_dpssm,
 			getHessian(d2f_dp2, spi_mask, dI0_dpssm);
 		} else{
 #endif
-			d2f_dp2.noalias() = -dI0_dpssm.transpose() * dI0_dpssm;
+			cmptJacobianProduct(d2f_dp2, dI0_dpssm);
 #ifndef DISABLE_SPI
 		}
 #endif
@@ -358,7 +507,7 @@ void SSDBase::cmptCurrHessian(MatrixXd &d2f_dp2, const MatrixXd &dIt_dpssm,
 			getHessian(d2f_dp2, spi_mask, dIt_dpssm);
 		} else{
 #endif
-			d2f_dp2.noalias() = -dIt_dpssm.transpose() * dIt_dpssm;
+			cmptJacobianProduct(d2f_dp2, dIt_dpssm);
 #ifndef DISABLE_SPI
 		}
 #endif
@@ -383,11 +532,10 @@ void SSDBase::cmptSumOfHessians(MatrixXd &d2f_dp2_sum,
 	assert(d2It_dpssm2.rows() == ssm_state_size * ssm_state_size && d2It_dpssm2.cols() == n_channels * n_pix);
 
 	if(ilm){
-		MatrixXd d2f_dp2t(d2f_dp2_sum.rows(), d2f_dp2_sum.cols());
-		cmptILMHessian(d2f_dp2t, dIt_dpssm, It_orig.data(), df_dgt.data());
-		MatrixXd d2f_dp20(d2f_dp2_sum.rows(), d2f_dp2_sum.cols());
-		cmptILMHessian(d2f_dp20, dI0_dpssm, I0.data(), df_dgt.data());
-		d2f_dp2_sum.noalias() = d2f_dp2t + d2f_dp20;
+		d2f_dp2_t.resize(d2f_dp2_sum.rows(), d2f_dp2_sum.cols());
+		cmptILMHessian(d2f_dp2_t, dIt_dpssm, It_orig.data(), df_dgt.data());
+		cmptILMHessian(d2f_dp2_sum, dI0_dpssm, I0.data(), df_dgt.data());
+		d2f_dp2_sum += d2f_dp2_t;
 	} else{
 #ifndef DISABLE_SPI
 		if(spi_mask){
@@ -395,8 +543,8 @@ void SSDBase::cmptSumOfHessians(MatrixXd &d2f_dp2_sum,
 				dI0_dpssm, dIt_dpssm);
 		} else{
 #endif
-			d2f_dp2_sum.noalias() = -(dI0_dpssm.transpose() * dI0_dpssm
-				+ dIt_dpssm.transpose() * dIt_dpssm);
+			cmptJacobianProduct(d2f_dp2_sum, dI0_dpssm);
+			cmptJacobianProduct(d2f_dp2_sum, dIt_dpssm, true);
 #ifndef DISABLE_SPI
 		}
 #endif
@@ -416,7 +564,7 @@ void SSDBase::cmptSumOfHessians(MatrixXd &d2f_dp2_sum,
 
 void SSDBase::getJacobian(RowVectorXd &jacobian, const bool *pix_mask,
 	const RowVectorXd &df_dI, const MatrixXd &dI_dpssm){
-	assert(dI_dpssm.rows() == patch_size && dI_dpssm.rows() == jacobian.size());
+	assert(dI_dpssm.rows() == patch_size && dI_dpssm.cols() == jacobian.size());
 	jacobian.setZero();
 	int ch_pix_id = 0;
 	for(unsigned int pix_id = 0; pix_id < n_pix; ++pix_id){
@@ -575,31 +723,7 @@ void SSDBase::generatePerturbation(VectorXd &perturbation){
 */
 double SSDBaseDist::operator()(const double* a, const double* b,
 	size_t size, double worst_dist) const{
-	double result = 0;
-	double diff0, diff1, diff2, diff3;
-	const double* last = a + size;
-	const double* lastgroup = last - 3;
-
-	/* Process 4 items with each loop for efficiency. */
-	while(a < lastgroup){
-		diff0 = (a[0] - b[0]);
-		diff1 = (a[1] - b[1]);
-		diff2 = (a[2] - b[2]);
-		diff3 = (a[3] - b[3]);
-		result += diff0 * diff0 + diff1 * diff1 + diff2 * diff2 + diff3 * diff3;
-		a += 4;
-		b += 4;
-
-		if((worst_dist > 0) && (result > worst_dist)){
-			return result;
-		}
-	}
-	/* Process last 0-3 pixels.  Not needed for standard vector lengths. */
-	while(a < last){
-		diff0 = (*a++ - *b++);
-		result += diff0 * diff0;
-	}
-	return result;
+	return utils::simd::getSSD(a, b, size, worst_dist);
 }
 
 
@@ -1,5 +1,6 @@
 #include "mtf/AM/SSIM.h"
 #include "mtf/Utilities/miscUtils.h"
+#include "mtf/Utilities/simdUtils.h"
 
 #define SSIM_K1 0.01
 #define SSIM_K2 0.03
@@ -316,24 +317,10 @@ void SSIM::updateDistFeat(){
 double SSIMDist::operator()(const double* a, const double* b, size_t size, double worst_dist) const
 {
 	double result = double();
-	double cross_pix_var = 0;
 	size_t _patch_size = size - 3;
-	const double* last = a + _patch_size;
-	const double* lastgroup = last - 3;
-
-	/* Process 4 items with each loop for efficiency. */
-	while(a < lastgroup) {
-
-		cross_pix_var += a[0] * b[0] + a[1] * b[1] + a[2] * b[2] + a[3] * b[3];
-		a += 4;
-		b += 4;
-	}
-	/* Process last 0-3 pixels.  Not needed for standard vector lengths. */
-	while(a < last) {
-		cross_pix_var += *a * *b;
-		a++;
-		b++;
-	}
+	double cross_pix_var = utils::simd::getDotProduct(a, b, _patch_size);
+	a += _patch_size;
+	b += _patch_size;
 	cross_pix_var /= _patch_size - 1;
 	result = -((2 * a[0] * b[0] + c1)*(2 * cross_pix_var + c2)) / ((a[1] + b[1] + c1)*(a[2] + b[2] + c2));
 	return result;
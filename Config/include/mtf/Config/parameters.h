@@ -166,6 +166,11 @@ namespace mtf{
 		bool invalid_state_check = true;
 		double invalid_state_err_thresh = 0;
 		bool uchar_input = false;
+		bool img_deriv_cache = false;
+		bool float_jac = false;
+		int am_n_threads = 1;
+		int am_grain_size = 0;
+		int parallel_backend = 0;
 
 		bool ic_update_ssm = true;
 		bool ic_chained_warp = true;
@@ -177,6 +182,7 @@ namespace mtf{
 		bool fc_show_grid = false;
 		bool fc_show_patch = false;
 		double fc_patch_resize_factor = 1.0;
+		bool fc_fused_gn = false;
 		bool fc_debug_mode = false;
 
 		int fa_hess_type = 1;
@@ -344,6 +350,7 @@ namespace mtf{
 		int mi_n_bins = 8;
 		double mi_pre_seed = 10;
 		bool mi_pou = false;
+		int mi_lut_steps = 0;
 		double mi_likelihood_alpha = 50;
 
 		//! CCRE
@@ -352,6 +359,7 @@ namespace mtf{
 		bool ccre_pou = false;
 		bool ccre_symmetrical_grad = false;
 		int ccre_n_blocks = 0;
+		int ccre_lut_steps = 0;
 		double ccre_likelihood_alpha = 50;
 
 		//!NGF
@@ -378,13 +386,26 @@ namespace mtf{
 		bool nn_save_index = false;
 		bool nn_load_index = false;
 		int nn_saved_index_fid = 0;
+		int nn_n_threads = 1;
+		bool nn_sampler_streams = false;
 		//! GNN
 		int nn_gnn_degree = 250;
 		int nn_gnn_max_steps = 10;
 		int nn_gnn_cmpt_dist_thresh = 10000;
 		bool nn_gnn_random_start = false;
+		int nn_gnn_build_type = 0;
+		int nn_gnn_nnd_max_iters = 10;
+		double nn_gnn_nnd_sample_rate = 0.5;
+		double nn_gnn_nnd_delta = 0.001;
+		double nn_gnn_nnd_target_recall = 0.99;
+		int nn_gnn_n_threads = 1;
 		bool nn_gnn_verbose = false;
 		int nn_fgnn_index_type = 0;
+		//! HNSW
+		int nn_hnsw_M = 16;
+		int nn_hnsw_ef_construction = 200;
+		int nn_hnsw_ef_search = 50;
+		bool nn_hnsw_verbose = false;
 		//! FLANN specific params
 		int nn_srch_checks = 32;
 		float nn_srch_eps = 0.0;
@@ -472,6 +493,8 @@ namespace mtf{
 		vectord pf_pix_sigma;
 		int pf_show_particles = 0;
 		bool pf_jacobian_as_sigma = false;
+		int pf_n_threads = 1;
+		bool pf_sampler_streams = false;
 		bool pf_debug_mode = false;
 
 		//! Multi Layer Particle Filter
@@ -512,7 +535,7 @@ namespace mtf{
 		bool grid_fb_reinit = 0;
 		bool grid_show_trackers = false;
 		bool grid_show_tracker_edges = false;
-		bool grid_use_tbb = true;
+		int grid_n_threads = 0;
 		//! OpenCV grid tracker
 		int grid_pyramid_levels = 2;
 		bool grid_use_min_eig_vals = 0;
@@ -525,6 +548,8 @@ namespace mtf{
 		int feat_min_matches = 10;
 		bool feat_rebuild_index = false;
 		bool feat_use_cv_flann = true;
+		bool feat_detect_in_roi = false;
+		bool feat_use_prosac = false;
 		bool feat_show_keypoints = 0;
 		bool feat_show_matches = 0;
 		bool feat_debug_mode = 0;
@@ -643,6 +668,7 @@ namespace mtf{
 		double est_confidence = 0.995;
 		bool est_refine = true;
 		int est_lm_max_iters = 10;
+		int est_n_threads = 1;
 
 
 		char* line_sm = "iclk";
@@ -672,6 +698,9 @@ namespace mtf{
 		bool prl_auto_reinit = false;
 		double prl_reinit_err_thresh = 1.0;
 		int prl_reinit_frame_gap = 1;
+		int prl_n_threads = 0;
+		bool prl_pin_threads = false;
+		bool prl_reinit_share_frames = false;
 
 		//! Pyramidal Tracker
 		std::string pyr_sm = "fc";
@@ -679,6 +708,8 @@ namespace mtf{
 		double pyr_scale_factor = 0.50;
 		bool pyr_scale_res = true;
 		bool pyr_show_levels = false;
+		bool pyr_shared_cache = false;
+		int pyr_cache_roi_margin = -1;
 
 		//! MTF Diagnostics
 		char* diag_am = "ssd";
@@ -1435,6 +1466,26 @@ namespace mtf{
 				uchar_input = atoi(arg_val);
 				return;
 			}
+			if(!strcmp(arg_name, "img_deriv_cache")){
+				img_deriv_cache = atoi(arg_val);
+				return;
+			}
+			if(!strcmp(arg_name, "float_jac")){
+				float_jac = atoi(arg_val);
+				return;
+			}
+			if(!strcmp(arg_name, "am_n_threads")){
+				am_n_threads = atoi(arg_val);
+				return;
+			}
+			if(!strcmp(arg_name, "am_grain_size")){
+				am_grain_size = atoi(arg_val);
+				return;
+			}
+			if(!strcmp(arg_name, "parallel_backend")){
+				parallel_backend = atoi(arg_val);
+				return;
+			}
 			//! ICLK
 			if(!strcmp(arg_name, "ic_update_ssm")){
 				ic_update_ssm = atoi(arg_val);
@@ -1473,6 +1524,10 @@ namespace mtf{
 				fc_patch_resize_factor = atoi(arg_val);
 				return;
 			}
+			if(!strcmp(arg_name, "fc_fused_gn")){
+				fc_fused_gn = atoi(arg_val);
+				return;
+			}
 			if(!strcmp(arg_name, "fc_debug_mode")){
 				fc_debug_mode = atoi(arg_val);
 				return;
@@ -2003,6 +2058,10 @@ namespace mtf{
 				mi_n_bins = atoi(arg_val);
 				return;
 			}
+			if(!strcmp(arg_name, "mi_lut_steps")){
+				mi_lut_steps = atoi(arg_val);
+				return;
+			}
 			if(!strcmp(arg_name, "mi_likelihood_alpha")){
 				mi_likelihood_alpha = atof(arg_val);
 				return;
@@ -2026,6 +2085,10 @@ namespace mtf{
 			}
 			if(!strcmp(arg_name, "ccre_n_blocks")){
 				ccre_n_blocks = atoi(arg_val);
+				return;
+			}
+			if(!strcmp(arg_name, "ccre_lut_steps")){
+				ccre_lut_steps = atoi(arg_val);
 				return;
 			}
 			if(!strcmp(arg_name, "ccre_likelihood_alpha")){
@@ -2249,6 +2312,14 @@ namespace mtf{
 				nn_save_index = atoi(arg_val);
 				return;
 			}
+			if(!strcmp(arg_name, "nn_n_threads")){
+				nn_n_threads = atoi(arg_val);
+				return;
+			}
+			if(!strcmp(arg_name, "nn_sampler_streams")){
+				nn_sampler_streams = atoi(arg_val);
+				return;
+			}
 			if(!strcmp(arg_name, "nn_load_index")){
 				nn_load_index = atoi(arg_val);
 				return;
@@ -2300,6 +2371,26 @@ namespace mtf{
 			}
 			if(!strcmp(arg_name, "nn_gnn_random_start")){
 				nn_gnn_random_start = atoi(arg_val);
+				return;
+			}
+			if(!strcmp(arg_name, "nn_gnn_build_type")){
+				nn_gnn_build_type = atoi(arg_val);
+				return;
+			}
+			if(!strcmp(arg_name, "nn_gnn_nnd_max_iters")){
+				nn_gnn_nnd_max_iters = atoi(arg_val);
+				return;
+			}
+			if(!strcmp(arg_name, "nn_gnn_nnd_sample_rate")){
+				nn_gnn_nnd_sample_rate = atof(arg_val);
+				return;
+			}
+			if(!strcmp(arg_name, "nn_gnn_nnd_delta")){
+				nn_gnn_nnd_delta = atof(arg_val);
+				return;
+			}
+			if(!strcmp(arg_name, "nn_gnn_nnd_target_recall")){
+				nn_gnn_nnd_target_recall = atof(arg_val);
 				return;
 			}
 			if(!strcmp(arg_name, "nn_fgnn_index_type")){
@@ -2308,6 +2399,26 @@ namespace mtf{
 			}
 			if(!strcmp(arg_name, "nn_gnn_verbose")){
 				nn_gnn_verbose = atoi(arg_val);
+				return;
+			}
+			if(!strcmp(arg_name, "nn_gnn_n_threads")){
+				nn_gnn_n_threads = atoi(arg_val);
+				return;
+			}
+			if(!strcmp(arg_name, "nn_hnsw_M")){
+				nn_hnsw_M = atoi(arg_val);
+				return;
+			}
+			if(!strcmp(arg_name, "nn_hnsw_ef_construction")){
+				nn_hnsw_ef_construction = atoi(arg_val);
+				return;
+			}
+			if(!strcmp(arg_name, "nn_hnsw_ef_search")){
+				nn_hnsw_ef_search = atoi(arg_val);
+				return;
+			}
+			if(!strcmp(arg_name, "nn_hnsw_verbose")){
+				nn_hnsw_verbose = atoi(arg_val);
 				return;
 			}
 			if(!strcmp(arg_name, "nn_kdt_trees")){
@@ -2544,8 +2655,8 @@ namespace mtf{
 				grid_show_tracker_edges = atoi(arg_val);
 				return;
 			}
-			if(!strcmp(arg_name, "grid_use_tbb")){
-				grid_use_tbb = atoi(arg_val);
+			if(!strcmp(arg_name, "grid_n_threads")){
+				grid_n_threads = atoi(arg_val);
 				return;
 			}
 			if(!strcmp(arg_name, "grid_pyramid_levels")){
@@ -2599,6 +2710,14 @@ namespace mtf{
 			if(!strcmp(arg_name, "feat_use_cv_flann")){
 				feat_use_cv_flann = atoi(arg_val);
 				return;
+			}
+			if(!strcmp(arg_name, "feat_detect_in_roi")){
+				feat_detect_in_roi = atoi(arg_val);
+				return;
+			}
+			if(!strcmp(arg_name, "feat_use_prosac")){
+				feat_use_prosac = atoi(arg_val);
+				return;
 			}  if(!strcmp(arg_name, "feat_show_keypoints")){
 				feat_show_keypoints = atoi(arg_val);
 				return;
@@ -3001,6 +3120,10 @@ namespace mtf{
 				est_lm_max_iters = atoi(arg_val);
 				return;
 			}
+			if(!strcmp(arg_name, "est_n_threads")){
+				est_n_threads = atoi(arg_val);
+				return;
+			}
 			//! RKLT
 			if(!strcmp(arg_name, "rkl_sm")){
 				processStringParam(rkl_sm, arg_val);
@@ -3047,6 +3170,18 @@ namespace mtf{
 				prl_reinit_frame_gap = atoi(arg_val);
 				return;
 			}
+			if(!strcmp(arg_name, "prl_n_threads")) {
+				prl_n_threads = atoi(arg_val);
+				return;
+			}
+			if(!strcmp(arg_name, "prl_pin_threads")) {
+				prl_pin_threads = atoi(arg_val);
+				return;
+			}
+			if(!strcmp(arg_name, "prl_reinit_share_frames")) {
+				prl_reinit_share_frames = atoi(arg_val);
+				return;
+			}
 			//! Pyramidal Tracker
 			if(!strcmp(arg_name, "pyr_sm")) {
 				pyr_sm = std::string(arg_val);
@@ -3068,6 +3203,14 @@ namespace mtf{
 				pyr_show_levels = atoi(arg_val);
 				return;
 			}
+			if(!strcmp(arg_name, "pyr_shared_cache")) {
+				pyr_shared_cache = atoi(arg_val);
+				return;
+			}
+			if(!strcmp(arg_name, "pyr_cache_roi_margin")) {
+				pyr_cache_roi_margin = atoi(arg_val);
+				return;
+			}
 			//! Gradient Descent
 			if(!strcmp(arg_name, "sd_learning_rate")){
 				sd_learning_rate = atof(arg_val);
@@ -3171,6 +3314,14 @@ namespace mtf{
 			}
 			if(!strcmp(arg_name, "pf_jacobian_as_sigma")){
 				pf_jacobian_as_sigma = atoi(arg_val);
+				return;
+			}
+			if(!strcmp(arg_name, "pf_n_threads")){
+				pf_n_threads = atoi(arg_val);
+				return;
+			}
+			if(!strcmp(arg_name, "pf_sampler_streams")){
+				pf_sampler_streams = atoi(arg_val);
 				return;
 			}
 			if(!strcmp(arg_name, "pf_debug_mode")){
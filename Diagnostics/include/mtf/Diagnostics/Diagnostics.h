@@ -167,6 +167,7 @@ private:
 	void updateCurrSelfHess();
 
 	bool validateHessians(const MatrixXd &self_hessian);
+	bool validateFusedHessian();
 
 	void drawCurrCorners(cv::Mat &img, int state_id = -1, int thickness = 2,
 		bool write_text = true, cv::Scalar corners_col = (0, 0, 255));
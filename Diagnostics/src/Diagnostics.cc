@@ -164,6 +164,44 @@ bool Diagnostics::validateHessians(const MatrixXd &self_hessian){
 	return matching_hess;
 }
 
+/**
+compares the Jacobian and first order self Hessian computed by the AM from the pixel Jacobian supplied
+block by block with those computed from the complete pixel Jacobian for the same pixel gradient
+*/
+bool Diagnostics::validateFusedHessian(){
+	ssm->cmptWarpedPixJacobian(curr_pix_jacobian, am->getInitPixGrad());
+	am->cmptCurrJacobian(similarity_jacobian, curr_pix_jacobian);
+	am->cmptSelfHessian(hessian, curr_pix_jacobian);
+
+	RowVectorXd fused_jacobian(state_size);
+	MatrixXd fused_hessian(state_size, state_size);
+	MatrixXd fused_pix_jacobian(am->getPatchSize(), ssm_state_size);
+	am->cmptCurrJacobianAndSelfHessian(fused_jacobian, fused_hessian,
+		[&](MatrixXd &pix_jacobian_block, unsigned int start_id, unsigned int n_block){
+		ssm->cmptWarpedPixJacobianBlock(pix_jacobian_block, am->getInitPixGrad(), start_id, n_block);
+	}, fused_pix_jacobian);
+
+	bool matching_fused = true;
+	double jacobian_diff_norm = (fused_jacobian - similarity_jacobian).squaredNorm();
+	if(jacobian_diff_norm > params.validation_prec){
+		printf("Diagnostics:: Fused Jacobian does not match Curr Jacobian\n");
+		utils::printMatrix(fused_jacobian, "fused_jacobian");
+		utils::printMatrix(similarity_jacobian, "similarity_jacobian");
+		utils::printScalar(jacobian_diff_norm, "jacobian_diff_norm", "%e");
+		matching_fused = false;
+	}
+	double hessian_diff_norm = (fused_hessian - hessian).squaredNorm();
+	if(hessian_diff_norm > params.validation_prec){
+		printf("Diagnostics:: Fused Hessian does not match Self Hessian\n");
+		utils::printMatrix(fused_hessian, "fused_hessian");
+		utils::printMatrix(hessian, "hessian");
+		utils::printScalar(hessian_diff_norm, "hessian_diff_norm", "%e");
+		double relative_diff = 2 * hessian_diff_norm / (hessian.squaredNorm() + fused_hessian.squaredNorm());
+		utils::printScalar(relative_diff, "relative_diff", "%e");
+		matching_fused = false;
+	}
+	return matching_fused;
+}
 
 void Diagnostics::initialize(const cv::Mat &corners, 
 	const bool *gen_flags){
@@ -199,6 +237,9 @@ void Diagnostics::initialize(const cv::Mat &corners,
 		if(!validateHessians(init_self_hessian2)){
 			throw utils::LogicError("Diagnostics:: Second Order Hessian Mismatch Encountered");
 		}
+		if(ssm->supportsPixJacobianBlocks() && !validateFusedHessian()){
+			throw utils::LogicError("Diagnostics:: Fused Jacobian/Hessian Mismatch Encountered");
+		}
 	}
 	if(gen_flags[3]){
 		am->initializeDistFeat();
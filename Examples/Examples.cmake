@@ -291,6 +291,15 @@ if(NOT WIN32)
 	  )
 	add_custom_target(mtft DEPENDS diagnoseMTF mtf_diag install_diag install_diag_lib)
 endif() 
+
+add_executable(testMTF Examples/cpp/testMTF.cc)
+target_compile_definitions(testMTF PUBLIC ${MTF_DEFINITIONS})
+target_compile_options(testMTF PUBLIC ${MTF_RUNTIME_FLAGS} ${MTF_COMPILETIME_FLAGS})
+target_include_directories(testMTF PUBLIC ${MTF_INCLUDE_DIRS} ${MTF_EXT_INCLUDE_DIRS})
+target_link_libraries(testMTF mtf ${MTF_LIBS})
+add_custom_target(tst DEPENDS testMTF)
+enable_testing()
+add_test(NAME testMTF COMMAND testMTF)
 # add_custom_target(all DEPENDS ${EX_TARGET_NAMES})
 if(NOT WIN32)
 	add_custom_target(install_all DEPENDS ${EX_INSTALL_TARGET_NAMES})
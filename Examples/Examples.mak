@@ -120,6 +120,7 @@ ifeq (${o}, 1)
 		_MTF_EXE_NAME = runMTF
 	endif
 	_MTF_DIAG_EXE_NAME = diagnoseMTF
+	_MTF_TEST_EXE_NAME = testMTF
 	_MTF_PATCH_EXE_NAME = extractPatch
 	_MTF_UAV_EXE_NAME = trackUAVTrajectory
 	_MTF_GT_EXE_NAME = showGroundTruth
@@ -139,6 +140,7 @@ else ifeq (${o}, 2)
 		_MTF_EXE_NAME = runMTF_fast
 	endif
 	_MTF_DIAG_EXE_NAME = diagnoseMTF_fast
+	_MTF_TEST_EXE_NAME = testMTF_fast
 	_MTF_PATCH_EXE_NAME = extractPatch_fast
 	_MTF_UAV_EXE_NAME = trackUAVTrajectory_fast
 	_MTF_GT_EXE_NAME = showGroundTruth_fast
@@ -157,6 +159,7 @@ else
 		_MTF_EXE_NAME = runMTF_debug
 	endif
 	_MTF_DIAG_EXE_NAME = diagnoseMTF_debug
+	_MTF_TEST_EXE_NAME = testMTF_debug
 	_MTF_PATCH_EXE_NAME = extractPatch_debug
 	_MTF_UAV_EXE_NAME = trackUAVTrajectory_debug
 	_MTF_GT_EXE_NAME = showGroundTruth_debug
@@ -171,6 +174,7 @@ endif
 
 MTF_EXE_NAME = $(addsuffix ${LIB_POST_FIX}${MTF_EXE_EXT}, ${_MTF_EXE_NAME})
 MTF_DIAG_EXE_NAME = $(addsuffix ${LIB_POST_FIX}${MTF_EXE_EXT}, ${_MTF_DIAG_EXE_NAME})
+MTF_TEST_EXE_NAME = $(addsuffix ${LIB_POST_FIX}${MTF_EXE_EXT}, ${_MTF_TEST_EXE_NAME})
 MTF_PATCH_EXE_NAME = $(addsuffix ${LIB_POST_FIX}${MTF_EXE_EXT}, ${_MTF_PATCH_EXE_NAME})
 MTF_UAV_EXE_NAME = $(addsuffix ${LIB_POST_FIX}${MTF_EXE_EXT}, ${_MTF_UAV_EXE_NAME})
 MTF_GT_EXE_NAME = $(addsuffix ${LIB_POST_FIX}${MTF_EXE_EXT}, ${_MTF_GT_EXE_NAME})
@@ -196,6 +200,7 @@ endif
 .PHONY: exe uav mos syn py diag gt patch qr app mtfi mtfp mtfc mtfu mtfd mtfs mtfm
 .PHONY: install_exe install_uav install_mos install_patch install_qr install_rec install_syn install_py install_diag install_app install_all
 .PHONY: run
+.PHONY: tst check
 
 exe: ${BUILD_DIR}/${MTF_EXE_NAME}
 uav: ${BUILD_DIR}/${MTF_UAV_EXE_NAME}
@@ -205,6 +210,7 @@ py: ${BUILD_DIR}/${MTF_PY_LIB_NAME}
 mex: ${BUILD_DIR}/${MTF_MEX_MODULE_NAME}
 mex2: ${BUILD_DIR}/${MTF_MEX2_MODULE_NAME}
 diag: ${BUILD_DIR}/${MTF_DIAG_EXE_NAME}
+tst: ${BUILD_DIR}/${MTF_TEST_EXE_NAME}
 gt: ${BUILD_DIR}/${MTF_GT_EXE_NAME}
 patch: ${BUILD_DIR}/${MTF_PATCH_EXE_NAME}
 rec: ${BUILD_DIR}/${MTF_REC_EXE_NAME}
@@ -245,6 +251,8 @@ mtfc: all
 
 run: install_exe
 	${MTF_EXE_NAME}
+check: tst
+	${BUILD_DIR}/${MTF_TEST_EXE_NAME}
 ${MTF_EXEC_INSTALL_DIR}/${MTF_EXE_NAME}: ${BUILD_DIR}/${MTF_EXE_NAME}
 	${MTF_EXE_INSTALL_CMD_PREFIX} ${CP_CMD} $< $@	
 ${MTF_EXEC_INSTALL_DIR}/${MTF_UAV_EXE_NAME}: ${BUILD_DIR}/${MTF_UAV_EXE_NAME}
@@ -276,6 +284,7 @@ ${MTF_DIAG_INSTALL_DIR}/${MTF_DIAG_EXE_NAME}: ${BUILD_DIR}/${MTF_DIAG_EXE_NAME}
 ${BUILD_DIR}/${MTF_EXE_NAME}: | ${BUILD_DIR}	
 ${BUILD_DIR}/${MTF_PY_LIB_NAME}: | ${BUILD_DIR}	
 ${BUILD_DIR}/${MTF_DIAG_EXE_NAME}: | ${BUILD_DIR}
+${BUILD_DIR}/${MTF_TEST_EXE_NAME}: | ${BUILD_DIR}
 ${BUILD_DIR}/${MTF_REC_EXE_NAME}: | ${BUILD_DIR}
 ${BUILD_DIR}/${MTF_UAV_EXE_NAME}: | ${BUILD_DIR}	
 ${BUILD_DIR}/${MTF_GT_EXE_NAME}: | ${BUILD_DIR}	
@@ -326,6 +335,9 @@ ${BUILD_DIR}/${MTF_MOS_EXE_NAME}: ${EXAMPLES_SRC_DIR}/createMosaic.cc ${MTF_HEAD
 ${BUILD_DIR}/${MTF_DIAG_EXE_NAME}: ${EXAMPLES_SRC_DIR}/diagnoseMTF.cc ${TEST_HEADERS} ${MTF_HEADERS}
 	${CXX} $< -o $@ -w ${WARNING_FLAGS} ${MTF_RUNTIME_FLAGS} ${MTF_INCLUDE_FLAGS} ${EXAMPLES_INCLUDE_FLAGS} ${OPENCV_FLAGS} ${MTF_LIB_LINK} ${LIBS} ${LIBS_PARALLEL} ${BOOST_LIBS} ${MTF_DIAG_LIBS} ${MTF_LIBS_DIRS} ${MTF_LIBS} ${OPENCV_LIBS} 
 	
+${BUILD_DIR}/${MTF_TEST_EXE_NAME}: ${EXAMPLES_SRC_DIR}/testMTF.cc ${MTF_HEADERS}
+	${CXX} $< -o $@ -w ${WARNING_FLAGS} ${MTF_RUNTIME_FLAGS} ${MTF_INCLUDE_FLAGS} ${EXAMPLES_INCLUDE_FLAGS} ${OPENCV_FLAGS} ${MTF_LIB_LINK} ${LIBS} ${BOOST_LIBS} ${LIBS_PARALLEL} ${MTF_LIBS_DIRS} ${MTF_LIBS} ${OPENCV_LIBS} 
+	
 ${BUILD_DIR}/${MTF_APP_EXE_NAME}: ${MTF_APP_SRC_DIR}/${app}.cc ${MTF_HEADERS}
 	${CXX}  $< -o $@ -w ${WARNING_FLAGS} ${MTF_RUNTIME_FLAGS} ${MTF_INCLUDE_FLAGS} ${EXAMPLES_INCLUDE_FLAGS} ${OPENCV_FLAGS} ${MTF_LIB_LINK} ${LIBS} ${BOOST_LIBS} ${LIBS_PARALLEL} ${MTF_LIBS_DIRS} ${MTF_LIBS} ${OPENCV_LIBS} 
 	
@@ -22,9 +22,7 @@ int main(int argc, char * argv[]) {
 
 	if(!readParams(argc, argv)){ return EXIT_FAILURE; }
 
-#ifdef ENABLE_PARALLEL
 	Eigen::initParallel();
-#endif
 	printf("*******************************\n");
 	printf("Using parameters:\n");
 	printf("n_trackers: %d\n", n_trackers);
@@ -58,9 +58,7 @@ static PyObject* create(PyObject* self, PyObject* args) {
 		PySys_WriteStdout("\n----pyMTF::create: Input arguments could not be parsed----\n\n");
 		return Py_BuildValue("i", 0);
 	}
-#ifdef USE_TBB
 	Eigen::initParallel();
-#endif
 	if(!config_root_dir){
 		config_root_dir = "../../Config";
 		PySys_WriteStdout("Using default configuration folder: %s\n", config_root_dir);
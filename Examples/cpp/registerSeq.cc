@@ -36,9 +36,7 @@ int main(int argc, char * argv[]) {
 
 	if(!readParams(argc, argv)){ return EXIT_FAILURE; }
 
-#ifdef ENABLE_PARALLEL
 	Eigen::initParallel();
-#endif
 
 	printf("*******************************\n");
 	printf("Using parameters:\n");
@@ -41,9 +41,7 @@ int main(int argc, char * argv[]) {
 
 	if(!readParams(argc, argv)){ return EXIT_FAILURE; }
 
-#ifdef ENABLE_PARALLEL
 	Eigen::initParallel();
-#endif
 	printf("*******************************\n");
 	printf("Using parameters:\n");
 	printf("n_trackers: %u\n", n_trackers);
@@ -144,6 +142,10 @@ int main(int argc, char * argv[]) {
 	FILE *multi_fid = nullptr;
 	vector<Tracker_> trackers(n_trackers);
 	vector<PreProc_> pre_procs(n_trackers);
+	//! image pyramids shared by all pyramidal trackers if this is enabled
+	mtf::ImagePyramidCache_ img_pyr_cache = mtf::getImagePyramidCache();
+	vector<cv::Mat> tracker_regions(n_trackers);
+	if(img_pyr_cache){ img_pyr_cache->update(input->getFrameID(), cv::Rect(), false); }
 	for(unsigned int tracker_id = 0; tracker_id < n_trackers; ++tracker_id) {
 		if(n_trackers > 1){ multi_fid = readTrackerParams(multi_fid); }
 		try{
@@ -203,6 +205,7 @@ int main(int argc, char * argv[]) {
 			}
 		}
 		try{
+			if(img_pyr_cache){ img_pyr_cache->update(input->getFrameID(), cv::Rect(), false); }
 			for(unsigned int tracker_id = 0; tracker_id < n_trackers; ++tracker_id) {
 				pre_procs[tracker_id]->update(input->getFrame(), input->getFrameID());
 				trackers[tracker_id]->setRegion(obj_utils.getGT(input->getFrameID()));
@@ -688,6 +691,20 @@ int main(int argc, char * argv[]) {
 				break;
 			}
 		}
+		if(img_pyr_cache){
+			/**
+			update all pre processors before any of the trackers so that the pyramids needed 
+			in this frame can be built together and only once;
+			their lower levels are only rebuilt around the regions tracked in the last frame
+			if pyr_cache_roi_margin is non negative
+			*/
+			for(unsigned int tracker_id = 0; tracker_id < n_trackers; ++tracker_id) {
+				pre_procs[tracker_id]->update(input->getFrame(), input->getFrameID());
+				tracker_regions[tracker_id] = trackers[tracker_id]->getRegion();
+			}
+			img_pyr_cache->update(input->getFrameID(),
+				mtf::utils::ImagePyramidCache::getBoundingBox(tracker_regions));
+		}
 		//! update trackers       
 		for(unsigned int tracker_id = 0; tracker_id < n_trackers; ++tracker_id) {
 			//! update pre processor
@@ -0,0 +1,1057 @@
+//! self checking tests of the library internals that need no input data or configuration files;
+//! runs all tests by default or only the ones whose names are passed as arguments;
+//! benchmarks are only run when named explicitly and always pass;
+//! float_jac_accuracy tracks the dataset sequence specified in the configuration files
+#include "mtf/AM/SSD.h"
+#include "mtf/AM/ZNCC.h"
+#include "mtf/AM/SAD.h"
+#include "mtf/AM/NCC.h"
+#include "mtf/AM/SSIM.h"
+#include "mtf/AM/SPSS.h"
+#include "mtf/SSM/Homography.h"
+#include "mtf/SSM/Translation.h"
+#include "mtf/SSM/IST.h"
+#include "mtf/SM/FCLK.h"
+#include "mtf/SM/ICLK.h"
+#include "mtf/SM/ESM.h"
+#include "mtf/SM/PF.h"
+#include "mtf/SM/GridTracker.h"
+#include "mtf/SM/GridTrackerBatch.h"
+#include "mtf/SM/RKLT.h"
+#include "mtf/Utilities/cacheUtils.h"
+#include "mtf/Utilities/histUtils.h"
+#include "mtf/Utilities/imgUtils.h"
+#include "mtf/Utilities/miscUtils.h"
+#include "mtf/Utilities/objUtils.h"
+#include "mtf/Utilities/rngUtils.h"
+#include "mtf/Utilities/simdUtils.h"
+
+#include "mtf/Config/parameters.h"
+
+#include "opencv2/core/core.hpp"
+#include "opencv2/imgproc/imgproc.hpp"
+#include "opencv2/highgui/highgui.hpp"
+#include <boost/random/mersenne_twister.hpp>
+#include <boost/random/seed_seq.hpp>
+#include "mtf/SM/GNN.h"
+#include "mtf/SM/HNSW.h"
+#ifndef DISABLE_FLANN
+#include <flann/flann.hpp>
+#endif
+
+#include <vector>
+#include <memory>
+#include <limits>
+#include <algorithm>
+#include <string>
+#include <fstream>
+#include <cstring>
+#include <cstdio>
+#include <cmath>
+#include <cstdlib>
+#include <exception>
+
+using namespace std;
+using namespace mtf;
+
+namespace{
+	typedef bool(*TestFuncT)();
+	struct TestCase{
+		const char *name;
+		TestFuncT func;
+		bool is_benchmark;
+	};
+
+	bool check(bool cond, const char *msg){
+		if(!cond){ printf("\t%s\n", msg); }
+		return cond;
+	}
+	//! n_pts x n_pts grid of points spanning [min_coord, max_coord] in both directions
+	Matrix2Xd getGridPts(int n_pts, double min_coord, double max_coord){
+		Matrix2Xd pts(2, n_pts*n_pts);
+		double step = (max_coord - min_coord) / (n_pts - 1);
+		for(int y_id = 0; y_id < n_pts; ++y_id){
+			for(int x_id = 0; x_id < n_pts; ++x_id){
+				pts(0, y_id*n_pts + x_id) = min_coord + x_id*step;
+				pts(1, y_id*n_pts + x_id) = min_coord + y_id*step;
+			}
+		}
+		return pts;
+	}
+	template<typename FuncT>
+	void fillImg(cv::Mat &img, FuncT func){
+		for(int y = 0; y < img.rows; ++y){
+			for(int x = 0; x < img.cols; ++x){
+				img.at<float>(y, x) = static_cast<float>(func(x, y));
+			}
+		}
+	}
+	void updatePixDiff(SSD &am, const Matrix2Xd &pts){
+		am.setFirstIter();
+		am.updatePixVals(pts);
+		am.updatePixGrad(pts);
+		am.updatePixHess(pts);
+	}
+	/**
+	the input pipeline overwrites the same frame buffer with each new frame so the derivatives
+	cached by the AM must be recomputed on each frame even though setCurrImg is not called again
+	*/
+	bool testImgDerivCache(){
+		cv::Mat img(64, 64, CV_32FC1);
+		fillImg(img, [](int x, int y){ return 2 * x + 3 * y; });
+		Matrix2Xd pts = getGridPts(10, 20, 40);
+
+		AMParams am_params(10, 10);
+		am_params.img_deriv_cache = true;
+		SSDParams ssd_params(&am_params, false);
+		SSD am(&ssd_params);
+		am.setCurrImg(img);
+		am.initializePixVals(pts);
+		am.initializePixGrad(pts);
+		am.initializePixHess(pts);
+		updatePixDiff(am, pts);
+		PixGradT first_grad = am.getCurrPixGrad();
+		PixHessT first_hess = am.getCurrPixHess();
+
+		fillImg(img, [](int x, int y){ return 0.1 * x * y + sin(0.3 * x); });
+		updatePixDiff(am, pts);
+
+		//! AM that sees the second frame from the start
+		SSD ref_am(&ssd_params);
+		ref_am.setCurrImg(img);
+		ref_am.initializePixVals(pts);
+		ref_am.initializePixGrad(pts);
+		ref_am.initializePixHess(pts);
+		updatePixDiff(ref_am, pts);
+
+		bool passed = check((am.getCurrPixGrad() - first_grad).norm() > 1e-3,
+			"gradient did not change with the image");
+		passed = check((am.getCurrPixHess() - first_hess).norm() > 1e-3,
+			"Hessian did not change with the image") && passed;
+		passed = check((am.getCurrPixGrad() - ref_am.getCurrPixGrad()).norm() < 1e-10,
+			"gradient differs from that of an AM initialized on the new image") && passed;
+		passed = check((am.getCurrPixHess() - ref_am.getCurrPixHess()).norm() < 1e-10,
+			"Hessian differs from that of an AM initialized on the new image") && passed;
+		return passed;
+	}
+	/**
+	the interpolated BSpline lookup tables used by MI and CCRE must stay within their error bound
+	of the exact functions for all table sizes while the exact mode must match them exactly
+	*/
+	bool testBSpl3LUT(){
+		bool passed = true;
+		for(unsigned int n_steps : { 0, 1, 8, 64, 1024 }){
+			utils::BSpl3LUT bspl_lut;
+			bspl_lut.resize(n_steps);
+			const double max_diff = utils::validateBSpl3LUT(bspl_lut);
+			passed = check(max_diff <= bspl_lut.getMaxError() + 1e-14,
+				"lookup table error exceeds its bound") && passed;
+		}
+		return passed;
+	}
+	/**
+	the histograms accumulated in parallel by SCV, RSCV and KLD must match those computed serially
+	*/
+	bool testParallelJointHist(){
+		const int n_bins = 8, n_pix = 1000;
+		//! pixel values in [0, n_bins - 1)
+		VectorXd pix_vals1 = (VectorXd::Random(n_pix).array() + 1) * (n_bins - 1.01) / 2;
+		VectorXd pix_vals2 = (VectorXd::Random(n_pix).array() + 1) * (n_bins - 1.01) / 2;
+		const double pre_seed = 0.1, hist_pre_seed = n_bins*pre_seed;
+
+		utils::TaskArena task_arena(4);
+		utils::ParallelHist hist_accum;
+		hist_accum.resize(n_bins*(n_bins + 2), 4);
+		MatrixXd joint_hist(n_bins, n_bins), par_joint_hist(n_bins, n_bins);
+		VectorXd hist1(n_bins), hist2(n_bins), par_hist1(n_bins), par_hist2(n_bins);
+
+		utils::getDiracJointHist(joint_hist, hist1, hist2, pix_vals1, pix_vals2,
+			hist_pre_seed, pre_seed, n_pix, n_bins);
+		utils::getDiracJointHist(par_joint_hist, par_hist1, par_hist2, pix_vals1, pix_vals2,
+			hist_pre_seed, pre_seed, n_pix, n_bins, hist_accum, &task_arena);
+		bool passed = check((joint_hist - par_joint_hist).norm() + (hist1 - par_hist1).norm() +
+			(hist2 - par_hist2).norm() < 1e-10, "Dirac histograms differ");
+
+		utils::getBilinearJointHist(joint_hist, hist1, hist2, pix_vals1, pix_vals2,
+			hist_pre_seed, pre_seed, n_pix, n_bins);
+		utils::getBilinearJointHist(par_joint_hist, par_hist1, par_hist2, pix_vals1, pix_vals2,
+			hist_pre_seed, pre_seed, n_pix, n_bins, hist_accum, &task_arena);
+		passed = check((joint_hist - par_joint_hist).norm() + (hist1 - par_hist1).norm() +
+			(hist2 - par_hist2).norm() < 1e-10, "bilinear histograms differ") && passed;
+
+		MatrixX2i std_bspl_ids(n_bins, 2);
+		for(int bin_id = 0; bin_id < n_bins; ++bin_id){
+			std_bspl_ids(bin_id, 0) = std::max(0, bin_id - 1);
+			std_bspl_ids(bin_id, 1) = std::min(n_bins - 1, bin_id + 2);
+		}
+		MatrixXd hist1_mat(n_bins, n_pix), par_hist1_mat(n_bins, n_pix), hist2_mat(n_bins, n_pix);
+		MatrixX2i bspl_ids1(n_pix, 2), par_bspl_ids1(n_pix, 2), bspl_ids2(n_pix, 2);
+		utils::getBSplHist(hist2, hist2_mat, bspl_ids2, pix_vals2, std_bspl_ids, hist_pre_seed, n_pix);
+		utils::getBSplJointHist(joint_hist, hist1, hist1_mat, bspl_ids1, pix_vals1, bspl_ids2,
+			hist2_mat, std_bspl_ids, hist_pre_seed, pre_seed, n_pix);
+		hist_accum.resize(n_bins*(n_bins + 1), 4);
+		utils::getBSplJointHist(par_joint_hist, par_hist1, par_hist1_mat, par_bspl_ids1, pix_vals1, bspl_ids2,
+			hist2_mat, std_bspl_ids, hist_pre_seed, pre_seed, n_pix, hist_accum, &task_arena);
+		passed = check((joint_hist - par_joint_hist).norm() + (hist1 - par_hist1).norm() +
+			(hist1_mat - par_hist1_mat).norm() < 1e-10 && bspl_ids1 == par_bspl_ids1,
+			"BSpline histograms differ") && passed;
+
+		MatrixXd hist1_grad(n_bins, n_pix), par_hist1_grad(n_bins, n_pix);
+		const double hist_norm_mult = 1.0 / (n_pix + hist_pre_seed);
+		utils::getBSplHistWithGrad(hist1, hist1_mat, hist1_grad, bspl_ids1, pix_vals1,
+			std_bspl_ids, pre_seed, n_pix, hist_norm_mult);
+		hist_accum.resize(n_bins, 4);
+		utils::getBSplHistWithGrad(par_hist1, par_hist1_mat, par_hist1_grad, par_bspl_ids1, pix_vals1,
+			std_bspl_ids, pre_seed, n_pix, hist_norm_mult, hist_accum, &task_arena);
+		passed = check((hist1 - par_hist1).norm() + (hist1_mat - par_hist1_mat).norm() +
+			(hist1_grad - par_hist1_grad).norm() < 1e-10, "BSpline histogram gradients differ") && passed;
+		return passed;
+	}
+	/**
+	the fused fetch of the pixel values and their derivatives must give exactly the same results as
+	fetching them separately for all the instruction sets, including points near and beyond the border
+	*/
+	bool testFusedPixFetch(){
+		const unsigned int h = 48, w = 64, n_pix = 11 * 11;
+		EigImgMat img_data = EigImgMat::Random(h, w);
+		img_data = (img_data.array() + 1) * 127.5f;
+		EigImgT img(img_data.data(), h, w);
+		Matrix2Xd pts = getGridPts(11, -1.5, 50.3);
+		const double grad_eps = 1e-8, hess_eps = 1, norm_mult = 1.0 / 255, norm_add = 0.5;
+
+		VectorXd pix_vals(n_pix), fused_pix_vals(n_pix);
+		PixGradT img_grad(n_pix, 2), fused_img_grad(n_pix, 2);
+		PixHessT img_hess(4, n_pix), fused_img_hess(4, n_pix);
+		bool passed = true;
+		utils::simd::ISA supported_isa = utils::simd::getSupportedISA();
+		for(int isa_id = 0; isa_id <= static_cast<int>(supported_isa); ++isa_id){
+			utils::simd::ISA isa = utils::simd::setActiveISA(static_cast<utils::simd::ISA>(isa_id));
+			utils::getPixVals(pix_vals, img, pts, n_pix, h, w, norm_mult, norm_add);
+			utils::getImgGrad(img_grad, img, pts, grad_eps, n_pix, h, w, norm_mult);
+			utils::getImgHess(img_hess, img, pts, hess_eps, n_pix, h, w, norm_mult);
+
+			utils::getPixValsGradHess(fused_pix_vals, &fused_img_grad, &fused_img_hess, img, pts,
+				grad_eps, hess_eps, n_pix, h, w, norm_mult, norm_add);
+			bool isa_passed = check(fused_pix_vals == pix_vals, "pixel values differ");
+			isa_passed = check(fused_img_grad == img_grad, "gradients differ") && isa_passed;
+			isa_passed = check(fused_img_hess == img_hess, "Hessians differ") && isa_passed;
+
+			fused_img_grad.setZero();
+			utils::getPixValsGradHess(fused_pix_vals, &fused_img_grad, nullptr, img, pts,
+				grad_eps, hess_eps, n_pix, h, w, norm_mult, norm_add);
+			isa_passed = check(fused_pix_vals == pix_vals && fused_img_grad == img_grad,
+				"values or gradients differ without the Hessian") && isa_passed;
+
+			fused_pix_vals.setZero();
+			utils::getPixValsGradHess(fused_pix_vals, nullptr, nullptr, img, pts,
+				grad_eps, hess_eps, n_pix, h, w, norm_mult, norm_add);
+			isa_passed = check(fused_pix_vals == pix_vals, "values differ without derivatives") && isa_passed;
+			if(!isa_passed){ printf("\twith ISA: %s\n", utils::simd::toString(isa)); }
+			passed = isa_passed && passed;
+		}
+		utils::simd::setActiveISA(supported_isa);
+		return passed;
+	}
+	//! textured pattern shifted by (shift_x, shift_y) pixels
+	void fillShiftedPattern(cv::Mat &img, double shift_x, double shift_y){
+		fillImg(img, [&](int x, int y){
+			double sx = x - shift_x, sy = y - shift_y;
+			return 128 + 60 * sin(0.25*sx)*cos(0.2*sy) + 30 * sin(0.11*(sx + sy));
+		});
+	}
+	//! square object of the given size in the middle of the frames written by fillShiftedPattern
+	cv::Mat getObjectCorners(int img_size = 128, int obj_size = 40){
+		const double min_coord = (img_size - obj_size) / 2, max_coord = min_coord + obj_size;
+		cv::Mat corners(2, 4, CV_64FC1);
+		corners.at<double>(0, 0) = min_coord; corners.at<double>(1, 0) = min_coord;
+		corners.at<double>(0, 1) = max_coord; corners.at<double>(1, 1) = min_coord;
+		corners.at<double>(0, 2) = max_coord; corners.at<double>(1, 2) = max_coord;
+		corners.at<double>(0, 3) = min_coord; corners.at<double>(1, 3) = max_coord;
+		return corners;
+	}
+	/**
+	the patches warped and sampled for many states at once by the batched SSM and AM functions used by PF
+	must match those obtained by setting each state in turn; states whose warp is affine are warped
+	by a different code path than projective ones so both are included
+	*/
+	bool testBatchWarpSampling(){
+		cv::Mat img(128, 128, CV_32FC1);
+		fillImg(img, [](int x, int y){ return 128 + 60 * sin(0.25*x)*cos(0.2*y) + 30 * sin(0.11*(x + y)); });
+		SSMParams ssm_params(24, 24);
+		HomographyParams hom_params(&ssm_params, false, false, false);
+		Homography ssm(&hom_params);
+		ssm.initialize(getObjectCorners());
+		AMParams am_params(24, 24);
+		SSDParams ssd_params(&am_params, false);
+		SSD am(&ssd_params);
+		am.setCurrImg(img);
+		am.initializePixVals(ssm.getPts());
+
+		const int n_states = 6, n_pts = ssm.getNPts();
+		MatrixXd states = 0.05*MatrixXd::Random(ssm.getStateSize(), n_states);
+		states.col(0).setZero();
+		states.col(1).tail<2>().setZero();
+		states.rightCols(n_states - 2).bottomRows<2>() *= 1e-3;
+		Matrix2Xd pts_batch(2, n_states*n_pts);
+		MatrixXdr pix_vals_batch(n_states, am.getPatchSize());
+		ssm.getPtsBatch(pts_batch, states);
+		am.updatePixValsBatch(pix_vals_batch, pts_batch);
+
+		bool passed = check(ssm.supportsWarpBatch() && am.supportsPixValsBatch(),
+			"SSD and homography do not support batched warping and sampling");
+		VectorXd state(ssm.getStateSize());
+		for(int state_id = 0; state_id < n_states; ++state_id){
+			state = states.col(state_id);
+			ssm.setState(state);
+			const auto warped_pts = pts_batch.middleCols(state_id*n_pts, n_pts);
+			bool state_passed = check((warped_pts - ssm.getPts()).cwiseAbs().maxCoeff() < 1e-9,
+				"batched points differ from those of setState");
+			am.updatePixVals(warped_pts);
+			state_passed = check(pix_vals_batch.row(state_id).transpose() == am.getCurrPixVals(),
+				"batched pixel values differ from those of updatePixVals") && state_passed;
+			am.updatePixVals(ssm.getPts());
+			state_passed = check((pix_vals_batch.row(state_id).transpose() - am.getCurrPixVals()).cwiseAbs().maxCoeff() < 1e-6,
+				"batched pixel values differ from those at the points of setState") && state_passed;
+			if(!state_passed){ printf("	for state %d\n", state_id); }
+			passed = state_passed && passed;
+		}
+		return passed;
+	}
+	const double obj_shift_x = 0.6, obj_shift_y = 0.4;
+	const int n_track_frames = 5;
+	/**
+	runs a few updates of the given SM with SSD and homography while the object moves across frames
+	that are written into the same buffer and returns the final corners;
+	if MTF is compiled with alloc_check=1, any heap allocation by Eigen after the first update fails an
+	assertion so this also checks that the SM and the SSD AM do not allocate in their steady state
+	*/
+	template<class SMType>
+	cv::Mat trackShiftedPattern(typename SMType::ParamType &sm_params, const AMParams &am_params){
+		cv::Mat img(128, 128, CV_32FC1);
+		fillShiftedPattern(img, 0, 0);
+		SSDParams ssd_params(&am_params, false);
+		SSMParams ssm_params(24, 24);
+		HomographyParams hom_params(&ssm_params, false, false, false);
+		SMType sm(&sm_params, &ssd_params, &hom_params);
+		sm.setImage(img);
+		sm.initialize(getObjectCorners());
+		for(int frame_id = 1; frame_id <= n_track_frames; ++frame_id){
+			fillShiftedPattern(img, frame_id*obj_shift_x, frame_id*obj_shift_y);
+			sm.update();
+		}
+		return sm.getRegion().clone();
+	}
+	//! the tracked corners are only checked against the true ones if check_corners is true since PF is stochastic
+	template<class SMType>
+	bool runSMUpdates(typename SMType::ParamType &sm_params, const char *sm_name, bool check_corners){
+		const cv::Mat corners = getObjectCorners();
+		const cv::Mat region = trackShiftedPattern<SMType>(sm_params, AMParams(24, 24));
+		bool passed = true;
+		for(int corner_id = 0; corner_id < 4; ++corner_id){
+			double err_x = region.at<double>(0, corner_id) - corners.at<double>(0, corner_id) - n_track_frames*obj_shift_x;
+			double err_y = region.at<double>(1, corner_id) - corners.at<double>(1, corner_id) - n_track_frames*obj_shift_y;
+			if(!std::isfinite(err_x) || !std::isfinite(err_y)){
+				passed = check(false, "tracked corners are not finite");
+			} else if(check_corners && err_x*err_x + err_y*err_y > 0.25){
+				passed = check(false, "tracked corners are too far from the true ones");
+			}
+		}
+		if(!passed){ printf("\twith %s\n", sm_name); }
+		return passed;
+	}
+	bool testSMAllocCheck(){
+		FCLKParams fclk_params;
+		ICLKParams iclk_params;
+		ESMParams esm_params;
+		PFParams pf_params;
+		pf_params.pix_sigma = { 1 };
+		bool passed = runSMUpdates<FCLK<SSD, Homography> >(fclk_params, "FCLK", true);
+		passed = runSMUpdates<ICLK<SSD, Homography> >(iclk_params, "ICLK", true) && passed;
+		passed = runSMUpdates<ESM<SSD, Homography> >(esm_params, "ESM", true) && passed;
+		passed = runSMUpdates<PF<SSD, Homography> >(pf_params, "PF", false) && passed;
+		return passed;
+	}
+	//! corners tracked with float_jac enabled and disabled
+	double getMaxCornerDiff(const cv::Mat &corners1, const cv::Mat &corners2){
+		double max_diff = 0;
+		for(int corner_id = 0; corner_id < 4; ++corner_id){
+			for(int coord_id = 0; coord_id < 2; ++coord_id){
+				max_diff = std::max(max_diff, std::abs(corners1.at<double>(coord_id, corner_id) -
+					corners2.at<double>(coord_id, corner_id)));
+			}
+		}
+		return max_diff;
+	}
+	template<class SMType>
+	double getFloatJacobianTrackingDiff(typename SMType::ParamType &sm_params){
+		AMParams am_params(24, 24), float_am_params(24, 24);
+		float_am_params.float_jac = true;
+		const cv::Mat region = trackShiftedPattern<SMType>(sm_params, am_params);
+		const cv::Mat float_region = trackShiftedPattern<SMType>(sm_params, float_am_params);
+		return getMaxCornerDiff(region, float_region);
+	}
+	/**
+	compares the first order Hessian and the Jacobian computed from single precision pixel Jacobians
+	with the ones computed from the same Jacobians in double precision, both for the
+	product kernels with the state sizes of all the SSMs and for the corners tracked by the SMs that use them;
+	the Jacobian columns are scaled as with an unnormalized homography whose last two parameters
+	have much larger derivatives than the first ones
+	*/
+	bool testFloatJacobian(){
+		const int n_pix = 24 * 24 + 7;
+		bool passed = true;
+		for(int state_size : { 2, 3, 4, 5, 6, 7, 8 }){
+			VectorXd col_scale = VectorXd::LinSpaced(state_size, 0, 4);
+			MatrixXf float_jacobian = (MatrixXd::Random(n_pix, state_size) *
+				Eigen::pow(10.0, col_scale.array()).matrix().asDiagonal()).cast<float>();
+			MatrixXd jacobian = float_jacobian.cast<double>();
+			MatrixXd jac_prod(state_size, state_size), float_jac_prod(state_size, state_size);
+			utils::getJacobianProduct(jac_prod, jacobian, -1);
+			utils::getJacobianProduct(float_jac_prod, float_jacobian, -1);
+			// the error relative to the magnitudes of the two columns that each entry depends on
+			MatrixXd rel_err = (float_jac_prod - jac_prod).cwiseAbs().array() /
+				(jac_prod.diagonal().cwiseAbs().cwiseSqrt() * jac_prod.diagonal().cwiseAbs().cwiseSqrt().transpose()).array();
+			if(!check(rel_err.maxCoeff() < 1e-5, "single precision Jacobian product is not accurate enough")){
+				printf("\twith %d parameters: %g\n", state_size, rel_err.maxCoeff());
+				passed = false;
+			}
+			RowVectorXd vec = RowVectorXd::Random(n_pix);
+			RowVectorXd vec_prod = vec*jacobian, float_vec_prod(state_size);
+			utils::getJacobianVecProduct(float_vec_prod, vec, float_jacobian);
+			RowVectorXd vec_rel_err = (float_vec_prod - vec_prod).cwiseAbs().array() /
+				(vec.norm()*jacobian.colwise().norm()).array();
+			if(!check(vec_rel_err.maxCoeff() < 1e-5, "single precision Jacobian vector product is not accurate enough")){
+				printf("\twith %d parameters: %g\n", state_size, vec_rel_err.maxCoeff());
+				passed = false;
+			}
+		}
+		FCLKParams fclk_params;
+		ICLKParams iclk_params;
+		ESMParams esm_params;
+		const double fclk_diff = getFloatJacobianTrackingDiff<FCLK<SSD, Homography> >(fclk_params);
+		const double iclk_diff = getFloatJacobianTrackingDiff<ICLK<SSD, Homography> >(iclk_params);
+		const double esm_diff = getFloatJacobianTrackingDiff<ESM<SSD, Homography> >(esm_params);
+		printf("\tmax corner difference with float_jac: FCLK: %g ICLK: %g ESM: %g\n",
+			fclk_diff, iclk_diff, esm_diff);
+		passed = check(fclk_diff < 1e-2 && iclk_diff < 1e-2 && esm_diff < 1e-2,
+			"corners tracked with float_jac differ from the double precision ones") && passed;
+		return passed;
+	}
+	//! frames of the dataset sequence specified in the configuration files preprocessed as in runMTF
+	bool readDatasetFrame(cv::Mat &frame, int frame_id){
+		cv::Mat raw_frame = cv::imread(cv::format("%s/%s/frame%05d.%s", params::seq_path.c_str(),
+			params::seq_name.c_str(), frame_id + 1, params::seq_fmt.c_str()), 0);
+		if(raw_frame.empty()){ return false; }
+		raw_frame.convertTo(frame, CV_32FC1);
+		cv::GaussianBlur(frame, frame, cv::Size(params::gauss_kernel_size, params::gauss_kernel_size),
+			params::gauss_sigma_x, params::gauss_sigma_y);
+		return true;
+	}
+	/**
+	tracks the dataset sequence with SSD and homography and prints the mean and maximum corner error
+	w.r.t. the ground truth, the no. of failures where the error exceeds 20 pixels and the tracker
+	is reinitialized on the ground truth, and the mean FPS
+	*/
+	template<class SMType>
+	void trackDatasetSequence(typename SMType::ParamType &sm_params, bool float_jac,
+		const vector<cv::Mat> &gt, const char *sm_name){
+		AMParams am_params(params::resx, params::resy);
+		am_params.float_jac = float_jac;
+		SSDParams ssd_params(&am_params, false);
+		SSMParams ssm_params(params::resx, params::resy);
+		HomographyParams hom_params(&ssm_params, false, false, false);
+		SMType sm(&sm_params, &ssd_params, &hom_params);
+		cv::Mat frame;
+		readDatasetFrame(frame, 0);
+		sm.setImage(frame);
+		sm.initialize(gt[0]);
+		double mean_err = 0, max_err = 0, track_time = 0, elapsed_time;
+		int n_failures = 0, n_tracked = 0;
+		for(int frame_id = 1; frame_id < static_cast<int>(gt.size()); ++frame_id){
+			if(!readDatasetFrame(frame, frame_id)){ break; }
+			mtf_clock_get(start_time);
+			sm.update();
+			mtf_clock_get(end_time);
+			mtf_clock_measure(start_time, end_time, elapsed_time);
+			track_time += elapsed_time;
+			++n_tracked;
+			double err = utils::getTrackingError<utils::TrackErrT::MCD>(gt[frame_id], sm.getRegion());
+			if(!std::isfinite(err) || err > 20){
+				++n_failures;
+				sm.initialize(gt[frame_id]);
+				continue;
+			}
+			mean_err += err;
+			max_err = std::max(max_err, err);
+		}
+		mean_err /= std::max(n_tracked - n_failures, 1);
+		printf("\t%s float_jac: %d mean error: %8.5f max error: %8.4f failures: %3d fps: %8.2f\n",
+			sm_name, float_jac, mean_err, max_err, n_failures, n_tracked / track_time);
+	}
+	/**
+	accuracy of tracking with single precision pixel Jacobians compared to double precision ones
+	on the dataset sequence specified in the configuration files (actor_id, seq_id, db_root_path etc.);
+	prints a message and passes if the sequence or its ground truth cannot be read
+	*/
+	bool benchmarkFloatJacobianAccuracy(){
+		if(!params::readParams(0, nullptr)){ return true; }
+		utils::ObjUtils obj_utils;
+		cv::Mat frame;
+		if(!readDatasetFrame(frame, 0) || !obj_utils.readGT(params::seq_name, params::seq_path, 0)){
+			printf("\tsequence %s/%s could not be read\n", params::seq_path.c_str(), params::seq_name.c_str());
+			return true;
+		}
+		printf("\tsequence: %s with %d frames\n", params::seq_name.c_str(), obj_utils.getGTSize());
+		for(bool float_jac : { false, true }){
+			FCLKParams fclk_params;
+			ICLKParams iclk_params;
+			ESMParams esm_params;
+			trackDatasetSequence<FCLK<SSD, Homography> >(fclk_params, float_jac, obj_utils.getGT(), "FCLK");
+			trackDatasetSequence<ICLK<SSD, Homography> >(iclk_params, float_jac, obj_utils.getGT(), "ICLK");
+			trackDatasetSequence<ESM<SSD, Homography> >(esm_params, float_jac, obj_utils.getGT(), "ESM");
+		}
+		return true;
+	}
+	//! tracks the shifted pattern for n_frames and returns the final corners along with the mean time per frame
+	cv::Mat trackShiftedPatternTimed(TrackerBase &tracker, cv::Mat &img, const cv::Mat &corners,
+		int n_frames, double &frame_time){
+		fillShiftedPattern(img, 0, 0);
+		tracker.setImage(img);
+		tracker.initialize(corners);
+		frame_time = 0;
+		double elapsed_time;
+		for(int frame_id = 1; frame_id <= n_frames; ++frame_id){
+			fillShiftedPattern(img, frame_id*obj_shift_x, frame_id*obj_shift_y);
+			mtf_clock_get(start_time);
+			tracker.update();
+			mtf_clock_get(end_time);
+			mtf_clock_measure(start_time, end_time, elapsed_time);
+			frame_time += elapsed_time;
+		}
+		frame_time /= n_frames;
+		return tracker.getRegion().clone();
+	}
+	/**
+	tracks the shifted pattern with GridTracker using ICLK patch trackers with SSD and PatchSSM
+	and with GridTrackerBatch using the corresponding patch SSM; both use translation as the
+	global SSM; returns the maximum difference between the final corners of the two
+	*/
+	template<class PatchSSM>
+	double getGridTrackerBatchDiff(GridTrackerBatchParams::SSMType ssm_type, int img_size, int obj_size,
+		int grid_size, int patch_size, int n_frames, double &grid_frame_time, double &batch_frame_time){
+		const int max_iters = 30;
+		const double epsilon = 1e-6;
+		cv::Mat img(img_size, img_size, CV_32FC1);
+		const cv::Mat corners = getObjectCorners(img_size, obj_size);
+		SSMParams ssm_params(grid_size + 1, grid_size + 1);
+		mtf::TranslationParams trans_params(&ssm_params, false);
+		SSMEstimatorParams est_params;
+		// the translation is estimated directly rather than with the OpenCV based RANSAC estimator
+		est_params.max_iters = 0;
+
+		ICLKParams iclk_params;
+		iclk_params.max_iters = max_iters;
+		iclk_params.epsilon = epsilon;
+		iclk_params.leven_marq = false;
+		iclk_params.hess_type = ICLKParams::HessType::InitialSelf;
+		AMParams patch_am_params(patch_size, patch_size);
+		SSDParams patch_ssd_params(&patch_am_params, false);
+		SSMParams patch_ssm_params(patch_size, patch_size);
+		typename PatchSSM::ParamType patch_params(&patch_ssm_params, false);
+		vector<TrackerBase*> patch_trackers;
+		for(int patch_id = 0; patch_id < grid_size*grid_size; ++patch_id){
+			patch_trackers.push_back(new ICLK<SSD, PatchSSM>(&iclk_params, &patch_ssd_params, &patch_params));
+		}
+		GridTrackerParams grid_params(grid_size, grid_size, patch_size, patch_size, 1, false, true,
+			0, false, 1, max_iters, epsilon, false, false, false, false);
+		TrackerBase *grid_tracker = new GridTracker<mtf::Translation>(patch_trackers,
+			&grid_params, &est_params, &trans_params);
+		const cv::Mat grid_corners = trackShiftedPatternTimed(*grid_tracker, img, corners,
+			n_frames, grid_frame_time);
+		delete(grid_tracker);
+		for(TrackerBase *patch_tracker : patch_trackers){ delete(patch_tracker); }
+
+		GridTrackerBatchParams batch_params(grid_size, grid_size, patch_size, patch_size, 0, 0,
+			GridTrackerBatchParams::AMType::SSD, ssm_type, 1, true, max_iters, epsilon, false, false);
+		TrackerBase *batch_tracker = new GridTrackerBatch<mtf::Translation>(&batch_params,
+			&est_params, &trans_params);
+		const cv::Mat batch_corners = trackShiftedPatternTimed(*batch_tracker, img, corners,
+			n_frames, batch_frame_time);
+		delete(batch_tracker);
+		return getMaxCornerDiff(grid_corners, batch_corners);
+	}
+	/**
+	GridTrackerBatch must give the same results as GridTracker with ICLK patch trackers using SSD
+	since both sample the patches and their gradients in the same way and run the same Gauss Newton
+	iterations with the same convergence check; the IST SSM scales about the image origin while
+	GridTrackerBatch scales about the patch center so only their converged locations are the same;
+	RKLT must also work with GridTrackerBatch as its grid tracker
+	*/
+	bool testGridTrackerBatch(){
+		double grid_frame_time, batch_frame_time;
+		const double trans_diff = getGridTrackerBatchDiff<mtf::Translation>(GridTrackerBatchParams::SSMType::Translation,
+			128, 40, 4, 8, n_track_frames, grid_frame_time, batch_frame_time);
+		const double ist_diff = getGridTrackerBatchDiff<mtf::IST>(GridTrackerBatchParams::SSMType::IST,
+			128, 40, 4, 8, n_track_frames, grid_frame_time, batch_frame_time);
+		printf("\tmax corner difference from GridTracker: translation: %g IST: %g\n", trans_diff, ist_diff);
+		bool passed = check(trans_diff < 1e-4 && ist_diff < 1e-4,
+			"corners tracked by GridTrackerBatch differ from those tracked by GridTracker");
+
+		// the sampling resolution of the RKLT template tracker must be the same as the grid size
+		const int grid_size = 12, patch_size = 6;
+		cv::Mat img(128, 128, CV_32FC1);
+		SSMParams ssm_params(grid_size + 1, grid_size + 1);
+		mtf::TranslationParams trans_params(&ssm_params, false);
+		SSMEstimatorParams est_params;
+		est_params.max_iters = 0;
+		GridTrackerBatchParams batch_params(grid_size, grid_size, patch_size, patch_size, 0, 0,
+			GridTrackerBatchParams::AMType::SSD, GridTrackerBatchParams::SSMType::Translation,
+			1, true, 30, 1e-6, false, false);
+		ICLKParams iclk_params;
+		AMParams am_params(grid_size, grid_size);
+		SSDParams ssd_params(&am_params, false);
+		SSMParams templ_ssm_params(grid_size, grid_size);
+		TranslationParams templ_trans_params(&templ_ssm_params, false);
+		RKLTParams rklt_params;
+		// RKLT deletes its grid and template trackers
+		TrackerBase *rklt = new RKLT<SSD, mtf::Translation>(&rklt_params,
+			new GridTrackerBatch<mtf::Translation>(&batch_params, &est_params, &trans_params),
+			new ICLK<SSD, mtf::Translation>(&iclk_params, &ssd_params, &templ_trans_params));
+		double rklt_frame_time;
+		cv::Mat corners = getObjectCorners();
+		const cv::Mat region = trackShiftedPatternTimed(*rklt, img, corners, n_track_frames, rklt_frame_time);
+		delete(rklt);
+		corners.row(0) += n_track_frames*obj_shift_x;
+		corners.row(1) += n_track_frames*obj_shift_y;
+		const double rklt_err = getMaxCornerDiff(region, corners);
+		printf("\tmax corner error of RKLT with GridTrackerBatch: %g\n", rklt_err);
+		return check(rklt_err < 1e-2, "RKLT with GridTrackerBatch did not track the object") && passed;
+	}
+	/**
+	speed of GridTrackerBatch compared to GridTracker with ICLK patch trackers running on a single thread
+	for the default grid and patch sizes; always passes
+	*/
+	bool benchmarkGridTrackerBatch(){
+		const int n_frames = 50;
+		for(int grid_size : { 5, 10, 20 }){
+			double grid_frame_time, batch_frame_time;
+			double diff = getGridTrackerBatchDiff<mtf::Translation>(GridTrackerBatchParams::SSMType::Translation,
+				640, 400, grid_size, 10, n_frames, grid_frame_time, batch_frame_time);
+			printf("\t%2d x %2d translation: GridTracker: %8.2f fps GridTrackerBatch: %8.2f fps corner difference: %g\n",
+				grid_size, grid_size, 1.0 / grid_frame_time, 1.0 / batch_frame_time, diff);
+			diff = getGridTrackerBatchDiff<mtf::IST>(GridTrackerBatchParams::SSMType::IST,
+				640, 400, grid_size, 10, n_frames, grid_frame_time, batch_frame_time);
+			printf("\t%2d x %2d IST:         GridTracker: %8.2f fps GridTrackerBatch: %8.2f fps corner difference: %g\n",
+				grid_size, grid_size, 1.0 / grid_frame_time, 1.0 / batch_frame_time, diff);
+		}
+		return true;
+	}
+
+	/**
+	the SSM samplers must keep producing the same sequence as their default generator
+	unless a stream is selected after which they must match the Philox stream exactly
+	*/
+	bool testSamplerGen(){
+		const int n_vals = 1000;
+		boost::random::seed_seq seed_seq{ 1, 2, 3, 4 }, ref_seed_seq{ 1, 2, 3, 4 };
+		utils::StreamableGen<boost::mt11213b> gen(seed_seq);
+		boost::mt11213b ref_gen(ref_seed_seq);
+		bool passed = true;
+		for(int val_id = 0; val_id < n_vals && passed; ++val_id){
+			passed = check(gen() == ref_gen(), "default generator sequence differs");
+		}
+		gen.seed(5, 6);
+		utils::Philox4x32 ref_stream_gen(5, 6);
+		for(int val_id = 0; val_id < n_vals && passed; ++val_id){
+			passed = check(gen() == ref_stream_gen(), "stream sequence differs");
+		}
+		return passed;
+	}
+
+	/**
+	a saved GNN graph must give the same neighbors as the one it was saved from once loaded
+	and must be rejected if any of its neighbor indices lies outside the dataset
+	so that NN rebuilds it instead of searching beyond the end of the dataset
+	*/
+	bool testGNNGraphLoad(){
+		typedef gnn::GNN<SSDBaseDist> GNNT;
+		const int n_samples = 500, n_dims = 16, K = 5;
+		const unsigned long long dataset_key = 1;
+		const char *file_path = "testMTF_graph.gnn";
+		MatrixXd dataset = MatrixXd::Random(n_dims, n_samples);
+		VectorXd query = VectorXd::Random(n_dims);
+		GNNT::DistTypePtr dist_func = std::make_shared<const SSDBaseDist>("ssd");
+		VectorXi built_ids(K), loaded_ids(K);
+		VectorXd built_dists(K), loaded_dists(K);
+		//! the search starts from a random node drawn when the graph is constructed
+		srand(1);
+		GNNT built_graph(dist_func, n_samples, n_dims);
+		built_graph.buildGraph(dataset.data());
+		built_graph.saveGraph(file_path, dataset_key);
+		built_graph.searchGraph(query.data(), dataset.data(), built_ids.data(), built_dists.data(), K);
+		srand(1);
+		GNNT loaded_graph(dist_func, n_samples, n_dims);
+		bool passed = check(loaded_graph.loadGraph(file_path, dataset_key), "saved graph was rejected");
+		if(passed){
+			loaded_graph.searchGraph(query.data(), dataset.data(), loaded_ids.data(), loaded_dists.data(), K);
+			passed = check(loaded_ids == built_ids, "loaded graph gives different neighbors");
+		}
+		gnn::GraphHeader header;
+		{
+			ifstream in_file(file_path, ios::in | ios::binary);
+			in_file.read((char*)(&header), sizeof(gnn::GraphHeader));
+		}
+		for(int invalid_idx : { n_samples, -1 }){
+			{
+				fstream out_file(file_path, ios::in | ios::out | ios::binary);
+				out_file.seekp(header.nns_inds_offset + sizeof(int)*(n_samples / 2));
+				out_file.write((char*)(&invalid_idx), sizeof(int));
+			}
+			GNNT corrupted_graph(dist_func, n_samples, n_dims);
+			passed = check(!corrupted_graph.loadGraph(file_path, dataset_key),
+				"graph with neighbors outside the dataset was accepted") && passed;
+		}
+		remove(file_path);
+		return passed;
+	}
+
+	/**
+	the graph built by NN-Descent must reach the target recall against the exact neighbors
+	found by brute force and must be the same regardless of the no. of threads used to build it;
+	the graphs are compared through the files they are saved to
+	*/
+	bool testGNNNNDescent(){
+		typedef gnn::GNN<SSDBaseDist> GNNT;
+		const int n_samples = 2000, n_dims = 32, sub_dims = 6, degree = 10;
+		const double target_recall = 0.95;
+		const char *file_paths[] = { "testMTF_nnd_1.gnn", "testMTF_nnd_4.gnn" };
+		const int n_threads[] = { 1, 4 };
+		MatrixXd basis = MatrixXd::Random(n_dims, sub_dims);
+		MatrixXd dataset = basis * MatrixXd::Random(sub_dims, n_samples) +
+			0.05 * MatrixXd::Random(n_dims, n_samples);
+		GNNT::DistTypePtr dist_func = std::make_shared<const SSDBaseDist>("ssd");
+		gnn::GNNParams gnn_params;
+		gnn_params.degree = degree;
+		gnn_params.build_type = gnn::GNNParams::BuildType::NNDescent;
+		gnn_params.nnd_max_iters = 20;
+		gnn_params.nnd_delta = 0;
+		gnn_params.nnd_target_recall = target_recall;
+		vector<char> graph_data[2];
+		for(int graph_id = 0; graph_id < 2; ++graph_id){
+			gnn_params.n_threads = n_threads[graph_id];
+			GNNT graph(dist_func, n_samples, n_dims, true, &gnn_params);
+			graph.buildGraph(dataset.data());
+			graph.saveGraph(file_paths[graph_id]);
+			ifstream in_file(file_paths[graph_id], ios::in | ios::binary);
+			graph_data[graph_id].assign(std::istreambuf_iterator<char>(in_file), std::istreambuf_iterator<char>());
+			in_file.close();
+			remove(file_paths[graph_id]);
+		}
+		bool passed = check(graph_data[0] == graph_data[1],
+			"graph built with 4 threads differs from the one built with 1 thread");
+
+		const gnn::GraphHeader *header = reinterpret_cast<const gnn::GraphHeader*>(graph_data[0].data());
+		const uint64_t *nns_offsets = reinterpret_cast<const uint64_t*>(
+			graph_data[0].data() + header->nns_offsets_offset);
+		const int *nns_inds = reinterpret_cast<const int*>(graph_data[0].data() + header->nns_inds_offset);
+		int n_found = 0;
+		for(int id1 = 0; id1 < n_samples; ++id1){
+			VectorXd dists = (dataset.colwise() - dataset.col(id1)).colwise().squaredNorm();
+			dists(id1) = std::numeric_limits<double>::infinity();
+			vector<int> ids(n_samples);
+			for(int id2 = 0; id2 < n_samples; ++id2){ ids[id2] = id2; }
+			partial_sort(ids.begin(), ids.begin() + degree, ids.end(),
+				[&](int a, int b){ return dists(a) < dists(b); });
+			for(uint64_t nn_id = nns_offsets[id1]; nn_id < nns_offsets[id1 + 1]; ++nn_id){
+				n_found += std::find(ids.begin(), ids.begin() + degree, nns_inds[nn_id]) != ids.begin() + degree;
+			}
+		}
+		const double recall = static_cast<double>(n_found) / (n_samples*degree);
+		printf("\trecall of the NN-Descent graph: %f\n", recall);
+		return check(recall >= target_recall, "NN-Descent graph did not reach the target recall") && passed;
+	}
+
+	/**
+	recall against the exact nearest neighbors and the mean query time of the approximate
+	searches that NN can use, over samples that lie close to a low dimensional subspace
+	like the patches sampled around a tracked object; the FLANN KD tree is only included
+	if FLANN is enabled; always passes
+	*/
+	bool benchmarkNNSearch(){
+		const int n_pts = 5000, n_queries = 200, n_dims = 64, sub_dims = 8, K = 10;
+		MatrixXd basis = MatrixXd::Random(n_dims, sub_dims);
+		MatrixXd dataset = basis * MatrixXd::Random(sub_dims, n_pts) +
+			0.05 * MatrixXd::Random(n_dims, n_pts);
+		MatrixXd queries = basis * MatrixXd::Random(sub_dims, n_queries) +
+			0.05 * MatrixXd::Random(n_dims, n_queries);
+		MatrixXi exact_ids(K, n_queries);
+		for(int query_id = 0; query_id < n_queries; ++query_id){
+			VectorXd dists = (dataset.colwise() - queries.col(query_id)).colwise().squaredNorm();
+			vector<int> ids(n_pts);
+			for(int pt_id = 0; pt_id < n_pts; ++pt_id){ ids[pt_id] = pt_id; }
+			partial_sort(ids.begin(), ids.begin() + K, ids.end(),
+				[&](int a, int b){ return dists(a) < dists(b); });
+			for(int nn_id = 0; nn_id < K; ++nn_id){ exact_ids(nn_id, query_id) = ids[nn_id]; }
+		}
+		MatrixXi nn_ids(K, n_queries);
+		MatrixXd nn_dists(K, n_queries);
+		auto printResults = [&](const char *name, double build_time, double search_time){
+			int n_found_1 = 0, n_found_k = 0;
+			for(int query_id = 0; query_id < n_queries; ++query_id){
+				n_found_1 += nn_ids(0, query_id) == exact_ids(0, query_id);
+				for(int nn_id = 0; nn_id < K; ++nn_id){
+					for(int exact_id = 0; exact_id < K; ++exact_id){
+						if(nn_ids(nn_id, query_id) == exact_ids(exact_id, query_id)){
+							++n_found_k;
+							break;
+						}
+					}
+				}
+			}
+			printf("\t%-8s recall@1: %5.3f recall@%d: %5.3f build: %8.3f s query: %8.2f us\n",
+				name, static_cast<double>(n_found_1) / n_queries, K,
+				static_cast<double>(n_found_k) / (n_queries*K), build_time,
+				1e6*search_time / n_queries);
+		};
+		double build_time, search_time;
+		printf("\t%d points with %d dimensions, %d queries\n", n_pts, n_dims, n_queries);
+		hnsw::HNSW<SSDBaseDist>::DistTypePtr dist_func = std::make_shared<const SSDBaseDist>("ssd");
+		{
+			mtf_clock_get(build_start);
+			hnsw::HNSW<SSDBaseDist> hnsw_index(dist_func, n_dims);
+			hnsw_index.buildIndex(dataset.data(), n_pts);
+			mtf_clock_get(build_end);
+			mtf_clock_measure(build_start, build_end, build_time);
+			mtf_clock_get(search_start);
+			for(int query_id = 0; query_id < n_queries; ++query_id){
+				hnsw_index.searchKNN(queries.col(query_id).data(), nn_ids.col(query_id).data(),
+					nn_dists.col(query_id).data(), K);
+			}
+			mtf_clock_get(search_end);
+			mtf_clock_measure(search_start, search_end, search_time);
+			printResults("HNSW", build_time, search_time);
+		}
+		{
+			mtf_clock_get(build_start);
+			gnn::GNN<SSDBaseDist> gnn_index(dist_func, n_pts, n_dims);
+			gnn_index.buildGraph(dataset.data());
+			mtf_clock_get(build_end);
+			mtf_clock_measure(build_start, build_end, build_time);
+			mtf_clock_get(search_start);
+			for(int query_id = 0; query_id < n_queries; ++query_id){
+				gnn_index.searchGraph(queries.col(query_id).data(), dataset.data(),
+					nn_ids.col(query_id).data(), nn_dists.col(query_id).data(), K);
+			}
+			mtf_clock_get(search_end);
+			mtf_clock_measure(search_start, search_end, search_time);
+			printResults("GNN", build_time, search_time);
+		}
+#ifndef DISABLE_FLANN
+		{
+			mtf_clock_get(build_start);
+			flann::Matrix<double> flann_dataset(dataset.data(), n_pts, n_dims);
+			flann::Index<flann::L2<double> > kdtree_index(flann_dataset, flann::KDTreeIndexParams(4));
+			kdtree_index.buildIndex();
+			mtf_clock_get(build_end);
+			mtf_clock_measure(build_start, build_end, build_time);
+			flann::SearchParams search_params(128);
+			mtf_clock_get(search_start);
+			for(int query_id = 0; query_id < n_queries; ++query_id){
+				flann::Matrix<double> flann_query(queries.col(query_id).data(), 1, n_dims);
+				flann::Matrix<int> flann_ids(nn_ids.col(query_id).data(), 1, K);
+				flann::Matrix<double> flann_dists(nn_dists.col(query_id).data(), 1, K);
+				kdtree_index.knnSearch(flann_query, flann_ids, flann_dists, K, search_params);
+			}
+			mtf_clock_get(search_end);
+			mtf_clock_measure(search_start, search_end, search_time);
+			printResults("KD tree", build_time, search_time);
+		}
+#endif
+		return true;
+	}
+
+	/**
+	runs the distance functor of the given AM between a template and all samples in a dataset of
+	patches extracted from the given image at different offsets, once with each supported ISA
+	and both with and without early abandoning, i.e. passing the distance of the
+	nearest sample found so far as worst_dist as in exhaustive NN search, and prints the
+	no. of distance evaluations per second for each
+	*/
+	template<class AMType>
+	bool benchmarkAMDistFunc(const typename AMType::ParamType &am_params, const cv::Mat &img,
+		const Matrix2Xd &templ_pts, int n_samples, int n_reps){
+		AMType am(&am_params);
+		am.setCurrImg(img);
+		am.initializePixVals(templ_pts);
+		am.initializeDistFeat();
+		const unsigned int dist_size = am.getDistFeatSize();
+		VectorXd templ_feat(dist_size);
+		am.updateDistFeat(templ_feat.data());
+		MatrixXdr dataset(n_samples, dist_size);
+		const int n_sample_cols = 50;
+		for(int sample_id = 0; sample_id < n_samples; ++sample_id){
+			Matrix2Xd sample_pts = templ_pts;
+			sample_pts.row(0).array() += (sample_id % n_sample_cols - n_sample_cols / 2)*1.7 + 0.3;
+			sample_pts.row(1).array() += (sample_id / n_sample_cols - n_samples / (2 * n_sample_cols))*1.9 + 0.2;
+			am.updatePixVals(sample_pts);
+			am.updateDistFeat(dataset.row(sample_id).data());
+		}
+		std::unique_ptr<const AMDist> dist_func(am.getDistFunc());
+
+		bool passed = true;
+		int ref_best_id = -1;
+		const utils::simd::ISA supported_isa = utils::simd::getSupportedISA();
+		for(int isa_id = 0; isa_id <= static_cast<int>(supported_isa); ++isa_id){
+			const utils::simd::ISA isa = utils::simd::setActiveISA(static_cast<utils::simd::ISA>(isa_id));
+			double evals_per_sec[2];
+			for(int early_abandon = 0; early_abandon < 2; ++early_abandon){
+				int best_id = -1;
+				double elapsed_time;
+				mtf_clock_get(start_time);
+				for(int rep_id = 0; rep_id < n_reps; ++rep_id){
+					double best_dist = std::numeric_limits<double>::infinity();
+					for(int sample_id = 0; sample_id < n_samples; ++sample_id){
+						const double dist = (*dist_func)(templ_feat.data(), dataset.row(sample_id).data(),
+							dist_size, early_abandon ? best_dist : -1);
+						if(dist < best_dist){
+							best_dist = dist;
+							best_id = sample_id;
+						}
+					}
+				}
+				mtf_clock_get(end_time);
+				mtf_clock_measure(start_time, end_time, elapsed_time);
+				evals_per_sec[early_abandon] = n_samples*n_reps / elapsed_time;
+				if(ref_best_id < 0){ ref_best_id = best_id; }
+				passed = check(best_id == ref_best_id, "nearest sample differs from the one found with the scalar kernels "
+					"without early abandoning") && passed;
+			}
+			printf("	%-5s %-7s %12.0f evals/s without early abandoning %12.0f evals/s with early abandoning\n",
+				am.name.c_str(), utils::simd::toString(isa), evals_per_sec[0], evals_per_sec[1]);
+		}
+		utils::simd::setActiveISA(supported_isa);
+		return passed;
+	}
+	/**
+	throughput of the distance functors of the AMs that use the vectorized distance kernels
+	on a dataset of 2000 patches of 50 x 50 pixels; always passes
+	*/
+	bool benchmarkAMDist(){
+		const int n_samples = 2000, n_reps = 20, res = 50;
+		cv::Mat img(256, 256, CV_32FC1);
+		fillImg(img, [](int x, int y){
+			return 128 + 60 * sin(0.25*x)*cos(0.2*y) + 30 * sin(0.11*(x + y)) + 20 * cos(0.07*x*y);
+		});
+		const Matrix2Xd templ_pts = getGridPts(res, 103, 153);
+		AMParams am_params(res, res);
+		SSDParams ssd_params(&am_params, false);
+		ZNCCParams zncc_params(&am_params, false);
+		NCCParams ncc_params(&am_params, false);
+		SSIMParams ssim_params(&am_params, 0.01, 0.03);
+		SPSSParams spss_params(&am_params, 0.01, nullptr);
+		printf("\t%d samples with %d pixels, %d passes\n", n_samples, res*res, n_reps);
+		benchmarkAMDistFunc<SSD>(ssd_params, img, templ_pts, n_samples, n_reps);
+		benchmarkAMDistFunc<ZNCC>(zncc_params, img, templ_pts, n_samples, n_reps);
+		benchmarkAMDistFunc<SAD>(am_params, img, templ_pts, n_samples, n_reps);
+		benchmarkAMDistFunc<NCC>(ncc_params, img, templ_pts, n_samples, n_reps);
+		benchmarkAMDistFunc<SSIM>(ssim_params, img, templ_pts, n_samples, n_reps);
+		benchmarkAMDistFunc<SPSS>(spss_params, img, templ_pts, n_samples, n_reps);
+		return true;
+	}
+	/**
+	time taken to make a saved NN feature dataset available by reading it into memory, 
+	as was done before the cache files were memory mapped, against that of mapping it 
+	and of mapping it and then scanning it once as the first NN search does; 
+	the file is in the page cache in all cases as it has just been written; always passes
+	*/
+	bool benchmarkDatasetCacheLoad(){
+		const int n_samples = 5000, feat_size = 2500, n_reps = 5;
+		const char *file_path = "testMTF_dataset.bin";
+		MatrixXdr dataset = MatrixXdr::Random(n_samples, feat_size);
+		{
+			ofstream out_file(file_path, ios::out | ios::binary);
+			out_file.write((char*)(dataset.data()), sizeof(double)*dataset.size());
+			if(!out_file.good()){
+				printf("\tfailed to write %s\n", file_path);
+				return true;
+			}
+		}
+		VectorXd query = VectorXd::Random(feat_size);
+		double read_time = 0, map_time = 0, map_scan_time = 0, elapsed_time;
+		double read_dist = 0, map_dist = 0;
+		for(int rep_id = 0; rep_id < n_reps; ++rep_id){
+			{
+				mtf_clock_get(start_time);
+				MatrixXdr loaded_dataset(n_samples, feat_size);
+				ifstream in_file(file_path, ios::in | ios::binary);
+				in_file.read((char*)(loaded_dataset.data()), sizeof(double)*loaded_dataset.size());
+				mtf_clock_get(end_time);
+				mtf_clock_measure(start_time, end_time, elapsed_time);
+				read_time += elapsed_time;
+				read_dist = (loaded_dataset.rowwise() - query.transpose()).rowwise().squaredNorm().minCoeff();
+			}
+			{
+				mtf_clock_get(start_time);
+				utils::MappedFile in_file;
+				in_file.open(file_path);
+				mtf_clock_get(end_time);
+				mtf_clock_measure(start_time, end_time, elapsed_time);
+				map_time += elapsed_time;
+				Map<const MatrixXdr> mapped_dataset(in_file.getData<double>(), n_samples, feat_size);
+				map_dist = (mapped_dataset.rowwise() - query.transpose()).rowwise().squaredNorm().minCoeff();
+				mtf_clock_get(scan_end_time);
+				mtf_clock_measure(start_time, scan_end_time, elapsed_time);
+				map_scan_time += elapsed_time;
+			}
+		}
+		remove(file_path);
+		printf("\t%d samples with %d features (%.0f MB), mean of %d loads\n", n_samples, feat_size,
+			sizeof(double)*dataset.size() / (1024.0 * 1024.0), n_reps);
+		printf("\tread: %8.4f s map: %8.4f s map and scan: %8.4f s\n",
+			read_time / n_reps, map_time / n_reps, map_scan_time / n_reps);
+		check(read_dist == map_dist, "mapped dataset differs from the one read");
+		return true;
+	}
+
+	const TestCase test_cases[] = {
+		{ "img_deriv_cache", testImgDerivCache, false },
+		{ "bspl_lut", testBSpl3LUT, false },
+		{ "parallel_joint_hist", testParallelJointHist, false },
+		{ "fused_pix_fetch", testFusedPixFetch, false },
+		{ "sm_alloc_check", testSMAllocCheck, false },
+		{ "float_jacobian", testFloatJacobian, false },
+		{ "sampler_gen", testSamplerGen, false },
+		{ "batch_warp_sampling", testBatchWarpSampling, false },
+		{ "grid_tracker_batch", testGridTrackerBatch, false },
+		{ "gnn_graph_load", testGNNGraphLoad, false },
+		{ "gnn_nn_descent", testGNNNNDescent, false },
+		{ "nn_search", benchmarkNNSearch, true },
+		{ "dataset_cache_load", benchmarkDatasetCacheLoad, true },
+		{ "am_dist", benchmarkAMDist, true },
+		{ "float_jac_accuracy", benchmarkFloatJacobianAccuracy, true },
+		{ "grid_tracker_batch_fps", benchmarkGridTrackerBatch, true },
+	};
+}
+
+int main(int argc, char * argv[]) {
+	int n_failed = 0, n_run = 0;
+	for(const TestCase &test_case : test_cases){
+		bool selected = argc <= 1 && !test_case.is_benchmark;
+		for(int arg_id = 1; arg_id < argc; ++arg_id){
+			if(!strcmp(argv[arg_id], test_case.name)){ selected = true; }
+		}
+		if(!selected){ continue; }
+		printf("%s...\n", test_case.name);
+		bool passed = false;
+		try{
+			passed = test_case.func();
+		} catch(const std::exception &err){
+			printf("\texception: %s\n", err.what());
+		}
+		printf("%s: %s\n", test_case.name, passed ? "passed" : "FAILED");
+		++n_run;
+		if(!passed){ ++n_failed; }
+	}
+	printf("%d of %d tests failed\n", n_failed, n_run);
+	return n_failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
@@ -41,9 +41,7 @@ int main(int argc, char * argv[]) {
 	// ********************************** read configuration parameters ********************************** //
 	if(!readParams(argc, argv)){ return EXIT_FAILURE; }
 
-#ifdef ENABLE_PARALLEL
 	Eigen::initParallel();
-#endif
 	printf("*******************************\n");
 	printf("Using parameters:\n");
 	printf("qr_detector_ssm: %s\n", qr_detector_ssm.c_str());
@@ -34,9 +34,7 @@ int main(int argc, char * argv[]) {
 
 	if(!readParams(argc, argv)){ return EXIT_FAILURE; }
 
-#ifdef ENABLE_PARALLEL
 	Eigen::initParallel();
-#endif
 
 	actor = "Misc";
 	seq_name = "uav_sim";
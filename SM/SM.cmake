@@ -4,9 +4,9 @@ option(WITH_GRID_TRACKERS "Enable Grid trackers (RANSAC/LMS SMs) and RKLT" ON)
 option(WITH_FEAT "Enable Feature based Tracker (requires nonfree OpenCV module)" ON)
 option(WITH_REGNET "Enable regression network search method (requires a custom version of Caffe to be present)" OFF)
 
-set(SEARCH_METHODS "")
+set(SEARCH_METHODS GNN HNSW)
 set(SEARCH_METHODS_NT ESM AESM FCLK ICLK FALK IALK FCSD PF NN GNN)
-set(SEARCH_PARAMS FCLK ICLK FALK IALK ESM NN GNN PF Cascade Parallel Pyramidal)
+set(SEARCH_PARAMS FCLK ICLK FALK IALK ESM NN GNN HNSW PF Cascade Parallel Pyramidal)
 set(COMPOSITE_SEARCH_METHODS CascadeTracker ParallelTracker PyramidalTracker LineTracker)
 if(WITH_TEMPLATED)
 	set(SEARCH_METHODS ${SEARCH_METHODS} ESM FCLK ICLK FALK IALK PF)
@@ -16,7 +16,7 @@ else(WITH_TEMPLATED)
 	set(MTF_DEFINITIONS ${MTF_DEFINITIONS} DISABLE_TEMPLATED_SM)	
 endif()
 if(WITH_GRID_TRACKERS)
-	set(COMPOSITE_SEARCH_METHODS ${COMPOSITE_SEARCH_METHODS} GridTracker GridTrackerCV)
+	set(COMPOSITE_SEARCH_METHODS ${COMPOSITE_SEARCH_METHODS} GridTracker GridTrackerCV GridTrackerBatch)
 	if(WITH_TEMPLATED)
 		set(COMPOSITE_SEARCH_METHODS ${COMPOSITE_SEARCH_METHODS} GridTrackerFlow RKLT)
 	endif(WITH_TEMPLATED)
@@ -55,7 +55,7 @@ endif(WITH_REGNET)
 if(WITH_FLANN)
 	find_package(FLANN)
 	if(FLANN_FOUND) 
-		set(SEARCH_METHODS ${SEARCH_METHODS} NN GNN FGNN)
+		set(SEARCH_METHODS ${SEARCH_METHODS} NN FGNN)
 		set(SEARCH_PARAMS ${SEARCH_PARAMS} FLANN)
 		set(MTF_LIBS ${MTF_LIBS} ${FLANN_LIBS})
 		set(MTF_EXT_INCLUDE_DIRS ${MTF_EXT_INCLUDE_DIRS} ${FLANN_INCLUDE_DIRS})
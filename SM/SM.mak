@@ -26,9 +26,6 @@ regnet ?= 0
 # use CPU only version of Caffe with RegNet; only matters if RegNet is enabled
 regnet_cpu ?= 0
 
-# enable parallelization of Particle Filter SM using OpenMP
-pfomp ?= 0
-
 SM_INCLUDE_DIR = SM/include
 SM_SRC_DIR = SM/src
 SM_HEADER_DIR = ${SM_INCLUDE_DIR}/mtf/SM
@@ -39,10 +36,10 @@ COMPOSITE_BASE_HEADERS =  ${SM_HEADER_DIR}/CompositeBase.h
 MTF_INCLUDE_DIRS += ${SM_INCLUDE_DIR}
 BASE_HEADERS += ${SM_HEADER_DIR}/SearchMethod.h
 
-SEARCH_METHODS = 
+SEARCH_METHODS = GNN HNSW
 COMPOSITE = CascadeTracker ParallelTracker PyramidalTracker LineTracker
 SEARCH_METHODS_NT = FCLK ICLK FALK IALK ESM PF NN GNN FCSD AESM
-SEARCH_PARAMS = FCLK ICLK FALK IALK ESM PF NN GNN Cascade Parallel Pyramidal
+SEARCH_PARAMS = FCLK ICLK FALK IALK ESM PF NN GNN HNSW Cascade Parallel Pyramidal
 
 SEARCH_OBJS = $(addprefix ${BUILD_DIR}/,$(addsuffix .o, ${SEARCH_METHODS}))
 SEARCH_NT_OBJS = $(addprefix ${BUILD_DIR}/,$(addsuffix _NT.o, ${SEARCH_METHODS_NT}))
@@ -69,7 +66,7 @@ else
 	MTF_COMPILETIME_FLAGS += -D DISABLE_TEMPLATED_SM
 endif
 ifeq (${grid}, 1)
-	COMPOSITE +=  GridTracker GridTrackerCV	
+	COMPOSITE +=  GridTracker GridTrackerCV GridTrackerBatch	
 	COMPOSITE_BASE_HEADERS +=  ${SM_HEADER_DIR}/GridBase.h
 	ifeq (${only_nt}, 0)
 		COMPOSITE +=  GridTrackerFlow
@@ -82,7 +79,7 @@ else
 endif
 
 ifeq (${nn}, 1)
-	SEARCH_METHODS += NN GNN FGNN
+	SEARCH_METHODS += NN FGNN
 	SEARCH_PARAMS += FLANN
 	MTF_LIBS += -lflann
 	ifeq ($(OS),Windows_NT)
@@ -144,10 +141,6 @@ fct ?= 0
 fad ?= 0
 fat ?= 0
 iat ?= 0
-prltbb ?= 0
-prlomp ?= 0
-gridtbb ?= 0
-gridomp ?= 0
 efd ?= 0
 
 
@@ -162,28 +155,6 @@ endif
 ifeq (${regnet_cpu}, 1)
 RGN_FLAGS += -D CPU_ONLY
 endif
-ifeq (${prltbb}, 1)
-PRL_FLAGS += -D ENABLE_TBB
-MTF_RUNTIME_FLAGS += -D ENABLE_PARALLEL
-endif
-
-ifeq (${gridtbb}, 1)
-GRID_FLAGS += -D ENABLE_TBB 
-MTF_RUNTIME_FLAGS += -D ENABLE_PARALLEL
-else
-ifeq (${gridomp}, 1)
-GRID_FLAGS += -D ENABLE_PARALLEL -D ENABLE_OMP -fopenmp 
-MTF_RUNTIME_FLAGS += -D ENABLE_PARALLEL -fopenmp
-MTF_LIBS += -fopenmp
-endif
-endif
-
-ifeq (${pfomp}, 1)
-PF_FLAGS += -D ENABLE_PARALLEL -D ENABLE_OMP -fopenmp 
-MTF_RUNTIME_FLAGS += -D ENABLE_PARALLEL -fopenmp
-MTF_LIBS += -fopenmp
-endif
-
 ifeq (${et}, 1)
 ESM_FLAGS += -D ENABLE_PROFILING
 endif
@@ -225,39 +196,42 @@ NN_FLAGS += -D ENABLE_PROFILING
 endif
 
 
-${BUILD_DIR}/ICLK.o: ${SM_SRC_DIR}/ICLK.cc ${SM_HEADER_DIR}/ICLK.h ${SM_HEADER_DIR}/ICLKParams.h ${APPEARANCE_HEADERS} ${STATE_SPACE_HEADERS} ${SM_BASE_HEADERS} ${UTILITIES_HEADER_DIR}/excpUtils.h  ${UTILITIES_HEADER_DIR}/miscUtils.h ${MACROS_HEADER_DIR}/common.h ${MACROS_HEADER_DIR}/register.h
+${BUILD_DIR}/ICLK.o: ${SM_SRC_DIR}/ICLK.cc ${SM_HEADER_DIR}/ICLK.h ${SM_HEADER_DIR}/NewtonSolver.h ${SM_HEADER_DIR}/ICLKParams.h ${APPEARANCE_HEADERS} ${STATE_SPACE_HEADERS} ${SM_BASE_HEADERS} ${UTILITIES_HEADER_DIR}/excpUtils.h  ${UTILITIES_HEADER_DIR}/miscUtils.h ${MACROS_HEADER_DIR}/common.h ${MACROS_HEADER_DIR}/register.h
 	${CXX} -c ${MTF_PIC_FLAG} ${WARNING_FLAGS} ${OPT_FLAGS} ${PROF_FLAGS} ${MTF_COMPILETIME_FLAGS} ${MTF_INCLUDE_FLAGS} ${IC_FLAGS} $< ${OPENCV_FLAGS} -o $@
 	
-${BUILD_DIR}/FCLK.o: ${SM_SRC_DIR}/FCLK.cc ${SM_HEADER_DIR}/FCLK.h ${SM_HEADER_DIR}/FCLKParams.h ${APPEARANCE_HEADERS} ${STATE_SPACE_HEADERS} ${SM_BASE_HEADERS} ${UTILITIES_HEADER_DIR}/excpUtils.h  ${UTILITIES_HEADER_DIR}/miscUtils.h ${MACROS_HEADER_DIR}/common.h ${MACROS_HEADER_DIR}/register.h
+${BUILD_DIR}/FCLK.o: ${SM_SRC_DIR}/FCLK.cc ${SM_HEADER_DIR}/FCLK.h ${SM_HEADER_DIR}/NewtonSolver.h ${SM_HEADER_DIR}/FCLKParams.h ${APPEARANCE_HEADERS} ${STATE_SPACE_HEADERS} ${SM_BASE_HEADERS} ${UTILITIES_HEADER_DIR}/excpUtils.h  ${UTILITIES_HEADER_DIR}/miscUtils.h ${MACROS_HEADER_DIR}/common.h ${MACROS_HEADER_DIR}/register.h
 	${CXX} -c ${MTF_PIC_FLAG} ${WARNING_FLAGS} ${OPT_FLAGS} ${PROF_FLAGS} ${MTF_COMPILETIME_FLAGS} ${MTF_INCLUDE_FLAGS} ${FC_FLAGS} $< ${OPENCV_FLAGS} -o $@
 	
-${BUILD_DIR}/FALK.o: ${SM_SRC_DIR}/FALK.cc ${SM_HEADER_DIR}/FALK.h ${SM_HEADER_DIR}/FALKParams.h ${APPEARANCE_HEADERS} ${STATE_SPACE_HEADERS} ${SM_BASE_HEADERS} ${UTILITIES_HEADER_DIR}/excpUtils.h  ${UTILITIES_HEADER_DIR}/miscUtils.h ${MACROS_HEADER_DIR}/common.h ${MACROS_HEADER_DIR}/register.h
+${BUILD_DIR}/FALK.o: ${SM_SRC_DIR}/FALK.cc ${SM_HEADER_DIR}/FALK.h ${SM_HEADER_DIR}/NewtonSolver.h ${SM_HEADER_DIR}/FALKParams.h ${APPEARANCE_HEADERS} ${STATE_SPACE_HEADERS} ${SM_BASE_HEADERS} ${UTILITIES_HEADER_DIR}/excpUtils.h  ${UTILITIES_HEADER_DIR}/miscUtils.h ${MACROS_HEADER_DIR}/common.h ${MACROS_HEADER_DIR}/register.h
 	${CXX} -c ${MTF_PIC_FLAG} ${WARNING_FLAGS} ${OPT_FLAGS} ${PROF_FLAGS} ${MTF_COMPILETIME_FLAGS} ${MTF_INCLUDE_FLAGS} ${FA_FLAGS} $< ${OPENCV_FLAGS} -o $@
 	
-${BUILD_DIR}/IALK.o: ${SM_SRC_DIR}/IALK.cc ${SM_HEADER_DIR}/IALK.h ${SM_HEADER_DIR}/IALKParams.h ${APPEARANCE_HEADERS} ${STATE_SPACE_HEADERS} ${SM_BASE_HEADERS} ${UTILITIES_HEADER_DIR}/excpUtils.h  ${UTILITIES_HEADER_DIR}/miscUtils.h ${MACROS_HEADER_DIR}/common.h ${MACROS_HEADER_DIR}/register.h
+${BUILD_DIR}/IALK.o: ${SM_SRC_DIR}/IALK.cc ${SM_HEADER_DIR}/IALK.h ${SM_HEADER_DIR}/NewtonSolver.h ${SM_HEADER_DIR}/IALKParams.h ${APPEARANCE_HEADERS} ${STATE_SPACE_HEADERS} ${SM_BASE_HEADERS} ${UTILITIES_HEADER_DIR}/excpUtils.h  ${UTILITIES_HEADER_DIR}/miscUtils.h ${MACROS_HEADER_DIR}/common.h ${MACROS_HEADER_DIR}/register.h
 	${CXX} -c ${MTF_PIC_FLAG} ${WARNING_FLAGS} ${OPT_FLAGS} ${PROF_FLAGS} ${MTF_COMPILETIME_FLAGS} ${MTF_INCLUDE_FLAGS} ${IA_FLAGS} $< ${OPENCV_FLAGS} -o $@
 	
 ${BUILD_DIR}/FCSD.o: ${SM_SRC_DIR}/FCSD.cc ${SM_HEADER_DIR}/FCSD.h ${APPEARANCE_HEADERS} ${STATE_SPACE_HEADERS} ${SM_BASE_HEADERS} ${UTILITIES_HEADER_DIR}/excpUtils.h  ${UTILITIES_HEADER_DIR}/miscUtils.h ${MACROS_HEADER_DIR}/common.h ${MACROS_HEADER_DIR}/register.h
 	${CXX} -c ${MTF_PIC_FLAG} ${WARNING_FLAGS} ${OPT_FLAGS} ${PROF_FLAGS} ${MTF_COMPILETIME_FLAGS} ${MTF_INCLUDE_FLAGS} ${FC_FLAGS} $< ${OPENCV_FLAGS} -o $@
 
-${BUILD_DIR}/AESM.o: ${SM_SRC_DIR}/AESM.cc ${SM_HEADER_DIR}/AESM.h ${SM_HEADER_DIR}/ESM.h ${SM_HEADER_DIR}/ESMParams.h ${APPEARANCE_HEADERS} ${STATE_SPACE_HEADERS} ${SM_BASE_HEADERS} ${UTILITIES_HEADER_DIR}/excpUtils.h  ${UTILITIES_HEADER_DIR}/miscUtils.h ${MACROS_HEADER_DIR}/common.h ${MACROS_HEADER_DIR}/register.h
+${BUILD_DIR}/AESM.o: ${SM_SRC_DIR}/AESM.cc ${SM_HEADER_DIR}/AESM.h ${SM_HEADER_DIR}/NewtonSolver.h ${SM_HEADER_DIR}/ESM.h ${SM_HEADER_DIR}/ESMParams.h ${APPEARANCE_HEADERS} ${STATE_SPACE_HEADERS} ${SM_BASE_HEADERS} ${UTILITIES_HEADER_DIR}/excpUtils.h  ${UTILITIES_HEADER_DIR}/miscUtils.h ${MACROS_HEADER_DIR}/common.h ${MACROS_HEADER_DIR}/register.h
 	${CXX} -c ${MTF_PIC_FLAG} ${WARNING_FLAGS} ${OPT_FLAGS} ${PROF_FLAGS} ${MTF_COMPILETIME_FLAGS} ${MTF_INCLUDE_FLAGS} ${ESM_FLAGS} $< ${OPENCV_FLAGS} -o $@
 
-${BUILD_DIR}/ESM.o: ${SM_SRC_DIR}/ESM.cc ${SM_HEADER_DIR}/ESM.h ${SM_HEADER_DIR}/ESMParams.h ${APPEARANCE_HEADERS} ${STATE_SPACE_HEADERS} ${SM_BASE_HEADERS} ${UTILITIES_HEADER_DIR}/excpUtils.h  ${UTILITIES_HEADER_DIR}/miscUtils.h ${UTILITIES_HEADER_DIR}/spiUtils.h ${MACROS_HEADER_DIR}/common.h ${MACROS_HEADER_DIR}/register.h
+${BUILD_DIR}/ESM.o: ${SM_SRC_DIR}/ESM.cc ${SM_HEADER_DIR}/ESM.h ${SM_HEADER_DIR}/NewtonSolver.h ${SM_HEADER_DIR}/ESMParams.h ${APPEARANCE_HEADERS} ${STATE_SPACE_HEADERS} ${SM_BASE_HEADERS} ${UTILITIES_HEADER_DIR}/excpUtils.h  ${UTILITIES_HEADER_DIR}/miscUtils.h ${UTILITIES_HEADER_DIR}/spiUtils.h ${MACROS_HEADER_DIR}/common.h ${MACROS_HEADER_DIR}/register.h
 	${CXX} -c ${MTF_PIC_FLAG} ${WARNING_FLAGS} ${OPT_FLAGS} ${PROF_FLAGS} ${MTF_COMPILETIME_FLAGS} ${MTF_INCLUDE_FLAGS} ${ESM_FLAGS} $< ${OPENCV_FLAGS} -o $@
 	
-${BUILD_DIR}/PF.o: ${SM_SRC_DIR}/PF.cc ${SM_HEADER_DIR}/PF.h ${SM_HEADER_DIR}/PFParams.h ${APPEARANCE_HEADERS} ${STATE_SPACE_HEADERS} ${SM_BASE_HEADERS} ${UTILITIES_HEADER_DIR}/excpUtils.h  ${UTILITIES_HEADER_DIR}/miscUtils.h ${MACROS_HEADER_DIR}/common.h ${MACROS_HEADER_DIR}/register.h
+${BUILD_DIR}/PF.o: ${SM_SRC_DIR}/PF.cc ${SM_HEADER_DIR}/PF.h ${SM_HEADER_DIR}/PFParams.h ${APPEARANCE_HEADERS} ${STATE_SPACE_HEADERS} ${SM_BASE_HEADERS} ${UTILITIES_HEADER_DIR}/excpUtils.h  ${UTILITIES_HEADER_DIR}/miscUtils.h ${UTILITIES_HEADER_DIR}/parallelUtils.h ${MACROS_HEADER_DIR}/common.h ${MACROS_HEADER_DIR}/register.h
 	${CXX} -c ${MTF_PIC_FLAG} ${WARNING_FLAGS} ${OPT_FLAGS} ${PROF_FLAGS} ${MTF_COMPILETIME_FLAGS} ${MTF_INCLUDE_FLAGS} ${PF_FLAGS} $< ${OPENCV_FLAGS} -o $@
 	
-${BUILD_DIR}/NN.o: ${SM_SRC_DIR}/NN.cc ${SM_HEADER_DIR}/NN.h ${SM_HEADER_DIR}/FGNN.h ${SM_HEADER_DIR}/GNN.h ${SM_HEADER_DIR}/NNParams.h ${SM_HEADER_DIR}/GNNParams.h ${SM_HEADER_DIR}/FLANNParams.h ${APPEARANCE_HEADERS} ${STATE_SPACE_HEADERS} ${SM_BASE_HEADERS} ${UTILITIES_HEADER_DIR}/excpUtils.h  ${UTILITIES_HEADER_DIR}/miscUtils.h ${MACROS_HEADER_DIR}/common.h ${MACROS_HEADER_DIR}/register.h
+${BUILD_DIR}/NN.o: ${SM_SRC_DIR}/NN.cc ${SM_HEADER_DIR}/NN.h ${SM_HEADER_DIR}/FGNN.h ${SM_HEADER_DIR}/GNN.h ${SM_HEADER_DIR}/HNSW.h ${SM_HEADER_DIR}/NNParams.h ${SM_HEADER_DIR}/GNNParams.h ${SM_HEADER_DIR}/HNSWParams.h ${SM_HEADER_DIR}/FLANNParams.h ${APPEARANCE_HEADERS} ${STATE_SPACE_HEADERS} ${SM_BASE_HEADERS} ${UTILITIES_HEADER_DIR}/excpUtils.h  ${UTILITIES_HEADER_DIR}/miscUtils.h ${UTILITIES_HEADER_DIR}/parallelUtils.h ${MACROS_HEADER_DIR}/common.h ${MACROS_HEADER_DIR}/register.h
 	${CXX} -c ${MTF_PIC_FLAG} ${WARNING_FLAGS} ${OPT_FLAGS} ${PROF_FLAGS} ${MTF_COMPILETIME_FLAGS} ${MTF_INCLUDE_FLAGS} ${NN_FLAGS} $< ${OPENCV_FLAGS} -o $@
 	
-${BUILD_DIR}/GNN.o: ${SM_SRC_DIR}/GNN.cc ${SM_HEADER_DIR}/GNN.h ${SM_HEADER_DIR}/GNNParams.h ${APPEARANCE_HEADERS} ${UTILITIES_HEADER_DIR}/miscUtils.h ${MACROS_HEADER_DIR}/common.h ${MACROS_HEADER_DIR}/register.h 
+${BUILD_DIR}/GNN.o: ${SM_SRC_DIR}/GNN.cc ${SM_HEADER_DIR}/GNN.h ${SM_HEADER_DIR}/GNNParams.h ${APPEARANCE_HEADERS} ${UTILITIES_HEADER_DIR}/miscUtils.h ${UTILITIES_HEADER_DIR}/parallelUtils.h ${MACROS_HEADER_DIR}/common.h ${MACROS_HEADER_DIR}/register.h 
 	${CXX} -c ${MTF_PIC_FLAG} ${WARNING_FLAGS} ${OPT_FLAGS} ${PROF_FLAGS} ${MTF_COMPILETIME_FLAGS} ${MTF_INCLUDE_FLAGS} ${GNN_FLAGS} $< ${OPENCV_FLAGS} -o $@	
 	
-${BUILD_DIR}/FGNN.o: ${SM_SRC_DIR}/FGNN.cc ${SM_HEADER_DIR}/FGNN.h ${SM_HEADER_DIR}/GNN.h ${APPEARANCE_HEADERS} ${UTILITIES_HEADER_DIR}/miscUtils.h ${MACROS_HEADER_DIR}/common.h ${MACROS_HEADER_DIR}/register.h 
+${BUILD_DIR}/FGNN.o: ${SM_SRC_DIR}/FGNN.cc ${SM_HEADER_DIR}/FGNN.h ${SM_HEADER_DIR}/GNN.h ${SM_HEADER_DIR}/HNSW.h ${APPEARANCE_HEADERS} ${UTILITIES_HEADER_DIR}/miscUtils.h ${MACROS_HEADER_DIR}/common.h ${MACROS_HEADER_DIR}/register.h 
 	${CXX} -c ${MTF_PIC_FLAG} ${WARNING_FLAGS} ${OPT_FLAGS} ${PROF_FLAGS} ${MTF_COMPILETIME_FLAGS} ${MTF_INCLUDE_FLAGS} ${FGNN_FLAGS} $< ${OPENCV_FLAGS} -o $@	
 	
+${BUILD_DIR}/HNSW.o: ${SM_SRC_DIR}/HNSW.cc ${SM_HEADER_DIR}/HNSW.h ${SM_HEADER_DIR}/HNSWParams.h ${APPEARANCE_HEADERS} ${UTILITIES_HEADER_DIR}/excpUtils.h ${UTILITIES_HEADER_DIR}/rngUtils.h ${UTILITIES_HEADER_DIR}/cacheUtils.h ${MACROS_HEADER_DIR}/common.h ${MACROS_HEADER_DIR}/register.h 
+	${CXX} -c ${MTF_PIC_FLAG} ${WARNING_FLAGS} ${OPT_FLAGS} ${PROF_FLAGS} ${MTF_COMPILETIME_FLAGS} ${MTF_INCLUDE_FLAGS} $< ${OPENCV_FLAGS} -o $@	
+	
 	
 # ------------------------------------------------------------------------------- #
 # ---------------------------------- Composite ---------------------------------- #
@@ -269,21 +243,24 @@ ${BUILD_DIR}/CascadeTracker.o: ${SM_SRC_DIR}/CascadeTracker.cc ${SM_HEADER_DIR}/
 ${BUILD_DIR}/CascadeSM.o: ${SM_SRC_DIR}/CascadeSM.cc ${SM_HEADER_DIR}/CascadeSM.h ${SM_HEADER_DIR}/CascadeParams.h ${SM_HEADER_DIR}/CompositeSM.h ${APPEARANCE_HEADERS} ${STATE_SPACE_HEADERS} ${SM_BASE_HEADERS} ${UTILITIES_HEADER_DIR}/excpUtils.h  ${UTILITIES_HEADER_DIR}/miscUtils.h ${MACROS_HEADER_DIR}/common.h ${MACROS_HEADER_DIR}/register.h
 	${CXX} -c ${MTF_PIC_FLAG} ${WARNING_FLAGS} ${OPT_FLAGS} ${PROF_FLAGS} ${MTF_COMPILETIME_FLAGS} ${MTF_INCLUDE_FLAGS} $< ${OPENCV_FLAGS} -o $@
 	
-${BUILD_DIR}/ParallelTracker.o: ${SM_SRC_DIR}/ParallelTracker.cc ${SM_HEADER_DIR}/ParallelTracker.h ${SM_HEADER_DIR}/ParallelParams.h ${SM_HEADER_DIR}/CompositeBase.h ${ROOT_HEADER_DIR}/TrackerBase.h ${SM_BASE_HEADERS} ${UTILITIES_HEADER_DIR}/excpUtils.h  ${UTILITIES_HEADER_DIR}/miscUtils.h ${MACROS_HEADER_DIR}/common.h
+${BUILD_DIR}/ParallelTracker.o: ${SM_SRC_DIR}/ParallelTracker.cc ${SM_HEADER_DIR}/ParallelTracker.h ${SM_HEADER_DIR}/ParallelParams.h ${SM_HEADER_DIR}/CompositeBase.h ${ROOT_HEADER_DIR}/TrackerBase.h ${SM_BASE_HEADERS} ${UTILITIES_HEADER_DIR}/excpUtils.h  ${UTILITIES_HEADER_DIR}/miscUtils.h ${UTILITIES_HEADER_DIR}/parallelUtils.h ${MACROS_HEADER_DIR}/common.h
 	${CXX} -c ${MTF_PIC_FLAG} ${WARNING_FLAGS} ${OPT_FLAGS} ${PROF_FLAGS} ${MTF_COMPILETIME_FLAGS} ${MTF_INCLUDE_FLAGS} ${PRL_FLAGS} $< ${OPENCV_FLAGS} -o $@
 	
-${BUILD_DIR}/ParallelSM.o: ${SM_SRC_DIR}/ParallelSM.cc ${SM_HEADER_DIR}/ParallelSM.h ${SM_HEADER_DIR}/ParallelParams.h ${SM_HEADER_DIR}/CompositeSM.h ${APPEARANCE_HEADERS} ${STATE_SPACE_HEADERS} ${SM_BASE_HEADERS} ${UTILITIES_HEADER_DIR}/excpUtils.h  ${UTILITIES_HEADER_DIR}/miscUtils.h ${MACROS_HEADER_DIR}/common.h ${MACROS_HEADER_DIR}/register.h
+${BUILD_DIR}/ParallelSM.o: ${SM_SRC_DIR}/ParallelSM.cc ${SM_HEADER_DIR}/ParallelSM.h ${SM_HEADER_DIR}/ParallelParams.h ${SM_HEADER_DIR}/CompositeSM.h ${APPEARANCE_HEADERS} ${STATE_SPACE_HEADERS} ${SM_BASE_HEADERS} ${UTILITIES_HEADER_DIR}/excpUtils.h  ${UTILITIES_HEADER_DIR}/miscUtils.h ${UTILITIES_HEADER_DIR}/parallelUtils.h ${MACROS_HEADER_DIR}/common.h ${MACROS_HEADER_DIR}/register.h
 	${CXX} -c ${MTF_PIC_FLAG} ${WARNING_FLAGS} ${OPT_FLAGS} ${PROF_FLAGS} ${MTF_COMPILETIME_FLAGS} ${MTF_INCLUDE_FLAGS} ${PRL_FLAGS} $< ${OPENCV_FLAGS} -o $@	
 
-${BUILD_DIR}/PyramidalTracker.o: ${SM_SRC_DIR}/PyramidalTracker.cc ${SM_HEADER_DIR}/PyramidalTracker.h ${SM_HEADER_DIR}/PyramidalParams.h ${SM_HEADER_DIR}/CompositeBase.h ${ROOT_HEADER_DIR}/TrackerBase.h ${UTILITIES_HEADER_DIR}/excpUtils.h  ${UTILITIES_HEADER_DIR}/miscUtils.h ${MACROS_HEADER_DIR}/common.h
+${BUILD_DIR}/PyramidalTracker.o: ${SM_SRC_DIR}/PyramidalTracker.cc ${SM_HEADER_DIR}/PyramidalTracker.h ${SM_HEADER_DIR}/PyramidalParams.h ${SM_HEADER_DIR}/CompositeBase.h ${ROOT_HEADER_DIR}/TrackerBase.h ${UTILITIES_HEADER_DIR}/excpUtils.h  ${UTILITIES_HEADER_DIR}/miscUtils.h ${UTILITIES_HEADER_DIR}/pyramidUtils.h ${MACROS_HEADER_DIR}/common.h
 	${CXX} -c ${MTF_PIC_FLAG} ${WARNING_FLAGS} ${OPT_FLAGS} ${PROF_FLAGS} ${MTF_COMPILETIME_FLAGS} ${MTF_INCLUDE_FLAGS} ${PRL_FLAGS} $< ${OPENCV_FLAGS} -o $@
 	
-${BUILD_DIR}/PyramidalSM.o: ${SM_SRC_DIR}/PyramidalSM.cc ${SM_HEADER_DIR}/PyramidalSM.h ${SM_HEADER_DIR}/PyramidalParams.h  ${SM_HEADER_DIR}/CompositeSM.h ${APPEARANCE_HEADERS} ${STATE_SPACE_HEADERS} ${SM_BASE_HEADERS} ${UTILITIES_HEADER_DIR}/excpUtils.h  ${UTILITIES_HEADER_DIR}/miscUtils.h ${MACROS_HEADER_DIR}/common.h ${MACROS_HEADER_DIR}/register.h
+${BUILD_DIR}/PyramidalSM.o: ${SM_SRC_DIR}/PyramidalSM.cc ${SM_HEADER_DIR}/PyramidalSM.h ${SM_HEADER_DIR}/PyramidalParams.h  ${SM_HEADER_DIR}/CompositeSM.h ${APPEARANCE_HEADERS} ${STATE_SPACE_HEADERS} ${SM_BASE_HEADERS} ${UTILITIES_HEADER_DIR}/excpUtils.h  ${UTILITIES_HEADER_DIR}/miscUtils.h ${UTILITIES_HEADER_DIR}/pyramidUtils.h ${MACROS_HEADER_DIR}/common.h ${MACROS_HEADER_DIR}/register.h
 	${CXX} -c ${MTF_PIC_FLAG} ${WARNING_FLAGS} ${OPT_FLAGS} ${PROF_FLAGS} ${MTF_COMPILETIME_FLAGS} ${MTF_INCLUDE_FLAGS} ${PRL_FLAGS} $< ${OPENCV_FLAGS} -o $@	
 	
 ${BUILD_DIR}/GridTrackerCV.o: ${SM_SRC_DIR}/GridTrackerCV.cc ${SM_HEADER_DIR}/GridTrackerCV.h ${SM_HEADER_DIR}/GridBase.h ${SM_HEADER_DIR}/CompositeBase.h ${ROOT_HEADER_DIR}/TrackerBase.h ${UTILITIES_HEADER_DIR}/excpUtils.h ${UTILITIES_HEADER_DIR}/miscUtils.h ${UTILITIES_HEADER_DIR}/imgUtils.h ${MACROS_HEADER_DIR}/common.h ${MACROS_HEADER_DIR}/register.h ${STATE_SPACE_HEADERS}
 	${CXX} -c ${MTF_PIC_FLAG} ${WARNING_FLAGS} ${OPT_FLAGS} ${PROF_FLAGS} ${MTF_COMPILETIME_FLAGS} ${MTF_INCLUDE_FLAGS} $< ${OPENCV_FLAGS} -o $@
 
+${BUILD_DIR}/GridTrackerBatch.o: ${SM_SRC_DIR}/GridTrackerBatch.cc ${SM_HEADER_DIR}/GridTrackerBatch.h ${SM_HEADER_DIR}/GridBase.h ${SM_HEADER_DIR}/CompositeBase.h ${ROOT_HEADER_DIR}/TrackerBase.h ${UTILITIES_HEADER_DIR}/excpUtils.h ${UTILITIES_HEADER_DIR}/miscUtils.h ${UTILITIES_HEADER_DIR}/imgUtils.h ${MACROS_HEADER_DIR}/common.h ${MACROS_HEADER_DIR}/register.h ${STATE_SPACE_HEADERS}
+	${CXX} -c ${MTF_PIC_FLAG} ${WARNING_FLAGS} ${OPT_FLAGS} ${PROF_FLAGS} ${MTF_COMPILETIME_FLAGS} ${MTF_INCLUDE_FLAGS} $< ${OPENCV_FLAGS} -o $@
+
 ${BUILD_DIR}/GridTrackerFlow.o: ${SM_SRC_DIR}/GridTrackerFlow.cc ${SM_HEADER_DIR}/GridTrackerFlow.h ${SM_HEADER_DIR}/GridTrackerFlowParams.h ${SM_HEADER_DIR}/GridBase.h ${SM_HEADER_DIR}/CompositeBase.h ${ROOT_HEADER_DIR}/TrackerBase.h ${UTILITIES_HEADER_DIR}/excpUtils.h ${UTILITIES_HEADER_DIR}/miscUtils.h ${MACROS_HEADER_DIR}/common.h ${MACROS_HEADER_DIR}/register.h ${APPEARANCE_HEADERS} ${STATE_SPACE_HEADERS}
 	${CXX} -c ${MTF_PIC_FLAG} ${WARNING_FLAGS} ${OPT_FLAGS} ${PROF_FLAGS} ${MTF_COMPILETIME_FLAGS} ${MTF_INCLUDE_FLAGS} $< ${OPENCV_FLAGS} -o $@
 	
@@ -293,7 +270,7 @@ ${BUILD_DIR}/FeatureTracker.o: ${SM_SRC_DIR}/FeatureTracker.cc ${SM_HEADER_DIR}/
 ${BUILD_DIR}/RKLT.o: ${SM_SRC_DIR}/RKLT.cc ${SM_HEADER_DIR}/RKLT.h ${APPEARANCE_HEADERS} ${STATE_SPACE_HEADERS} ${SM_BASE_HEADERS} ${UTILITIES_HEADER_DIR}/excpUtils.h ${UTILITIES_HEADER_DIR}/miscUtils.h ${MACROS_HEADER_DIR}/common.h ${MACROS_HEADER_DIR}/register.h ${SM_HEADER_DIR}/GridBase.h
 	${CXX} -c ${MTF_PIC_FLAG} ${WARNING_FLAGS} ${OPT_FLAGS} ${PROF_FLAGS} ${MTF_COMPILETIME_FLAGS} ${MTF_INCLUDE_FLAGS} ${GRID_FLAGS} $< ${OPENCV_FLAGS} -o $@
 	
-${BUILD_DIR}/GridTracker.o: ${SM_SRC_DIR}/GridTracker.cc ${SM_HEADER_DIR}/GridTracker.h ${STATE_SPACE_HEADERS} ${SM_BASE_HEADERS} ${UTILITIES_HEADER_DIR}/excpUtils.h ${SM_HEADER_DIR}/GridBase.h ${SM_HEADER_DIR}/CompositeBase.h ${UTILITIES_HEADER_DIR}/miscUtils.h ${MACROS_HEADER_DIR}/common.h ${MACROS_HEADER_DIR}/register.h ${SM_HEADER_DIR}/GridBase.h
+${BUILD_DIR}/GridTracker.o: ${SM_SRC_DIR}/GridTracker.cc ${SM_HEADER_DIR}/GridTracker.h ${STATE_SPACE_HEADERS} ${SM_BASE_HEADERS} ${UTILITIES_HEADER_DIR}/excpUtils.h ${SM_HEADER_DIR}/GridBase.h ${SM_HEADER_DIR}/CompositeBase.h ${UTILITIES_HEADER_DIR}/miscUtils.h ${UTILITIES_HEADER_DIR}/parallelUtils.h ${MACROS_HEADER_DIR}/common.h ${MACROS_HEADER_DIR}/register.h ${SM_HEADER_DIR}/GridBase.h
 	${CXX} -c ${MTF_PIC_FLAG} ${WARNING_FLAGS} ${OPT_FLAGS} ${PROF_FLAGS} ${MTF_COMPILETIME_FLAGS} ${MTF_INCLUDE_FLAGS} ${GRID_FLAGS} $< ${OPENCV_FLAGS} -o $@
 	
 ${BUILD_DIR}/LineTracker.o: ${SM_SRC_DIR}/LineTracker.cc ${SM_HEADER_DIR}/LineTracker.h ${SM_HEADER_DIR}/CompositeBase.h ${ROOT_HEADER_DIR}/TrackerBase.h ${UTILITIES_HEADER_DIR}/excpUtils.h ${UTILITIES_HEADER_DIR}/miscUtils.h ${MACROS_HEADER_DIR}/common.h ${MACROS_HEADER_DIR}/register.h ${SM_HEADER_DIR}/GridBase.h
@@ -360,12 +337,15 @@ ${BUILD_DIR}/FALKParams.o: ${SM_SRC_DIR}/FALKParams.cc ${SM_HEADER_DIR}/FALKPara
 ${BUILD_DIR}/IALKParams.o: ${SM_SRC_DIR}/IALKParams.cc ${SM_HEADER_DIR}/IALKParams.h ${UTILITIES_HEADER_DIR}/excpUtils.h  ${MACROS_HEADER_DIR}/common.h
 	${CXX} -c ${MTF_PIC_FLAG} ${WARNING_FLAGS} ${OPT_FLAGS} ${PROF_FLAGS} ${MTF_COMPILETIME_FLAGS} ${MTF_INCLUDE_FLAGS} $< ${OPENCV_FLAGS} -o $@	
 	
-${BUILD_DIR}/NNParams.o: ${SM_SRC_DIR}/NNParams.cc ${SM_HEADER_DIR}/NNParams.h ${SM_HEADER_DIR}/GNNParams.h  ${UTILITIES_HEADER_DIR}/miscUtils.h ${UTILITIES_HEADER_DIR}/excpUtils.h ${MACROS_HEADER_DIR}/common.h
+${BUILD_DIR}/NNParams.o: ${SM_SRC_DIR}/NNParams.cc ${SM_HEADER_DIR}/NNParams.h ${SM_HEADER_DIR}/GNNParams.h ${SM_HEADER_DIR}/HNSWParams.h  ${UTILITIES_HEADER_DIR}/miscUtils.h ${UTILITIES_HEADER_DIR}/excpUtils.h ${MACROS_HEADER_DIR}/common.h
 	${CXX} -c ${MTF_PIC_FLAG} ${WARNING_FLAGS} ${OPT_FLAGS} ${PROF_FLAGS} ${MTF_COMPILETIME_FLAGS} ${MTF_INCLUDE_FLAGS} $< ${OPENCV_FLAGS} -o $@
 	
 ${BUILD_DIR}/GNNParams.o: ${SM_SRC_DIR}/GNNParams.cc ${SM_HEADER_DIR}/GNNParams.h ${MACROS_HEADER_DIR}/common.h
 	${CXX} -c ${MTF_PIC_FLAG} ${WARNING_FLAGS} ${OPT_FLAGS} ${PROF_FLAGS} ${MTF_COMPILETIME_FLAGS} ${MTF_INCLUDE_FLAGS} $< ${OPENCV_FLAGS} -o $@		
 	
+${BUILD_DIR}/HNSWParams.o: ${SM_SRC_DIR}/HNSWParams.cc ${SM_HEADER_DIR}/HNSWParams.h ${MACROS_HEADER_DIR}/common.h
+	${CXX} -c ${MTF_PIC_FLAG} ${WARNING_FLAGS} ${OPT_FLAGS} ${PROF_FLAGS} ${MTF_COMPILETIME_FLAGS} ${MTF_INCLUDE_FLAGS} $< ${OPENCV_FLAGS} -o $@		
+	
 ${BUILD_DIR}/FLANNParams.o: ${SM_SRC_DIR}/FLANNParams.cc ${SM_HEADER_DIR}/FLANNParams.h ${UTILITIES_HEADER_DIR}/excpUtils.h ${MACROS_HEADER_DIR}/common.h
 	${CXX} -c ${MTF_PIC_FLAG} ${WARNING_FLAGS} ${OPT_FLAGS} ${PROF_FLAGS} ${MTF_COMPILETIME_FLAGS} ${MTF_INCLUDE_FLAGS} $< ${OPENCV_FLAGS} -o $@	
 	
@@ -3,6 +3,8 @@
 
 #include "SearchMethod.h"
 #include "ESMParams.h"
+#include "NewtonSolver.h"
+#include "mtf/AM/AppearanceModel.h"
 
 _MTF_BEGIN_NAMESPACE
 
@@ -38,17 +40,26 @@ protected:
 	//! N x S jacobians of the pixel values w.r.t the SSM state vector where N = resx * resy
 	//! is the no. of pixels in the object patch
 	MatrixXd dI0_dpssm, dIt_dpssm, mean_dI_dpssm;
+	//! single precision versions of the above that are used instead if float_jac is true
+	MatrixXf dI0_dpssm_f, dIt_dpssm_f, mean_dI_dpssm_f;
+	//! store the pixel Jacobians in single precision if the AM supports it and the Hessian is first order
+	bool float_jac;
 	MatrixXd d2I0_dpssm2, d2It_dpssm2, mean_d2I_dpssm2;
 
 	//! 1 x S Jacobian of the AM error norm w.r.t. SSM state vector
 	RowVectorXd df_dp;
 	//! S x S Hessian of the AM error norm w.r.t. SSM state vector
 	MatrixXd d2f_dp2, init_d2f_dp2;
+	//! solves the Newton system formed by the above two
+	NewtonSolver solver;
 
 	VectorXd state_update, ssm_update, am_update;
 	VectorXd inv_ssm_update, inv_am_update;
 	int state_size, ssm_state_size, am_state_size;
 
+	//! quantities needed from the AM before and after the LM check in each iteration
+	AMUpdateStatus sim_required, grad_required;
+
 	int frame_id;
 
 	Matrix24d prev_corners;
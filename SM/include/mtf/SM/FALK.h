@@ -3,6 +3,8 @@
 
 #include "SearchMethod.h"
 #include "FALKParams.h"
+#include "NewtonSolver.h"
+#include "mtf/AM/AppearanceModel.h"
 
 _MTF_BEGIN_NAMESPACE
 
@@ -36,14 +38,18 @@ protected:
 	//! 1 x S Jacobian of the AM similarity function w.r.t. SSM state vector
 	RowVectorXd jacobian;
 	//! S x S Hessian of the AM similarity function w.r.t. SSM state vector
-	MatrixXd init_self_hessian, hessian;
+	MatrixXd hessian;
+	//! solves the Newton system formed by the above two
+	NewtonSolver solver;
+	//! quantities needed from the AM before and after the LM check in each iteration
+	AMUpdateStatus sim_required, grad_required;
 	//! N x S jacobians of the pixel values w.r.t the SSM state vector 
 	MatrixXd init_pix_jacobian, curr_pix_jacobian;
 	//! N x S x S hessians of the pixel values w.r.t the SSM state vector stored as a (S*S) x N 2D matrix
 	MatrixXd init_pix_hessian, curr_pix_hessian;
 
 	Matrix24d prev_corners;
-	VectorXd ssm_update;
+	VectorXd ssm_update, inv_ssm_update;
 	int frame_id;
 
 	init_profiling();
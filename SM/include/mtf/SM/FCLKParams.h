@@ -20,6 +20,10 @@ struct FCLKParams{
 	bool show_grid;
 	bool show_patch;
 	double patch_resize_factor;
+	//! accumulate the first order Hessian and the Jacobian directly from blocks of the pixel Jacobian
+	//! without storing the latter in its entirety; only used with the Current Self Hessian
+	//! if both the AM and the SSM support it, i.e. with SSD based AMs and Homography or Affine
+	bool fused_gn;
 	bool debug_mode; //! decides whether logging data will be printed for debugging purposes; 
 	//! only matters if logging is enabled at compile time
 
@@ -29,7 +33,8 @@ struct FCLKParams{
 		double _lm_delta_init, double _lm_delta_update,
 		bool _enable_learning, bool _write_ssm_updates,
 		bool _show_grid, bool _show_patch,
-		double _patch_resize_factor, bool _debug_mode);
+		double _patch_resize_factor, bool _fused_gn,
+		bool _debug_mode);
 	FCLKParams(const FCLKParams *params = nullptr);
 	static const char* toString(HessType hess_type);
 };
@@ -2,6 +2,7 @@
 #define MTF_FGNN_H
 
 #include "mtf/SM/GNN.h"
+#include "mtf/SM/HNSW.h"
 #include "mtf/Macros/common.h"
 #include <flann/flann.hpp>
 #include <memory>
@@ -18,6 +19,7 @@ namespace gnn{
 		typedef flann::Matrix<double> flannMatT;
 		typedef flann::Matrix<int> flannResultT;
 		typedef flann::Index<DistType> flannIdxT;
+		typedef hnsw::HNSW<DistType> hnswIdxT;
 
 		FGNN(DistTypePtr _dist_func, int _n_samples, int _n_dims,
 			bool _is_symmetrical = true, const ParamType *gnn_params = nullptr):
@@ -27,11 +29,14 @@ namespace gnn{
 		using GNN<DistType>::n_dims;
 		using GNN<DistType>::nodes;
 		using GNN<DistType>::params;
+		using GNN<DistType>::initNodes;
 		using GNN<DistType>::addNode;
 		using GNN<DistType>::loadGraph;
 		using GNN<DistType>::buildGraph;
 		void buildGraph(const double *dataset, flannIdxT* flann_index, 
 			const flann::SearchParams &search_params);
+		//! uses the approximate neighbors of each node found by an HNSW index built from the same dataset
+		void buildGraph(const double *dataset, hnswIdxT* hnsw_index);
 	};
 }
 _MTF_END_NAMESPACE
@@ -11,7 +11,7 @@ struct FLANNParams{
 
 	enum class IdxType{
 		GNN, KDTree, HierarchicalClustering, KMeans, Composite, Linear,
-		KDTreeSingle, KDTreeCuda3d, Autotuned
+		KDTreeSingle, KDTreeCuda3d, Autotuned, HNSW
 	};
 	enum class SearchType{ KNN, Radius };
 	static const char* toString(IdxType index_type);
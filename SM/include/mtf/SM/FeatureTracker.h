@@ -250,6 +250,11 @@ struct FeatureTrackerParams{
 	bool use_cv_flann;
 
 	bool uchar_input;
+	//! run detection, description and conversion of the input image only on the
+	//! search region instead of the full frame
+	bool detect_in_roi;
+	//! sort the matches by descriptor distance and use PROSAC sampling in the estimator
+	bool use_prosac;
 
 	//! show the locations of individual key points
 	bool show_keypoints;
@@ -269,7 +274,8 @@ struct FeatureTrackerParams{
 		int _max_iters, double _epsilon, bool _enable_pyr,
 		bool _use_cv_flann,
 		double _max_dist_ratio, int _min_matches, bool _uchar_input,
-		bool _show_keypoints, bool _show_matches, bool _debug_mode);
+		bool _detect_in_roi, bool _use_prosac, bool _show_keypoints, bool _show_matches,
+		bool _debug_mode);
 	FeatureTrackerParams(const FeatureTrackerParams *params = nullptr);
 
 	int getResX() const{ return grid_size_x; }
@@ -354,6 +360,10 @@ private:
 	int n_pts, n_key_pts, n_good_key_pts;
 	cv::Size search_window;
 	cv::Mat curr_descriptors, prev_descriptors;
+	//! mask for restricting detection to the search region that is reused across frames
+	//! by clearing only the region set in the last frame
+	cv::Mat search_mask;
+	cv::Rect search_mask_region;
 	std::vector<uchar> pix_mask;
 	std::vector<int> good_indices;
 
@@ -368,6 +378,9 @@ private:
 	int pause_seq;
 	bool use_feature_detector;
 
+	//! detects keypoints in the given region of the current image and computes their descriptors
+	void detectKeyPoints(const cv::Rect &region, std::vector<cv::KeyPoint> &key_pts,
+		cv::Mat &descriptors);
 	void matchKeyPoints();
 	void cmptWarpedCorners();
 	void showKeyPoints();
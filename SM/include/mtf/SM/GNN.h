@@ -2,6 +2,7 @@
 #define MTF_GNN_H
 
 #include "mtf/SM/GNNParams.h"
+#include "mtf/Utilities/cacheUtils.h"
 
 #include <vector>
 #include <memory>
@@ -9,15 +10,37 @@
 _MTF_BEGIN_NAMESPACE
 
 namespace gnn{
+	//! the neighbor indices point either into the storage owned by the graph
+	//! or into the memory mapped file from which it was loaded
 	struct Node{
-		VectorXi nns_inds;
+		int *nns_inds;
 		int size;
 		int capacity;
+	};
+	//! header of the graph files; the neighbors of all nodes are stored in
+	//! compressed sparse row format so that the loaded graph can be used in place
+	struct GraphHeader{
+		char magic[8];
+		uint32_t version;
+		uint32_t header_size;
+		int32_t n_samples, n_dims;
+		//! identifies the dataset from which the graph was built
+		uint64_t dataset_key;
+		//! offsets from the start of the file
+		uint64_t nns_offsets_offset, nns_inds_offset;
+		uint64_t file_size;
 	};
 	struct IndxDist{
 		double dist;
 		int idx;
 	};
+	//! candidate neighbor of a node during NN-Descent
+	struct NNDNeighbor{
+		double dist;
+		int idx;
+		//! neighbors are new until they have taken part in a local join
+		bool is_new;
+	};
 	inline int cmpQsort(const void *a, const void *b){
 		IndxDist *a1 = (IndxDist *)a;
 		IndxDist *b1 = (IndxDist *)b;
@@ -32,6 +55,7 @@ namespace gnn{
 	public:
 
 		typedef GNNParams ParamType;
+		typedef ParamType::BuildType BuildType;
 		typedef std::shared_ptr<const DistType> DistTypePtr;
 
 		GNN(DistTypePtr _dist_func, int _n_samples, int _n_dims,
@@ -41,8 +65,11 @@ namespace gnn{
 		void buildGraph(const double *dataset);
 		void searchGraph(const double *query, const double *dataset, 
 			int *nn_ids, double *nn_dists, int K = 1);
-		void saveGraph(const char* file_name);
-		void loadGraph(const char* file_name);
+		//! dataset_key should uniquely identify the dataset from which the graph was built
+		void saveGraph(const char* file_name, unsigned long long dataset_key = 0);
+		//! returns false if the file does not exist, does not match the dataset or has neighbors outside it
+		//! in which case the graph is left unchanged and must be rebuilt
+		bool loadGraph(const char* file_name, unsigned long long dataset_key = 0);
 
 		void  buildGraph(const double *X, int k);
 		int searchGraph(const double *Xq, const double *X, 
@@ -55,10 +82,15 @@ namespace gnn{
 		const bool is_symmetrical;
 		ParamType params;
 		std::vector<Node> nodes;
+		//! neighbor indices of each node when the graph was built rather than loaded
+		std::vector<VectorXi> nns_storage;
+		utils::MappedFile graph_file;
 		MatrixXd dataset_distances;
 
 		int start_node_idx;
 		bool dist_computed;
+		//! workspaces for searchGraph
+		std::vector<IndxDist> gnn_dists_buf, visited_nodes_buf;
 
 		int getRandNum(int lb, int ub){
 			//  time_t sec;
@@ -83,7 +115,12 @@ namespace gnn{
 		void pickKNNs(IndxDist *vis_nodes, int visited, IndxDist **gnn_dists,
 			int K, int *gnns_cap);
 
-		void addNode(Node *node_i, int nn);
+		//! allocates storage for the given no. of neighbors of every node and 
+		//! releases the loaded graph if any
+		void initNodes(int capacity);
+		void addNode(int node_id, int nn);
+		//! builds an approximate graph using NN-Descent without computing the distances between all pairs of samples
+		void buildGraphNND(const double *dataset);
 	};
 }
 _MTF_END_NAMESPACE
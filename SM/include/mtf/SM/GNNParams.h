@@ -7,15 +7,35 @@ _MTF_BEGIN_NAMESPACE
 
 namespace gnn{	
 	struct GNNParams{
+		enum class BuildType{
+			BruteForce,
+			NNDescent
+		};
 		int degree;
 		int max_steps;
 		int cmpt_dist_thresh;
 		bool random_start;
+		//! method used for finding the neighbors of each node while building the graph
+		BuildType build_type;
+		//! maximum no. of iterations of NN-Descent
+		int nnd_max_iters;
+		//! fraction of the new neighbors of each node that take part in the local join in each iteration
+		double nnd_sample_rate;
+		//! NN-Descent terminates when the fraction of neighbors updated in an iteration falls below this
+		double nnd_delta;
+		//! NN-Descent also terminates when the recall of the graph against the exact neighbors 
+		//! of a subset of the nodes reaches this; setting it to 0 disables the recall estimation
+		double nnd_target_recall;
+		//! no. of threads used for building the graph with NN-Descent; <= 0 uses all the available cores
+		int n_threads;
 		bool verbose;
 		GNNParams(int _dgree, int _max_steps,
 			int _cmpt_dist_thresh, bool _random_start,
-			bool _verbose);
+			BuildType _build_type, int _nnd_max_iters,
+			double _nnd_sample_rate, double _nnd_delta,
+			double _nnd_target_recall, int _n_threads, bool _verbose);
 		GNNParams(const GNNParams *params = nullptr);
+		static const char* toString(BuildType _build_type);
 	};
 }
 _MTF_END_NAMESPACE
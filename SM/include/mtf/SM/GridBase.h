@@ -9,7 +9,7 @@ class GridBase : public CompositeBase{
 public:
 	GridBase(const vector<TrackerBase*> _trackers) :
 		CompositeBase(_trackers), pix_mask_needed(false){}
-	GridBase(){}
+	GridBase() : pix_mask_needed(false){}
 	virtual void initPixMask(){ pix_mask_needed = true; }
 	virtual const uchar* getPixMask() = 0;
 	virtual int getResX() = 0;
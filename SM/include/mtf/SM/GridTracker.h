@@ -2,8 +2,10 @@
 #define MTF_GRID_TRACKER2_H
 
 #include "GridBase.h"
+#include "mtf/Utilities/parallelUtils.h"
 
 #include <vector>
+#include <memory>
 
 #define GT_GRID_SIZE_X 10
 #define GT_GRID_SIZE_Y 10
@@ -14,7 +16,7 @@
 #define GT_PATCH_CENTROID_INSIDE true
 #define GT_FB_ERR_THRESH 0
 #define GT_FB_REINIT true
-#define GT_USE_TBB true
+#define GT_N_THREADS 0
 #define GT_MAX_ITERS 1
 #define GT_EPSILON 0.01
 #define GT_ENABLE_PYR 0
@@ -37,7 +39,8 @@ struct GridTrackerParams{
 	double fb_err_thresh;
 	bool fb_reinit;
 
-	bool use_tbb;
+	//! no. of threads among which the patch trackers are divided; <= 0 uses all the available cores
+	int n_threads;
 
 	int max_iters; //! maximum iterations of the GridTracker algorithm to run for each frame
 	double epsilon;
@@ -54,7 +57,7 @@ struct GridTrackerParams{
 		int _patch_size_x, int _patch_size_y,
 		int _reset_at_each_frame, bool _dyn_patch_size,
 		bool _patch_centroid_inside, double fb_err_thresh,
-		bool _fb_reinit, bool _use_tbb, int _max_iters, double _epsilon,
+		bool _fb_reinit, int _n_threads, int _max_iters, double _epsilon,
 		bool _enable_pyr,bool _show_trackers, 
 		bool _show_tracker_edges,bool _debug_mode);
 	GridTrackerParams(const GridTrackerParams *params = nullptr);
@@ -102,7 +105,6 @@ private:
 	std::vector<cv::Point2f> prev_pts;
 	std::vector<cv::Point2f> curr_pts;
 
-	cv::Mat patch_corners;
 	std::vector<uchar> pix_mask;
 	VectorXd ssm_update;
 
@@ -120,6 +122,8 @@ private:
 	std::vector<cv::Point2f> fb_prev_pts;
 	VectorXb fb_err_mask;
 	bool enable_fb_err_est;
+	//! runs the patch trackers in parallel
+	std::unique_ptr<utils::TaskArena> task_arena;
 
 	~GridTracker(){}
 	void resetTrackers(bool reinit=true);
@@ -0,0 +1,169 @@
+#ifndef MTF_GRID_TRACKER_BATCH_H
+#define MTF_GRID_TRACKER_BATCH_H
+
+#include "GridBase.h"
+#include <vector>
+
+#define GTB_GRID_SIZE_X 10
+#define GTB_GRID_SIZE_Y 10
+#define GTB_PATCH_SIZE_X 10
+#define GTB_PATCH_SIZE_Y 10
+#define GTB_PATCH_RES_X 0
+#define GTB_PATCH_RES_Y 0
+#define GTB_AM_TYPE GridTrackerBatchParams::AMType::SSD
+#define GTB_SSM_TYPE GridTrackerBatchParams::SSMType::Translation
+#define GTB_RESET_AT_EACH_FRAME 1
+#define GTB_PATCH_CENTROID_INSIDE true
+#define GTB_MAX_ITERS 30
+#define GTB_EPSILON 0.01
+#define GTB_SHOW_TRACKERS 0
+#define GTB_DEBUG_MODE 0
+
+_MTF_BEGIN_NAMESPACE
+
+struct GridTrackerBatchParams{
+	//! AMs supported by the patch trackers;
+	//! ZNCC is SSD between patches normalized to have zero mean and unit variance
+	//! so it is also used in place of NCC whose optimum is the same
+	enum class AMType{ SSD, ZNCC };
+	//! SSMs supported by the patch trackers: 2 DOF translation and 3 DOF isotropic scaling with translation
+	enum class SSMType{ Translation, IST };
+
+	int grid_size_x, grid_size_y;
+	int patch_size_x, patch_size_y;
+	//! no. of pixels sampled from each patch in each direction; 0 uses the patch size
+	int patch_res_x, patch_res_y;
+
+	AMType am_type;
+	SSMType ssm_type;
+
+	//! 0: patches are not reset; 1: patches are reset to the grid and their templates are updated;
+	//! 2: patches are reset to the grid but their templates are retained
+	int reset_at_each_frame;
+	bool patch_centroid_inside;
+
+	int max_iters; //! maximum iterations of the patch trackers to run for each frame
+	double epsilon;
+
+	bool show_trackers;// show the locations of individual patch trackers
+
+	bool debug_mode; //! decides whether logging data will be printed for debugging purposes;
+	//! only matters if logging is enabled at compile time
+
+	GridTrackerBatchParams(
+		int _grid_size_x, int _grid_size_y,
+		int _patch_size_x, int _patch_size_y,
+		int _patch_res_x, int _patch_res_y,
+		AMType _am_type, SSMType _ssm_type,
+		int _reset_at_each_frame, bool _patch_centroid_inside,
+		int _max_iters, double _epsilon,
+		bool _show_trackers, bool _debug_mode);
+	GridTrackerBatchParams(const GridTrackerBatchParams *params = nullptr);
+
+	int getResX() const{ return resx; }
+	int getResY() const{ return resy; }
+	static const char* toString(AMType _am_type);
+	static const char* toString(SSMType _ssm_type);
+
+private:
+	int resx, resy;
+	void updateRes();
+};
+
+/**
+grid tracker that runs all the patch trackers together instead of as separate tracker objects;
+this only supports the most commonly used low DOF patch trackers - inverse compositional
+Lucas Kanade with translation or IST SSMs and SSD or ZNCC AMs - but runs them in lock-step over all patches
+with the data of all patches stored in structure of arrays form so that each step of the
+optimization is vectorized across patches;
+pixel values and gradients are sampled with the same interpolation, border handling and
+gradient step as the AMs so that the results match those of GridTracker with ICLK patch trackers;
+patches that have converged are masked out of the update while the others keep iterating
+*/
+template<class SSM>
+class GridTrackerBatch : public GridBase{
+
+public:
+	typedef GridTrackerBatchParams ParamType;
+	typedef typename SSM::ParamType SSMParams;
+	typedef typename SSM::EstimatorParams EstimatorParams;
+	//! each row holds the values for one pixel or parameter in all the patches
+	typedef Array<float, Dynamic, Dynamic, RowMajor> PatchArrayT;
+	typedef Array<float, 1, Dynamic> PatchVectorT;
+
+	GridTrackerBatch(const ParamType *grid_params, const EstimatorParams *_est_params,
+		const SSMParams *ssm_params);
+
+	void initialize(const cv::Mat &corners) override;
+	void update() override;
+	void setImage(const cv::Mat &img) override;
+	void setRegion(const cv::Mat& corners) override;
+	const uchar* getPixMask() override{ return pix_mask.data(); }
+	int getResX() override{ return params.grid_size_x; }
+	int getResY() override{ return params.grid_size_y; }
+	const cv::Mat& getRegion() override{ return cv_corners_mat; }
+	int inputType() const override{ return CV_32FC1; }
+	SSM& getSSM() { return ssm; }
+
+	EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+
+private:
+
+	SSM ssm;
+	ParamType params;
+	EstimatorParams est_params;
+
+	cv::Mat curr_img;
+
+	int n_patches, n_pix, state_size;
+	bool normalize_patches;
+	//! offsets of the sampled pixels from the patch center
+	VectorXf pix_offset_x, pix_offset_y;
+
+	//! current state of each patch - center and scale change relative to the template
+	PatchVectorT patch_x, patch_y, patch_scale;
+	//! 1 for patches that are still being optimized and 0 for those that have converged
+	PatchVectorT active_mask;
+	//! squared norm of the change in the corners of each patch in the last iteration
+	//! as used for checking convergence by the patch trackers in GridTracker
+	PatchVectorT update_norm, scale_ratio;
+	//! sum of the squared distances of the patch corners from its center
+	float corner_dist_sq;
+	//! locations of all pixels in all patches stored as interleaved x, y pairs in the same order
+	//! as the values in PatchArrayT and the double precision pixel values sampled there
+	Matrix2Xd sample_pts;
+	VectorXd sample_vals, sample_vals_dec;
+	EigImgT curr_img_eig;
+
+	PatchArrayT templ_vals, curr_vals, err_vals;
+	//! Jacobian of the template with respect to each of the state parameters
+	std::vector<PatchArrayT> templ_jacobian;
+	//! inverse of the Gauss Newton Hessian with each row holding one entry for all patches
+	PatchArrayT hess_inv;
+	PatchArrayT hessian;
+	PatchArrayT jacobian_err, state_update;
+
+	std::vector<cv::Point2f> prev_pts, curr_pts;
+	cv::Mat patch_corners;
+	std::vector<uchar> pix_mask;
+	VectorXd ssm_update;
+	MatrixXi _linear_idx;//used for indexing the sub region locations
+	bool reinit_at_each_frame;
+
+	cv::Mat curr_img_uchar, curr_img_disp;
+	char* patch_win_name;
+
+	~GridTrackerBatch(){}
+	void resetPatches(bool reinit);
+	void initTemplates();
+	//! samples the current image at all pixels of all patches offset by the given amounts into vals
+	void samplePatches(VectorXd &vals, double offset_x = 0, double offset_y = 0);
+	//! inverts the Hessians of all patches together; patches without any texture get a zero inverse
+	void invertHessians();
+	void normalizePatches(PatchArrayT &vals, PatchVectorT *patch_sd = nullptr);
+	void showTrackers();
+};
+
+_MTF_END_NAMESPACE
+
+#endif
@@ -0,0 +1,105 @@
+#ifndef MTF_HNSW_H
+#define MTF_HNSW_H
+
+#include "mtf/SM/HNSWParams.h"
+
+#include <vector>
+#include <memory>
+#include <utility>
+
+_MTF_BEGIN_NAMESPACE
+
+namespace hnsw{
+	//! header of the saved index files; the levels of all the points are followed by 
+	//! the no. of neighbors and the neighbor indices of each point in each of its levels
+	struct IndexHeader{
+		char magic[8];
+		uint32_t version;
+		uint32_t header_size;
+		int32_t n_points, n_dims;
+		int32_t M, max_level;
+		int32_t entry_point, reserved;
+		//! identifies the dataset from which the index was built
+		uint64_t dataset_key;
+		uint64_t file_size;
+	};
+	/**
+	Hierarchical Navigable Small World graph where each point is present in all the layers
+	up to its randomly drawn level and the no. of points in each layer decreases exponentially
+	with the level so that a query can be greedily routed from the sparse top layer to the dense
+	bottom one in logarithmic time irrespective of where the previous nearest neighbor was
+	Malkov, Y. A. & Yashunin, D. A., 'Efficient and robust approximate nearest neighbor search 
+	using Hierarchical Navigable Small World graphs', IEEE TPAMI, 2018
+	*/
+	template<class DistType>
+	class HNSW{
+	public:
+		typedef HNSWParams ParamType;
+		typedef std::shared_ptr<const DistType> DistTypePtr;
+
+		HNSW(DistTypePtr _dist_func, int _n_dims, const ParamType *hnsw_params = nullptr);
+		~HNSW(){}
+		//! discards any existing points and inserts n_points consecutive points from the dataset
+		void buildIndex(const double *dataset, int n_points);
+		/**
+		inserts n_points consecutive points into the existing index where the new points
+		are assigned indices following those already present; the index only stores pointers 
+		to the points so they must remain valid as long as the index is in use
+		*/
+		void addPoints(const double *points, int n_points);
+		//! finds the K nearest neighbors of the query sorted by their distances
+		void searchKNN(const double *query, int *nn_ids, double *nn_dists, int K = 1);
+		int getNPoints() const{ return static_cast<int>(points.size()); }
+		//! dataset_key should uniquely identify the dataset from which the index was built
+		void saveIndex(const char* file_name, unsigned long long dataset_key = 0);
+		/**
+		loads the graph built from the first n_points points of the dataset;
+		returns false if the file does not exist or does not match the dataset 
+		in which case the index is left unchanged
+		*/
+		bool loadIndex(const char* file_name, const double *dataset, int n_points,
+			unsigned long long dataset_key = 0);
+
+	protected:
+		typedef std::pair<double, int> DistIdx;
+
+		DistTypePtr dist_func;
+		const int n_dims;
+		ParamType params;
+		//! normalization factor for the exponentially decaying distribution of the point levels
+		double level_mult;
+
+		std::vector<const double*> points;
+		//! neighbors of each point in each of the levels from 0 up to its own level
+		std::vector< std::vector< std::vector<int> > > links;
+		int entry_point, max_level;
+
+		//! points whose entry equals visit_id have been visited in the current search
+		std::vector<unsigned int> visit_marks;
+		unsigned int visit_id;
+
+		int getMaxNeighbors(int level) const{ return level == 0 ? 2 * params.M : params.M; }
+		//! drawn from a counter based stream indexed by the point so that the index is reproducible
+		int getRandomLevel(int point_id) const;
+		void startSearch();
+		//! moves to the nearest neighbor in the given level until no neighbor is closer to the query
+		void searchGreedy(const double *query, int &nn_id, double &nn_dist, int level);
+		/**
+		beam search in the given level starting from the given points; 
+		on return, nns has the ef nearest points found sorted by their distances
+		*/
+		void searchLayer(const double *query, std::vector<DistIdx> &nns, int ef, int level);
+		/**
+		heuristic for choosing the neighbors of a point from the sorted candidates that
+		skips those closer to an already chosen neighbor than to the point itself 
+		so that the links span different directions;
+		the skipped candidates are used to fill up the remaining slots
+		*/
+		void selectNeighbors(std::vector<DistIdx> &candidates, int max_neighbors);
+		void insertPoint(int point_id);
+	};
+}
+_MTF_END_NAMESPACE
+
+#endif
+
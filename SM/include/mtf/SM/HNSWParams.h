@@ -0,0 +1,27 @@
+#ifndef MTF_HNSW_PARAMS_H
+#define MTF_HNSW_PARAMS_H
+
+#include "mtf/Macros/common.h"
+
+_MTF_BEGIN_NAMESPACE
+
+namespace hnsw{
+	struct HNSWParams{
+		//! no. of neighbors each point is connected to in the upper layers;
+		//! twice as many are allowed in the bottom layer
+		int M;
+		//! size of the candidate list used when inserting points
+		int ef_construction;
+		//! size of the candidate list used when searching for the nearest neighbor;
+		//! larger values increase the recall at the cost of slower queries
+		int ef_search;
+		bool verbose;
+		HNSWParams(int _M, int _ef_construction,
+			int _ef_search, bool _verbose);
+		HNSWParams(const HNSWParams *params = nullptr);
+	};
+}
+_MTF_END_NAMESPACE
+
+#endif
+
@@ -3,6 +3,8 @@
 
 #include "SearchMethod.h"
 #include "IALKParams.h"
+#include "NewtonSolver.h"
+#include "mtf/AM/AppearanceModel.h"
 
 _MTF_BEGIN_NAMESPACE
 
@@ -38,7 +40,11 @@ protected:
 	//! 1 x S Jacobian of the AM error norm w.r.t. SSM state vector
 	RowVectorXd jacobian;
 	//! S x S Hessian of the AM error norm w.r.t. SSM state vector
-	MatrixXd init_self_hessian, hessian;
+	MatrixXd hessian;
+	//! solves the Newton system formed by the above two
+	NewtonSolver solver;
+	//! quantities needed from the AM before and after the LM check in each iteration
+	AMUpdateStatus sim_required, grad_required;
 	//! N x S jacobians of the pix values w.r.t the SSM state vector where N = resx * resy
 	//! is the no. of pixels in the object patch
 	//! N x S jacobians of the pix values w.r.t the SSM state vector 
@@ -47,7 +53,7 @@ protected:
 	MatrixXd init_pix_hessian, curr_pix_hessian;
 
 	Matrix24d prev_corners;
-	VectorXd ssm_update;
+	VectorXd ssm_update, inv_ssm_update;
 	Matrix3d warp_update;
 	int frame_id;
 
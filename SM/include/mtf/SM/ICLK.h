@@ -3,6 +3,8 @@
 
 #include "SearchMethod.h"
 #include "ICLKParams.h"
+#include "NewtonSolver.h"
+#include "mtf/AM/AppearanceModel.h"
 
 _MTF_BEGIN_NAMESPACE
 
@@ -37,9 +39,15 @@ protected:
 	//! 1 x S Jacobian of the AM error norm w.r.t. SSM state vector
 	RowVectorXd df_dp;
 	//! S x S Hessian of the AM error norm w.r.t. SSM state vector
-	MatrixXd d2f_dp2_orig, d2f_dp2;
+	MatrixXd d2f_dp2;
+	//! solves the Newton system formed by the above two
+	NewtonSolver solver;
 	//! N x S jacobians of the pixel values w.r.t the SSM state vector 
 	MatrixXd dI0_dpssm, dIt_dpssm;
+	//! single precision versions of the above that are used instead if float_jac is true
+	MatrixXf dI0_dpssm_f, dIt_dpssm_f;
+	//! store the pixel Jacobians in single precision if the AM supports it and the Hessian is first order
+	bool float_jac;
 	//! N x S x S hessians of the pixel values w.r.t the SSM state vector stored as a (S*S) x N 2D matrix
 	MatrixXd d2I0_dpssm2, d2It_dpssm2;
 
@@ -49,6 +57,8 @@ protected:
 	VectorXd inv_ssm_update, inv_am_update;
 
 	int state_size, ssm_state_size, am_state_size;
+	//! quantities needed from the AM before and after the LM check in each iteration
+	AMUpdateStatus sim_required, grad_required;
 	int frame_id;
 
 private:
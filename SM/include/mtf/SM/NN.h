@@ -5,11 +5,35 @@
 #include "FGNN.h"
 #include "NNParams.h"
 #include "FLANNParams.h"
+#include "mtf/Utilities/cacheUtils.h"
+#include "mtf/Utilities/parallelUtils.h"
 
 #include <flann/flann.hpp>
 #include <memory>
+#include <list>
 
 _MTF_BEGIN_NAMESPACE
+
+//! header of the saved feature datasets; a dataset is only reused if all of these match the current tracker;
+//! the sampler sigma and mean for each distribution, the dataset itself and the SSM perturbations
+//! are stored at the given offsets from the start of the file which are aligned so they can be used in place
+struct NNCacheHeader{
+	char magic[8];
+	uint32_t version;
+	uint32_t header_size;
+	char am_name[32];
+	char ssm_name[32];
+	uint32_t resx, resy;
+	uint32_t n_samples, feat_size;
+	uint32_t state_size, n_distr;
+	uint32_t additive_update, reserved;
+	//! hash of the pixel values of the initial patch
+	uint64_t init_pix_hash;
+	//! hash of all of the above along with the sampler parameters
+	uint64_t key;
+	uint64_t distr_offset, dataset_offset;
+	uint64_t perturbations_offset, file_size;
+};
 
 template<class AM, class SSM>
 class NN : public SearchMethod < AM, SSM > {
@@ -25,6 +49,8 @@ public:
 	typedef unique_ptr<FLANN> FLANN_;
 	typedef gnn::FGNN<DistType> FGNN;
 	typedef unique_ptr<FGNN> FGNN_;
+	typedef hnsw::HNSW<DistType> HNSW;
+	typedef unique_ptr<HNSW> HNSW_;
 
 
 	typedef NNParams ParamType;
@@ -48,15 +74,38 @@ public:
 
 	void initialize(const cv::Mat &corners) override;
 	void update() override;
+	void setImage(const cv::Mat &img) override;
 
 private:
 
+	//! no. of workers among which the samples are divided while generating the dataset;
+	//! the first one uses the main AM and SSM while each of the others has its own copies
+	int n_workers;
+	typedef std::unique_ptr<AM> AMPTr;
+	typedef std::unique_ptr<SSM> SSMPTr;
+	std::vector<AMPTr> am_vec;
+	std::vector<SSMPTr> ssm_vec;
+	//! runs the workers in parallel
+	std::unique_ptr<utils::TaskArena> task_arena;
+	//! draw each perturbation from its own counter based stream so that
+	//! the dataset does not depend on the no. of workers
+	bool use_sampler_streams;
+	unsigned long long sampler_seed;
+	//! total no. of samples generated so far - used for assigning unique streams to new samples
+	unsigned long long n_generated_samples;
+
 	ParamType params;
 	FLANNParams flann_params;
 	FLANN_ flann_index;
 	FGNN_ gnn_index;
+	HNSW_ hnsw_index;
 
 	flannMatT_ flann_dataset;
+	//! points either to eig_dataset or to the dataset in the memory mapped cache file
+	double *dataset_data;
+	utils::MappedFile dataset_file;
+	//! content based key of the dataset that is also used in the names of the cache files
+	unsigned long long cache_key;
 
 	int frame_id;
 	unsigned int am_dist_size;
@@ -71,7 +120,8 @@ private:
 	vector<VectorXd> state_sigma, state_mean;
 
 	Matrix24d prev_corners;
-	VectorXd inv_state_update;
+	//! one for each worker
+	vector<VectorXd> inv_state_updates;
 
 	vector<VectorXd> ssm_perturbations;
 
@@ -81,6 +131,8 @@ private:
 	VectorXd eig_dists;
 
 	MatrixXdr eig_dataset_added;
+	//! the indices only store pointers to the added samples so each batch is kept here as long as the index exists
+	std::list<MatrixXdr> added_datasets;
 	vector<VectorXd> ssm_perturbations_added;
 	VectorXi distr_n_samples_added;
 
@@ -97,8 +149,21 @@ private:
 	char *log_fname;
 	char *time_fname;
 
+	AM& getWorkerAM(int worker_id){
+		return worker_id == 0 ? am : *am_vec[worker_id - 1];
+	}
+	SSM& getWorkerSSM(int worker_id){
+		return worker_id == 0 ? ssm : *ssm_vec[worker_id - 1];
+	}
 	void generateDataset(vector<VectorXd> &perturbations, 
 		MatrixXdr &dataset, const VectorXi &_distr_n_samples);
+	//! generates the samples in the range [start_id, end_id) using the given AM and SSM
+	void generateSamples(AM &worker_am, SSM &worker_ssm, VectorXd &inv_state_update,
+		vector<VectorXd> &perturbations, MatrixXdr &dataset, 
+		const VectorXi &_distr_n_samples, int start_id, int end_id);
+	void showSamples(const vector<VectorXd> &perturbations);
+	void fillCacheHeader(NNCacheHeader &header);
+	void initializeCache();
 	void loadDataset();
 	void saveDataset();
 };
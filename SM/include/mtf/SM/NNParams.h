@@ -2,6 +2,7 @@
 #define MTF_NN_PARAMS_H
 
 #include "mtf/SM/GNNParams.h"
+#include "mtf/SM/HNSWParams.h"
 #include "mtf/Macros/common.h"
 
 _MTF_BEGIN_NAMESPACE
@@ -9,6 +10,7 @@ _MTF_BEGIN_NAMESPACE
 struct NNParams{
 
 	gnn::GNNParams gnn;
+	hnsw::HNSWParams hnsw;
 
 	int n_samples;
 
@@ -36,12 +38,20 @@ struct NNParams{
 	bool load_index;
 	std::string saved_index_dir;
 
+	//! no. of threads among which the samples are divided for generating the dataset;
+	//! each thread other than the first uses its own copies of the AM and SSM; <= 0 uses all the available cores
+	int n_threads;
+	//! draw the perturbation of each sample from its own counter based stream so that the dataset
+	//! does not depend on n_threads; the SSM uses its default generator otherwise
+	bool sampler_streams;
+
 	//! decides whether logging data will be printed for debugging purposes; 
 	//! only matters if logging is enabled at compile time
 	bool debug_mode;
 
 	NNParams(
 		const gnn::GNNParams *_gnn,
+		const hnsw::HNSWParams *_hnsw,
 		int _n_samples,
 		int _max_iters,
 		double _epsilon,
@@ -56,6 +66,8 @@ struct NNParams{
 		bool load_index,
 		bool _save_index,
 		std::string _saved_index_dir,
+		int _n_threads,
+		bool _sampler_streams,
 		bool _debug_mode);
 	NNParams(const NNParams *params = nullptr);
 	/**
@@ -125,6 +125,7 @@ namespace nt{
 		void linearMultinomialResampling();
 		void binaryMultinomialResampling();
 		void residualResampling();
+		void stratifiedResampling(bool systematic);
 		void initializeParticles();
 		void initializeDistributions();
 		void updateMeanCorners();
@@ -0,0 +1,102 @@
+#ifndef MTF_NEWTON_SOLVER_H
+#define MTF_NEWTON_SOLVER_H
+
+#include "mtf/Macros/common.h"
+
+#define NS_RANK_TOL 1e-10
+
+_MTF_BEGIN_NAMESPACE
+
+/**
+solves the S x S Newton system of the gradient based SMs for the update:
+	-(H + lambda*diag(H))^-1 * J^T
+where H is the Hessian and J is the 1 x S Jacobian of the similarity w.r.t. the state vector
+and lambda is the Levenberg Marquardt damping factor;
+the system is factorized with LDLT which, unlike plain Cholesky, also works with the
+negative definite Hessians of similarity measures that are maximized;
+if H turns out to be (numerically) rank deficient, colPivHouseholderQr is used instead;
+SSMs do not expose their state size at compile time so it is checked when the system is solved
+and the common sizes are dispatched to fixed size kernels that do not allocate any memory
+for either of the two factorizations;
+the undamped system is retained so that it can be re-solved with a different damping
+when an LM step is rejected without having to recompute H and J
+*/
+class NewtonSolver{
+public:
+	NewtonSolver(int _state_size = 0, double _rank_tol = NS_RANK_TOL) :
+		state_size(0), rank_tol(_rank_tol){
+		resize(_state_size);
+	}
+	void resize(int _state_size){
+		state_size = _state_size;
+		hessian.resize(state_size, state_size);
+		damped_hessian.resize(state_size, state_size);
+		neg_jacobian.resize(state_size);
+		ldlt = LDLT<MatrixXd>(state_size);
+	}
+	int getStateSize() const{ return state_size; }
+	//! stores the given system and solves it with the given damping
+	template<typename HessT, typename JacT, typename UpdateT>
+	void solve(UpdateT &update, const HessT &_hessian, const JacT &_jacobian,
+		double damping = 0){
+		hessian = _hessian;
+		neg_jacobian = -_jacobian.transpose();
+		resolve(update, damping);
+	}
+	//! solves the system passed to the last call to solve with a different damping
+	template<typename UpdateT>
+	void resolve(UpdateT &update, double damping){
+		damped_hessian = hessian;
+		if(damping != 0){
+			damped_hessian.diagonal() += damping*hessian.diagonal();
+		}
+		switch(state_size){
+		case 2: solveFixed<2>(update); break;
+		case 3: solveFixed<3>(update); break;
+		case 4: solveFixed<4>(update); break;
+		case 6: solveFixed<6>(update); break;
+		case 8: solveFixed<8>(update); break;
+		default:
+			ldlt.compute(damped_hessian);
+			if(isFullRank(ldlt)){
+				update = ldlt.solve(neg_jacobian);
+			} else{
+				update = damped_hessian.colPivHouseholderQr().solve(neg_jacobian);
+			}
+		}
+	}
+
+private:
+	int state_size;
+	//! ratio of the smallest to the largest pivot below which the system is considered rank deficient
+	double rank_tol;
+	MatrixXd hessian, damped_hessian;
+	VectorXd neg_jacobian;
+	LDLT<MatrixXd> ldlt;
+
+	template<int N, typename UpdateT>
+	void solveFixed(UpdateT &update){
+		typedef Matrix<double, N, N> HessianT;
+		typedef Matrix<double, N, 1> VectorT;
+		const HessianT fixed_hessian(Map<const HessianT>(damped_hessian.data()));
+		Map<const VectorT> fixed_neg_jacobian(neg_jacobian.data());
+		LDLT<HessianT> fixed_ldlt(fixed_hessian);
+		if(isFullRank(fixed_ldlt)){
+			update = fixed_ldlt.solve(fixed_neg_jacobian);
+		} else{
+			// poorly scaled SSMs like the unnormalized homography often end up here
+			// so this has to be allocation free too
+			update = ColPivHouseholderQR<HessianT>(fixed_hessian).solve(fixed_neg_jacobian);
+		}
+	}
+	template<typename LDLTT>
+	bool isFullRank(const LDLTT &_ldlt) const{
+		if(_ldlt.info() != Success){ return false; }
+		double max_pivot = _ldlt.vectorD().cwiseAbs().maxCoeff();
+		return max_pivot > 0 && _ldlt.vectorD().cwiseAbs().minCoeff() > rank_tol*max_pivot;
+	}
+};
+
+_MTF_END_NAMESPACE
+
+#endif
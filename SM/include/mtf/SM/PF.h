@@ -6,10 +6,11 @@
 #include <boost/random/normal_distribution.hpp>
 #include <boost/random/uniform_real_distribution.hpp>
 #include "PFParams.h"
-
-#ifdef ENABLE_PARALLEL
+#include "mtf/Utilities/parallelUtils.h"
 #include <memory>
-#endif
+
+//! no. of particles whose patches are warped and sampled together when the SSM and AM support it
+#define PF_PATCH_BATCH_SIZE 16
 
 _MTF_BEGIN_NAMESPACE
 
@@ -67,15 +68,23 @@ public:
 	void initialize(const cv::Mat &corners) override;
 	void update() override;
 	void setRegion(const cv::Mat& corners) override;
+	void setImage(const cv::Mat &img) override;
 
 protected:
 
-#ifdef ENABLE_PARALLEL
+	//! no. of workers among which the particles are divided for evaluation;
+	//! the first one uses the main AM and SSM while each of the others has its own copies
+	int n_workers;
 	typedef std::unique_ptr<AM> AMPTr;
 	typedef std::unique_ptr<SSM> SSMPTr;
 	std::vector<AMPTr> am_vec;
 	std::vector<SSMPTr> ssm_vec;
-#endif
+	//! runs the workers in parallel
+	std::unique_ptr<utils::TaskArena> task_arena;
+	//! draw the perturbation of each particle from its own counter based stream 
+	//! so that the results do not depend on the no. of workers
+	bool use_sampler_streams;
+	unsigned long long sampler_seed;
 
 	ParamType params;
 
@@ -97,12 +106,16 @@ protected:
 	CornersT prev_corners;
 
 	VectorXd mean_state;
-	// SSM states for all particles
-	// 2 sets of particles are stored for efficient resampling
-	std::vector<VectorXd> particle_states[2];
-	// Update history for Auto Regression
-	std::vector<VectorXd> particle_ar[2];
+	//! S x N matrices with the SSM states for all particles in contiguous columns;
+	//! 2 sets of particles are stored for efficient resampling
+	MatrixXd particle_states[2];
+	//! update history for Auto Regression
+	MatrixXd particle_ar[2];
 	int curr_set_id;
+	//! buffer for passing the state of a single particle to the SSM
+	VectorXd particle_state;
+	//! particle states copied into separate vectors for SSM based mean computation
+	std::vector<VectorXd> mean_samples;
 
 	//! ID of the particle with the maximum weight
 	int max_wt_id;
@@ -110,15 +123,22 @@ protected:
 	VectorXd particle_wts;
 	VectorXd particle_cum_wts;
 
-	VectorXd perturbed_state;
-	VectorXd perturbed_ar;
+	//! one for each worker
+	std::vector<VectorXd> perturbed_states, perturbed_ars;
+	std::vector<VectorXd> base_states, base_ars;
+	//! points and pixel values for PF_PATCH_BATCH_SIZE particles at a time
+	std::vector<Matrix2Xd> batch_pts;
+	std::vector<MatrixXdr> batch_pix_vals;
+	//! true if the SSM can warp and the AM can sample patches for many particles at once
+	bool use_patch_batch;
 
 	VectorXd state_sigma, state_mean;
 	VectorXi resample_ids;
+	//! particle indices sorted by weight for residual resampling
+	VectorXi particle_idx;
 	VectorXd uniform_rand_nums;
 	bool using_pix_sigma;
 
-	double measurement_likelihood;
 	double measurement_factor;
 	cv::Mat curr_img_uchar;
 
@@ -128,10 +148,28 @@ protected:
 	char *log_fname;
 	char *time_fname;
 
+	AM& getWorkerAM(int worker_id){
+		return worker_id == 0 ? am : *am_vec[worker_id - 1];
+	}
+	SSM& getWorkerSSM(int worker_id){
+		return worker_id == 0 ? ssm : *ssm_vec[worker_id - 1];
+	}
+	//! generates and evaluates the particles in the range [start_id, end_id) using the given AM and SSM
+	void updateParticles(AM &worker_am, SSM &worker_ssm, int start_id, int end_id,
+		VectorXd &perturbed_state, VectorXd &perturbed_ar,
+		VectorXd &base_state, VectorXd &base_ar, Matrix2Xd &pts_batch,
+		MatrixXdr &pix_vals_batch, int iter_id);
+	void showParticles(int &pause_after_show);
 	void initializeParticles();
+	//! each of these only finds the IDs of the resampled particles
 	void linearMultinomialResampling();
 	void binaryMultinomialResampling();
 	void residualResampling();
+	//! draws a single random number for all N equal sized strata of [0, 1] if systematic is true
+	//! and one for each stratum otherwise; both need a single pass over the cumulative weights
+	void stratifiedResampling(bool systematic);
+	//! copies the resampled particles into the other set and makes it the current one
+	void gatherResampledParticles();
 	void updateMeanCorners();
 };
 
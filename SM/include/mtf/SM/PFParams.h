@@ -19,7 +19,9 @@ struct PFParams{
 		None,
 		BinaryMultinomial,
 		LinearMultinomial,
-		Residual
+		Residual,
+		Systematic,
+		Stratified
 	};
 	enum class LikelihoodFunc{
 		AM,
@@ -84,6 +86,12 @@ struct PFParams{
 	int show_particles;
 	bool enable_learning;
 	bool jacobian_as_sigma;
+	//! no. of threads among which the particles are divided for evaluation;
+	//! each thread other than the first uses its own copies of the AM and SSM; <= 0 uses all the available cores
+	int n_threads;
+	//! draw the perturbation of each particle from its own counter based stream so that the results
+	//! do not depend on n_threads; the SSM uses its default generator otherwise
+	bool sampler_streams;
 	//! decides whether logging data will be printed for debugging purposes; 
 	bool debug_mode;
 	PFParams(int _max_iters, int _n_particles, double _epsilon,
@@ -96,7 +104,8 @@ struct PFParams{
 		double _adaptive_resampling_thresh,
 		const vectord &_pix_sigma, double _measurement_sigma,
 		int _show_particles, bool _enable_learning,
-		bool _jacobian_as_sigma, bool _debug_mode);
+		bool _jacobian_as_sigma, int _n_threads, bool _sampler_streams,
+		bool _debug_mode);
 	PFParams(const PFParams *params = nullptr);
 	/**
 	parse the provided mean and sigma and apply several priors
@@ -8,6 +8,9 @@
 #define PARL_AUTO_REINIT 0
 #define PARL_REINIT_ERR_THRESH 1
 #define PRL_SM_REINIT_FRAME_GAP 1
+#define PRL_N_THREADS 0
+#define PRL_PIN_THREADS 0
+#define PRL_REINIT_SHARE_FRAMES 0
 
 _MTF_BEGIN_NAMESPACE
 
@@ -21,9 +24,21 @@ struct ParallelParams {
 	bool auto_reinit;
 	double reinit_err_thresh;
 	int reinit_frame_gap;
+	//! no. of threads in the task arena used for running the trackers;
+	//! 0 uses one thread for each tracker
+	int n_threads;
+	//! bind each thread in the arena to a different core (Linux only)
+	bool pin_threads;
+	/**
+	keep references to the input frames in the reinitialization buffer instead of copying them;
+	this is only correct if the input source allocates a new buffer for each frame rather than
+	reusing the same one, otherwise all entries in the buffer will end up pointing to the latest frame
+	*/
+	bool reinit_share_frames;
 	static const char* toString(PrlEstMethod _estimation_method);
 	ParallelParams(PrlEstMethod _estimation_method, bool _reset_to_mean,
-		bool _auto_reinit, double _reinit_err_thresh, int _reinit_frame_gap);
+		bool _auto_reinit, double _reinit_err_thresh, int _reinit_frame_gap,
+		int _n_threads, bool _pin_threads, bool _reinit_share_frames);
 	ParallelParams(const ParallelParams *params = nullptr);
 };
 
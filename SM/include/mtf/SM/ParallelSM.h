@@ -3,9 +3,12 @@
 
 #include "CompositeSM.h"
 #include "mtf/SM/ParallelParams.h"
+#include <memory>
 
 _MTF_BEGIN_NAMESPACE
 
+namespace utils{ class TaskArena; }
+
 /**
 run multiple search methods in parallel with the same AM/SSM; although the code here
 is currently identical to ParallelTracker, a seperate module exists for future extensions
@@ -53,6 +56,13 @@ protected:
 	std::vector<VectorXd> ssm_states;
 	VectorXd mean_state;
 
+	//! worker threads that are reused for running the search methods in every frame
+	std::shared_ptr<utils::TaskArena> task_arena;
+
+	template<typename FuncT>
+	void runTrackers(const FuncT &func);
+	void reinitTrackers();
+	void bufferFrame(const cv::Mat &corners);
 };
 
 
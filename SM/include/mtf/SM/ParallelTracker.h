@@ -3,9 +3,12 @@
 
 #include "CompositeBase.h"
 #include "mtf/SM/ParallelParams.h"
+#include <memory>
 
 _MTF_BEGIN_NAMESPACE
 
+namespace utils{ class TaskArena; }
+
 //! run multiple trackers in parallel
 class ParallelTracker : public CompositeBase {
 
@@ -30,6 +33,16 @@ protected:
 	bool buffer_filled;
 	cv::Mat curr_img;
 	cv::Mat mean_corners_cv;
+	//! worker threads that are reused for running the trackers in every frame
+	std::shared_ptr<utils::TaskArena> task_arena;
+
+	//! runs func(tracker_id) for all trackers in the task arena and waits for them to finish
+	template<typename FuncT>
+	void runTrackers(const FuncT &func);
+	//! reinitializes all trackers on the oldest frame in the buffer and updates them on the rest
+	void reinitTrackers();
+	//! adds the current frame and the given corners to the reinitialization buffer
+	void bufferFrame(const cv::Mat &corners);
 };
 
 _MTF_END_NAMESPACE
@@ -2,6 +2,7 @@
 #define MTF_PYRAMIDAL_PARAMS_H
 
 #include "mtf/Macros/common.h"
+#include <memory>
 
 #define PYRL_NO_OF_LEVELS 3
 #define PYRL_SCALE_FACTOR 0
@@ -11,12 +12,17 @@
 
 _MTF_BEGIN_NAMESPACE
 
+namespace utils{ class ImagePyramidCache; }
+
 struct PyramidalParams {
 	int no_of_levels;
 	double scale_factor;
 	bool show_levels;
+	//! optional cache shared with other trackers running on the same frame
+	//! from which the pyramid is obtained instead of building it here
+	std::shared_ptr<utils::ImagePyramidCache> img_pyr_cache;
 	PyramidalParams(int no_of_levels, double scale_factor, 
-		bool show_levels);
+		bool show_levels, const std::shared_ptr<utils::ImagePyramidCache> &img_pyr_cache);
 	PyramidalParams(const PyramidalParams *params = nullptr);
 };
 
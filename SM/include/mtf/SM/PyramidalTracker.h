@@ -29,6 +29,8 @@ protected:
 	ParamType params;
 	vector<cv::Size> img_sizes;
 	vector<cv::Mat> img_pyramid;
+	//! levels retrieved from the shared cache if there is one
+	vector<cv::Mat> cached_pyramid;
 	double overall_scale_factor;
 	bool external_img_pyramid;
 	void updateImagePyramid();
@@ -39,6 +39,10 @@ ESM<AM, SSM >::ESM(const ParamType *esm_params,
 	if(params.leven_marq){
 		printf("Using Levenberg Marquardt formulation...\n");
 	}
+	float_jac = am.supportsFloatJacobian() && !params.sec_ord_hess;
+	if(float_jac){
+		printf("Using single precision pixel Jacobians...\n");
+	}
 
 	ssm_state_size = ssm.getStateSize();
 	am_state_size = am.getStateSize();
@@ -54,15 +58,30 @@ ESM<AM, SSM >::ESM(const ParamType *esm_params,
 
 	df_dp.resize(state_size);
 	d2f_dp2.resize(state_size, state_size);
+	solver.resize(state_size);
+	//! the similarity itself is only needed for the LM check
+	sim_required.similarity = params.leven_marq;
+	sim_required.sim_prereq = true;
+	grad_required.curr_grad = true;
+	grad_required.init_grad = params.jac_type == JacType::DiffOfJacs || params.hess_type == HessType::SumOfStd;
+	grad_required.pix_grad = true;
+	grad_required.pix_hess = params.sec_ord_hess && params.hess_type != HessType::InitialSelf;
 	if(params.hess_type == HessType::SumOfSelf){
 		init_d2f_dp2.resize(state_size, state_size);
 	}
 
-	dI0_dpssm.resize(am.getPatchSize(), ssm_state_size);
-	dIt_dpssm.resize(am.getPatchSize(), ssm_state_size);
-
-	if(params.jac_type == JacType::Original || params.hess_type == HessType::Original){
-		mean_dI_dpssm.resize(am.getPatchSize(), ssm_state_size);
+	if(float_jac){
+		dI0_dpssm_f.resize(am.getPatchSize(), ssm_state_size);
+		dIt_dpssm_f.resize(am.getPatchSize(), ssm_state_size);
+		if(params.jac_type == JacType::Original || params.hess_type == HessType::Original){
+			mean_dI_dpssm_f.resize(am.getPatchSize(), ssm_state_size);
+		}
+	} else{
+		dI0_dpssm.resize(am.getPatchSize(), ssm_state_size);
+		dIt_dpssm.resize(am.getPatchSize(), ssm_state_size);
+		if(params.jac_type == JacType::Original || params.hess_type == HessType::Original){
+			mean_dI_dpssm.resize(am.getPatchSize(), ssm_state_size);
+		}
 	}
 	if(params.sec_ord_hess){
 		d2I0_dpssm2.resize(ssm_state_size*ssm_state_size, am.getPatchSize());
@@ -92,7 +111,11 @@ void ESM<AM, SSM >::initialize(const cv::Mat &corners){
 	am.initializeHess();
 
 	am.initializePixGrad(ssm.getPts());
-	ssm.cmptWarpedPixJacobian(dI0_dpssm, am.getInitPixGrad());
+	if(float_jac){
+		ssm.cmptWarpedPixJacobianFloat(dI0_dpssm_f, am.getInitPixGrad());
+	} else{
+		ssm.cmptWarpedPixJacobian(dI0_dpssm, am.getInitPixGrad());
+	}
 
 	if(params.sec_ord_hess){
 		am.initializePixHess(ssm.getPts());
@@ -103,6 +126,8 @@ void ESM<AM, SSM >::initialize(const cv::Mat &corners){
 	if(params.hess_type == HessType::InitialSelf || params.hess_type == HessType::SumOfSelf){
 		if(params.sec_ord_hess){
 			am.cmptSelfHessian(d2f_dp2, dI0_dpssm, d2I0_dpssm2);
+		} else if(float_jac){
+			am.cmptSelfHessianFloat(d2f_dp2, dI0_dpssm_f);
 		} else{
 			am.cmptSelfHessian(d2f_dp2, dI0_dpssm);
 		}
@@ -119,25 +144,23 @@ void ESM<AM, SSM >::initialize(const cv::Mat &corners){
 template <class AM, class SSM>
 void ESM<AM, SSM >::update(){
 	++frame_id;
+	utils::AllocGuard alloc_guard(frame_id > 1);
 	write_frame_id(frame_id);
 
 	double prev_f = 0;
 	double lm_delta = params.lm_delta_init;
-	bool state_reset = false;
 
 	am.setFirstIter();
 	for(int iter_id = 0; iter_id < params.max_iters; ++iter_id){
 		init_timer();
 
 		//! extract pixel values from the current image at the latest known position of the object
-		am.updatePixVals(ssm.getPts());
-		record_event("am.updatePixVals");
-
-		//! compute f and the prerequisites for its gradients
-		am.updateSimilarity(false);
-		record_event("am.updateSimilarity");
+		//! and compute f and/or the prerequisites for its gradients; the pixel gradient and Hessian
+		//! are computed here too if the AM can do so in the same pass as the pixel values
+		am.updateRequired(ssm.getPts(), sim_required, grad_required);
+		record_event("am.updateRequired (similarity)");
 
-		if(params.leven_marq && !state_reset){
+		if(params.leven_marq){
 			double f = am.getSimilarity();
 			if(iter_id > 0){
 				if(f < prev_f){
@@ -147,8 +170,15 @@ void ESM<AM, SSM >::update(){
 					ssm.compositionalUpdate(inv_ssm_update);
 					am.invertState(inv_am_update, am_update);
 					am.updateState(inv_am_update);
-
-					state_reset = true;
+					//! and retry it with the larger damping using the system that produced it
+					//! since the Jacobian and Hessian at the restored state are still the same
+					solver.resolve(state_update, lm_delta);
+					ssm_update = state_update.head(ssm_state_size);
+					am_update = state_update.tail(am_state_size);
+					prev_corners = ssm.getCorners();
+					ssm.compositionalUpdate(ssm_update);
+					am.updateState(am_update);
+					if((prev_corners - ssm.getCorners()).squaredNorm() < params.epsilon){ break; }
 					continue;
 				}
 				if(f > prev_f){
@@ -157,28 +187,28 @@ void ESM<AM, SSM >::update(){
 			}
 			prev_f = f;
 		}
-		state_reset = false;
-
-		//! update the gradient of f w.r.t. It
-		am.updateCurrGrad();
-		record_event("am.updateCurrGrad");
 
-		//! update the gradient of f w.r.t. I0
-		am.updateInitGrad();
-		record_event("am.updateInitGrad");
+		//! update the gradients of f w.r.t. It and, if needed, I0 along with the pixel gradient and Hessian
+		am.updateRequired(ssm.getPts(), grad_required);
+		record_event("am.updateRequired (gradients)");
 
-		am.updatePixGrad(ssm.getPts());
-		record_event("am.updatePixGrad");
-		ssm.cmptWarpedPixJacobian(dIt_dpssm, am.getCurrPixGrad());
-		record_event("ssm.cmptWarpedPixJacobian");
+		if(float_jac){
+			ssm.cmptWarpedPixJacobianFloat(dIt_dpssm_f, am.getCurrPixGrad());
+			record_event("ssm.cmptWarpedPixJacobianFloat");
+		} else{
+			ssm.cmptWarpedPixJacobian(dIt_dpssm, am.getCurrPixGrad());
+			record_event("ssm.cmptWarpedPixJacobian");
+		}
 
 		if(params.jac_type == JacType::Original || params.hess_type == HessType::Original){
-			mean_dI_dpssm = (dI0_dpssm + dIt_dpssm) / 2.0;
+			if(float_jac){
+				mean_dI_dpssm_f = (dI0_dpssm_f + dIt_dpssm_f) / 2.0f;
+			} else{
+				mean_dI_dpssm = (dI0_dpssm + dIt_dpssm) / 2.0;
+			}
 			record_event("mean_dI_dpssm");
 		}
 		if(params.sec_ord_hess && params.hess_type != HessType::InitialSelf){
-			am.updatePixHess(ssm.getPts());
-			record_event("am.updatePixHess");
 			ssm.cmptWarpedPixHessian(d2It_dpssm2, am.getCurrPixHess(), am.getCurrPixGrad());
 			record_event("ssm.cmptWarpedPixHessian");
 		}
@@ -189,12 +219,20 @@ void ESM<AM, SSM >::update(){
 			take the mean at the level of the df_dp of the pixel values wrt SSM parameters,
 			then use this mean df_dp to compute the Jacobian of the error norm wrt SSM parameters
 			*/
-			am.cmptCurrJacobian(df_dp, mean_dI_dpssm);
+			if(float_jac){
+				am.cmptCurrJacobianFloat(df_dp, mean_dI_dpssm_f);
+			} else{
+				am.cmptCurrJacobian(df_dp, mean_dI_dpssm);
+			}
 			record_event("am.cmptCurrJacobian");
 			break;
 		case JacType::DiffOfJacs:
 			//! compute the mean difference between the Jacobians of the error norm w.r.t. initial AND current values of SSM parameters
-			am.cmptDifferenceOfJacobians(df_dp, dI0_dpssm, dIt_dpssm);
+			if(float_jac){
+				am.cmptDifferenceOfJacobiansFloat(df_dp, dI0_dpssm_f, dIt_dpssm_f);
+			} else{
+				am.cmptDifferenceOfJacobians(df_dp, dI0_dpssm, dIt_dpssm);
+			}
 			df_dp *= 0.5;
 			record_event("am.cmptDifferenceOfJacobians");
 			break;
@@ -202,9 +240,6 @@ void ESM<AM, SSM >::update(){
 		//! compute the Hessian of the similarity w.r.t. SSM parameters
 		switch(params.hess_type){
 		case HessType::InitialSelf:
-			if(params.leven_marq){
-				d2f_dp2 = init_d2f_dp2;
-			}
 			break;
 		case HessType::Original:
 			if(params.sec_ord_hess){
@@ -212,6 +247,9 @@ void ESM<AM, SSM >::update(){
 				record_event("mean_d2I_dpssm2");
 				am.cmptCurrHessian(d2f_dp2, mean_dI_dpssm, mean_d2I_dpssm2);
 				record_event("am.cmptCurrHessian (second order)");
+			} else if(float_jac){
+				am.cmptCurrHessianFloat(d2f_dp2, mean_dI_dpssm_f);
+				record_event("am.cmptCurrHessianFloat");
 			} else{
 				am.cmptCurrHessian(d2f_dp2, mean_dI_dpssm);
 				record_event("am.cmptCurrHessian (first order)");
@@ -222,6 +260,9 @@ void ESM<AM, SSM >::update(){
 				am.cmptSumOfHessians(d2f_dp2, dI0_dpssm, dIt_dpssm,
 					d2I0_dpssm2, d2It_dpssm2);
 				record_event("am.cmptSumOfHessians (second order)");
+			} else if(float_jac){
+				am.cmptSumOfHessiansFloat(d2f_dp2, dI0_dpssm_f, dIt_dpssm_f);
+				record_event("am.cmptSumOfHessiansFloat");
 			} else{
 				am.cmptSumOfHessians(d2f_dp2, dI0_dpssm, dIt_dpssm);
 				record_event("am.cmptSumOfHessians (first order)");
@@ -232,6 +273,9 @@ void ESM<AM, SSM >::update(){
 			if(params.sec_ord_hess){
 				am.cmptSelfHessian(d2f_dp2, dIt_dpssm, d2It_dpssm2);
 				record_event("am.cmptSelfHessian (second order)");
+			} else if(float_jac){
+				am.cmptSelfHessianFloat(d2f_dp2, dIt_dpssm_f);
+				record_event("am.cmptSelfHessianFloat");
 			} else{
 				am.cmptSelfHessian(d2f_dp2, dIt_dpssm);
 				record_event("am.cmptSelfHessian (first order)");
@@ -242,6 +286,9 @@ void ESM<AM, SSM >::update(){
 			if(params.sec_ord_hess){
 				am.cmptSelfHessian(d2f_dp2, dIt_dpssm, d2It_dpssm2);
 				record_event("am.cmptSelfHessian (second order)");
+			} else if(float_jac){
+				am.cmptSelfHessianFloat(d2f_dp2, dIt_dpssm_f);
+				record_event("am.cmptSelfHessianFloat");
 			} else{
 				am.cmptSelfHessian(d2f_dp2, dIt_dpssm);
 				record_event("am.cmptSelfHessian (first order)");
@@ -251,6 +298,9 @@ void ESM<AM, SSM >::update(){
 			if(params.sec_ord_hess){
 				am.cmptCurrHessian(d2f_dp2, dIt_dpssm, d2It_dpssm2);
 				record_event("am.cmptCurrHessian (second order)");
+			} else if(float_jac){
+				am.cmptCurrHessianFloat(d2f_dp2, dIt_dpssm_f);
+				record_event("am.cmptCurrHessianFloat");
 			} else{
 				am.cmptCurrHessian(d2f_dp2, dIt_dpssm);
 				record_event("am.cmptCurrHessian (first order)");
@@ -258,12 +308,7 @@ void ESM<AM, SSM >::update(){
 			break;
 		}
 
-		if(params.leven_marq){
-			MatrixXd diag_hessian = d2f_dp2.diagonal().asDiagonal();
-			d2f_dp2 += lm_delta*diag_hessian;
-		}
-
-		state_update = -d2f_dp2.colPivHouseholderQr().solve(df_dp.transpose());
+		solver.solve(state_update, d2f_dp2, df_dp, params.leven_marq ? lm_delta : 0);
 		record_event("state_update");
 
 		ssm_update = state_update.head(ssm_state_size);
@@ -297,13 +342,19 @@ void ESM<AM, SSM >::setRegion(const cv::Mat& corners){
 	// since the above command completely resets the SSM state including its initial points,
 	// any quantities that depend on these, like dI0_dpssm and d2I0_dpssm2,
 	// must be recomputed along with quantities that depend on them in turn.
-	ssm.cmptInitPixJacobian(dI0_dpssm, am.getInitPixGrad());
+	if(float_jac){
+		ssm.cmptInitPixJacobianFloat(dI0_dpssm_f, am.getInitPixGrad());
+	} else{
+		ssm.cmptInitPixJacobian(dI0_dpssm, am.getInitPixGrad());
+	}
 	if(params.sec_ord_hess){
 		ssm.cmptInitPixHessian(d2I0_dpssm2, am.getInitPixHess(), am.getInitPixGrad());
 	}
 	if(params.hess_type == HessType::InitialSelf || params.hess_type == HessType::SumOfSelf){
 		if(params.sec_ord_hess){
 			am.cmptSelfHessian(d2f_dp2, dI0_dpssm, d2I0_dpssm2);
+		} else if(float_jac){
+			am.cmptSelfHessianFloat(d2f_dp2, dI0_dpssm_f);
 		} else{
 			am.cmptSelfHessian(d2f_dp2, dI0_dpssm);
 		}
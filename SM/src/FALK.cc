@@ -39,9 +39,17 @@ FALK<AM, SSM >::FALK(const ParamType *falk_params,
 	}
 
 	ssm_update.resize(ssm.getStateSize());
+	inv_ssm_update.resize(ssm.getStateSize());
 	curr_pix_jacobian.resize(am.getPatchSize(), ssm.getStateSize());
 	jacobian.resize(ssm.getStateSize());
 	hessian.resize(ssm.getStateSize(), ssm.getStateSize());
+	solver.resize(ssm.getStateSize());
+	//! the similarity itself is only needed for the LM check
+	sim_required.similarity = params.leven_marq;
+	sim_required.sim_prereq = true;
+	grad_required.curr_grad = true;
+	grad_required.pix_grad = true;
+	grad_required.pix_hess = params.sec_ord_hess && params.hess_type != HessType::InitialSelf;
 
 	if(params.hess_type == HessType::InitialSelf){
 		init_pix_jacobian.resize(am.getPatchSize(), ssm.getStateSize());
@@ -81,9 +89,6 @@ void FALK<AM, SSM >::initialize(const cv::Mat &corners){
 			am.cmptSelfHessian(hessian, init_pix_jacobian);
 		}
 	}
-	if(params.leven_marq){
-		init_self_hessian = hessian;
-	}
 	ssm.getCorners(cv_corners_mat);
 
 	end_timer();
@@ -93,33 +98,34 @@ void FALK<AM, SSM >::initialize(const cv::Mat &corners){
 template <class AM, class SSM>
 void FALK<AM, SSM >::update(){
 	++frame_id;
+	utils::AllocGuard alloc_guard(frame_id > 1);
 	write_frame_id(frame_id);
 
 	double prev_f = 0;
 	double lm_delta = params.lm_delta_init;
-	bool state_reset = false;
 
 	am.setFirstIter();
 	for(int iter_id = 0; iter_id < params.max_iters; ++iter_id){
 		init_timer();
 
-		am.updatePixVals(ssm.getPts());
-		record_event("am.updatePixVals");
-
-		// compute the prerequisites for the gradient function
-		am.updateSimilarity(false);
-		record_event("am.updateSimilarity");
+		// compute the similarity and/or the prerequisites for the gradient function
+		am.updateRequired(ssm.getPts(), sim_required, grad_required);
+		record_event("am.updateRequired (similarity)");
 
-		if(params.leven_marq && !state_reset){
+		if(params.leven_marq){
 			double f = am.getSimilarity();
 			if(iter_id > 0){
 				if(f < prev_f){
 					lm_delta *= params.lm_delta_update;
 					//! undo the last update
-					VectorXd inv_ssm_update = -ssm_update;
+					inv_ssm_update = -ssm_update;
 					ssm.additiveUpdate(inv_ssm_update);
-
-					state_reset = true;
+					//! and retry it with the larger damping using the system that produced it
+					//! since the Jacobian and Hessian at the restored state are still the same
+					solver.resolve(ssm_update, lm_delta);
+					prev_corners = ssm.getCorners();
+					ssm.additiveUpdate(ssm_update);
+					if((prev_corners - ssm.getCorners()).squaredNorm() < params.epsilon){ break; }
 					continue;
 				}
 				if(f > prev_f){
@@ -128,24 +134,18 @@ void FALK<AM, SSM >::update(){
 			}
 			prev_f = f;
 		}
-		state_reset = false;
 
-		am.updatePixGrad(ssm.getPts());
-		record_event("am.updatePixGrad");
+		am.updateRequired(ssm.getPts(), grad_required);
+		record_event("am.updateRequired (gradients)");
 
 		ssm.cmptPixJacobian(curr_pix_jacobian, am.getCurrPixGrad());
 		record_event("ssm.cmptPixJacobian");
 
-		am.updateCurrGrad();
-		record_event("am.updateCurrGrad");
-
 		am.cmptCurrJacobian(jacobian, curr_pix_jacobian);
 		record_event("am.cmptCurrJacobian");
 
 		//compute pixel Hessian
 		if(params.sec_ord_hess && params.hess_type != HessType::InitialSelf){
-			am.updatePixHess(ssm.getPts());
-			record_event("am.updatePixHess");
 			ssm.cmptPixHessian(curr_pix_hessian, am.getCurrPixHess(), am.getCurrPixGrad());
 			record_event("ssm.cmptPixHessian");
 		}
@@ -153,9 +153,6 @@ void FALK<AM, SSM >::update(){
 		// compute similarity Hessian
 		switch(params.hess_type){
 		case HessType::InitialSelf:
-			if(params.leven_marq){
-				hessian = init_self_hessian;
-			}
 			break;
 		case HessType::CurrentSelf:
 			if(params.sec_ord_hess){
@@ -176,12 +173,8 @@ void FALK<AM, SSM >::update(){
 			}
 			break;
 		}
-		if(params.leven_marq){
-			MatrixXd diag_hessian = hessian.diagonal().asDiagonal();
-			hessian += lm_delta*diag_hessian;
-		}
 
-		ssm_update = -hessian.colPivHouseholderQr().solve(jacobian.transpose());
+		solver.solve(ssm_update, hessian, jacobian, params.leven_marq ? lm_delta : 0);
 		record_event("ssm_update");
 
 		prev_corners = ssm.getCorners();
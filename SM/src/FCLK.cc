@@ -38,6 +38,20 @@ FCLK<AM, SSM >::FCLK(const ParamType *fclk_params,
 	if(params.leven_marq){
 		printf("Using Levenberg Marquardt formulation...\n");
 	}
+	float_jac = am.supportsFloatJacobian() && !params.sec_ord_hess;
+	if(float_jac){
+		printf("Using single precision pixel Jacobians...\n");
+	}
+	use_fused_gn = false;
+	if(params.fused_gn){
+		if(params.hess_type == HessType::CurrentSelf && !params.sec_ord_hess && !float_jac &&
+			ssm.supportsPixJacobianBlocks() && am.supportsFusedJacobianAndHessian()){
+			printf("Using fused Jacobian and Hessian computation...\n");
+			use_fused_gn = true;
+		} else{
+			printf("Fused Jacobian and Hessian computation is not supported with this Hessian or AM/SSM so it is disabled\n");
+		}
+	}
 
 	ssm_state_size = ssm.getStateSize();
 	am_state_size = am.getStateSize();
@@ -52,12 +66,27 @@ FCLK<AM, SSM >::FCLK(const ParamType *fclk_params,
 	inv_ssm_update.resize(ssm_state_size);
 	inv_am_update.resize(am_state_size);
 
-	dIt_dpssm.resize(am.getPatchSize(), ssm_state_size);
+	if(float_jac){
+		dIt_dpssm_f.resize(am.getPatchSize(), ssm_state_size);
+	} else{
+		dIt_dpssm.resize(am.getPatchSize(), ssm_state_size);
+	}
 	df_dp.resize(state_size);
 	d2f_dp2.resize(state_size, state_size);
+	solver.resize(state_size);
+	//! the similarity itself is only needed for the LM check
+	sim_required.similarity = params.leven_marq;
+	sim_required.sim_prereq = true;
+	grad_required.curr_grad = true;
+	grad_required.pix_grad = true;
+	grad_required.pix_hess = params.sec_ord_hess && params.hess_type != HessType::InitialSelf;
 
 	if(params.hess_type == HessType::InitialSelf){
-		dI0_dpssm.resize(am.getPatchSize(), ssm_state_size);
+		if(float_jac){
+			dI0_dpssm_f.resize(am.getPatchSize(), ssm_state_size);
+		} else{
+			dI0_dpssm.resize(am.getPatchSize(), ssm_state_size);
+		}
 		if(params.sec_ord_hess){
 			d2I0_dpssm2.resize(ssm_state_size*ssm_state_size, am.getPatchSize());
 		}
@@ -85,16 +114,18 @@ void FCLK<AM, SSM>::initialize(const cv::Mat &corners){
 		am.initializePixHess(ssm.getPts());
 	}
 	if(params.hess_type == HessType::InitialSelf){
-		ssm.cmptWarpedPixJacobian(dI0_dpssm, am.getInitPixGrad());
-		if(params.sec_ord_hess){
-			ssm.cmptWarpedPixHessian(d2I0_dpssm2, am.getInitPixHess(),
-					am.getInitPixGrad());	
-			am.cmptSelfHessian(d2f_dp2, dI0_dpssm, d2I0_dpssm2);
+		if(float_jac){
+			ssm.cmptWarpedPixJacobianFloat(dI0_dpssm_f, am.getInitPixGrad());
+			am.cmptSelfHessianFloat(d2f_dp2, dI0_dpssm_f);
 		} else{
-			am.cmptSelfHessian(d2f_dp2, dI0_dpssm);
-		}
-		if(params.leven_marq){
-			init_d2f_dp2 = d2f_dp2;
+			ssm.cmptWarpedPixJacobian(dI0_dpssm, am.getInitPixGrad());
+			if(params.sec_ord_hess){
+				ssm.cmptWarpedPixHessian(d2I0_dpssm2, am.getInitPixHess(),
+					am.getInitPixGrad());
+				am.cmptSelfHessian(d2f_dp2, dI0_dpssm, d2I0_dpssm2);
+			} else{
+				am.cmptSelfHessian(d2f_dp2, dI0_dpssm);
+			}
 		}
 	}
 	ssm.getCorners(cv_corners_mat);
@@ -107,20 +138,20 @@ template <class AM, class SSM>
 void FCLK<AM, SSM>::update(){
 
 	++frame_id;
+	utils::AllocGuard alloc_guard(frame_id > 1);
 	write_frame_id(frame_id);
 
 	double prev_f = 0;
 	double lm_delta = params.lm_delta_init;
-	bool state_reset = false;
 
 	am.setFirstIter();
 	for(int iter_id = 0; iter_id < params.max_iters; ++iter_id){
 		init_timer();
 
-		am.updatePixVals(ssm.getPts()); record_event("am.updatePixVals");
-		am.updateSimilarity(false); record_event("am.updateSimilarity");
+		am.updateRequired(ssm.getPts(), sim_required, grad_required);
+		record_event("am.updateRequired (similarity)");
 
-		if(params.leven_marq && !state_reset){
+		if(params.leven_marq){
 			double f = am.getSimilarity();
 			if(iter_id > 0){
 				if(f < prev_f){
@@ -130,8 +161,15 @@ void FCLK<AM, SSM>::update(){
 					ssm.compositionalUpdate(inv_ssm_update);
 					am.invertState(inv_am_update, am_update);
 					am.updateState(inv_am_update);
-
-					state_reset = true;
+					//! and retry it with the larger damping using the system that produced it
+					//! since the Jacobian and Hessian at the restored state are still the same
+					solver.resolve(state_update, lm_delta);
+					ssm_update = state_update.head(ssm_state_size);
+					am_update = state_update.tail(am_state_size);
+					prev_corners = ssm.getCorners();
+					ssm.compositionalUpdate(ssm_update);
+					am.updateState(am_update);
+					if((prev_corners - ssm.getCorners()).squaredNorm() < params.epsilon){ break; }
 					continue;
 				}
 				if(f > prev_f){
@@ -140,40 +178,53 @@ void FCLK<AM, SSM>::update(){
 			}
 			prev_f = f;
 		}
-		state_reset = false;
 
-		am.updateCurrGrad(); record_event("am.updateCurrGrad");
-
-		am.updatePixGrad(ssm.getPts());
-		record_event("am.updatePixGrad");
-		ssm.cmptWarpedPixJacobian(dIt_dpssm, am.getCurrPixGrad());
-		record_event("ssm.cmptWarpedPixJacobian");
+		am.updateRequired(ssm.getPts(), grad_required);
+		record_event("am.updateRequired (gradients)");
+
+		if(use_fused_gn){
+			//! the pixel Jacobian is generated block by block and consumed by the AM as it goes
+			am.cmptCurrJacobianAndSelfHessian(df_dp, d2f_dp2,
+				[&](MatrixXd &dIt_dpssm_block, unsigned int start_id, unsigned int n_block){
+				ssm.cmptWarpedPixJacobianBlock(dIt_dpssm_block, am.getCurrPixGrad(), start_id, n_block);
+			}, dIt_dpssm);
+			record_event("am.cmptCurrJacobianAndSelfHessian");
+		} else if(float_jac){
+			ssm.cmptWarpedPixJacobianFloat(dIt_dpssm_f, am.getCurrPixGrad());
+			record_event("ssm.cmptWarpedPixJacobianFloat");
+		} else{
+			ssm.cmptWarpedPixJacobian(dIt_dpssm, am.getCurrPixGrad());
+			record_event("ssm.cmptWarpedPixJacobian");
+		}
 
 		//! compute pixel Hessian
-		if(params.sec_ord_hess && params.hess_type != HessType::InitialSelf){
-			am.updatePixHess(ssm.getPts());
-			record_event("am.updatePixHess");
+		if(params.sec_ord_hess && params.hess_type != HessType::InitialSelf){
 			ssm.cmptWarpedPixHessian(d2It_dpssm2, am.getCurrPixHess(), am.getCurrPixGrad());
 			record_event("ssm.cmptWarpedPixHessian");
 		}
 
 		//! compute similarity Jacobian
-		am.cmptCurrJacobian(df_dp, dIt_dpssm);
-		record_event("am.cmptCurrJacobian");
+		if(float_jac){
+			am.cmptCurrJacobianFloat(df_dp, dIt_dpssm_f);
+			record_event("am.cmptCurrJacobianFloat");
+		} else if(!use_fused_gn){
+			am.cmptCurrJacobian(df_dp, dIt_dpssm);
+			record_event("am.cmptCurrJacobian");
+		}
 
 		//! compute similarity Hessian
 		switch(params.hess_type){
 		case HessType::InitialSelf:
-			if(params.leven_marq){
-				d2f_dp2 = init_d2f_dp2;
-			}
 			break;
 		case HessType::CurrentSelf:
 			if(params.sec_ord_hess){
 				am.cmptSelfHessian(d2f_dp2, dIt_dpssm, d2It_dpssm2);
 				record_event("am.cmptSelfHessian (second order)");
-			} else{
-				am.cmptSelfHessian(d2f_dp2, dIt_dpssm);
+			} else if(float_jac){
+				am.cmptSelfHessianFloat(d2f_dp2, dIt_dpssm_f);
+				record_event("am.cmptSelfHessianFloat");
+			} else if(!use_fused_gn){
+				am.cmptSelfHessian(d2f_dp2, dIt_dpssm);
 				record_event("am.cmptSelfHessian (first order)");
 			}
 			break;
@@ -181,6 +232,9 @@ void FCLK<AM, SSM>::update(){
 			if(params.sec_ord_hess){
 				am.cmptCurrHessian(d2f_dp2, dIt_dpssm, d2It_dpssm2);
 				record_event("am.cmptCurrHessian (second order)");
+			} else if(float_jac){
+				am.cmptCurrHessianFloat(d2f_dp2, dIt_dpssm_f);
+				record_event("am.cmptCurrHessianFloat");
 			} else{
 				am.cmptCurrHessian(d2f_dp2, dIt_dpssm);
 				record_event("am.cmptCurrHessian (first order)");
@@ -188,12 +242,7 @@ void FCLK<AM, SSM>::update(){
 			break;
 		}
 
-		if(params.leven_marq){
-			MatrixXd diag_d2f_dp2 = d2f_dp2.diagonal().asDiagonal();
-			d2f_dp2 += lm_delta*diag_d2f_dp2;
-		}
-
-		state_update = -d2f_dp2.colPivHouseholderQr().solve(df_dp.transpose());
+		solver.solve(state_update, d2f_dp2, df_dp, params.leven_marq ? lm_delta : 0);
 		ssm_update = state_update.head(ssm_state_size);
 		am_update = state_update.tail(am_state_size);
 
@@ -230,13 +279,18 @@ void FCLK<AM, SSM >::setRegion(const cv::Mat& corners){
 	// any quantities that depend on these, like dI0_dpssm and d2I0_dpssm2,
 	// must be recomputed along with quantities that depend on these in turn.
 	if(params.hess_type == HessType::InitialSelf){
-		ssm.cmptInitPixJacobian(dI0_dpssm, am.getInitPixGrad());
-		if(params.sec_ord_hess){
-			ssm.cmptInitPixHessian(d2I0_dpssm2, am.getInitPixHess(),
-				am.getInitPixGrad());
-			am.cmptSelfHessian(d2f_dp2, dI0_dpssm, d2I0_dpssm2);
+		if(float_jac){
+			ssm.cmptInitPixJacobianFloat(dI0_dpssm_f, am.getInitPixGrad());
+			am.cmptSelfHessianFloat(d2f_dp2, dI0_dpssm_f);
 		} else{
-			am.cmptSelfHessian(d2f_dp2, dI0_dpssm);
+			ssm.cmptInitPixJacobian(dI0_dpssm, am.getInitPixGrad());
+			if(params.sec_ord_hess){
+				ssm.cmptInitPixHessian(d2I0_dpssm2, am.getInitPixHess(),
+					am.getInitPixGrad());
+				am.cmptSelfHessian(d2f_dp2, dI0_dpssm, d2I0_dpssm2);
+			} else{
+				am.cmptSelfHessian(d2f_dp2, dI0_dpssm);
+			}
 		}
 	}
 	ssm.getCorners(cv_corners_mat);
@@ -14,6 +14,7 @@
 #define FC_SHOW_GRID false
 #define FC_SHOW_PATCH false
 #define FC_PATCH_RESIZE_FACTOR 1.0
+#define FC_FUSED_GN false
 #define FC_DEBUG_MODE false
 
 _MTF_BEGIN_NAMESPACE
@@ -24,7 +25,8 @@ bool _chained_warp, bool _leven_marq,
 double _lm_delta_init, double _lm_delta_update, 
 bool _enable_learning, bool _write_ssm_updates,
 bool _show_grid, bool _show_patch,
-double _patch_resize_factor, bool _debug_mode) :
+double _patch_resize_factor, bool _fused_gn,
+bool _debug_mode) :
 max_iters(_max_iters),
 epsilon(_epsilon),
 hess_type(_hess_type),
@@ -38,6 +40,7 @@ write_ssm_updates(_write_ssm_updates),
 show_grid(_show_grid),
 show_patch(_show_patch),
 patch_resize_factor(_patch_resize_factor),
+fused_gn(_fused_gn),
 debug_mode(_debug_mode){}
 
 FCLKParams::FCLKParams(const FCLKParams *params) :
@@ -54,6 +57,7 @@ write_ssm_updates(FC_WRITE_SSM_UPDATES),
 show_grid(FC_SHOW_GRID),
 show_patch(FC_SHOW_PATCH),
 patch_resize_factor(FC_PATCH_RESIZE_FACTOR),
+fused_gn(FC_FUSED_GN),
 debug_mode(FC_DEBUG_MODE){
 	if(params){
 		max_iters = params->max_iters;
@@ -69,6 +73,7 @@ debug_mode(FC_DEBUG_MODE){
 		show_grid = params->show_grid;
 		show_patch = params->show_patch;
 		patch_resize_factor = params->patch_resize_factor;
+		fused_gn = params->fused_gn;
 		debug_mode = params->debug_mode;
 	}
 }
@@ -164,6 +164,8 @@ const flann::IndexParams FLANNParams::getIndexParams(IdxType _index_type,
 	switch(_index_type){
 	case IdxType::GNN:
 		throw utils::InvalidArgument("GNN is not a valid FLANN index type");
+	case IdxType::HNSW:
+		throw utils::InvalidArgument("HNSW is not a valid FLANN index type");
 	case IdxType::Linear:
 		printf("Using Linear index\n");
 		return flann::LinearIndexParams();
@@ -260,6 +262,8 @@ const char* FLANNParams::toString(IdxType index_type){
 		return "KDTreeCuda3d";
 	case IdxType::Autotuned:
 		return "Autotuned";
+	case IdxType::HNSW:
+		return "HNSW";
 	default:
 		throw utils::InvalidArgument("Invalid index type provided");
 	}
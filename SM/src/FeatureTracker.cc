@@ -20,6 +20,8 @@
 
 
 #include <stdexcept>
+#include <numeric>
+#include <algorithm>
 
 #define FEAT_GRID_SIZE_X 10
 #define FEAT_GRID_SIZE_Y 10
@@ -36,6 +38,8 @@
 #define FEAT_MAX_DIST_RATIO 0.75
 #define FEAT_MIN_MATCHES 10
 #define FEAT_UCHAR_INPUT 1
+#define FEAT_DETECT_IN_ROI 0
+#define FEAT_USE_PROSAC 0
 #define FEAT_SHOW_TRACKERS 0
 #define FEAT_SHOW_TRACKER_EDGES 0
 #define FEAT_DEBUG_MODE 0
@@ -659,8 +663,8 @@ FeatureTrackerParams::FeatureTrackerParams(
 	bool _enable_pyr, bool _use_cv_flann,
 	double _max_dist_ratio,
 	int _min_matches, bool _uchar_input,
-	bool _show_keypoints, bool _show_matches,
-	bool _debug_mode) :
+	bool _detect_in_roi, bool _use_prosac, bool _show_keypoints,
+	bool _show_matches, bool _debug_mode) :
 	detector_type(_detector_type),
 	descriptor_type(_descriptor_type),
 	detector(_detector),
@@ -678,6 +682,8 @@ FeatureTrackerParams::FeatureTrackerParams(
 	max_dist_ratio(_max_dist_ratio),
 	min_matches(_min_matches),
 	uchar_input(_uchar_input),
+	detect_in_roi(_detect_in_roi),
+	use_prosac(_use_prosac),
 	show_keypoints(_show_keypoints),
 	show_matches(_show_matches),
 	debug_mode(_debug_mode){}
@@ -698,6 +704,8 @@ use_cv_flann(FEAT_USE_CV_FLANN),
 max_dist_ratio(FEAT_MAX_DIST_RATIO),
 min_matches(FEAT_MIN_MATCHES),
 uchar_input(FEAT_UCHAR_INPUT),
+detect_in_roi(FEAT_DETECT_IN_ROI),
+use_prosac(FEAT_USE_PROSAC),
 show_keypoints(FEAT_SHOW_TRACKERS),
 show_matches(FEAT_SHOW_TRACKER_EDGES),
 debug_mode(FEAT_DEBUG_MODE){
@@ -719,6 +727,8 @@ debug_mode(FEAT_DEBUG_MODE){
 		enable_pyr = params->enable_pyr;
 		use_cv_flann = params->use_cv_flann;
 		uchar_input = params->uchar_input;
+		detect_in_roi = params->detect_in_roi;
+		use_prosac = params->use_prosac;
 		show_keypoints = params->show_keypoints;
 		show_matches = params->show_matches;
 		debug_mode = params->debug_mode;
@@ -813,11 +823,15 @@ FeatureTracker<SSM>::FeatureTracker(
 	printf("min_matches: %d\n", params.min_matches);
 	printf("use_cv_flann: %d\n", params.use_cv_flann);
 	printf("uchar_input: %d\n", params.uchar_input);
+	printf("detect_in_roi: %d\n", params.detect_in_roi);
+	printf("use_prosac: %d\n", params.use_prosac);
 	printf("rebuild_index: %d\n", params.rebuild_index);
 	printf("show_keypoints: %d\n", params.show_keypoints);
 	printf("debug_mode: %d\n", params.debug_mode);
 	printf("\n");
 
+	//! the matches are sorted for PROSAC in matchKeyPoints
+	est_params.use_prosac = params.use_prosac;
 	printf("Using %s estimator with:\n", ssm.name.c_str());
 	est_params.print();
 	printf("\n");
@@ -965,18 +979,16 @@ void FeatureTracker<SSM>::initialize(const cv::Mat &corners) {
 	}
 
 	ssm.initialize(corners);
-	cv::Mat mask = cv::Mat::zeros(curr_img.rows, curr_img.cols, CV_8U); // all 0
-	mask(utils::getBestFitRectangle<int>(corners)) = 255;
 	if(use_feature_detector){
-		detector->detect(curr_img, prev_key_pts, mask);
+		detectKeyPoints(utils::getBestFitRectangle<int>(corners), prev_key_pts, prev_descriptors);
 	} else{
 		for(int pt_id = 0; pt_id < n_pts; ++pt_id){
 			Vector2d patch_centroid = ssm.getPts().col(pt_id);
 			prev_key_pts[pt_id].pt.x = static_cast<float>(patch_centroid(0));
 			prev_key_pts[pt_id].pt.y = static_cast<float>(patch_centroid(1));
 		}
+		descriptor->compute(curr_img, prev_key_pts, prev_descriptors);
 	}
-	descriptor->compute(curr_img, prev_key_pts, prev_descriptors);
 	//printf("prev_descriptors.type: %s\n", utils::getType(prev_descriptors));
 
 	if(params.debug_mode){
@@ -1003,22 +1015,23 @@ void FeatureTracker<SSM>::initialize(const cv::Mat &corners) {
 }
 template<class SSM>
 void FeatureTracker<SSM>::update() {
-	if(!params.uchar_input){
-		curr_img_in.convertTo(curr_img, curr_img.type());
-	}
-
-	//! create mask of search region for keypoints
-	cv::Mat mask = cv::Mat::zeros(curr_img.rows, curr_img.cols, CV_8U);
+	//! search region for keypoints
 	cv::Rect curr_location_rect = utils::getBestFitRectangle<int>(cv_corners_mat);
 	cv::Rect search_region;
 	search_region.x = max(curr_location_rect.x - params.search_window_x, 0);
 	search_region.y = max(curr_location_rect.y - params.search_window_y, 0);
 	search_region.width = min(curr_location_rect.width + 2 * params.search_window_x, curr_img.cols - search_region.x - 1);
 	search_region.height = min(curr_location_rect.height + 2 * params.search_window_y, curr_img.rows - search_region.y - 1);
-	mask(search_region) = 255;
 
-	detector->detect(curr_img, curr_key_pts, mask);
-	descriptor->compute(curr_img, curr_key_pts, curr_descriptors);
+	if(!params.uchar_input){
+		if(params.detect_in_roi){
+			cv::Mat curr_img_roi = curr_img(search_region);
+			curr_img_in(search_region).convertTo(curr_img_roi, curr_img.type());
+		} else{
+			curr_img_in.convertTo(curr_img, curr_img.type());
+		}
+	}
+	detectKeyPoints(search_region, curr_key_pts, curr_descriptors);
 
 	matchKeyPoints();
 	if(n_good_key_pts < params.min_matches){
@@ -1029,13 +1042,18 @@ void FeatureTracker<SSM>::update() {
 	ssm.setCorners(opt_warped_corners);
 	ssm.getCorners(cv_corners_mat);
 	if(params.show_keypoints){
-		utils::drawRegion(mask, cv_corners_mat, CV_RGB(255, 255, 255));
-		cv::imshow("Mask", mask);
+		if(!params.detect_in_roi){
+			cv::Mat mask_disp = search_mask.clone();
+			utils::drawRegion(mask_disp, cv_corners_mat, CV_RGB(255, 255, 255));
+			cv::imshow("Mask", mask_disp);
+		}
 		showKeyPoints();
 	}
 	if(params.init_at_each_frame){
-		prev_key_pts = curr_key_pts;
-		prev_descriptors = curr_descriptors.clone();
+		//! the current buffers are swapped with the previous ones rather than copied
+		//! so that they are overwritten by the next frame's keypoints and descriptors
+		prev_key_pts.swap(curr_key_pts);
+		cv::swap(prev_descriptors, curr_descriptors);
 #ifndef DISABLE_FLANN
 		if(!params.use_cv_flann){
 			if(params.rebuild_index){
@@ -1048,7 +1066,10 @@ void FeatureTracker<SSM>::update() {
 			}
 		}
 #endif
-		curr_img.copyTo(prev_img);
+		//! previous image is only needed for drawing the matches
+		if(params.show_matches){
+			curr_img.copyTo(prev_img);
+		}
 	}
 }
 
@@ -1079,6 +1100,32 @@ bool FeatureTracker<SSM>::detect(const cv::Mat &mask, cv::Mat &obj_location) {
 	return true;
 }
 
+template<class SSM>
+void FeatureTracker<SSM>::detectKeyPoints(const cv::Rect &region,
+	std::vector<cv::KeyPoint> &key_pts, cv::Mat &descriptors){
+	cv::Rect img_region = region & cv::Rect(0, 0, curr_img.cols, curr_img.rows);
+	if(params.detect_in_roi){
+		//! keypoints found in the ROI view are offset back to full image coordinates
+		cv::Mat curr_img_roi = curr_img(img_region);
+		detector->detect(curr_img_roi, key_pts);
+		descriptor->compute(curr_img_roi, key_pts, descriptors);
+		for(cv::KeyPoint &key_pt : key_pts){
+			key_pt.pt.x += img_region.x;
+			key_pt.pt.y += img_region.y;
+		}
+		return;
+	}
+	if(search_mask.size() != curr_img.size()){
+		search_mask = cv::Mat::zeros(curr_img.rows, curr_img.cols, CV_8U);
+	} else{
+		search_mask(search_mask_region) = 0;
+	}
+	search_mask(img_region) = 255;
+	search_mask_region = img_region;
+	detector->detect(curr_img, key_pts, search_mask);
+	descriptor->compute(curr_img, key_pts, descriptors);
+}
+
 template<class SSM>
 void FeatureTracker<SSM>::matchKeyPoints() {
 	n_key_pts = curr_descriptors.rows;
@@ -1162,6 +1209,25 @@ void FeatureTracker<SSM>::matchKeyPoints() {
 		}
 	}
 	n_good_key_pts = curr_pts.size();
+	if(params.use_prosac){
+		//! PROSAC needs the matches to be sorted in increasing order of descriptor distance
+		std::vector<int> match_ids(n_good_key_pts);
+		std::iota(match_ids.begin(), match_ids.end(), 0);
+		std::stable_sort(match_ids.begin(), match_ids.end(), [&](int id1, int id2){
+			return best_distances.at<float>(good_indices[id1], 0) <
+				best_distances.at<float>(good_indices[id2], 0);
+		});
+		std::vector<cv::Point2f> sorted_prev_pts(n_good_key_pts), sorted_curr_pts(n_good_key_pts);
+		std::vector<int> sorted_indices(n_good_key_pts);
+		for(int match_id = 0; match_id < n_good_key_pts; ++match_id){
+			sorted_prev_pts[match_id] = prev_pts[match_ids[match_id]];
+			sorted_curr_pts[match_id] = curr_pts[match_ids[match_id]];
+			sorted_indices[match_id] = good_indices[match_ids[match_id]];
+		}
+		prev_pts.swap(sorted_prev_pts);
+		curr_pts.swap(sorted_curr_pts);
+		good_indices.swap(sorted_indices);
+	}
 	if(params.debug_mode){
 		printf("n_good_key_pts: %d\n", n_good_key_pts);
 	}
@@ -1182,18 +1248,23 @@ void FeatureTracker<SSM>::cmptWarpedCorners() {
 template<class SSM>
 void FeatureTracker<SSM>::setRegion(const cv::Mat& corners) {
 	ssm.setCorners(corners);
-	cv::Mat mask = cv::Mat::zeros(curr_img.rows, curr_img.cols, CV_8U);
-	mask(utils::getBestFitRectangle<int>(corners)) = 1;
 	if(use_feature_detector){
-		detector->detect(curr_img, prev_key_pts, mask);
+		cv::Rect region = utils::getBestFitRectangle<int>(corners) &
+			cv::Rect(0, 0, curr_img.cols, curr_img.rows);
+		if(params.detect_in_roi && !params.uchar_input){
+			//! only the last search region of the current image may have been converted
+			cv::Mat curr_img_roi = curr_img(region);
+			curr_img_in(region).convertTo(curr_img_roi, curr_img.type());
+		}
+		detectKeyPoints(region, prev_key_pts, prev_descriptors);
 	} else{
 		for(int pt_id = 0; pt_id < n_pts; pt_id++){
 			Vector2d patch_centroid = ssm.getPts().col(pt_id);
 			prev_key_pts[pt_id].pt.x = static_cast<float>(patch_centroid(0));
 			prev_key_pts[pt_id].pt.y = static_cast<float>(patch_centroid(1));
 		}
+		descriptor->compute(curr_img, prev_key_pts, prev_descriptors);
 	}
-	descriptor->compute(curr_img, prev_key_pts, prev_descriptors);
 
 #ifndef DISABLE_FLANN
 	if(!params.use_cv_flann){
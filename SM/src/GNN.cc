@@ -1,6 +1,15 @@
 #include "mtf/SM/GNN.h"
 #include "mtf/Utilities//miscUtils.h"
 #include <fstream> 
+#include <cstdio>
+#include <cstring>
+#include <algorithm>
+#include <functional>
+#include "mtf/Utilities/rngUtils.h"
+#include "mtf/Utilities/parallelUtils.h"
+
+//! no. of nodes processed together by each task of NN-Descent
+#define GNN_NND_GRAIN_SIZE 64
 
 _MTF_BEGIN_NAMESPACE
 namespace gnn{
@@ -22,6 +31,14 @@ namespace gnn{
 		printf("max_steps: %d\n", params.max_steps);
 		printf("cmpt_dist_thresh: %d\n", params.cmpt_dist_thresh);
 		printf("random_start: %d\n", params.random_start);
+		printf("build_type: %s\n", GNNParams::toString(params.build_type));
+		if(params.build_type == BuildType::NNDescent){
+			printf("nnd_max_iters: %d\n", params.nnd_max_iters);
+			printf("nnd_sample_rate: %f\n", params.nnd_sample_rate);
+			printf("nnd_delta: %f\n", params.nnd_delta);
+			printf("nnd_target_recall: %f\n", params.nnd_target_recall);
+		}
+		printf("n_threads: %d\n", params.n_threads);
 		printf("verbose: %d\n", params.verbose);
 
 		dist_computed = false;
@@ -59,21 +76,23 @@ namespace gnn{
 	}
 	template <class DistType>
 	void GNN<DistType>::buildGraph(const double *dataset){
+		//! brute force search is exact and not slower when each node is connected to nearly all others
+		if(params.build_type == BuildType::NNDescent && params.degree < n_samples - 1){
+			buildGraphNND(dataset);
+			return;
+		}
 		if(!dist_computed && n_samples <= params.cmpt_dist_thresh){
 			// distance is pre computed and stored only if the no. of samples is not large enough to 
 			// cause a bad_alloc error on attempting to allocate memory for this
 			computeDistances(dataset);
 		}
-		nodes.resize(n_samples);
+		initNodes(params.degree);
 		std::vector<IndxDist> dists(params.degree + 1);
 		if(params.verbose){
 			printf("Processing graph nodes...\n");
 		}
 		mtf_clock_get(build_state_time);
 		for(int id1 = 0; id1 < n_samples; ++id1){
-			nodes[id1].nns_inds.resize(params.degree);
-			nodes[id1].capacity = params.degree;
-			nodes[id1].size = 0;
 			int count = 0;
 			for(int id2 = 0; id2 < n_samples; ++id2){
 				double dist = dist_computed ? dataset_distances(id1, id2) :
@@ -99,7 +118,7 @@ namespace gnn{
 			}
 			for(int j = 0; j < params.degree; j++){
 				int nns_ind = dists[j + 1].idx;
-				addNode(&nodes[id1], nns_ind);
+				addNode(id1, nns_ind);
 			}
 			if(params.verbose){
 				mtf_clock_get(end_time);
@@ -116,11 +135,19 @@ namespace gnn{
 	template <class DistType>
 	void GNN<DistType>::searchGraph(const double *query, const double *dataset,
 		int *nn_ids, double *nn_dists, int K){
-		int gnns_cap = K;
-		int visited_cap = K * 4;  //avg depth = 4
+		// the buffers are retained between searches and only ever grow so that
+		// no memory is allocated once they are large enough
+		if(static_cast<int>(gnn_dists_buf.size()) < K){
+			gnn_dists_buf.resize(K);
+		}
+		if(static_cast<int>(visited_nodes_buf.size()) < K * 4){ //avg depth = 4
+			visited_nodes_buf.resize(K * 4);
+		}
+		int gnns_cap = static_cast<int>(gnn_dists_buf.size());
+		int visited_cap = static_cast<int>(visited_nodes_buf.size());
 		int visited = 0;   // number of visited nodes
-		IndxDist *gnn_dists = static_cast<IndxDist*>(malloc(gnns_cap * sizeof(IndxDist))); // graph nn-dists
-		IndxDist *visited_nodes = static_cast<IndxDist*>(malloc(visited_cap * sizeof(IndxDist)));
+		IndxDist *gnn_dists = gnn_dists_buf.data(); // graph nn-dists
+		IndxDist *visited_nodes = visited_nodes_buf.data();
 
 		if(params.random_start){
 			start_node_idx = getRandNum(0, n_samples - 1);
@@ -136,7 +163,8 @@ namespace gnn{
 		for(int step_id = 0; step_id < params.max_steps; ++step_id){
 			if(nodes[r].size > gnns_cap) {
 				gnns_cap = nodes[r].size;
-				gnn_dists = static_cast<IndxDist*>(realloc(gnn_dists, gnns_cap * sizeof(IndxDist)));
+				gnn_dists_buf.resize(gnns_cap);
+				gnn_dists = gnn_dists_buf.data();
 			}
 			int count = 0;
 			//printf("Nodes[%d].size: %d\n", r, Nodes[r].size);
@@ -170,7 +198,8 @@ namespace gnn{
 				do {
 					visited_cap *= 2;
 				} while(visited_cap < (visited + m));
-				visited_nodes = static_cast<IndxDist*>(realloc(visited_nodes, visited_cap *sizeof(IndxDist)));
+				visited_nodes_buf.resize(visited_cap);
+				visited_nodes = visited_nodes_buf.data();
 			}
 			// add the visited nodes of the current parent node to the list of visited nodes
 			for(int i = 0; i < m; i++){
@@ -205,51 +234,114 @@ namespace gnn{
 	}
 
 	template <class DistType>
-	void GNN<DistType>::saveGraph(const char* saved_graph_path){
-		ofstream out_file(saved_graph_path, ios::out | ios::binary);
-		if(out_file.good()){
-			printf("Saving GNN graph to: %s\n", saved_graph_path);
-			out_file.write((char*)(&n_samples), sizeof(int));
-			out_file.write((char*)(&n_dims), sizeof(int));
-			out_file.write((char*)(nodes.data()), n_samples*sizeof(Node));
-			for(int node_id = 0; node_id < n_samples; node_id++){
-				out_file.write((char*)(nodes[node_id].nns_inds.data()),
-					nodes[node_id].capacity*sizeof(int));
-			}
-			out_file.close();
-		} else{
-			printf("Failed to saved GNN graph to: %s\n", saved_graph_path);
+	void GNN<DistType>::saveGraph(const char* saved_graph_path, unsigned long long dataset_key){
+		if(static_cast<int>(nodes.size()) != n_samples){
+			printf("GNN graph has not been built so cannot be saved\n");
+			return;
+		}
+		GraphHeader header = {};
+		memcpy(header.magic, "MTFGNN", 7);
+		header.version = 1;
+		header.header_size = sizeof(GraphHeader);
+		header.n_samples = n_samples;
+		header.n_dims = n_dims;
+		header.dataset_key = dataset_key;
+		//! only the neighbors actually present are saved rather than the full capacity of each node
+		std::vector<uint64_t> nns_offsets(n_samples + 1);
+		nns_offsets[0] = 0;
+		for(int node_id = 0; node_id < n_samples; ++node_id){
+			nns_offsets[node_id + 1] = nns_offsets[node_id] + nodes[node_id].size;
+		}
+		header.nns_offsets_offset = utils::alignOffset(sizeof(GraphHeader));
+		header.nns_inds_offset = utils::alignOffset(header.nns_offsets_offset +
+			nns_offsets.size()*sizeof(uint64_t));
+		header.file_size = header.nns_inds_offset + nns_offsets[n_samples] * sizeof(int);
+
+		//! write to a temporary file first so that an interrupted save never leaves behind a truncated graph
+		string tmp_path = string(saved_graph_path) + ".tmp";
+		ofstream out_file(tmp_path, ios::out | ios::binary);
+		if(!out_file.good()){
+			printf("Failed to save GNN graph to: %s\n", saved_graph_path);
+			return;
+		}
+		printf("Saving GNN graph to: %s\n", saved_graph_path);
+		const char padding[64] = {};
+		out_file.write((char*)(&header), sizeof(GraphHeader));
+		out_file.write(padding, header.nns_offsets_offset - sizeof(GraphHeader));
+		out_file.write((char*)(nns_offsets.data()), nns_offsets.size()*sizeof(uint64_t));
+		out_file.write(padding, header.nns_inds_offset - header.nns_offsets_offset -
+			nns_offsets.size()*sizeof(uint64_t));
+		for(int node_id = 0; node_id < n_samples; ++node_id){
+			out_file.write((char*)(nodes[node_id].nns_inds), nodes[node_id].size*sizeof(int));
+		}
+		bool write_successful = out_file.good();
+		out_file.close();
+		remove(saved_graph_path);
+		if(!write_successful || rename(tmp_path.c_str(), saved_graph_path) != 0){
+			printf("Failed to save GNN graph to: %s\n", saved_graph_path);
+			remove(tmp_path.c_str());
 		}
 	}
 	template <class DistType>
-	void GNN<DistType>::loadGraph(const char* saved_graph_path){
-		ifstream in_file(saved_graph_path, ios::in | ios::binary);
-		if(in_file.good()){
-			printf("Loading GNN graph from: %s\n", saved_graph_path);
-			in_file.read((char*)(&n_samples), sizeof(int));
-			in_file.read((char*)(&n_dims), sizeof(int));
-			printf("n_samples: %d\n", n_samples);
-			printf("n_dims: %d\n", n_dims);
-			nodes.resize(n_samples);
-			in_file.read((char*)(nodes.data()), n_samples*sizeof(Node));
-			for(int node_id = 0; node_id < n_samples; node_id++){
-				nodes[node_id].nns_inds.resize(nodes[node_id].capacity);
-				in_file.read((char*)(nodes[node_id].nns_inds.data()), nodes[node_id].capacity*sizeof(int));
-			}
-			in_file.close();
-		} else{
+	bool GNN<DistType>::loadGraph(const char* saved_graph_path, unsigned long long dataset_key){
+		utils::MappedFile in_file;
+		if(!in_file.open(saved_graph_path)){
 			printf("Failed to load GNN graph from: %s\n", saved_graph_path);
+			return false;
 		}
+		printf("Loading GNN graph from: %s\n", saved_graph_path);
+		const GraphHeader *header = in_file.getData<GraphHeader>();
+		const char *error = nullptr;
+		if(in_file.getSize() < sizeof(GraphHeader) || memcmp(header->magic, "MTFGNN", 7) != 0){
+			error = "not a GNN graph file";
+		} else if(header->version != 1 || header->header_size != sizeof(GraphHeader)){
+			error = "unsupported file version";
+		} else if(header->n_samples != n_samples || header->n_dims != n_dims){
+			error = "graph size does not match the dataset";
+		} else if(header->dataset_key != dataset_key){
+			error = "graph was built from a different dataset";
+		} else if(header->file_size != in_file.getSize() ||
+			!in_file.contains<uint64_t>(header->nns_offsets_offset, n_samples + 1)){
+			error = "file is truncated";
+		} else{
+			const uint64_t *nns_offsets = in_file.getData<uint64_t>(header->nns_offsets_offset);
+			if(nns_offsets[0] != 0 || !in_file.contains<int>(header->nns_inds_offset, nns_offsets[n_samples])){
+				error = "file is truncated";
+			}
+			for(int node_id = 0; node_id < n_samples && !error; ++node_id){
+				uint64_t node_size = nns_offsets[node_id + 1] - nns_offsets[node_id];
+				if(nns_offsets[node_id + 1] < nns_offsets[node_id] || node_size == 0){
+					error = "graph has invalid nodes";
+				}
+			}
+			//! a stale or corrupted file could otherwise make the search read beyond the dataset
+			const int *nns_inds = in_file.getData<int>(header->nns_inds_offset);
+			for(uint64_t ind_id = 0; !error && ind_id < nns_offsets[n_samples]; ++ind_id){
+				if(nns_inds[ind_id] < 0 || nns_inds[ind_id] >= n_samples){
+					error = "graph has invalid neighbors";
+				}
+			}
+		}
+		if(error){
+			printf("Rejecting GNN graph in %s: %s\n", saved_graph_path, error);
+			return false;
+		}
+		//! the nodes point directly into the mapped file which is kept open as long as the graph is in use
+		const uint64_t *nns_offsets = in_file.getData<uint64_t>(header->nns_offsets_offset);
+		int *nns_inds = in_file.getData<int>(header->nns_inds_offset);
+		nodes.resize(n_samples);
+		nns_storage.clear();
+		for(int node_id = 0; node_id < n_samples; ++node_id){
+			nodes[node_id].nns_inds = nns_inds + nns_offsets[node_id];
+			nodes[node_id].size = nodes[node_id].capacity =
+				static_cast<int>(nns_offsets[node_id + 1] - nns_offsets[node_id]);
+		}
+		graph_file.swap(in_file);
+		return true;
 	}
 	template <class DistType>
 	void GNN<DistType>::buildGraph(const double *X, int k){
-		nodes.resize(n_samples);
-		for(int i = 0; i < n_samples; i++){
-			nodes[i].nns_inds.resize(k);
-			//   memset(Nodes[i].nns_inds, -1, k*sizeof(int));
-			nodes[i].capacity = k;
-			nodes[i].size = 0;
-		}
+		initNodes(k);
 
 		//  struct indx_dist *dists = malloc(n_samples * sizeof(struct indx_dist));
 		//  check_pointer(dists, "Couldn't malloc dists");
@@ -265,7 +357,7 @@ namespace gnn{
 			knnSearch2(X + (i*n_dims), dists.data(), X, n_samples, n_dims, k + 1);   // index of 1st node is 0
 			for(int j = 0; j < k; j++){
 				int nns_ind = dists[j + 1].idx;
-				addNode(&nodes[i], nns_ind);
+				addNode(i, nns_ind);
 			}
 		}
 	}
@@ -305,7 +397,7 @@ namespace gnn{
 
 			// knn_search(query, gnn_dists, X1, Nodes[r].size, n_dims);
 			// knn_search1(query, gnn_dists, X, Nodes[r].size, n_dims, Nodes[r].nns_inds);
-			knnSearch11(query, gnn_dists, X, nodes[r].size, n_dims, K, nodes[r].nns_inds.data());
+			knnSearch11(query, gnn_dists, X, nodes[r].size, n_dims, K, nodes[r].nns_inds);
 
 			//      free(X1); 
 
@@ -458,14 +550,253 @@ namespace gnn{
 	}
 
 	template <class DistType>
-	void GNN<DistType>::addNode(Node *node_i, int nn){
-		int size = node_i->size++;
-		if(size >= node_i->capacity){
-			//node_i->nns_inds = static_cast<int*>(realloc(node_i->nns_inds, /*size*2*/ (size + 10)*sizeof(int)));
-			node_i->nns_inds.resize(size + 10);
-			node_i->capacity = /*size*2*/ size + 10;
-		}
-		node_i->nns_inds[size] = nn;
+	void GNN<DistType>::buildGraphNND(const double *dataset){
+		const int n_nns = params.degree;
+		const int sample_size = std::max(1, static_cast<int>(params.nnd_sample_rate*n_nns));
+		utils::TaskArena task_arena(params.n_threads, false,
+			utils::ParallelBackend::Default, GNN_NND_GRAIN_SIZE);
+		auto getDist = [&](int id1, int id2){
+			return (*dist_func)(dataset + id1*n_dims, dataset + id2*n_dims, n_dims);
+		};
+		//! random number stream that depends only on the iteration and node; together with the
+		//! fixed order in which the local join updates are applied, this makes the graph independent of the no. of threads
+		auto getRandGen = [&](int iter_id, int node_id){
+			return utils::Philox4x32(0, static_cast<unsigned long long>(iter_id)*n_samples + node_id);
+		};
+		//! moves a random subset of at most the given size to the front of the vector and discards the rest
+		auto sampleInPlace = [](std::vector<int> &ids, int size, utils::Philox4x32 &rand_gen){
+			if(static_cast<int>(ids.size()) <= size){ return; }
+			for(int id = 0; id < size; ++id){
+				int swap_id = id + static_cast<int>(rand_gen() % (ids.size() - id));
+				std::swap(ids[id], ids[swap_id]);
+			}
+			ids.resize(size);
+		};
+		//! neighbors found so far for each node sorted by distance
+		std::vector< std::vector<NNDNeighbor> > nns(n_samples);
+		//! tries to add id2 as a neighbor of id1 and returns 1 if it was added
+		auto updateNNs = [&](int id1, int id2, double dist){
+			std::vector<NNDNeighbor> &node_nns = nns[id1];
+			if(dist >= node_nns.back().dist){ return 0; }
+			for(int nn_id = 0; nn_id < n_nns; ++nn_id){
+				if(node_nns[nn_id].idx == id2){ return 0; }
+			}
+			int nn_id = n_nns - 1;
+			while(nn_id > 0 && node_nns[nn_id - 1].dist > dist){
+				node_nns[nn_id] = node_nns[nn_id - 1];
+				--nn_id;
+			}
+			node_nns[nn_id].dist = dist;
+			node_nns[nn_id].idx = id2;
+			node_nns[nn_id].is_new = true;
+			return 1;
+		};
+		if(params.verbose){
+			printf("Initializing graph nodes with random neighbors...\n");
+		}
+		mtf_clock_get(build_state_time);
+		task_arena.parallelFor(0, n_samples, [&](int start_id, int end_id){
+			for(int id1 = start_id; id1 < end_id; ++id1){
+				utils::Philox4x32 rand_gen = getRandGen(0, id1);
+				std::vector<int> nn_ids;
+				nn_ids.reserve(n_nns);
+				while(static_cast<int>(nn_ids.size()) < n_nns){
+					int id2 = static_cast<int>(rand_gen() % (n_samples - 1));
+					if(id2 >= id1){ ++id2; }
+					std::vector<int>::iterator pos = std::lower_bound(nn_ids.begin(), nn_ids.end(), id2);
+					if(pos == nn_ids.end() || *pos != id2){ nn_ids.insert(pos, id2); }
+				}
+				nns[id1].resize(n_nns);
+				for(int nn_id = 0; nn_id < n_nns; ++nn_id){
+					nns[id1][nn_id].idx = nn_ids[nn_id];
+					nns[id1][nn_id].dist = getDist(id1, nn_ids[nn_id]);
+					nns[id1][nn_id].is_new = true;
+				}
+				std::sort(nns[id1].begin(), nns[id1].end(),
+					[](const NNDNeighbor &a, const NNDNeighbor &b){ return a.dist < b.dist; });
+			}
+		});
+		//! exact neighbors of a few evenly spaced nodes for estimating the recall of the graph
+		int n_recall_nodes = params.nnd_target_recall > 0 ? std::min(100, n_samples) : 0;
+		std::vector< std::vector<int> > recall_nns(n_recall_nodes);
+		task_arena.run(n_recall_nodes, [&](int recall_id){
+			int id1 = static_cast<int>(static_cast<long long>(recall_id)*n_samples / n_recall_nodes);
+			std::vector<IndxDist> dists;
+			dists.reserve(n_samples - 1);
+			for(int id2 = 0; id2 < n_samples; ++id2){
+				if(id2 == id1){ continue; }
+				IndxDist dist;
+				dist.idx = id2;
+				dist.dist = getDist(id1, id2);
+				dists.push_back(dist);
+			}
+			std::partial_sort(dists.begin(), dists.begin() + n_nns, dists.end(),
+				[](const IndxDist &a, const IndxDist &b){ return a.dist < b.dist; });
+			for(int nn_id = 0; nn_id < n_nns; ++nn_id){
+				recall_nns[recall_id].push_back(dists[nn_id].idx);
+			}
+			std::sort(recall_nns[recall_id].begin(), recall_nns[recall_id].end());
+		});
+		std::vector< std::vector<int> > new_nns(n_samples), old_nns(n_samples);
+		std::vector< std::vector<int> > new_rev_nns(n_samples), old_rev_nns(n_samples);
+		//! candidate neighbors found by the local join of each node along with the node they are candidates for
+		std::vector< std::vector< std::pair<int, IndxDist> > > join_cands(n_samples);
+		//! candidate neighbors of each node in the order in which they are tried
+		std::vector< std::vector<IndxDist> > node_cands(n_samples);
+		for(int iter_id = 1; iter_id <= params.nnd_max_iters; ++iter_id){
+			//! sample the new neighbors of each node and mark them as old so they take part in only one local join
+			task_arena.parallelFor(0, n_samples, [&](int start_id, int end_id){
+				for(int id1 = start_id; id1 < end_id; ++id1){
+					utils::Philox4x32 rand_gen = getRandGen(2 * iter_id - 1, id1);
+					new_nns[id1].clear();
+					old_nns[id1].clear();
+					for(int nn_id = 0; nn_id < n_nns; ++nn_id){
+						if(nns[id1][nn_id].is_new){
+							new_nns[id1].push_back(nn_id);
+						} else{
+							old_nns[id1].push_back(nns[id1][nn_id].idx);
+						}
+					}
+					sampleInPlace(new_nns[id1], sample_size, rand_gen);
+					for(int &nn_id : new_nns[id1]){
+						nns[id1][nn_id].is_new = false;
+						nn_id = nns[id1][nn_id].idx;
+					}
+				}
+			});
+			//! reverse neighbors are collected serially to avoid having to lock the lists
+			for(int id1 = 0; id1 < n_samples; ++id1){
+				new_rev_nns[id1].clear();
+				old_rev_nns[id1].clear();
+			}
+			for(int id1 = 0; id1 < n_samples; ++id1){
+				for(int id2 : new_nns[id1]){ new_rev_nns[id2].push_back(id1); }
+				for(int id2 : old_nns[id1]){ old_rev_nns[id2].push_back(id1); }
+			}
+			task_arena.parallelFor(0, n_samples, [&](int start_id, int end_id){
+				for(int id1 = start_id; id1 < end_id; ++id1){
+					utils::Philox4x32 rand_gen = getRandGen(2 * iter_id, id1);
+					sampleInPlace(new_rev_nns[id1], sample_size, rand_gen);
+					sampleInPlace(old_rev_nns[id1], sample_size, rand_gen);
+					new_nns[id1].insert(new_nns[id1].end(), new_rev_nns[id1].begin(), new_rev_nns[id1].end());
+					old_nns[id1].insert(old_nns[id1].end(), old_rev_nns[id1].begin(), old_rev_nns[id1].end());
+					std::sort(new_nns[id1].begin(), new_nns[id1].end());
+					new_nns[id1].erase(std::unique(new_nns[id1].begin(), new_nns[id1].end()), new_nns[id1].end());
+					std::sort(old_nns[id1].begin(), old_nns[id1].end());
+					old_nns[id1].erase(std::unique(old_nns[id1].begin(), old_nns[id1].end()), old_nns[id1].end());
+				}
+			});
+			//! local join: the neighbors of each node are likely to be neighbors of each other
+			//! so compare new neighbors with each other and with the old ones;
+			//! the neighbor lists are left unchanged while the candidates are collected so that
+			//! the candidates do not depend on the order in which the nodes are processed
+			task_arena.parallelFor(0, n_samples, [&](int start_id, int end_id){
+				for(int id1 = start_id; id1 < end_id; ++id1){
+					std::vector< std::pair<int, IndxDist> > &cands = join_cands[id1];
+					cands.clear();
+					//! candidates that are no closer than the current farthest neighbor can never be added
+					auto addCand = [&](int nn1, int nn2, double dist){
+						if(dist < nns[nn1].back().dist){
+							IndxDist cand;
+							cand.dist = dist;
+							cand.idx = nn2;
+							cands.push_back(std::make_pair(nn1, cand));
+						}
+					};
+					const std::vector<int> &node_new_nns = new_nns[id1];
+					const std::vector<int> &node_old_nns = old_nns[id1];
+					for(size_t new_id1 = 0; new_id1 < node_new_nns.size(); ++new_id1){
+						int nn1 = node_new_nns[new_id1];
+						for(size_t new_id2 = new_id1 + 1; new_id2 < node_new_nns.size(); ++new_id2){
+							int nn2 = node_new_nns[new_id2];
+							double dist = getDist(nn1, nn2);
+							addCand(nn1, nn2, dist);
+							addCand(nn2, nn1, is_symmetrical ? dist : getDist(nn2, nn1));
+						}
+						for(int nn2 : node_old_nns){
+							if(nn2 == nn1){ continue; }
+							double dist = getDist(nn1, nn2);
+							addCand(nn1, nn2, dist);
+							addCand(nn2, nn1, is_symmetrical ? dist : getDist(nn2, nn1));
+						}
+					}
+				}
+			});
+			//! candidates are distributed to the nodes serially in the order of the nodes that found them
+			//! and then tried on each node in that order so no locking is needed
+			for(int id1 = 0; id1 < n_samples; ++id1){
+				node_cands[id1].clear();
+			}
+			for(int id1 = 0; id1 < n_samples; ++id1){
+				for(const std::pair<int, IndxDist> &cand : join_cands[id1]){
+					node_cands[cand.first].push_back(cand.second);
+				}
+			}
+			long long n_updates = task_arena.parallelReduce(0, n_samples, 0LL, [&](int start_id, int end_id){
+				long long chunk_updates = 0;
+				for(int id1 = start_id; id1 < end_id; ++id1){
+					for(const IndxDist &cand : node_cands[id1]){
+						chunk_updates += updateNNs(id1, cand.idx, cand.dist);
+					}
+				}
+				return chunk_updates;
+			}, std::plus<long long>());
+			double recall = 0;
+			for(int recall_id = 0; recall_id < n_recall_nodes; ++recall_id){
+				int id1 = static_cast<int>(static_cast<long long>(recall_id)*n_samples / n_recall_nodes);
+				for(int nn_id = 0; nn_id < n_nns; ++nn_id){
+					if(std::binary_search(recall_nns[recall_id].begin(), recall_nns[recall_id].end(),
+						nns[id1][nn_id].idx)){
+						++recall;
+					}
+				}
+			}
+			if(n_recall_nodes > 0){
+				recall /= static_cast<double>(n_recall_nodes)*n_nns;
+			}
+			if(params.verbose){
+				mtf_clock_get(end_time);
+				double elapsed_time;
+				mtf_clock_measure(build_state_time, end_time, elapsed_time);
+				printf("NN-Descent iteration %d: %lld updates, estimated recall: %f. Time elapsed: %f secs...\n",
+					iter_id, n_updates, recall, elapsed_time);
+			}
+			if(n_updates <= params.nnd_delta*n_samples*n_nns ||
+				(n_recall_nodes > 0 && recall >= params.nnd_target_recall)){
+				break;
+			}
+		}
+		initNodes(n_nns);
+		for(int id1 = 0; id1 < n_samples; ++id1){
+			for(int nn_id = 0; nn_id < n_nns; ++nn_id){
+				addNode(id1, nns[id1][nn_id].idx);
+			}
+		}
+	}
+
+	template <class DistType>
+	void GNN<DistType>::initNodes(int capacity){
+		graph_file.close();
+		nodes.resize(n_samples);
+		nns_storage.resize(n_samples);
+		for(int node_id = 0; node_id < n_samples; ++node_id){
+			nns_storage[node_id].resize(capacity);
+			nodes[node_id].nns_inds = nns_storage[node_id].data();
+			nodes[node_id].capacity = capacity;
+			nodes[node_id].size = 0;
+		}
+	}
+
+	template <class DistType>
+	void GNN<DistType>::addNode(int node_id, int nn){
+		Node &node = nodes[node_id];
+		int size = node.size++;
+		if(size >= node.capacity){
+			node.capacity = /*size*2*/ size + 10;
+			nns_storage[node_id].conservativeResize(node.capacity);
+			node.nns_inds = nns_storage[node_id].data();
+		}
+		node.nns_inds[size] = nn;
 	}
 }
 
@@ -1,9 +1,16 @@
 #include "mtf/SM/GNNParams.h"
+#include "mtf/Utilities/excpUtils.h"
 
 #define GNN_DEGREE 250
 #define GNN_MAX_STEPS 10
 #define GNN_CMPT_DIST_THRESH 10000
 #define GNN_RANDOM_START 0
+#define GNN_BUILD_TYPE 0
+#define GNN_NND_MAX_ITERS 10
+#define GNN_NND_SAMPLE_RATE 0.5
+#define GNN_NND_DELTA 0.001
+#define GNN_NND_TARGET_RECALL 0.99
+#define GNN_N_THREADS 1
 #define GNN_VERBOSE 0
 
 _MTF_BEGIN_NAMESPACE
@@ -11,11 +18,19 @@ _MTF_BEGIN_NAMESPACE
 namespace gnn{
 	GNNParams::GNNParams(int _degree, int _max_steps,
 		int _cmpt_dist_thresh, bool _random_start,
-		bool _verbose) :
+		BuildType _build_type, int _nnd_max_iters,
+		double _nnd_sample_rate, double _nnd_delta,
+		double _nnd_target_recall, int _n_threads, bool _verbose) :
 		degree(_degree),
 		max_steps(_max_steps),
 		cmpt_dist_thresh(_cmpt_dist_thresh),
 		random_start(_random_start),
+		build_type(_build_type),
+		nnd_max_iters(_nnd_max_iters),
+		nnd_sample_rate(_nnd_sample_rate),
+		nnd_delta(_nnd_delta),
+		nnd_target_recall(_nnd_target_recall),
+		n_threads(_n_threads),
 		verbose(_verbose){}
 
 	GNNParams::GNNParams(const GNNParams *params) :
@@ -23,14 +38,36 @@ namespace gnn{
 		max_steps(GNN_MAX_STEPS),
 		cmpt_dist_thresh(GNN_CMPT_DIST_THRESH),
 		random_start(GNN_RANDOM_START),
+		build_type(static_cast<BuildType>(GNN_BUILD_TYPE)),
+		nnd_max_iters(GNN_NND_MAX_ITERS),
+		nnd_sample_rate(GNN_NND_SAMPLE_RATE),
+		nnd_delta(GNN_NND_DELTA),
+		nnd_target_recall(GNN_NND_TARGET_RECALL),
+		n_threads(GNN_N_THREADS),
 		verbose(GNN_VERBOSE){
 		if(params){
 			degree = params->degree;
 			max_steps = params->max_steps;
 			cmpt_dist_thresh = params->cmpt_dist_thresh;
 			random_start = params->random_start;
+			build_type = params->build_type;
+			nnd_max_iters = params->nnd_max_iters;
+			nnd_sample_rate = params->nnd_sample_rate;
+			nnd_delta = params->nnd_delta;
+			nnd_target_recall = params->nnd_target_recall;
+			n_threads = params->n_threads;
 			verbose = params->verbose;
 		}
 	}
+	const char* GNNParams::toString(BuildType _build_type){
+		switch(_build_type){
+		case BuildType::BruteForce:
+			return "BruteForce";
+		case BuildType::NNDescent:
+			return "NNDescent";
+		default:
+			throw utils::InvalidArgument("Invalid graph build type provided");
+		}
+	}
 }
 _MTF_END_NAMESPACE
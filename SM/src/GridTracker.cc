@@ -7,15 +7,6 @@
 #include "opencv2/imgproc/imgproc.hpp"
 #include "opencv2/highgui/highgui.hpp"
 
-#ifdef ENABLE_TBB
-#include "tbb/tbb.h" 
-#endif
-
-//! OpenMP scheduler
-#ifndef GRID_OMP_SCHD
-#define GRID_OMP_SCHD static
-#endif
-
 _MTF_BEGIN_NAMESPACE
 
 GridTrackerParams::GridTrackerParams(
@@ -23,7 +14,7 @@ int _grid_size_x, int _grid_size_y,
 int _patch_size_x, int _patch_size_y,
 int _reset_at_each_frame, bool _dyn_patch_size,
 bool _patch_centroid_inside, double _fb_err_thresh,
-bool _fb_reinit, bool _use_tbb, int _max_iters, 
+bool _fb_reinit, int _n_threads, int _max_iters, 
 double _epsilon, bool _enable_pyr, bool _show_trackers,
 bool _show_tracker_edges, bool _debug_mode) :
 grid_size_x(_grid_size_x),
@@ -35,7 +26,7 @@ dyn_patch_size(_dyn_patch_size),
 patch_centroid_inside(_patch_centroid_inside),
 fb_err_thresh(_fb_err_thresh),
 fb_reinit(_fb_reinit),
-use_tbb(_use_tbb),
+n_threads(_n_threads),
 max_iters(_max_iters),
 epsilon(_epsilon),
 enable_pyr(_enable_pyr),
@@ -55,7 +46,7 @@ dyn_patch_size(GT_DYN_PATCH_SIZE),
 patch_centroid_inside(GT_PATCH_CENTROID_INSIDE),
 fb_err_thresh(GT_FB_ERR_THRESH),
 fb_reinit(GT_FB_REINIT),
-use_tbb(GT_USE_TBB),
+n_threads(GT_N_THREADS),
 max_iters(GT_MAX_ITERS),
 epsilon(GT_EPSILON),
 enable_pyr(GT_ENABLE_PYR),
@@ -72,7 +63,7 @@ debug_mode(GT_DEBUG_MODE){
 		patch_centroid_inside = params->patch_centroid_inside;
 		fb_err_thresh = params->fb_err_thresh;
 		fb_reinit = params->fb_reinit;
-		use_tbb = params->use_tbb;
+		n_threads = params->n_threads;
 		max_iters = params->max_iters;
 		epsilon = params->epsilon;
 		enable_pyr = params->enable_pyr;
@@ -107,7 +98,7 @@ GridTracker<SSM>::GridTracker(const vector<TrackerBase*> _trackers,
 	printf("patch_centroid_inside: %d\n", params.patch_centroid_inside);
 	printf("fb_err_thresh: %f\n", params.fb_err_thresh);
 	printf("fb_reinit: %d\n", params.fb_reinit);
-	printf("use_tbb: %d\n", params.use_tbb);
+	printf("n_threads: %d\n", params.n_threads);
 	printf("max_iters: %d\n", params.max_iters);
 	printf("epsilon: %f\n", params.epsilon);
 	printf("enable_pyr: %d\n", params.enable_pyr);
@@ -147,7 +138,6 @@ GridTracker<SSM>::GridTracker(const vector<TrackerBase*> _trackers,
 	if(params.dyn_patch_size){
 		printf("Using dynamic patch sizes\n");
 	}
-	patch_corners.create(2, 4, CV_64FC1);
 	cv_corners_mat.create(2, 4, CV_64FC1);
 	prev_pts.resize(n_trackers);
 	curr_pts.resize(n_trackers);
@@ -195,11 +185,11 @@ GridTracker<SSM>::GridTracker(const vector<TrackerBase*> _trackers,
 		patch_win_name = "Patch Trackers";
 		cv::namedWindow(patch_win_name);
 	}
-#if defined ENABLE_TBB
-	printf("Parallelization enabled using TBB\n");
-#elif defined ENABLE_OMP
-	printf("Parallelization enabled using OpenMP\n");
-#endif
+	task_arena.reset(new utils::TaskArena(params.n_threads));
+	if(task_arena->getNThreads() > 1){
+		printf("Parallelization enabled using %s with %d threads\n",
+			utils::TaskArena::toString(task_arena->getBackend()), task_arena->getNThreads());
+	}
 }
 template<class SSM>
 void GridTracker<SSM>::setImage(const cv::Mat &img) {
@@ -245,23 +235,13 @@ void GridTracker<SSM>::initialize(const cv::Mat &corners) {
 }
 template<class SSM>
 void GridTracker<SSM>::update() {
-#ifdef ENABLE_TBB
-	parallel_for(tbb::blocked_range<size_t>(0, n_trackers),
-		[&](const tbb::blocked_range<size_t>& r){
-		for(size_t tracker_id = r.begin(); tracker_id != r.end(); ++tracker_id){
-#else
-#ifdef ENABLE_OMP
-#pragma omp parallel for schedule(GRID_OMP_SCHD)
-#endif	
-	for(int tracker_id = 0; tracker_id < n_trackers; ++tracker_id){
-#endif		
-		trackers[tracker_id]->update();
-		utils::getCentroid(curr_pts[tracker_id], trackers[tracker_id]->getRegion());
-		//patch_corners = trackers[tracker_id]->getRegion();
-	}
-#ifdef ENABLE_TBB
-		});
-#endif
+	task_arena->parallelFor(0, n_trackers, [&](int start_id, int end_id){
+		for(int tracker_id = start_id; tracker_id < end_id; ++tracker_id){
+			trackers[tracker_id]->update();
+			utils::getCentroid(curr_pts[tracker_id], trackers[tracker_id]->getRegion());
+			//patch_corners = trackers[tracker_id]->getRegion();
+		}
+	});
 		if(enable_fb_err_est){
 			backwardEstimation();
 			prev_img = curr_img.clone();
@@ -343,52 +323,43 @@ void GridTracker<SSM>::backwardEstimation(){
 
 template<class SSM>
 void GridTracker<SSM>::resetTrackers(bool reinit){
-#ifdef ENABLE_TBB
-	parallel_for(tbb::blocked_range<size_t>(0, n_trackers),
-		[&](const tbb::blocked_range<size_t>& r){
-		for(size_t tracker_id = r.begin(); tracker_id != r.end(); ++tracker_id){
-#else
-#ifdef ENABLE_OMP
-#pragma omp parallel for schedule(GRID_OMP_SCHD)
-#endif	
-	for(int tracker_id = 0; tracker_id < n_trackers; ++tracker_id){
-
-#endif
-		int row_id = tracker_id / params.grid_size_x;
-		int col_id = tracker_id % params.grid_size_x;
-
-		patch_corners.at<double>(0, 0) = ssm.getPts()(0, _linear_idx(row_id, col_id));
-		patch_corners.at<double>(1, 0) = ssm.getPts()(1, _linear_idx(row_id, col_id));
-
-		patch_corners.at<double>(0, 1) = ssm.getPts()(0, _linear_idx(row_id, col_id + 1));
-		patch_corners.at<double>(1, 1) = ssm.getPts()(1, _linear_idx(row_id, col_id + 1));
-
-		patch_corners.at<double>(0, 2) = ssm.getPts()(0, _linear_idx(row_id + 1, col_id + 1));
-		patch_corners.at<double>(1, 2) = ssm.getPts()(1, _linear_idx(row_id + 1, col_id + 1));
-
-		patch_corners.at<double>(0, 3) = ssm.getPts()(0, _linear_idx(row_id + 1, col_id));
-		patch_corners.at<double>(1, 3) = ssm.getPts()(1, _linear_idx(row_id + 1, col_id));
-
-		if(!params.dyn_patch_size){
-			Vector2d patch_centroid = ssm.getPts().col(tracker_id);
-			if(params.patch_centroid_inside){
-				utils::getCentroid(patch_centroid, patch_corners);
+	task_arena->parallelFor(0, n_trackers, [&](int start_id, int end_id){
+		for(int tracker_id = start_id; tracker_id < end_id; ++tracker_id){
+			//! each tracker gets its own corners since trackers run in parallel and may keep a reference to them
+			cv::Mat patch_corners(2, 4, CV_64FC1);
+			int row_id = tracker_id / params.grid_size_x;
+			int col_id = tracker_id % params.grid_size_x;
+
+			patch_corners.at<double>(0, 0) = ssm.getPts()(0, _linear_idx(row_id, col_id));
+			patch_corners.at<double>(1, 0) = ssm.getPts()(1, _linear_idx(row_id, col_id));
+
+			patch_corners.at<double>(0, 1) = ssm.getPts()(0, _linear_idx(row_id, col_id + 1));
+			patch_corners.at<double>(1, 1) = ssm.getPts()(1, _linear_idx(row_id, col_id + 1));
+
+			patch_corners.at<double>(0, 2) = ssm.getPts()(0, _linear_idx(row_id + 1, col_id + 1));
+			patch_corners.at<double>(1, 2) = ssm.getPts()(1, _linear_idx(row_id + 1, col_id + 1));
+
+			patch_corners.at<double>(0, 3) = ssm.getPts()(0, _linear_idx(row_id + 1, col_id));
+			patch_corners.at<double>(1, 3) = ssm.getPts()(1, _linear_idx(row_id + 1, col_id));
+
+			if(!params.dyn_patch_size){
+				Vector2d patch_centroid = ssm.getPts().col(tracker_id);
+				if(params.patch_centroid_inside){
+					utils::getCentroid(patch_centroid, patch_corners);
+				}
+				patch_corners = utils::Corners(cv::Rect_<double>(
+					patch_centroid(0) - centrod_dist_x, patch_centroid(1) - centrod_dist_y,
+					params.patch_size_x, params.patch_size_y)).mat();
 			}
-			patch_corners = utils::Corners(cv::Rect_<double>(
-				patch_centroid(0) - centrod_dist_x, patch_centroid(1) - centrod_dist_y,
-				params.patch_size_x, params.patch_size_y)).mat();
-		}
-		if(reinit){
-			trackers[tracker_id]->initialize(patch_corners);
-		} else{
-			trackers[tracker_id]->setRegion(patch_corners);
+			if(reinit){
+				trackers[tracker_id]->initialize(patch_corners);
+			} else{
+				trackers[tracker_id]->setRegion(patch_corners);
+			}
+			//patch_corners = trackers[tracker_id]->getRegion();
+			utils::getCentroid(prev_pts[tracker_id], trackers[tracker_id]->getRegion());
 		}
-		//patch_corners = trackers[tracker_id]->getRegion();
-		utils::getCentroid(prev_pts[tracker_id], trackers[tracker_id]->getRegion());
-	}
-#ifdef ENABLE_TBB
-		});
-#endif		
+	});
 }
 
 template<class SSM>
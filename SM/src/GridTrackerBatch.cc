@@ -0,0 +1,437 @@
+#include "mtf/SM/GridTrackerBatch.h"
+#include "mtf/Utilities/miscUtils.h"
+#include "mtf/Utilities/imgUtils.h"
+#include "mtf/Utilities/simdUtils.h"
+#include "opencv2/imgproc/imgproc.hpp"
+#include "opencv2/highgui/highgui.hpp"
+#include <stdexcept>
+
+_MTF_BEGIN_NAMESPACE
+
+GridTrackerBatchParams::GridTrackerBatchParams(
+int _grid_size_x, int _grid_size_y,
+int _patch_size_x, int _patch_size_y,
+int _patch_res_x, int _patch_res_y,
+AMType _am_type, SSMType _ssm_type,
+int _reset_at_each_frame, bool _patch_centroid_inside,
+int _max_iters, double _epsilon,
+bool _show_trackers, bool _debug_mode) :
+grid_size_x(_grid_size_x),
+grid_size_y(_grid_size_y),
+patch_size_x(_patch_size_x),
+patch_size_y(_patch_size_y),
+patch_res_x(_patch_res_x),
+patch_res_y(_patch_res_y),
+am_type(_am_type),
+ssm_type(_ssm_type),
+reset_at_each_frame(_reset_at_each_frame),
+patch_centroid_inside(_patch_centroid_inside),
+max_iters(_max_iters),
+epsilon(_epsilon),
+show_trackers(_show_trackers),
+debug_mode(_debug_mode){
+	updateRes();
+}
+GridTrackerBatchParams::GridTrackerBatchParams(const GridTrackerBatchParams *params) :
+grid_size_x(GTB_GRID_SIZE_X),
+grid_size_y(GTB_GRID_SIZE_Y),
+patch_size_x(GTB_PATCH_SIZE_X),
+patch_size_y(GTB_PATCH_SIZE_Y),
+patch_res_x(GTB_PATCH_RES_X),
+patch_res_y(GTB_PATCH_RES_Y),
+am_type(GTB_AM_TYPE),
+ssm_type(GTB_SSM_TYPE),
+reset_at_each_frame(GTB_RESET_AT_EACH_FRAME),
+patch_centroid_inside(GTB_PATCH_CENTROID_INSIDE),
+max_iters(GTB_MAX_ITERS),
+epsilon(GTB_EPSILON),
+show_trackers(GTB_SHOW_TRACKERS),
+debug_mode(GTB_DEBUG_MODE){
+	if(params){
+		grid_size_x = params->grid_size_x;
+		grid_size_y = params->grid_size_y;
+		patch_size_x = params->patch_size_x;
+		patch_size_y = params->patch_size_y;
+		patch_res_x = params->patch_res_x;
+		patch_res_y = params->patch_res_y;
+		am_type = params->am_type;
+		ssm_type = params->ssm_type;
+		reset_at_each_frame = params->reset_at_each_frame;
+		patch_centroid_inside = params->patch_centroid_inside;
+		max_iters = params->max_iters;
+		epsilon = params->epsilon;
+		show_trackers = params->show_trackers;
+		debug_mode = params->debug_mode;
+	}
+	updateRes();
+}
+void GridTrackerBatchParams::updateRes(){
+	if(patch_centroid_inside){
+		resx = grid_size_x + 1;
+		resy = grid_size_y + 1;
+	} else{
+		resx = grid_size_x;
+		resy = grid_size_y;
+	}
+}
+const char* GridTrackerBatchParams::toString(AMType _am_type){
+	switch(_am_type){
+	case AMType::SSD:
+		return "SSD";
+	case AMType::ZNCC:
+		return "ZNCC";
+	default:
+		throw utils::InvalidArgument("Invalid AM type provided");
+	}
+}
+const char* GridTrackerBatchParams::toString(SSMType _ssm_type){
+	switch(_ssm_type){
+	case SSMType::Translation:
+		return "Translation";
+	case SSMType::IST:
+		return "IST";
+	default:
+		throw utils::InvalidArgument("Invalid SSM type provided");
+	}
+}
+
+template<class SSM>
+GridTrackerBatch<SSM>::GridTrackerBatch(const ParamType *grid_params,
+	const EstimatorParams *_est_params, const SSMParams *_ssm_params) :
+	GridBase(), ssm(_ssm_params), params(grid_params),
+	est_params(_est_params), curr_img_eig(nullptr, 0, 0){
+	printf("\n");
+	printf("Using Batch Grid tracker with:\n");
+	printf("grid_size: %d x %d\n", params.grid_size_x, params.grid_size_y);
+	printf("patch_size: %d x %d\n", params.patch_size_x, params.patch_size_y);
+	printf("patch_res: %d x %d\n", params.patch_res_x, params.patch_res_y);
+	printf("am_type: %s\n", ParamType::toString(params.am_type));
+	printf("ssm_type: %s\n", ParamType::toString(params.ssm_type));
+	printf("reset_at_each_frame: %d\n", params.reset_at_each_frame);
+	printf("patch_centroid_inside: %d\n", params.patch_centroid_inside);
+	printf("max_iters: %d\n", params.max_iters);
+	printf("epsilon: %f\n", params.epsilon);
+	printf("show_trackers: %d\n", params.show_trackers);
+	printf("debug_mode: %d\n", params.debug_mode);
+	printf("\n");
+
+	printf("Using %s estimator with:\n", ssm.name.c_str());
+	est_params.print();
+
+	name = "grid_batch";
+
+	if(ssm.getResX() != params.getResX() || ssm.getResY() != params.getResY()){
+		throw utils::InvalidArgument(
+			cv::format("GridTrackerBatch: SSM has invalid sampling resolution: %d x %d",
+			ssm.getResX(), ssm.getResY()));
+	}
+	reinit_at_each_frame = params.reset_at_each_frame == 1;
+	normalize_patches = params.am_type == ParamType::AMType::ZNCC;
+	state_size = params.ssm_type == ParamType::SSMType::IST ? 3 : 2;
+
+	n_patches = params.grid_size_x*params.grid_size_y;
+	int patch_res_x = params.patch_res_x > 0 ? params.patch_res_x : params.patch_size_x;
+	int patch_res_y = params.patch_res_y > 0 ? params.patch_res_y : params.patch_size_y;
+	n_pix = patch_res_x*patch_res_y;
+
+	VectorXf offsets_x = VectorXf::LinSpaced(patch_res_x,
+		-params.patch_size_x / 2.0f, params.patch_size_x / 2.0f);
+	VectorXf offsets_y = VectorXf::LinSpaced(patch_res_y,
+		-params.patch_size_y / 2.0f, params.patch_size_y / 2.0f);
+	pix_offset_x.resize(n_pix);
+	pix_offset_y.resize(n_pix);
+	for(int row_id = 0; row_id < patch_res_y; ++row_id){
+		for(int col_id = 0; col_id < patch_res_x; ++col_id){
+			pix_offset_x(row_id*patch_res_x + col_id) = offsets_x(col_id);
+			pix_offset_y(row_id*patch_res_x + col_id) = offsets_y(row_id);
+		}
+	}
+
+	patch_x.resize(n_patches);
+	patch_y.resize(n_patches);
+	patch_scale.resize(n_patches);
+	patch_scale.setZero();
+	active_mask.resize(n_patches);
+	update_norm.resize(n_patches);
+	scale_ratio.resize(n_patches);
+	corner_dist_sq = static_cast<float>(params.patch_size_x*params.patch_size_x +
+		params.patch_size_y*params.patch_size_y);
+
+	sample_pts.resize(Eigen::NoChange, n_pix*n_patches);
+	sample_vals.resize(n_pix*n_patches);
+	sample_vals_dec.resize(n_pix*n_patches);
+
+	templ_vals.resize(n_pix, n_patches);
+	curr_vals.resize(n_pix, n_patches);
+	err_vals.resize(n_pix, n_patches);
+	templ_jacobian.resize(state_size);
+	for(int state_id = 0; state_id < state_size; ++state_id){
+		templ_jacobian[state_id].resize(n_pix, n_patches);
+	}
+	hess_inv.resize(state_size*state_size, n_patches);
+	hessian.resize(state_size*state_size, n_patches);
+	jacobian_err.resize(state_size, n_patches);
+	state_update.resize(state_size, n_patches);
+
+	int sub_regions_x = params.grid_size_x + 1, sub_regions_y = params.grid_size_y + 1;
+	_linear_idx.resize(sub_regions_y, sub_regions_x);
+	for(int idy = 0; idy < sub_regions_y; idy++){
+		for(int idx = 0; idx < sub_regions_x; idx++){
+			_linear_idx(idy, idx) = idy * sub_regions_x + idx;
+		}
+	}
+	patch_corners.create(2, 4, CV_64FC1);
+	cv_corners_mat.create(2, 4, CV_64FC1);
+	prev_pts.resize(n_patches);
+	curr_pts.resize(n_patches);
+	ssm_update.resize(ssm.getStateSize());
+	pix_mask.resize(n_patches);
+	std::fill(pix_mask.begin(), pix_mask.end(), 1);
+
+	if(params.show_trackers){
+		pix_mask_needed = true;
+		patch_win_name = "Patch Trackers";
+		cv::namedWindow(patch_win_name);
+	}
+}
+
+template<class SSM>
+void GridTrackerBatch<SSM>::setImage(const cv::Mat &img){
+	if(img.type() != inputType()){
+		throw utils::InvalidArgument(
+			cv_format("GridTrackerBatch::Input image type: %s does not match the required type: %s",
+			utils::getType(img), utils::typeToString(inputType())));
+	}
+	if(params.show_trackers && curr_img_disp.empty()){
+		curr_img_disp.create(img.rows, img.cols, CV_8UC3);
+	}
+	curr_img = img;
+	new (&curr_img_eig) EigImgT((EigPixT*)(img.data), img.rows, img.cols);
+}
+
+template<class SSM>
+void GridTrackerBatch<SSM>::initialize(const cv::Mat &corners) {
+	ssm.initialize(corners);
+	resetPatches(true);
+	curr_pts = prev_pts;
+	ssm.getCorners(cv_corners_mat);
+	if(params.show_trackers){ showTrackers(); }
+}
+
+template<class SSM>
+void GridTrackerBatch<SSM>::update() {
+	active_mask.setOnes();
+	for(int iter_id = 0; iter_id < params.max_iters; ++iter_id){
+		samplePatches(sample_vals);
+		curr_vals = Map<const Array<double, Dynamic, Dynamic, RowMajor> >(
+			sample_vals.data(), n_pix, n_patches).cast<float>();
+		if(normalize_patches){ normalizePatches(curr_vals); }
+		err_vals = curr_vals - templ_vals;
+		for(int state_id = 0; state_id < state_size; ++state_id){
+			jacobian_err.row(state_id) = (templ_jacobian[state_id] * err_vals).colwise().sum();
+		}
+		for(int state_id = 0; state_id < state_size; ++state_id){
+			state_update.row(state_id) = hess_inv.row(state_id*state_size) * jacobian_err.row(0);
+			for(int state_id2 = 1; state_id2 < state_size; ++state_id2){
+				state_update.row(state_id) += hess_inv.row(state_id*state_size + state_id2) *
+					jacobian_err.row(state_id2);
+			}
+		}
+		// patches that have already converged are left where they are
+		state_update.rowwise() *= active_mask;
+		// compose the current warp with the inverse of the update;
+		// the change in the patch corners is that of the center plus that due to the
+		// change in scale which adds (ds^2)*(hx^2 + hy^2) for each corner since the offsets of
+		// the four corners from the center sum to zero
+		if(state_size == 3){
+			scale_ratio = (1 + patch_scale) / (1 + state_update.row(2));
+			state_update.row(0) *= scale_ratio;
+			state_update.row(1) *= scale_ratio;
+			state_update.row(2) = scale_ratio - 1 - patch_scale;
+			patch_scale = scale_ratio - 1;
+			update_norm = state_update.row(0).square() + state_update.row(1).square() +
+				0.25f*corner_dist_sq*state_update.row(2).square();
+		} else{
+			update_norm = state_update.row(0).square() + state_update.row(1).square();
+		}
+		patch_x -= state_update.row(0);
+		patch_y -= state_update.row(1);
+		update_norm *= 4;
+		active_mask *= (update_norm >= static_cast<float>(params.epsilon)).template cast<float>();
+		if(active_mask.sum() == 0){ break; }
+	}
+	for(int patch_id = 0; patch_id < n_patches; ++patch_id){
+		curr_pts[patch_id].x = patch_x(patch_id);
+		curr_pts[patch_id].y = patch_y(patch_id);
+	}
+	ssm.estimateWarpFromPts(ssm_update, pix_mask, prev_pts, curr_pts, est_params);
+
+	Matrix24d opt_warped_corners;
+	ssm.applyWarpToCorners(opt_warped_corners, ssm.getCorners(), ssm_update);
+	ssm.setCorners(opt_warped_corners);
+	if(params.reset_at_each_frame){
+		resetPatches(reinit_at_each_frame);
+	} else{
+		prev_pts = curr_pts;
+	}
+	ssm.getCorners(cv_corners_mat);
+	if(params.show_trackers){ showTrackers(); }
+}
+
+template<class SSM>
+void GridTrackerBatch<SSM>::setRegion(const cv::Mat& corners) {
+	ssm.setCorners(corners);
+	resetPatches(reinit_at_each_frame);
+	ssm.getCorners(cv_corners_mat);
+}
+
+template<class SSM>
+void GridTrackerBatch<SSM>::resetPatches(bool reinit){
+	for(int patch_id = 0; patch_id < n_patches; ++patch_id){
+		if(params.patch_centroid_inside){
+			int row_id = patch_id / params.grid_size_x;
+			int col_id = patch_id % params.grid_size_x;
+
+			patch_corners.at<double>(0, 0) = ssm.getPts()(0, _linear_idx(row_id, col_id));
+			patch_corners.at<double>(1, 0) = ssm.getPts()(1, _linear_idx(row_id, col_id));
+
+			patch_corners.at<double>(0, 1) = ssm.getPts()(0, _linear_idx(row_id, col_id + 1));
+			patch_corners.at<double>(1, 1) = ssm.getPts()(1, _linear_idx(row_id, col_id + 1));
+
+			patch_corners.at<double>(0, 2) = ssm.getPts()(0, _linear_idx(row_id + 1, col_id + 1));
+			patch_corners.at<double>(1, 2) = ssm.getPts()(1, _linear_idx(row_id + 1, col_id + 1));
+
+			patch_corners.at<double>(0, 3) = ssm.getPts()(0, _linear_idx(row_id + 1, col_id));
+			patch_corners.at<double>(1, 3) = ssm.getPts()(1, _linear_idx(row_id + 1, col_id));
+
+			utils::getCentroid(prev_pts[patch_id], patch_corners);
+		} else{
+			prev_pts[patch_id].x = static_cast<float>(ssm.getPts()(0, patch_id));
+			prev_pts[patch_id].y = static_cast<float>(ssm.getPts()(1, patch_id));
+		}
+		patch_x(patch_id) = prev_pts[patch_id].x;
+		patch_y(patch_id) = prev_pts[patch_id].y;
+	}
+	patch_scale.setZero();
+	if(reinit){ initTemplates(); }
+}
+
+template<class SSM>
+void GridTrackerBatch<SSM>::initTemplates(){
+	typedef Map<const Array<double, Dynamic, Dynamic, RowMajor> > SampleArrayT;
+	samplePatches(sample_vals);
+	templ_vals = SampleArrayT(sample_vals.data(), n_pix, n_patches).cast<float>();
+	// pixel gradients are computed as in the AMs by sampling at the same small offsets on either side
+	const double grad_mult = 1.0 / (2 * GRAD_EPS);
+	samplePatches(sample_vals, GRAD_EPS, 0);
+	samplePatches(sample_vals_dec, -GRAD_EPS, 0);
+	templ_jacobian[0] = ((SampleArrayT(sample_vals.data(), n_pix, n_patches) -
+		SampleArrayT(sample_vals_dec.data(), n_pix, n_patches))*grad_mult).cast<float>();
+	samplePatches(sample_vals, 0, GRAD_EPS);
+	samplePatches(sample_vals_dec, 0, -GRAD_EPS);
+	templ_jacobian[1] = ((SampleArrayT(sample_vals.data(), n_pix, n_patches) -
+		SampleArrayT(sample_vals_dec.data(), n_pix, n_patches))*grad_mult).cast<float>();
+	if(state_size == 3){
+		templ_jacobian[2] = templ_jacobian[0].colwise() * pix_offset_x.array() +
+			templ_jacobian[1].colwise() * pix_offset_y.array();
+	}
+	if(normalize_patches){
+		PatchVectorT templ_sd;
+		normalizePatches(templ_vals, &templ_sd);
+		for(int state_id = 0; state_id < state_size; ++state_id){
+			templ_jacobian[state_id].rowwise() -= templ_jacobian[state_id].colwise().mean();
+			templ_jacobian[state_id].rowwise() /= templ_sd;
+		}
+	}
+	for(int state_id = 0; state_id < state_size; ++state_id){
+		for(int state_id2 = state_id; state_id2 < state_size; ++state_id2){
+			hessian.row(state_id*state_size + state_id2) =
+				(templ_jacobian[state_id] * templ_jacobian[state_id2]).colwise().sum();
+			hessian.row(state_id2*state_size + state_id) = hessian.row(state_id*state_size + state_id2);
+		}
+	}
+	invertHessians();
+}
+
+template<class SSM>
+void GridTrackerBatch<SSM>::invertHessians(){
+	typedef Array<double, 1, Dynamic> HessEntryT;
+	// the adjugate and determinant of each patch Hessian are computed in double precision
+	// with one entry of all patches at a time
+	auto h = [&](int row_id, int col_id) -> HessEntryT {
+		return hessian.row(row_id*state_size + col_id).template cast<double>();
+	};
+	auto setInv = [&](int row_id, int col_id, const HessEntryT &inv_entry){
+		hess_inv.row(row_id*state_size + col_id) = inv_entry.template cast<float>();
+	};
+	HessEntryT det_inv;
+	if(state_size == 3){
+		HessEntryT c00 = h(1, 1)*h(2, 2) - h(1, 2)*h(1, 2);
+		HessEntryT c01 = h(1, 2)*h(0, 2) - h(0, 1)*h(2, 2);
+		HessEntryT c02 = h(0, 1)*h(1, 2) - h(1, 1)*h(0, 2);
+		HessEntryT c11 = h(0, 0)*h(2, 2) - h(0, 2)*h(0, 2);
+		HessEntryT c12 = h(0, 2)*h(0, 1) - h(0, 0)*h(1, 2);
+		HessEntryT c22 = h(0, 0)*h(1, 1) - h(0, 1)*h(0, 1);
+		HessEntryT det = h(0, 0)*c00 + h(0, 1)*c01 + h(0, 2)*c02;
+		// patches without any texture are not moved at all
+		det_inv = (det.abs() > 1e-8).select(det.inverse(), 0.0);
+		setInv(0, 0, c00*det_inv);
+		setInv(1, 1, c11*det_inv);
+		setInv(2, 2, c22*det_inv);
+		setInv(0, 1, c01*det_inv);
+		setInv(1, 0, c01*det_inv);
+		setInv(0, 2, c02*det_inv);
+		setInv(2, 0, c02*det_inv);
+		setInv(1, 2, c12*det_inv);
+		setInv(2, 1, c12*det_inv);
+	} else{
+		HessEntryT det = h(0, 0)*h(1, 1) - h(0, 1)*h(0, 1);
+		det_inv = (det.abs() > 1e-8).select(det.inverse(), 0.0);
+		setInv(0, 0, h(1, 1)*det_inv);
+		setInv(1, 1, h(0, 0)*det_inv);
+		setInv(0, 1, -h(0, 1)*det_inv);
+		setInv(1, 0, -h(0, 1)*det_inv);
+	}
+}
+
+template<class SSM>
+void GridTrackerBatch<SSM>::samplePatches(VectorXd &vals, double offset_x, double offset_y){
+	// the locations are generated for all patches at a time, one pixel of the patch at a time
+	typedef Map<Array<double, 1, Dynamic>, 0, InnerStride<2> > PtsRowT;
+	for(int pix_id = 0; pix_id < n_pix; ++pix_id){
+		PtsRowT pts_x(sample_pts.data() + 2 * pix_id*n_patches, n_patches);
+		PtsRowT pts_y(sample_pts.data() + 2 * pix_id*n_patches + 1, n_patches);
+		pts_x = (patch_x + (1 + patch_scale)*pix_offset_x(pix_id)).template cast<double>() + offset_x;
+		pts_y = (patch_y + (1 + patch_scale)*pix_offset_y(pix_id)).template cast<double>() + offset_y;
+	}
+	// the vectorized kernel used by the AMs with the same constant border
+	utils::simd::getPixValsLinear(vals.data(), curr_img_eig, sample_pts.data(),
+		n_pix*n_patches, curr_img.rows, curr_img.cols);
+}
+
+template<class SSM>
+void GridTrackerBatch<SSM>::normalizePatches(PatchArrayT &vals, PatchVectorT *patch_sd){
+	vals.rowwise() -= vals.colwise().mean().eval();
+	PatchVectorT sd = vals.square().colwise().mean().sqrt().max(1e-6f);
+	vals.rowwise() /= sd;
+	if(patch_sd){ *patch_sd = sd; }
+}
+
+template<class SSM>
+void GridTrackerBatch<SSM>::showTrackers(){
+	curr_img.convertTo(curr_img_uchar, CV_8UC1);
+	cv::cvtColor(curr_img_uchar, curr_img_disp, CV_GRAY2BGR);
+	utils::drawRegion(curr_img_disp, cv_corners_mat, CV_RGB(0, 0, 255), 2);
+	for(int patch_id = 0; patch_id < n_patches; ++patch_id) {
+		cv::Scalar tracker_color = pix_mask[patch_id] ? CV_RGB(0, 255, 0) : CV_RGB(255, 0, 0);
+		circle(curr_img_disp, curr_pts[patch_id], 2, tracker_color, 2);
+	}
+	imshow(patch_win_name, curr_img_disp);
+}
+
+_MTF_END_NAMESPACE
+
+#ifndef HEADER_ONLY_MODE
+#include "mtf/Macros/register.h"
+_REGISTER_TRACKERS_SSM(GridTrackerBatch);
+#endif
@@ -0,0 +1,397 @@
+#include "mtf/SM/HNSW.h"
+#include "mtf/Utilities/excpUtils.h"
+#include "mtf/Utilities/cacheUtils.h"
+#include "mtf/Utilities/rngUtils.h"
+
+#include <fstream>
+#include <cstdio>
+#include <cstring>
+#include <cmath>
+#include <algorithm>
+#include <queue>
+#include <limits>
+#include <functional>
+
+_MTF_BEGIN_NAMESPACE
+namespace hnsw{
+	template <class DistType>
+	HNSW<DistType>::HNSW(DistTypePtr _dist_func, int _n_dims,
+		const ParamType *hnsw_params) :
+		dist_func(_dist_func),
+		n_dims(_n_dims),
+		params(hnsw_params),
+		entry_point(-1),
+		max_level(-1),
+		visit_id(0){
+		if(params.M < 2){
+			throw utils::InvalidArgument(
+				"HNSW :: No. of neighbors per point must be at least 2");
+		}
+		if(params.ef_construction < params.M){
+			params.ef_construction = params.M;
+		}
+		if(params.ef_search < 1){
+			params.ef_search = 1;
+		}
+		level_mult = 1.0 / log(static_cast<double>(params.M));
+
+		printf("Using HNSW index with:\n");
+		printf("M: %d\n", params.M);
+		printf("ef_construction: %d\n", params.ef_construction);
+		printf("ef_search: %d\n", params.ef_search);
+		printf("verbose: %d\n", params.verbose);
+	}
+
+	template <class DistType>
+	int HNSW<DistType>::getRandomLevel(int point_id) const{
+		utils::Philox4x32 rand_gen(0, point_id);
+		//! uniformly distributed in (0, 1]
+		double rand_val = (static_cast<double>(rand_gen()) + 1.0) / 4294967296.0;
+		return static_cast<int>(-log(rand_val) * level_mult);
+	}
+
+	template <class DistType>
+	void HNSW<DistType>::startSearch(){
+		if(visit_marks.size() < points.size()){
+			visit_marks.resize(points.size(), 0);
+		}
+		if(++visit_id == 0){
+			std::fill(visit_marks.begin(), visit_marks.end(), 0);
+			visit_id = 1;
+		}
+	}
+
+	template <class DistType>
+	void HNSW<DistType>::searchGreedy(const double *query, int &nn_id, double &nn_dist, int level){
+		bool nn_changed = true;
+		while(nn_changed){
+			nn_changed = false;
+			const std::vector<int> &nn_links = links[nn_id][level];
+			for(unsigned int link_id = 0; link_id < nn_links.size(); ++link_id){
+				double dist = (*dist_func)(query, points[nn_links[link_id]], n_dims);
+				if(dist < nn_dist){
+					nn_dist = dist;
+					nn_id = nn_links[link_id];
+					nn_changed = true;
+				}
+			}
+		}
+	}
+
+	template <class DistType>
+	void HNSW<DistType>::searchLayer(const double *query, std::vector<DistIdx> &nns,
+		int ef, int level){
+		startSearch();
+		//! closest candidate on top
+		std::priority_queue<DistIdx, std::vector<DistIdx>, std::greater<DistIdx> > candidates;
+		//! farthest of the current nearest neighbors on top
+		std::priority_queue<DistIdx> nearest;
+		for(unsigned int nn_id = 0; nn_id < nns.size(); ++nn_id){
+			visit_marks[nns[nn_id].second] = visit_id;
+			candidates.push(nns[nn_id]);
+			nearest.push(nns[nn_id]);
+		}
+		while(!candidates.empty()){
+			DistIdx candidate = candidates.top();
+			if(candidate.first > nearest.top().first){ break; }
+			candidates.pop();
+			const std::vector<int> &candidate_links = links[candidate.second][level];
+			for(unsigned int link_id = 0; link_id < candidate_links.size(); ++link_id){
+				int point_id = candidate_links[link_id];
+				if(visit_marks[point_id] == visit_id){ continue; }
+				visit_marks[point_id] = visit_id;
+				double dist = (*dist_func)(query, points[point_id], n_dims);
+				if(static_cast<int>(nearest.size()) < ef || dist < nearest.top().first){
+					candidates.push(DistIdx(dist, point_id));
+					nearest.push(DistIdx(dist, point_id));
+					if(static_cast<int>(nearest.size()) > ef){ nearest.pop(); }
+				}
+			}
+		}
+		nns.resize(nearest.size());
+		for(int nn_id = static_cast<int>(nearest.size()) - 1; nn_id >= 0; --nn_id){
+			nns[nn_id] = nearest.top();
+			nearest.pop();
+		}
+	}
+
+	template <class DistType>
+	void HNSW<DistType>::selectNeighbors(std::vector<DistIdx> &candidates, int max_neighbors){
+		if(static_cast<int>(candidates.size()) <= max_neighbors){ return; }
+		std::vector<DistIdx> selected, skipped;
+		selected.reserve(max_neighbors);
+		for(unsigned int candidate_id = 0; candidate_id < candidates.size() &&
+			static_cast<int>(selected.size()) < max_neighbors; ++candidate_id){
+			const DistIdx &candidate = candidates[candidate_id];
+			bool is_diverse = true;
+			for(unsigned int selected_id = 0; selected_id < selected.size(); ++selected_id){
+				if((*dist_func)(points[candidate.second], points[selected[selected_id].second],
+					n_dims) < candidate.first){
+					is_diverse = false;
+					break;
+				}
+			}
+			if(is_diverse){
+				selected.push_back(candidate);
+			} else{
+				skipped.push_back(candidate);
+			}
+		}
+		for(unsigned int skipped_id = 0; skipped_id < skipped.size() &&
+			static_cast<int>(selected.size()) < max_neighbors; ++skipped_id){
+			selected.push_back(skipped[skipped_id]);
+		}
+		candidates.swap(selected);
+	}
+
+	template <class DistType>
+	void HNSW<DistType>::insertPoint(int point_id){
+		int level = getRandomLevel(point_id);
+		links[point_id].assign(level + 1, std::vector<int>());
+		if(entry_point < 0){
+			entry_point = point_id;
+			max_level = level;
+			return;
+		}
+		const double *point = points[point_id];
+		int nn_id = entry_point;
+		double nn_dist = (*dist_func)(point, points[nn_id], n_dims);
+		for(int curr_level = max_level; curr_level > level; --curr_level){
+			searchGreedy(point, nn_id, nn_dist, curr_level);
+		}
+		//! the nearest neighbors found in each level are the starting points for the next one
+		std::vector<DistIdx> nns(1, DistIdx(nn_dist, nn_id));
+		std::vector<DistIdx> neighbors, shrunk_links;
+		for(int curr_level = std::min(level, max_level); curr_level >= 0; --curr_level){
+			searchLayer(point, nns, params.ef_construction, curr_level);
+			neighbors = nns;
+			selectNeighbors(neighbors, params.M);
+			std::vector<int> &point_links = links[point_id][curr_level];
+			point_links.resize(neighbors.size());
+			int max_neighbors = getMaxNeighbors(curr_level);
+			for(unsigned int neighbor_id = 0; neighbor_id < neighbors.size(); ++neighbor_id){
+				int neighbor = neighbors[neighbor_id].second;
+				point_links[neighbor_id] = neighbor;
+				std::vector<int> &neighbor_links = links[neighbor][curr_level];
+				neighbor_links.push_back(point_id);
+				if(static_cast<int>(neighbor_links.size()) <= max_neighbors){ continue; }
+				//! the neighbor has too many links so only the most diverse of them are retained
+				const double *neighbor_point = points[neighbor];
+				shrunk_links.resize(neighbor_links.size());
+				for(unsigned int link_id = 0; link_id < neighbor_links.size(); ++link_id){
+					shrunk_links[link_id] = DistIdx((*dist_func)(neighbor_point,
+						points[neighbor_links[link_id]], n_dims), neighbor_links[link_id]);
+				}
+				std::sort(shrunk_links.begin(), shrunk_links.end());
+				selectNeighbors(shrunk_links, max_neighbors);
+				neighbor_links.resize(shrunk_links.size());
+				for(unsigned int link_id = 0; link_id < shrunk_links.size(); ++link_id){
+					neighbor_links[link_id] = shrunk_links[link_id].second;
+				}
+			}
+		}
+		if(level > max_level){
+			max_level = level;
+			entry_point = point_id;
+		}
+	}
+
+	template <class DistType>
+	void HNSW<DistType>::buildIndex(const double *dataset, int n_points){
+		points.clear();
+		links.clear();
+		entry_point = max_level = -1;
+		addPoints(dataset, n_points);
+	}
+
+	template <class DistType>
+	void HNSW<DistType>::addPoints(const double *new_points, int n_points){
+		int start_id = static_cast<int>(points.size());
+		points.resize(start_id + n_points);
+		links.resize(start_id + n_points);
+		visit_marks.resize(start_id + n_points, 0);
+		if(params.verbose){
+			printf("Adding %d points to HNSW index...\n", n_points);
+		}
+		mtf_clock_get(build_start_time);
+		for(int point_id = start_id; point_id < start_id + n_points; ++point_id){
+			points[point_id] = new_points + (point_id - start_id)*n_dims;
+			insertPoint(point_id);
+			if(params.verbose && (point_id - start_id + 1) % 1000 == 0){
+				mtf_clock_get(end_time);
+				double elapsed_time;
+				mtf_clock_measure(build_start_time, end_time, elapsed_time);
+				printf("Done %d/%d points (%6.2f%%). Time elapsed: %f secs...\n",
+					point_id - start_id + 1, n_points,
+					double(point_id - start_id + 1) / double(n_points) * 100,
+					elapsed_time);
+			}
+		}
+		if(params.verbose){
+			printf("HNSW index has %d points in %d levels\n", getNPoints(), max_level + 1);
+		}
+	}
+
+	template <class DistType>
+	void HNSW<DistType>::searchKNN(const double *query, int *nn_ids, double *nn_dists, int K){
+		if(entry_point < 0){
+			throw utils::LogicError("HNSW :: Index is empty");
+		}
+		int nn_id = entry_point;
+		double nn_dist = (*dist_func)(query, points[nn_id], n_dims);
+		for(int level = max_level; level > 0; --level){
+			searchGreedy(query, nn_id, nn_dist, level);
+		}
+		std::vector<DistIdx> nns(1, DistIdx(nn_dist, nn_id));
+		searchLayer(query, nns, std::max(params.ef_search, K), 0);
+		for(int k = 0; k < K; ++k){
+			if(k < static_cast<int>(nns.size())){
+				nn_ids[k] = nns[k].second;
+				nn_dists[k] = nns[k].first;
+			} else{
+				nn_ids[k] = -1;
+				nn_dists[k] = std::numeric_limits<double>::infinity();
+			}
+		}
+	}
+
+	template <class DistType>
+	void HNSW<DistType>::saveIndex(const char* saved_index_path, unsigned long long dataset_key){
+		if(entry_point < 0){
+			printf("HNSW index has not been built so cannot be saved\n");
+			return;
+		}
+		int n_points = getNPoints();
+		IndexHeader header = {};
+		memcpy(header.magic, "MTFHNSW", 8);
+		header.version = 1;
+		header.header_size = sizeof(IndexHeader);
+		header.n_points = n_points;
+		header.n_dims = n_dims;
+		header.M = params.M;
+		header.max_level = max_level;
+		header.entry_point = entry_point;
+		header.dataset_key = dataset_key;
+		header.file_size = sizeof(IndexHeader) + n_points*sizeof(int32_t);
+		for(int point_id = 0; point_id < n_points; ++point_id){
+			for(unsigned int level = 0; level < links[point_id].size(); ++level){
+				header.file_size += (links[point_id][level].size() + 1)*sizeof(int32_t);
+			}
+		}
+		//! write to a temporary file first so that an interrupted save never leaves behind a truncated index
+		string tmp_path = string(saved_index_path) + ".tmp";
+		ofstream out_file(tmp_path, ios::out | ios::binary);
+		if(!out_file.good()){
+			printf("Failed to save HNSW index to: %s\n", saved_index_path);
+			return;
+		}
+		printf("Saving HNSW index to: %s\n", saved_index_path);
+		out_file.write((char*)(&header), sizeof(IndexHeader));
+		for(int point_id = 0; point_id < n_points; ++point_id){
+			int32_t level = static_cast<int32_t>(links[point_id].size()) - 1;
+			out_file.write((char*)(&level), sizeof(int32_t));
+		}
+		for(int point_id = 0; point_id < n_points; ++point_id){
+			for(unsigned int level = 0; level < links[point_id].size(); ++level){
+				int32_t n_links = static_cast<int32_t>(links[point_id][level].size());
+				out_file.write((char*)(&n_links), sizeof(int32_t));
+				out_file.write((char*)(links[point_id][level].data()), n_links*sizeof(int32_t));
+			}
+		}
+		bool write_successful = out_file.good();
+		out_file.close();
+		remove(saved_index_path);
+		if(!write_successful || rename(tmp_path.c_str(), saved_index_path) != 0){
+			printf("Failed to save HNSW index to: %s\n", saved_index_path);
+			remove(tmp_path.c_str());
+		}
+	}
+
+	template <class DistType>
+	bool HNSW<DistType>::loadIndex(const char* saved_index_path, const double *dataset,
+		int n_points, unsigned long long dataset_key){
+		utils::MappedFile in_file;
+		if(!in_file.open(saved_index_path)){
+			printf("Failed to load HNSW index from: %s\n", saved_index_path);
+			return false;
+		}
+		printf("Loading HNSW index from: %s\n", saved_index_path);
+		const IndexHeader *header = in_file.getData<IndexHeader>();
+		const char *error = nullptr;
+		if(in_file.getSize() < sizeof(IndexHeader) || memcmp(header->magic, "MTFHNSW", 8) != 0){
+			error = "not an HNSW index file";
+		} else if(header->version != 1 || header->header_size != sizeof(IndexHeader)){
+			error = "unsupported file version";
+		} else if(header->n_points != n_points || header->n_dims != n_dims){
+			error = "index size does not match the dataset";
+		} else if(header->M != params.M){
+			error = "index was built with a different no. of neighbors per point";
+		} else if(header->dataset_key != dataset_key){
+			error = "index was built from a different dataset";
+		} else if(header->file_size != in_file.getSize() ||
+			!in_file.contains<int32_t>(sizeof(IndexHeader), n_points) ||
+			header->entry_point < 0 || header->entry_point >= n_points){
+			error = "file is truncated";
+		}
+		std::vector< std::vector< std::vector<int> > > loaded_links;
+		if(!error){
+			//! the links are copied out of the file since they change when points are added
+			const int32_t *levels = in_file.getData<int32_t>(sizeof(IndexHeader));
+			uint64_t offset = sizeof(IndexHeader) + n_points*sizeof(int32_t);
+			loaded_links.resize(n_points);
+			for(int point_id = 0; point_id < n_points && !error; ++point_id){
+				if(levels[point_id] < 0 || levels[point_id] > header->max_level){
+					error = "index has invalid levels";
+					break;
+				}
+				loaded_links[point_id].resize(levels[point_id] + 1);
+				for(int level = 0; level <= levels[point_id] && !error; ++level){
+					if(!in_file.contains<int32_t>(offset, 1)){
+						error = "file is truncated";
+						break;
+					}
+					int32_t n_links = *in_file.getData<int32_t>(offset);
+					offset += sizeof(int32_t);
+					if(n_links < 0 || n_links > getMaxNeighbors(level) ||
+						!in_file.contains<int32_t>(offset, n_links)){
+						error = "index has invalid links";
+						break;
+					}
+					const int32_t *point_links = in_file.getData<int32_t>(offset);
+					offset += n_links*sizeof(int32_t);
+					for(int link_id = 0; link_id < n_links; ++link_id){
+						if(point_links[link_id] < 0 || point_links[link_id] >= n_points ||
+							levels[point_links[link_id]] < level){
+							error = "index has invalid links";
+							break;
+						}
+					}
+					loaded_links[point_id][level].assign(point_links, point_links + n_links);
+				}
+			}
+			if(!error && levels[header->entry_point] != header->max_level){
+				error = "index has an invalid entry point";
+			}
+		}
+		if(error){
+			printf("Rejecting HNSW index in %s: %s\n", saved_index_path, error);
+			return false;
+		}
+		links.swap(loaded_links);
+		points.resize(n_points);
+		for(int point_id = 0; point_id < n_points; ++point_id){
+			points[point_id] = dataset + point_id*n_dims;
+		}
+		visit_marks.assign(n_points, 0);
+		visit_id = 0;
+		entry_point = header->entry_point;
+		max_level = header->max_level;
+		return true;
+	}
+}
+_MTF_END_NAMESPACE
+
+#ifndef HEADER_ONLY_MODE
+#include "mtf/Macros/register.h"
+_REGISTER_TRACKERS_DIST(hnsw::HNSW);
+#endif
@@ -0,0 +1,31 @@
+#include "mtf/SM/HNSWParams.h"
+
+#define HNSW_M 16
+#define HNSW_EF_CONSTRUCTION 200
+#define HNSW_EF_SEARCH 50
+#define HNSW_VERBOSE 0
+
+_MTF_BEGIN_NAMESPACE
+
+namespace hnsw{
+	HNSWParams::HNSWParams(int _M, int _ef_construction,
+		int _ef_search, bool _verbose) :
+		M(_M),
+		ef_construction(_ef_construction),
+		ef_search(_ef_search),
+		verbose(_verbose){}
+
+	HNSWParams::HNSWParams(const HNSWParams *params) :
+		M(HNSW_M),
+		ef_construction(HNSW_EF_CONSTRUCTION),
+		ef_search(HNSW_EF_SEARCH),
+		verbose(HNSW_VERBOSE){
+		if(params){
+			M = params->M;
+			ef_construction = params->ef_construction;
+			ef_search = params->ef_search;
+			verbose = params->verbose;
+		}
+	}
+}
+_MTF_END_NAMESPACE
@@ -36,9 +36,15 @@ IALK<AM, SSM >::IALK(const ParamType *ialk_params,
 	}
 
 	ssm_update.resize(ssm.getStateSize());
+	inv_ssm_update.resize(ssm.getStateSize());
 	curr_pix_jacobian.resize(am.getPatchSize(), ssm.getStateSize());
 	jacobian.resize(ssm.getStateSize());
 	hessian.resize(ssm.getStateSize(), ssm.getStateSize());
+	solver.resize(ssm.getStateSize());
+	//! the similarity itself is only needed for the LM check
+	sim_required.similarity = params.leven_marq;
+	sim_required.sim_prereq = true;
+	grad_required.curr_grad = true;
 	if(params.hess_type == HessType::InitialSelf){
 		init_pix_jacobian.resize(am.getPatchSize(), ssm.getStateSize());
 	}
@@ -76,9 +82,6 @@ void IALK<AM, SSM >::initialize(const cv::Mat &corners){
 		} else{
 			am.cmptSelfHessian(hessian, init_pix_jacobian);
 		}
-		if(params.leven_marq){
-			init_self_hessian = hessian;
-		}
 	}
 	ssm.getCorners(cv_corners_mat);
 
@@ -89,31 +92,33 @@ void IALK<AM, SSM >::initialize(const cv::Mat &corners){
 template <class AM, class SSM>
 void IALK<AM, SSM >::update(){
 	++frame_id;
+	utils::AllocGuard alloc_guard(frame_id > 1);
 	write_frame_id(frame_id);
 
 	double prev_f = 0;
 	double lm_delta = params.lm_delta_init;
-	bool state_reset = false;
 
+	am.setFirstIter();
 	for(int iter_id = 0; iter_id < params.max_iters; ++iter_id){
 		init_timer();
 
-		am.updatePixVals(ssm.getPts());
-		record_event("am.updatePixVals");
+		am.updateRequired(ssm.getPts(), sim_required);
+		record_event("am.updateRequired (similarity)");
 
-		am.updateSimilarity(false);
-		record_event("am.updateSimilarity");
-
-		if(params.leven_marq && !state_reset){
+		if(params.leven_marq){
 			double f = am.getSimilarity();
 			if(iter_id > 0){
 				if(f < prev_f){
 					lm_delta *= params.lm_delta_update;
 					//! undo the last update
-					VectorXd inv_ssm_update = -ssm_update;
+					inv_ssm_update = -ssm_update;
 					ssm.additiveUpdate(inv_ssm_update);
-
-					state_reset = true;
+					//! and retry it with the larger damping using the system that produced it
+					//! since the Jacobian and Hessian at the restored state are still the same
+					solver.resolve(ssm_update, lm_delta);
+					prev_corners = ssm.getCorners();
+					ssm.additiveUpdate(ssm_update);
+					if((prev_corners - ssm.getCorners()).squaredNorm() < params.epsilon){ break; }
 					continue;
 				}
 				if(f > prev_f){
@@ -122,13 +127,12 @@ void IALK<AM, SSM >::update(){
 			}
 			prev_f = f;
 		}
-		state_reset = false;
 
 		ssm.cmptApproxPixJacobian(curr_pix_jacobian, am.getInitPixGrad());
 		record_event("am.cmptApproxPixJacobian");
 
-		am.updateCurrGrad();
-		record_event("am.updateCurrGrad");
+		am.updateRequired(ssm.getPts(), grad_required);
+		record_event("am.updateRequired (gradients)");
 
 		am.cmptCurrJacobian(jacobian, curr_pix_jacobian);
 		record_event("am.cmptCurrJacobian");
@@ -141,9 +145,6 @@ void IALK<AM, SSM >::update(){
 		}
 		switch(params.hess_type){
 		case HessType::InitialSelf:
-			if(params.leven_marq){
-				hessian = init_self_hessian;
-			}
 			break;
 		case HessType::CurrentSelf:
 			if(params.sec_ord_hess){
@@ -164,11 +165,7 @@ void IALK<AM, SSM >::update(){
 			}
 			break;
 		}
-		if(params.leven_marq){
-			MatrixXd diag_hessian = hessian.diagonal().asDiagonal();
-			hessian += lm_delta*diag_hessian;
-		}
-		ssm_update = -hessian.colPivHouseholderQr().solve(jacobian.transpose());
+		solver.solve(ssm_update, hessian, jacobian, params.leven_marq ? lm_delta : 0);
 		record_event("ssm_update");
 
 		prev_corners = ssm.getCorners();
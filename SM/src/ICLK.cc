@@ -46,13 +46,28 @@ ICLK<AM, SSM >::ICLK(const ParamType *iclk_params,
 	if(params.leven_marq){
 		printf("Using Levenberg Marquardt formulation...\n");
 	}
-
-	dI0_dpssm.resize(am.getPatchSize(), ssm_state_size);
-	if(params.hess_type == HessType::CurrentSelf){
-		dIt_dpssm.resize(am.getPatchSize(), ssm_state_size);
+	float_jac = am.supportsFloatJacobian() && !params.sec_ord_hess;
+	if(float_jac){
+		printf("Using single precision pixel Jacobians...\n");
+		dI0_dpssm_f.resize(am.getPatchSize(), ssm_state_size);
+		if(params.hess_type == HessType::CurrentSelf){
+			dIt_dpssm_f.resize(am.getPatchSize(), ssm_state_size);
+		}
+	} else{
+		dI0_dpssm.resize(am.getPatchSize(), ssm_state_size);
+		if(params.hess_type == HessType::CurrentSelf){
+			dIt_dpssm.resize(am.getPatchSize(), ssm_state_size);
+		}
 	}
 	df_dp.resize(state_size);
 	d2f_dp2.resize(state_size, state_size);
+	solver.resize(state_size);
+	//! the similarity itself is only needed for the LM check
+	sim_required.similarity = params.leven_marq;
+	sim_required.sim_prereq = true;
+	grad_required.init_grad = true;
+	grad_required.pix_grad = params.hess_type == HessType::CurrentSelf;
+	grad_required.pix_hess = grad_required.pix_grad && params.sec_ord_hess;
 
 	state_update.resize(state_size);
 	ssm_update.resize(ssm_state_size);
@@ -85,8 +100,13 @@ void ICLK<AM, SSM >::initialize(const cv::Mat &corners){
 	am.initializeHess();
 
 	am.initializePixGrad(ssm.getPts());
-	ssm.cmptWarpedPixJacobian(dI0_dpssm, am.getInitPixGrad());
-	am.cmptInitJacobian(df_dp, dI0_dpssm);
+	if(float_jac){
+		ssm.cmptWarpedPixJacobianFloat(dI0_dpssm_f, am.getInitPixGrad());
+		am.cmptInitJacobianFloat(df_dp, dI0_dpssm_f);
+	} else{
+		ssm.cmptWarpedPixJacobian(dI0_dpssm, am.getInitPixGrad());
+		am.cmptInitJacobian(df_dp, dI0_dpssm);
+	}
 
 	if(params.sec_ord_hess){
 		if(params.sec_ord_hess){
@@ -100,12 +120,11 @@ void ICLK<AM, SSM >::initialize(const cv::Mat &corners){
 	if(params.hess_type == HessType::InitialSelf){
 		if(params.sec_ord_hess){
 			am.cmptSelfHessian(d2f_dp2, dI0_dpssm, d2I0_dpssm2);
+		} else if(float_jac){
+			am.cmptSelfHessianFloat(d2f_dp2, dI0_dpssm_f);
 		} else{
 			am.cmptSelfHessian(d2f_dp2, dI0_dpssm);
 		}
-		if(params.leven_marq){
-			d2f_dp2_orig = d2f_dp2;
-		}
 	}
 	ssm.getCorners(cv_corners_mat);
 
@@ -120,8 +139,13 @@ void ICLK<AM, SSM >::setRegion(const cv::Mat& corners){
 		// since the above command completely resets the SSM state including its initial points,
 		// any quantities that depend on these, like dI0_dpssm and d2I0_dpssm2,
 		// must be recomputed along with quantities that depend on these in turn.
-		ssm.cmptWarpedPixJacobian(dI0_dpssm, am.getInitPixGrad());
-		am.cmptInitJacobian(df_dp, dI0_dpssm);
+		if(float_jac){
+			ssm.cmptWarpedPixJacobianFloat(dI0_dpssm_f, am.getInitPixGrad());
+			am.cmptInitJacobianFloat(df_dp, dI0_dpssm_f);
+		} else{
+			ssm.cmptWarpedPixJacobian(dI0_dpssm, am.getInitPixGrad());
+			am.cmptInitJacobian(df_dp, dI0_dpssm);
+		}
 		if(params.hess_type != HessType::CurrentSelf){
 			if(params.sec_ord_hess){
 				ssm.cmptWarpedPixHessian(d2I0_dpssm2, am.getInitPixHess(), am.getInitPixGrad());
@@ -129,12 +153,11 @@ void ICLK<AM, SSM >::setRegion(const cv::Mat& corners){
 			if(params.hess_type == HessType::InitialSelf){
 				if(params.sec_ord_hess){
 					am.cmptSelfHessian(d2f_dp2, dI0_dpssm, d2I0_dpssm2);
+				} else if(float_jac){
+					am.cmptSelfHessianFloat(d2f_dp2, dI0_dpssm_f);
 				} else{
 					am.cmptSelfHessian(d2f_dp2, dI0_dpssm);
 				}
-				if(params.leven_marq){
-					d2f_dp2_orig = d2f_dp2;
-				}
 			}
 		}
 	}
@@ -144,24 +167,21 @@ void ICLK<AM, SSM >::setRegion(const cv::Mat& corners){
 template <class AM, class SSM>
 void ICLK<AM, SSM >::update(){
 	++frame_id;
+	utils::AllocGuard alloc_guard(frame_id > 1);
 	write_frame_id(frame_id);
 
 	am.setFirstIter();
 
 	double prev_f = 0;
 	double lm_delta = params.lm_delta_init;
-	bool state_reset = false;
 
 	for(int iter_id = 0; iter_id < params.max_iters; ++iter_id){
 		init_timer();
 
-		am.updatePixVals(ssm.getPts());
-		record_event("am.updatePixVals");
+		am.updateRequired(ssm.getPts(), sim_required, grad_required);
+		record_event("am.updateRequired (similarity)");
 
-		am.updateSimilarity(false);
-		record_event("am.updateSimilarity");
-
-		if(params.leven_marq && !state_reset){
+		if(params.leven_marq){
 			double f = am.getSimilarity();
 			if(iter_id > 0){
 				if(f < prev_f){
@@ -169,7 +189,17 @@ void ICLK<AM, SSM >::update(){
 					//! undo the last update
 					ssm.compositionalUpdate(ssm_update);
 					am.updateState(am_update);
-					state_reset = true;
+					//! and retry it with the larger damping using the system that produced it
+					//! since the Jacobian and Hessian at the restored state are still the same
+					solver.resolve(state_update, lm_delta);
+					ssm_update = state_update.head(ssm_state_size);
+					am_update = state_update.tail(am_state_size);
+					prev_corners = ssm.getCorners();
+					ssm.invertState(inv_ssm_update, ssm_update);
+					ssm.compositionalUpdate(inv_ssm_update);
+					am.invertState(inv_am_update, am_update);
+					am.updateState(inv_am_update);
+					if((prev_corners - ssm.getCorners()).squaredNorm() < params.epsilon){ break; }
 					continue;
 				}
 				if(f > prev_f){
@@ -178,28 +208,31 @@ void ICLK<AM, SSM >::update(){
 			}
 			prev_f = f;
 		}
-		state_reset = false;
 
-		am.updateInitGrad();
-		record_event("am.updateInitGrad");
+		am.updateRequired(ssm.getPts(), grad_required);
+		record_event("am.updateRequired (gradients)");
 
-		am.cmptInitJacobian(df_dp, dI0_dpssm);
+		if(float_jac){
+			am.cmptInitJacobianFloat(df_dp, dI0_dpssm_f);
+		} else{
+			am.cmptInitJacobian(df_dp, dI0_dpssm);
+		}
 		record_event("am.cmptInitJacobian");
 
 		switch(params.hess_type){
 		case HessType::InitialSelf:
-			if(params.leven_marq){
-				d2f_dp2 = d2f_dp2_orig;
-			}
 			break;
-		case HessType::CurrentSelf:
-			am.updatePixGrad(ssm.getPts());
-			record_event("am.updatePixGrad");
+		case HessType::CurrentSelf:
+			if(float_jac){
+				ssm.cmptWarpedPixJacobianFloat(dIt_dpssm_f, am.getCurrPixGrad());
+				record_event("ssm.cmptWarpedPixJacobianFloat");
+				am.cmptSelfHessianFloat(d2f_dp2, dIt_dpssm_f);
+				record_event("am.cmptSelfHessianFloat");
+				break;
+			}
 			ssm.cmptWarpedPixJacobian(dIt_dpssm, am.getCurrPixGrad());
-			record_event("ssm.cmptWarpedPixJacobian");
-			if(params.sec_ord_hess){
-				am.updatePixHess(ssm.getPts());
-				record_event("am.updatePixHess");
+			record_event("ssm.cmptWarpedPixJacobian");
+			if(params.sec_ord_hess){
 				ssm.cmptWarpedPixHessian(d2It_dpssm2, am.getCurrPixHess(),
 					am.getCurrPixGrad());
 				record_event("ssm.cmptWarpedPixHessian");
@@ -214,18 +247,16 @@ void ICLK<AM, SSM >::update(){
 			if(params.sec_ord_hess){
 				am.cmptInitHessian(d2f_dp2, dI0_dpssm, d2I0_dpssm2);
 				record_event("am.cmptInitHessian (second order)");
+			} else if(float_jac){
+				am.cmptInitHessianFloat(d2f_dp2, dI0_dpssm_f);
+				record_event("am.cmptInitHessianFloat");
 			} else{
 				am.cmptInitHessian(d2f_dp2, dI0_dpssm);
 				record_event("am.cmptInitHessian (first order)");
 			}
 			break;
 		}
-		if(params.leven_marq){
-			MatrixXd diag_d2f_dp2 = d2f_dp2.diagonal().asDiagonal();
-			d2f_dp2 += lm_delta*diag_d2f_dp2;
-		}
-
-		state_update = -d2f_dp2.colPivHouseholderQr().solve(df_dp.transpose());
+		solver.solve(state_update, d2f_dp2, df_dp, params.leven_marq ? lm_delta : 0);
 		record_event("state_update");
 
 		ssm_update = state_update.head(ssm_state_size);
@@ -2,6 +2,9 @@
 #include "mtf/Utilities/miscUtils.h"
 #include "mtf/Utilities/excpUtils.h"
 #include <fstream> 
+#include <cstdio>
+#include <cstring>
+#include <boost/random/random_device.hpp>
 #include "opencv2/highgui/highgui.hpp"
 #ifndef DISABLE_HDF5
 #include <flann/io/hdf5.h>
@@ -16,11 +19,15 @@ NN<AM, SSM >::NN(const ParamType *nn_params,
 	const FLANNParams *_flann_params,
 	const AMParams *am_params, const SSMParams *ssm_params) :
 	SearchMethod<AM, SSM>(am_params, ssm_params),
+	n_workers(1), n_generated_samples(0),
 	params(nn_params),
 	flann_params(_flann_params),
 	flann_index(nullptr),
 	gnn_index(nullptr),
+	hnsw_index(nullptr),
 	flann_dataset(nullptr),
+	dataset_data(nullptr),
+	cache_key(0),
 	dataset_loaded(false){
 	printf("\n");
 	printf("Using Nearest Neighbor SM with:\n");
@@ -37,6 +44,7 @@ NN<AM, SSM >::NN(const ParamType *nn_params,
 	printf("n_samples_to_add: %d\n", params.n_samples_to_add);
 	printf("remove_samples: %d\n", params.remove_samples);
 	printf("save_index: %d\n", params.save_index);
+	printf("n_threads: %d\n", params.n_threads);
 	printf("debug_mode: %d\n", params.debug_mode);
 
 	printf("appearance model: %s\n", am.name.c_str());
@@ -57,15 +65,33 @@ NN<AM, SSM >::NN(const ParamType *nn_params,
 	using_pix_sigma = params.processDistributions(state_sigma, state_mean,
 		distr_n_samples, n_distr, ssm_state_size);
 
-	eig_dataset.resize(params.n_samples, am_dist_size);
 	eig_result.resize(1);
 	eig_dists.resize(1);
 
-	flann_dataset.reset(new flannMatT(const_cast<double *>(eig_dataset.data()),
-		eig_dataset.rows(), eig_dataset.cols()));
-
 	ssm_perturbations.resize(params.n_samples);
-	inv_state_update.resize(ssm_state_size);
+
+	boost::random_device r;
+	sampler_seed = (static_cast<unsigned long long>(r()) << 32) | r();
+	use_sampler_streams = params.sampler_streams && ssm.supportsSamplerStreams();
+
+	task_arena.reset(new utils::TaskArena(params.n_threads));
+	n_workers = std::max(1, std::min(task_arena->getNThreads(), params.n_samples));
+	if(n_workers > 1){
+		printf(" ******* Parallelization is enabled using %s with %d workers ******* \n",
+			utils::TaskArena::toString(task_arena->getBackend()), n_workers);
+	}
+	for(int worker_id = 1; worker_id < n_workers; ++worker_id){
+		am_vec.push_back(AMPTr(new AM(am_params)));
+		ssm_vec.push_back(SSMPTr(new SSM(ssm_params)));
+	}
+	if(n_workers > 1 && params.sampler_streams && !use_sampler_streams){
+		printf("SSM %s does not support sampler streams so the dataset will depend on the no. of workers\n",
+			ssm.name.c_str());
+	}
+	inv_state_updates.resize(n_workers);
+	for(int worker_id = 0; worker_id < n_workers; ++worker_id){
+		inv_state_updates[worker_id].resize(ssm_state_size);
+	}
 	
 	if(params.add_samples_gap){
 		printf("Adding %d samples every %d frames\n", 
@@ -91,11 +117,6 @@ NN<AM, SSM >::NN(const ParamType *nn_params,
 		}
 	}
 
-	string fname_template = cv::format("%s_%s_%d_%d", am.name.c_str(), ssm.name.c_str(),
-		params.n_samples, am_dist_size);
-	saved_db_path = cv::format("%s/%s.db", params.saved_index_dir.c_str(), fname_template.c_str());
-	saved_idx_path = cv::format("%s/%s_%s.idx", params.saved_index_dir.c_str(),
-		fname_template.c_str(), FLANNParams::toString(flann_params.index_type));
 }
 
 template <class AM, class SSM>
@@ -136,6 +157,17 @@ void NN<AM, SSM >::initialize(const cv::Mat &corners){
 	am.initializePixVals(ssm.getPts());
 	am.initializeDistFeat();
 
+	for(int worker_id = 1; worker_id < n_workers; ++worker_id){
+		SSM &worker_ssm = getWorkerSSM(worker_id);
+		AM &worker_am = getWorkerAM(worker_id);
+		worker_am.clearInitStatus();
+		worker_ssm.clearInitStatus();
+		worker_ssm.initialize(corners, am.getNChannels());
+		worker_ssm.initializeSampler(state_sigma[0], state_mean[0]);
+		worker_am.initializePixVals(ssm.getPts());
+		worker_am.initializeDistFeat();
+	}
+
 	//utils::printMatrix(ssm.getCorners(), "init_corners original");
 	//utils::printMatrix(ssm.getCorners(), "init_corners after");
 	//utils::printScalarToFile("initializing NN...", " ", log_fname, "%s", "w");
@@ -144,6 +176,8 @@ void NN<AM, SSM >::initialize(const cv::Mat &corners){
 		am.getCurrImg().convertTo(curr_img_uchar, CV_8UC1);
 	}
 
+	dataset_loaded = false;
+	if(params.load_index || params.save_index){ initializeCache(); }
 	if(params.load_index){ loadDataset(); }
 
 	if(!dataset_loaded){
@@ -151,6 +185,9 @@ void NN<AM, SSM >::initialize(const cv::Mat &corners){
 		printf("building feature dataset...\n");
 		mtf_clock_get(db_start_time);
 
+		dataset_file.close();
+		eig_dataset.resize(params.n_samples, am_dist_size);
+		dataset_data = eig_dataset.data();
 		generateDataset(ssm_perturbations, eig_dataset, distr_n_samples);
 
 		double db_time;
@@ -160,27 +197,38 @@ void NN<AM, SSM >::initialize(const cv::Mat &corners){
 
 		if(params.save_index){ saveDataset(); }
 	}
+	flann_dataset.reset(new flannMatT(dataset_data, params.n_samples, am_dist_size));
 	double idx_time;
 	std::shared_ptr<const DistType> dist_func(am.getDistFunc());
 	mtf_clock_get(idx_start_time);
 	if(flann_params.index_type == IdxType::GNN){
 		gnn_index.reset(new FGNN(dist_func, params.n_samples, am_dist_size,
 			am.isSymmetrical(), &params.gnn));
-		if(params.load_index){
-			gnn_index->loadGraph(saved_idx_path.c_str());
-		} else{
+		if(!params.load_index || !gnn_index->loadGraph(saved_idx_path.c_str(), cache_key)){
 			printf("building GNN graph...\n");
-			if(flann_params.fgnn_index_type != IdxType::GNN){
+			if(flann_params.fgnn_index_type == IdxType::HNSW){
+				printf("Using HNSW index to build the graph...\n");
+				HNSW graph_hnsw_index(dist_func, am_dist_size, &params.hnsw);
+				graph_hnsw_index.buildIndex(dataset_data, params.n_samples);
+				gnn_index->buildGraph(dataset_data, &graph_hnsw_index);
+			} else if(flann_params.fgnn_index_type != IdxType::GNN){
 				printf("Using FLANN %s index to build the graph...\n",
 					FLANNParams::toString(flann_params.fgnn_index_type));
 				flann_index.reset(new FLANN(*flann_dataset, flann_params.getIndexParams(
 					flann_params.fgnn_index_type, params.load_index, saved_idx_path), *dist_func));
 				flann_index->buildIndex();
-				gnn_index->buildGraph(eig_dataset.data(), flann_index.get(), flann_params.search);
+				gnn_index->buildGraph(dataset_data, flann_index.get(), flann_params.search);
 			} else{
-				gnn_index->buildGraph(eig_dataset.data());
+				gnn_index->buildGraph(dataset_data);
 			}
 		}
+	} else if(flann_params.index_type == IdxType::HNSW){
+		hnsw_index.reset(new HNSW(dist_func, am_dist_size, &params.hnsw));
+		if(!params.load_index || !hnsw_index->loadIndex(saved_idx_path.c_str(),
+			dataset_data, params.n_samples, cache_key)){
+			printf("building HNSW index...\n");
+			hnsw_index->buildIndex(dataset_data, params.n_samples);
+		}
 	} else{
 		printf("building FLANN index...\n");
 		flann_index.reset(new FLANN(*flann_dataset, flann_params.getIndexParams(
@@ -193,7 +241,9 @@ void NN<AM, SSM >::initialize(const cv::Mat &corners){
 
 	if(params.save_index){
 		if(flann_params.index_type == IdxType::GNN){
-			gnn_index->saveGraph(saved_idx_path.c_str());
+			gnn_index->saveGraph(saved_idx_path.c_str(), cache_key);
+		} else if(flann_params.index_type == IdxType::HNSW){
+			hnsw_index->saveIndex(saved_idx_path.c_str(), cache_key);
 		} else{
 			printf("Saving FLANN index to: %s\n", saved_idx_path.c_str());
 			flann_index->save(saved_idx_path);
@@ -213,6 +263,7 @@ void NN<AM, SSM >::initialize(const cv::Mat &corners){
 template <class AM, class SSM>
 void NN<AM, SSM >::update(){
 	++frame_id;
+	utils::AllocGuard alloc_guard(frame_id > 1 && !params.add_samples_gap);
 	write_frame_id(frame_id);
 
 	am.setFirstIter();
@@ -226,8 +277,11 @@ void NN<AM, SSM >::update(){
 		record_event("am.updateDistFeat");
 
 		if(flann_params.index_type == IdxType::GNN){
-			gnn_index->searchGraph(am.getDistFeat(), eig_dataset.data(),
+			gnn_index->searchGraph(am.getDistFeat(), dataset_data,
 				&best_idx, &best_dist);
+		} else if(flann_params.index_type == IdxType::HNSW){
+			hnsw_index->searchKNN(am.getDistFeat(), &best_idx, &best_dist);
+			record_event("hnsw_index->searchKNN");
 		} else{
 			flannMatT flann_query(const_cast<double*>(am.getDistFeat()), 1, am_dist_size);
 			flannResultT flann_result(&best_idx, 1, 1);
@@ -280,6 +334,8 @@ void NN<AM, SSM >::update(){
 	if(params.remove_samples){
 		if(flann_params.index_type == IdxType::GNN){
 			throw utils::FunctonNotImplemented("NN :: GNN does not currently support removing points");
+		} else if(flann_params.index_type == IdxType::HNSW){
+			throw utils::FunctonNotImplemented("NN :: HNSW does not currently support removing points");
 		} else{
 			flann_index->removePoint(best_idx);
 		}
@@ -292,9 +348,15 @@ void NN<AM, SSM >::update(){
 			//utils::printMatrix(distr_n_samples_added, "distr_n_samples_added", "%d");
 			//utils::printScalar(eig_dataset_added.rows(), "eig_dataset_added rows", "%d");
 			//utils::printScalar(eig_dataset_added.cols(), "eig_dataset_added cols", "%d");
-			flannMatT flann_dataset_added(const_cast<double*>(eig_dataset_added.data()),
-				eig_dataset_added.rows(), eig_dataset_added.cols());
-			flann_index->addPoints(flann_dataset_added);
+			added_datasets.push_back(eig_dataset_added);
+			MatrixXdr &dataset_added = added_datasets.back();
+			if(flann_params.index_type == IdxType::HNSW){
+				hnsw_index->addPoints(dataset_added.data(), params.n_samples_to_add);
+			} else{
+				flannMatT flann_dataset_added(dataset_added.data(),
+					dataset_added.rows(), dataset_added.cols());
+				flann_index->addPoints(flann_dataset_added);
+			}
 			for(int sample_id = 0; sample_id < params.n_samples_to_add; ++sample_id){
 				ssm_perturbations.push_back(ssm_perturbations_added[sample_id]);
 			}
@@ -303,110 +365,280 @@ void NN<AM, SSM >::update(){
 	ssm.getCorners(cv_corners_mat);
 }
 
+template <class AM, class SSM>
+void NN<AM, SSM >::setImage(const cv::Mat &img){
+	am.setCurrImg(img);
+	for(int worker_id = 1; worker_id < n_workers; ++worker_id){
+		getWorkerAM(worker_id).setCurrImg(img);
+	}
+}
+
 template <class AM, class SSM>
 void NN<AM, SSM >::generateDataset(vector<VectorXd> &perturbations, 
 	MatrixXdr &dataset, const VectorXi &_distr_n_samples){
-	int pause_after_show = 1;
-	int sample_id = 0;
-	for(unsigned int distr_id = 0; distr_id < n_distr; ++distr_id){
-		if(n_distr > 1){
-			//! need to reset SSM sampler only if multiple samplers are in use
-			//! since it was initialized with the first one
-			ssm.setSampler(state_sigma[distr_id], state_mean[distr_id]);
+	//! all workers perturb the current state of the main SSM
+	for(int worker_id = 1; worker_id < n_workers; ++worker_id){
+		getWorkerSSM(worker_id).setCorners(ssm.getCorners());
+	}
+	int n_samples = static_cast<int>(dataset.rows());
+	//! each worker generates a contiguous block of samples using its own AM and SSM
+	task_arena->run(n_workers, [&](int worker_id){
+		int start_id = worker_id*n_samples / n_workers;
+		int end_id = (worker_id + 1)*n_samples / n_workers;
+		generateSamples(getWorkerAM(worker_id), getWorkerSSM(worker_id), inv_state_updates[worker_id],
+			perturbations, dataset, _distr_n_samples, start_id, end_id);
+	});
+	n_generated_samples += n_samples;
+	if(params.show_samples){
+		showSamples(perturbations);
+	}
+}
+
+template <class AM, class SSM>
+void NN<AM, SSM >::generateSamples(AM &worker_am, SSM &worker_ssm, VectorXd &inv_state_update,
+	vector<VectorXd> &perturbations, MatrixXdr &dataset,
+	const VectorXi &_distr_n_samples, int start_id, int end_id){
+	//! find the distribution that generates the first sample in this block
+	unsigned int distr_id = 0;
+	int distr_end_id = _distr_n_samples[0];
+	while(distr_end_id <= start_id && distr_id < n_distr - 1){
+		distr_end_id += _distr_n_samples[++distr_id];
+	}
+	if(n_distr > 1){
+		//! need to reset SSM sampler only if multiple samplers are in use
+		//! since it was initialized with the first one
+		worker_ssm.setSampler(state_sigma[distr_id], state_mean[distr_id]);
+	}
+	for(int sample_id = start_id; sample_id < end_id; ++sample_id){
+		if(sample_id >= distr_end_id && distr_id < n_distr - 1){
+			distr_end_id += _distr_n_samples[++distr_id];
+			worker_ssm.setSampler(state_sigma[distr_id], state_mean[distr_id]);
 		}
-		for(int distr_sample_id = 0; distr_sample_id < _distr_n_samples[distr_id]; ++distr_sample_id){
-			perturbations[sample_id].resize(ssm_state_size);
-			ssm.generatePerturbation(perturbations[sample_id]);
-			//utils::printMatrix(_perturbations[sample_id], "state_update");
-
-			if(params.additive_update){
-				inv_state_update = -perturbations[sample_id];
-				ssm.additiveUpdate(inv_state_update);
-			} else{
-				ssm.invertState(inv_state_update, perturbations[sample_id]);
-				ssm.compositionalUpdate(inv_state_update);
-			}
-			//utils::printMatrix(inv_state_update, "inv_state_update");
+		if(use_sampler_streams){
+			//! unique stream for each sample generated by this tracker
+			worker_ssm.setSamplerStream(sampler_seed, n_generated_samples + sample_id);
+		}
+		perturbations[sample_id].resize(ssm_state_size);
+		worker_ssm.generatePerturbation(perturbations[sample_id]);
+
+		if(params.additive_update){
+			inv_state_update = -perturbations[sample_id];
+			worker_ssm.additiveUpdate(inv_state_update);
+		} else{
+			worker_ssm.invertState(inv_state_update, perturbations[sample_id]);
+			worker_ssm.compositionalUpdate(inv_state_update);
+		}
+		worker_am.updatePixVals(worker_ssm.getPts());
+		worker_am.updateDistFeat(dataset.row(sample_id).data());
 
-			am.updatePixVals(ssm.getPts());
-			am.updateDistFeat(dataset.row(sample_id).data());
+		// reset SSM to previous state
+		if(params.additive_update){
+			worker_ssm.additiveUpdate(perturbations[sample_id]);
+		} else{
+			worker_ssm.compositionalUpdate(perturbations[sample_id]);
+		}
+	}
+}
 
-			if(params.show_samples){
-				cv::Point2d sample_corners[4];
-				ssm.getCorners(sample_corners);
+template <class AM, class SSM>
+void NN<AM, SSM >::showSamples(const vector<VectorXd> &perturbations){
+	VectorXd &inv_state_update = inv_state_updates[0];
+	int pause_after_show = 1;
+	int n_samples = static_cast<int>(perturbations.size());
+	for(int sample_id = 0; sample_id < n_samples && params.show_samples; ++sample_id){
+		if(params.additive_update){
+			inv_state_update = -perturbations[sample_id];
+			ssm.additiveUpdate(inv_state_update);
+		} else{
+			ssm.invertState(inv_state_update, perturbations[sample_id]);
+			ssm.compositionalUpdate(inv_state_update);
+		}
+		cv::Point2d sample_corners[4];
+		ssm.getCorners(sample_corners);
 #ifdef _WIN32
-				utils::drawCorners(curr_img_uchar, sample_corners,
-					cv::Scalar(0, 0, 255), utils::to_string(sample_id + 1));
+		utils::drawCorners(curr_img_uchar, sample_corners,
+			cv::Scalar(0, 0, 255), utils::to_string(sample_id + 1));
 #else
-				utils::drawCorners(curr_img_uchar, sample_corners,
-					cv::Scalar(0, 0, 255), to_string(sample_id + 1));
-#endif
-
-				if((sample_id + 1) % params.show_samples == 0){
-					cv::imshow("Samples", curr_img_uchar);
-					int key = cv::waitKey(1 - pause_after_show);
-					if(key == 27){
-						cv::destroyWindow("Samples");
-						params.show_samples = 0;
-					} else if(key == 32){
-						pause_after_show = 1 - pause_after_show;
-					}
-					am.getCurrImg().convertTo(curr_img_uchar, CV_8UC1);
-				}
-			}
-			// reset SSM to previous state
-			if(params.additive_update){
-				ssm.additiveUpdate(perturbations[sample_id]);
-			} else{
-				ssm.compositionalUpdate(perturbations[sample_id]);
+		utils::drawCorners(curr_img_uchar, sample_corners,
+			cv::Scalar(0, 0, 255), to_string(sample_id + 1));
+#endif
+		if((sample_id + 1) % params.show_samples == 0){
+			cv::imshow("Samples", curr_img_uchar);
+			int key = cv::waitKey(1 - pause_after_show);
+			if(key == 27){
+				cv::destroyWindow("Samples");
+				params.show_samples = 0;
+			} else if(key == 32){
+				pause_after_show = 1 - pause_after_show;
 			}
-			++sample_id;
+			am.getCurrImg().convertTo(curr_img_uchar, CV_8UC1);
+		}
+		if(params.additive_update){
+			ssm.additiveUpdate(perturbations[sample_id]);
+		} else{
+			ssm.compositionalUpdate(perturbations[sample_id]);
 		}
 	}
 }
 
+template <class AM, class SSM>
+void NN<AM, SSM >::fillCacheHeader(NNCacheHeader &header){
+	header = NNCacheHeader();
+	memcpy(header.magic, "MTFNNDB", 8);
+	header.version = 1;
+	header.header_size = sizeof(NNCacheHeader);
+	strncpy(header.am_name, am.name.c_str(), sizeof(header.am_name) - 1);
+	strncpy(header.ssm_name, ssm.name.c_str(), sizeof(header.ssm_name) - 1);
+	header.resx = am.getResX();
+	header.resy = am.getResY();
+	header.n_samples = params.n_samples;
+	header.feat_size = am_dist_size;
+	header.state_size = ssm_state_size;
+	header.n_distr = n_distr;
+	header.additive_update = params.additive_update;
+	const auto &init_pix_vals = am.getInitPixVals();
+	header.init_pix_hash = utils::hashBytes(init_pix_vals.data(),
+		init_pix_vals.size()*sizeof(init_pix_vals.data()[0]));
+
+	uint64_t distr_size = 2 * n_distr*ssm_state_size*sizeof(double);
+	uint64_t dataset_size = static_cast<uint64_t>(params.n_samples)*am_dist_size*sizeof(double);
+	uint64_t perturbations_size = static_cast<uint64_t>(params.n_samples)*ssm_state_size*sizeof(double);
+	header.distr_offset = utils::alignOffset(sizeof(NNCacheHeader));
+	header.dataset_offset = utils::alignOffset(header.distr_offset + distr_size);
+	header.perturbations_offset = utils::alignOffset(header.dataset_offset + dataset_size);
+	header.file_size = header.perturbations_offset + perturbations_size;
+
+	uint64_t key = utils::hashBytes(&header, sizeof(NNCacheHeader));
+	for(unsigned int distr_id = 0; distr_id < n_distr; ++distr_id){
+		key = utils::hashBytes(state_sigma[distr_id].data(), ssm_state_size*sizeof(double), key);
+		key = utils::hashBytes(state_mean[distr_id].data(), ssm_state_size*sizeof(double), key);
+	}
+	key = utils::hashBytes(distr_n_samples.data(), distr_n_samples.size()*sizeof(int), key);
+	header.key = key;
+}
+
+template <class AM, class SSM>
+void NN<AM, SSM >::initializeCache(){
+	NNCacheHeader header;
+	fillCacheHeader(header);
+	cache_key = header.key;
+	//! the key is part of the file names so a cache created for a different patch or sampler is never even opened
+	string fname_template = cv::format("%s_%s_%d_%d_%016llx", am.name.c_str(), ssm.name.c_str(),
+		params.n_samples, am_dist_size, cache_key);
+	saved_db_path = cv::format("%s/%s.db", params.saved_index_dir.c_str(), fname_template.c_str());
+	saved_idx_path = cv::format("%s/%s_%s.idx", params.saved_index_dir.c_str(),
+		fname_template.c_str(), FLANNParams::toString(flann_params.index_type));
+}
+
 template <class AM, class SSM>
 void NN<AM, SSM >::loadDataset(){
-	ifstream in_file(saved_db_path, ios::in | ios::binary);
-	if(in_file.good()){
-		printf("Loading feature dataset from: %s\n", saved_db_path.c_str());
-		mtf_clock_get(db_start_time);
-		in_file.read((char*)(eig_dataset.data()), sizeof(double)*eig_dataset.size());
-		for(int sample_id = 0; sample_id < params.n_samples; ++sample_id){
-			ssm_perturbations[sample_id].resize(ssm_state_size);
-			in_file.read((char*)(ssm_perturbations[sample_id].data()), sizeof(double)*ssm_state_size);
-		}
-		in_file.close();
-		double db_time;
-		mtf_clock_get(db_end_time);
-		mtf_clock_measure(db_start_time, db_end_time, db_time);
-		printf("Time taken: %f secs\n", db_time);
-		dataset_loaded = true;
-		if(!ifstream(saved_idx_path, ios::in | ios::binary).good()){
-			// index file does not exist or is unreadable
-			params.load_index = false;
-		} else{
-			params.save_index = false;
-		}
-	} else{
+	utils::MappedFile in_file;
+	if(!in_file.open(saved_db_path)){
 		printf("Failed to load feature dataset from: %s\n", saved_db_path.c_str());
 		// index must be rebuilt if dataset could not loaded
 		params.load_index = false;
+		return;
+	}
+	printf("Loading feature dataset from: %s\n", saved_db_path.c_str());
+	mtf_clock_get(db_start_time);
+	NNCacheHeader expected;
+	fillCacheHeader(expected);
+	const NNCacheHeader *header = in_file.getData<NNCacheHeader>();
+	const char *error = nullptr;
+	if(in_file.getSize() < sizeof(NNCacheHeader) || memcmp(header->magic, expected.magic, 8) != 0){
+		error = "not a feature dataset file";
+	} else if(header->version != expected.version || header->header_size != expected.header_size){
+		error = "unsupported file version";
+	} else if(strncmp(header->am_name, expected.am_name, sizeof(expected.am_name)) != 0 ||
+		strncmp(header->ssm_name, expected.ssm_name, sizeof(expected.ssm_name)) != 0){
+		error = "created with a different AM or SSM";
+	} else if(header->resx != expected.resx || header->resy != expected.resy){
+		error = "created with a different sampling resolution";
+	} else if(header->n_samples != expected.n_samples || header->feat_size != expected.feat_size ||
+		header->state_size != expected.state_size || header->n_distr != expected.n_distr ||
+		header->additive_update != expected.additive_update){
+		error = "created with different sampling parameters";
+	} else if(header->init_pix_hash != expected.init_pix_hash){
+		error = "created from a different initial patch";
+	} else if(header->distr_offset != expected.distr_offset || header->dataset_offset != expected.dataset_offset ||
+		header->perturbations_offset != expected.perturbations_offset ||
+		header->file_size != expected.file_size || in_file.getSize() != expected.file_size){
+		error = "file is truncated or corrupted";
+	} else{
+		const double *distr_data = in_file.getData<double>(header->distr_offset);
+		for(unsigned int distr_id = 0; distr_id < n_distr && !error; ++distr_id){
+			if(Map<const VectorXd>(distr_data, ssm_state_size) != state_sigma[distr_id] ||
+				Map<const VectorXd>(distr_data + ssm_state_size, ssm_state_size) != state_mean[distr_id]){
+				error = "created with a different sampler sigma or mean";
+			}
+			distr_data += 2 * ssm_state_size;
+		}
+		if(!error && header->key != expected.key){
+			error = "created with different sampler parameters";
+		}
+	}
+	if(error){
+		printf("Rejecting feature dataset in %s: %s\n", saved_db_path.c_str(), error);
+		params.load_index = false;
+		return;
+	}
+	//! the dataset is used in place while the perturbations are small enough to be copied
+	const double *perturbations_data = in_file.getData<double>(header->perturbations_offset);
+	for(int sample_id = 0; sample_id < params.n_samples; ++sample_id){
+		ssm_perturbations[sample_id] = Map<const VectorXd>(perturbations_data + sample_id*ssm_state_size,
+			ssm_state_size);
+	}
+	dataset_data = in_file.getData<double>(header->dataset_offset);
+	dataset_file.swap(in_file);
+	eig_dataset.resize(0, am_dist_size);
+
+	double db_time;
+	mtf_clock_get(db_end_time);
+	mtf_clock_measure(db_start_time, db_end_time, db_time);
+	printf("Time taken: %f secs\n", db_time);
+	dataset_loaded = true;
+	if(!ifstream(saved_idx_path, ios::in | ios::binary).good()){
+		// index file does not exist or is unreadable
+		params.load_index = false;
+	} else{
+		params.save_index = false;
 	}
 }
 
 template <class AM, class SSM>
 void NN<AM, SSM >::saveDataset(){
-	ofstream out_file(saved_db_path, ios::out | ios::binary);
-	if(out_file.good()){
-		printf("Saving dataset to: %s\n", saved_db_path.c_str());
-		out_file.write((char*)(eig_dataset.data()), sizeof(double)*eig_dataset.size());
-		for(int sample_id = 0; sample_id < params.n_samples; ++sample_id){
-			out_file.write((char*)(ssm_perturbations[sample_id].data()), sizeof(double)*ssm_state_size);
-		}
-		out_file.close();
-	} else{
+	NNCacheHeader header;
+	fillCacheHeader(header);
+	//! write to a temporary file first so that an interrupted save never leaves behind a truncated dataset
+	string tmp_path = saved_db_path + ".tmp";
+	ofstream out_file(tmp_path, ios::out | ios::binary);
+	if(!out_file.good()){
+		printf("Failed to save dataset to: %s\n", saved_db_path.c_str());
+		return;
+	}
+	printf("Saving dataset to: %s\n", saved_db_path.c_str());
+	const char padding[64] = {};
+	auto pad_to = [&](uint64_t offset){
+		out_file.write(padding, offset - static_cast<uint64_t>(out_file.tellp()));
+	};
+	out_file.write((char*)(&header), sizeof(NNCacheHeader));
+	pad_to(header.distr_offset);
+	for(unsigned int distr_id = 0; distr_id < n_distr; ++distr_id){
+		out_file.write((char*)(state_sigma[distr_id].data()), sizeof(double)*ssm_state_size);
+		out_file.write((char*)(state_mean[distr_id].data()), sizeof(double)*ssm_state_size);
+	}
+	pad_to(header.dataset_offset);
+	out_file.write((char*)(dataset_data), sizeof(double)*params.n_samples*am_dist_size);
+	pad_to(header.perturbations_offset);
+	for(int sample_id = 0; sample_id < params.n_samples; ++sample_id){
+		out_file.write((char*)(ssm_perturbations[sample_id].data()), sizeof(double)*ssm_state_size);
+	}
+	bool write_successful = out_file.good();
+	out_file.close();
+	remove(saved_db_path.c_str());
+	if(!write_successful || rename(tmp_path.c_str(), saved_db_path.c_str()) != 0){
 		printf("Failed to save dataset to: %s\n", saved_db_path.c_str());
+		remove(tmp_path.c_str());
 	}
 }
 
@@ -15,12 +15,15 @@
 #define NN_LOAD_INDEX 0
 #define NN_SAVE_INDEX 0
 #define NN_INDEX_FILE_TEMPLATE "nn_saved_index"
+#define NN_N_THREADS 1
+#define NN_SAMPLER_STREAMS false
 #define NN_DEBUG_MODE false
 
 _MTF_BEGIN_NAMESPACE
 
 NNParams::NNParams(
 	const gnn::GNNParams *_gnn,
+	const hnsw::HNSWParams *_hnsw,
 	int _n_samples,
 	int _max_iters,
 	double _epsilon,
@@ -35,8 +38,11 @@ NNParams::NNParams(
 	bool _load_index, 
 	bool _save_index, 
 	string _saved_index_dir,
+	int _n_threads,
+	bool _sampler_streams,
 	bool _debug_mode) :
 	gnn(_gnn),
+	hnsw(_hnsw),
 	n_samples(_n_samples),
 	max_iters(_max_iters),
 	epsilon(_epsilon),
@@ -51,6 +57,8 @@ NNParams::NNParams(
 	load_index(_load_index),
 	save_index(_save_index),
 	saved_index_dir(_saved_index_dir),
+	n_threads(_n_threads),
+	sampler_streams(_sampler_streams),
 	debug_mode(_debug_mode){}
 
 NNParams::NNParams(const NNParams *params) :
@@ -65,9 +73,12 @@ remove_samples(NN_REMOVE_SAMPLES),
 load_index(NN_LOAD_INDEX),
 save_index(NN_SAVE_INDEX),
 saved_index_dir(NN_INDEX_FILE_TEMPLATE),
+n_threads(NN_N_THREADS),
+sampler_streams(NN_SAMPLER_STREAMS),
 debug_mode(NN_DEBUG_MODE){
 	if(params){
 		gnn = params->gnn;
+		hnsw = params->hnsw;
 
 		n_samples = params->n_samples;
 
@@ -90,6 +101,9 @@ debug_mode(NN_DEBUG_MODE){
 		save_index = params->save_index;
 		saved_index_dir = params->saved_index_dir;
 
+		n_threads = params->n_threads;
+		sampler_streams = params->sampler_streams;
+
 		debug_mode = params->debug_mode;
 	}
 }
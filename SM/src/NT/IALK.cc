@@ -95,6 +95,7 @@ namespace nt{
 		double leven_marq_delta = params.lm_delta_init;
 		bool state_reset = false;
 
+		am->setFirstIter();
 		for(int iter_id = 0; iter_id < params.max_iters; ++iter_id){
 			init_timer();
 
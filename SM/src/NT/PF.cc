@@ -399,6 +399,12 @@ namespace nt{
 				case ResamplingType::Residual:
 					residualResampling();
 					break;
+				case ResamplingType::Systematic:
+					stratifiedResampling(true);
+					break;
+				case ResamplingType::Stratified:
+					stratifiedResampling(false);
+					break;
 				}
 			}
 			switch(params.mean_type){
@@ -533,6 +539,33 @@ namespace nt{
 		curr_set_id = 1 - curr_set_id;
 	}
 
+	void PF::stratifiedResampling(bool systematic){
+		//! normalize the cumulative weights so that the strata are of size 1/N each
+		particle_cum_wts /= particle_cum_wts[params.n_particles - 1];
+		double strata_size = 1.0 / params.n_particles;
+		double offset = resample_dist(resample_gen);
+		double max_wt = std::numeric_limits<double>::lowest();
+		int resample_id = 0;
+		for(int particle_id = 0; particle_id < params.n_particles; ++particle_id){
+			if(!systematic && particle_id > 0){
+				offset = resample_dist(resample_gen);
+			}
+			//! the points are sorted so the search resumes from the last resampled particle
+			double uniform_rand_num = (particle_id + offset)*strata_size;
+			while(resample_id < params.n_particles - 1 &&
+				particle_cum_wts[resample_id] < uniform_rand_num){
+				++resample_id;
+			}
+			particle_states[1 - curr_set_id][particle_id] = particle_states[curr_set_id][resample_id];
+			particle_ar[1 - curr_set_id][particle_id] = particle_ar[curr_set_id][resample_id];
+			if(particle_wts[resample_id] >= max_wt){
+				max_wt = particle_wts[resample_id];
+				max_wt_id = particle_id;
+			}
+		}
+		curr_set_id = 1 - curr_set_id;
+	}
+
 	void PF::residualResampling() {
 		// normalize the weights
 		particle_wts /= particle_cum_wts[params.n_particles - 1];
@@ -3,11 +3,6 @@
 #include <boost/random/random_device.hpp>
 #include <boost/random/seed_seq.hpp>
 #include "opencv2/highgui/highgui.hpp"
-
-//! OpenMP scheduler
-#ifndef PF_OMP_SCHD
-#define PF_OMP_SCHD auto
-#endif
 
 _MTF_BEGIN_NAMESPACE
 
@@ -15,7 +10,7 @@ template <class AM, class SSM>
 PF<AM, SSM >::PF(const ParamType *pf_params,
 	const AMParams *am_params, const SSMParams *ssm_params) :
 	SearchMethod<AM, SSM>(am_params, ssm_params),
-	params(pf_params), max_wt_id(0),
+	params(pf_params), n_workers(1), max_wt_id(0),
 	enable_adaptive_resampling(false), min_eff_particles(0){
 	printf("\n");
 	printf("Using Particle Filter SM with:\n");
@@ -42,6 +37,7 @@ PF<AM, SSM >::PF(const ParamType *pf_params,
 	printf("measurement_sigma: %f\n", params.measurement_sigma);
 	printf("show_particles: %d\n", params.show_particles);
 	printf("enable_learning: %d\n", params.enable_learning);
+	printf("n_threads: %d\n", params.n_threads);
 	printf("debug_mode: %d\n", params.debug_mode);
 	printf("appearance model: %s\n", am.name.c_str());
 	printf("state space model: %s\n", ssm.name.c_str());
@@ -57,19 +53,22 @@ PF<AM, SSM >::PF(const ParamType *pf_params,
 	measurement_factor = 1.0 / sqrt(2 * pi * params.measurement_sigma);
 
 	for(int set_id = 0; set_id < 2; ++set_id){
-		particle_states[set_id].resize(params.n_particles);
-		particle_ar[set_id].resize(params.n_particles);
+		particle_states[set_id].resize(ssm_state_size, params.n_particles);
+		particle_ar[set_id].resize(ssm_state_size, params.n_particles);
+	}
+	curr_set_id = 0;
+	particle_state.resize(ssm_state_size);
+	particle_wts.resize(params.n_particles);
+	particle_cum_wts.setZero(params.n_particles);
+	resample_ids.resize(params.n_particles);
+	particle_idx.resize(params.n_particles);
+	if(params.mean_type == MeanType::SSM){
+		mean_samples.resize(params.n_particles);
 		for(int particle_id = 0; particle_id < params.n_particles; ++particle_id){
-			particle_states[set_id][particle_id].resize(ssm_state_size);
-			particle_ar[set_id][particle_id].resize(ssm_state_size);
+			mean_samples[particle_id].resize(ssm_state_size);
 		}
 	}
-	curr_set_id = 0;
-	particle_wts.resize(params.n_particles);
-	particle_cum_wts.setZero(params.n_particles);
 
-	perturbed_state.resize(ssm_state_size);
-	perturbed_ar.resize(ssm_state_size);
 	mean_state.resize(ssm_state_size);
 	state_sigma.resize(ssm_state_size);
 	state_mean.resize(ssm_state_size);
@@ -104,6 +103,9 @@ PF<AM, SSM >::PF(const ParamType *pf_params,
 	resample_gen = RandGenT(resample_seed);
 	resample_dist = ResampleDistT(0, 1);
 
+	sampler_seed = (static_cast<unsigned long long>(r()) << 32) | r();
+	use_sampler_streams = params.sampler_streams && ssm.supportsSamplerStreams();
+
 	if(params.adaptive_resampling_thresh > 0 && params.adaptive_resampling_thresh <= 1){
 		printf("Using adaptive resampling\n");
 		enable_adaptive_resampling = true;
@@ -112,19 +114,43 @@ PF<AM, SSM >::PF(const ParamType *pf_params,
 
 	if(params.debug_mode){
 		fclose(fopen(log_fname, "w"));
-		resample_ids.resize(params.n_particles);
 		uniform_rand_nums.resize(params.n_particles);
 	}
 
-#ifdef ENABLE_PARALLEL
-	for(int particle_id = 0; particle_id < params.n_particles; particle_id++){
+	task_arena.reset(new utils::TaskArena(params.n_threads));
+	n_workers = std::max(1, std::min(task_arena->getNThreads(), params.n_particles));
+	if(n_workers > 1){
+		printf(" ******* Parallelization is enabled using %s with %d workers ******* \n",
+			utils::TaskArena::toString(task_arena->getBackend()), n_workers);
+	}
+	for(int worker_id = 1; worker_id < n_workers; ++worker_id){
 		am_vec.push_back(AMPTr(new AM(am_params)));
 		ssm_vec.push_back(SSMPTr(new SSM(ssm_params)));
 	}
-#endif
-#if defined ENABLE_OMP
-printf(" ******* Parallelization is enabled using OpenMP ******* \n");
-#endif
+	if(n_workers > 1 && params.sampler_streams && !use_sampler_streams){
+		printf("SSM %s does not support sampler streams so results will depend on the no. of workers\n",
+			ssm.name.c_str());
+	}
+	perturbed_states.resize(n_workers);
+	perturbed_ars.resize(n_workers);
+	base_states.resize(n_workers);
+	base_ars.resize(n_workers);
+	for(int worker_id = 0; worker_id < n_workers; ++worker_id){
+		perturbed_states[worker_id].resize(ssm_state_size);
+		perturbed_ars[worker_id].resize(ssm_state_size);
+		base_states[worker_id].resize(ssm_state_size);
+		base_ars[worker_id].resize(ssm_state_size);
+	}
+	use_patch_batch = ssm.supportsWarpBatch() && am.supportsPixValsBatch();
+	batch_pts.resize(n_workers);
+	batch_pix_vals.resize(n_workers);
+	if(use_patch_batch){
+		int batch_size = std::min(PF_PATCH_BATCH_SIZE, params.n_particles);
+		for(int worker_id = 0; worker_id < n_workers; ++worker_id){
+			batch_pts[worker_id].resize(Eigen::NoChange, batch_size*ssm.getNPts());
+			batch_pix_vals[worker_id].resize(batch_size, am.getPatchSize());
+		}
+	}
 }
 
 template <class AM, class SSM>
@@ -157,115 +183,62 @@ void PF<AM, SSM >::initialize(const cv::Mat &corners){
 
 	prev_corners = ssm.getCorners();
 	ssm.getCorners(cv_corners_mat);
-#ifdef ENABLE_PARALLEL
-	for(int particle_id = 0; particle_id < params.n_particles; particle_id++){
-		ssm_vec[particle_id]->initialize(corners, am.getNChannels());
-		ssm_vec[particle_id]->initializeSampler(state_sigma, VectorXd::Zero(ssm_state_size));
-		am_vec[particle_id]->initializePixVals(ssm.getPts());
-		am_vec[particle_id]->initializeSimilarity();
+	for(int worker_id = 1; worker_id < n_workers; ++worker_id){
+		SSM &worker_ssm = getWorkerSSM(worker_id);
+		AM &worker_am = getWorkerAM(worker_id);
+		worker_ssm.initialize(corners, am.getNChannels());
+		worker_ssm.initializeSampler(state_sigma, state_mean);
+		worker_am.initializePixVals(ssm.getPts());
+		worker_am.initializeSimilarity();
+	}
+}
+
+template <class AM, class SSM>
+void PF<AM, SSM >::setImage(const cv::Mat &img){
+	am.setCurrImg(img);
+	for(int worker_id = 1; worker_id < n_workers; ++worker_id){
+		getWorkerAM(worker_id).setCurrImg(img);
 	}
-#endif
 }
 
 template <class AM, class SSM>
 void PF<AM, SSM >::initializeParticles(){
 	double init_wt = 1.0 / params.n_particles;
+	particle_states[curr_set_id].colwise() = ssm.getState();
+	particle_ar[curr_set_id].setZero();
 	for(int particle_id = 0; particle_id < params.n_particles; particle_id++){
-		particle_states[curr_set_id][particle_id] = ssm.getState();
 		particle_wts[particle_id] = init_wt;
 		if(particle_id > 0){
 			particle_cum_wts[particle_id] = particle_wts[particle_id] + particle_cum_wts[particle_id - 1];
 		} else{
 			particle_cum_wts[particle_id] = particle_wts[particle_id];
 		}
-		particle_ar[curr_set_id][particle_id].setZero();
 	}
 }
 
 template <class AM, class SSM>
 void PF<AM, SSM >::update(){
 	++frame_id;
+	utils::AllocGuard alloc_guard(frame_id > 1);
 	am.setFirstIter();
+	for(int worker_id = 1; worker_id < n_workers; ++worker_id){
+		getWorkerAM(worker_id).setFirstIter();
+	}
 	int pause_after_show = 1;
 	for(int i = 0; i < params.max_iters; i++){
-		if(params.show_particles){
-			am.getCurrImg().convertTo(curr_img_uchar, CV_8UC1);
-		}
+		//! each worker evaluates a contiguous block of particles using its own AM and SSM
+		task_arena->run(n_workers, [&](int worker_id){
+			int start_id = worker_id*params.n_particles / n_workers;
+			int end_id = (worker_id + 1)*params.n_particles / n_workers;
+			updateParticles(getWorkerAM(worker_id), getWorkerSSM(worker_id), start_id, end_id,
+				perturbed_states[worker_id], perturbed_ars[worker_id],
+				base_states[worker_id], base_ars[worker_id],
+				batch_pts[worker_id], batch_pix_vals[worker_id], i);
+		});
+		//! cumulative weights and the particle with the maximum weight are found serially
+		//! in the same order as the particles so the result does not depend on the no. of workers
 		double max_wt = std::numeric_limits<double>::lowest();
-#ifdef ENABLE_OMP
-#pragma omp parallel for schedule(PF_OMP_SCHD)
-#endif	
 		for(int particle_id = 0; particle_id < params.n_particles; ++particle_id){
-#ifdef ENABLE_PARALLEL
-			SSM &ssm = *ssm_vec[particle_id];
-			AM &am = *am_vec[particle_id];
-#endif
-			switch(params.dynamic_model){
-			case DynamicModel::AutoRegression1:
-				switch(params.update_type){
-				case UpdateType::Additive:
-					ssm.additiveAutoRegression1(perturbed_state, perturbed_ar,
-						particle_states[curr_set_id][particle_id], particle_ar[curr_set_id][particle_id]);
-					break;
-				case UpdateType::Compositional:
-					ssm.compositionalAutoRegression1(perturbed_state, perturbed_ar,
-						particle_states[curr_set_id][particle_id], particle_ar[curr_set_id][particle_id]);
-					break;
-				}
-				particle_ar[curr_set_id][particle_id] = perturbed_ar;
-				break;
-			case DynamicModel::RandomWalk:
-				switch(params.update_type){
-				case UpdateType::Additive:
-					ssm.additiveRandomWalk(perturbed_state, particle_states[curr_set_id][particle_id]);
-					break;
-				case UpdateType::Compositional:
-					ssm.compositionalRandomWalk(perturbed_state, particle_states[curr_set_id][particle_id]);
-					break;
-				}
-				break;
-			}
-			particle_states[curr_set_id][particle_id] = perturbed_state;
-
-			ssm.setState(particle_states[curr_set_id][particle_id]);
-			am.updatePixVals(ssm.getPts());
-			am.updateSimilarity(false);
-
-			// a positive number that measures the dissimilarity between the
-			// template and the patch corresponding to this particle
-			double measuremnt_val = max_similarity - am.getSimilarity();
-
-			// convert this dissimilarity to a likelihood proportional to the dissimilarity
-			switch(params.likelihood_func){
-			case LikelihoodFunc::AM:
-				measurement_likelihood = am.getLikelihood();
-				break;
-			case LikelihoodFunc::Gaussian:
-				measurement_likelihood = measurement_factor * exp(-0.5*measuremnt_val / params.measurement_sigma);
-				break;
-			case LikelihoodFunc::Reciprocal:
-				measurement_likelihood = 1.0 / (1.0 + measuremnt_val);
-				break;
-			}
-			if(params.show_particles){
-				cv::Point2d corners[4];
-				ssm.getCorners(corners);
-				utils::drawCorners(curr_img_uchar, corners,
-					cv::Scalar(0, 0, 255), cv::format("%d: %5.3e", particle_id + 1, measurement_likelihood));
-				//printf("measurement_likelihood: %e\n", measurement_likelihood);
-				if((particle_id + 1) % params.show_particles == 0){
-					cv::imshow("Particles", curr_img_uchar);
-					int key = cv::waitKey(1 - pause_after_show);
-					if(key == 27){
-						cv::destroyWindow("Particles");
-						params.show_particles = 0;
-					} else if(key == 32){
-						pause_after_show = 1 - pause_after_show;
-					}
-					am.getCurrImg().convertTo(curr_img_uchar, CV_8UC1);
-				}
-			}
-			particle_wts[particle_id] = measurement_likelihood;
 			if(particle_id > 0){
 				particle_cum_wts[particle_id] = particle_wts[particle_id] + particle_cum_wts[particle_id - 1];
 			} else{
@@ -276,6 +249,9 @@ void PF<AM, SSM >::update(){
 				max_wt_id = particle_id;
 			}
 		}
+		if(params.show_particles){
+			showParticles(pause_after_show);
+		}
 		if(params.debug_mode){
 			utils::printMatrixToFile(particle_wts.transpose(), "particle_wts", log_fname, "%e");
 			utils::printMatrixToFile(particle_cum_wts.transpose(), "particle_cum_wts", log_fname, "%e");
@@ -302,15 +278,28 @@ void PF<AM, SSM >::update(){
 			case ResamplingType::Residual:
 				residualResampling();
 				break;
+			case ResamplingType::Systematic:
+				stratifiedResampling(true);
+				break;
+			case ResamplingType::Stratified:
+				stratifiedResampling(false);
+				break;
+			}
+			if(params.resampling_type != ResamplingType::None){
+				gatherResampledParticles();
 			}
 		}
 		switch(params.mean_type){
 		case MeanType::None:
 			//! set the SSM state to that of the highest weighted particle
-			ssm.setState(particle_states[curr_set_id][max_wt_id]);
+			particle_state = particle_states[curr_set_id].col(max_wt_id);
+			ssm.setState(particle_state);
 			break;
 		case MeanType::SSM:
-			ssm.estimateMeanOfSamples(mean_state, particle_states[curr_set_id], params.n_particles);
+			for(int particle_id = 0; particle_id < params.n_particles; ++particle_id){
+				mean_samples[particle_id] = particle_states[curr_set_id].col(particle_id);
+			}
+			ssm.estimateMeanOfSamples(mean_state, mean_samples, params.n_particles);
 			ssm.setState(mean_state);
 			break;
 		case MeanType::Corners:
@@ -327,16 +316,133 @@ void PF<AM, SSM >::update(){
 			break;
 		}
 		am.clearFirstIter();
+		for(int worker_id = 1; worker_id < n_workers; ++worker_id){
+			getWorkerAM(worker_id).clearFirstIter();
+		}
 	}
 	if(params.reset_to_mean){
 		initializeParticles();
 	}
 	if(params.enable_learning){
 		am.updateModel(ssm.getPts());
+		for(int worker_id = 1; worker_id < n_workers; ++worker_id){
+			getWorkerAM(worker_id).updateModel(ssm.getPts());
+		}
 	}
 	ssm.getCorners(cv_corners_mat);
 }
 
+template <class AM, class SSM>
+void PF<AM, SSM >::updateParticles(AM &worker_am, SSM &worker_ssm, int start_id, int end_id,
+	VectorXd &perturbed_state, VectorXd &perturbed_ar,
+	VectorXd &base_state, VectorXd &base_ar, Matrix2Xd &pts_batch,
+	MatrixXdr &pix_vals_batch, int iter_id){
+	const int batch_size = use_patch_batch ? static_cast<int>(pix_vals_batch.rows()) : 1;
+	const int n_pts = worker_ssm.getNPts();
+	for(int batch_start_id = start_id; batch_start_id < end_id; batch_start_id += batch_size){
+		const int batch_end_id = std::min(batch_start_id + batch_size, end_id);
+		for(int particle_id = batch_start_id; particle_id < batch_end_id; ++particle_id){
+			//! the SSM interface takes whole vectors so the particle is copied into preallocated buffers
+			base_state = particle_states[curr_set_id].col(particle_id);
+			if(use_sampler_streams){
+				//! unique stream for each particle in each iteration of each frame
+				unsigned long long stream_id = (static_cast<unsigned long long>(frame_id)*params.max_iters
+					+ iter_id)*params.n_particles + particle_id;
+				worker_ssm.setSamplerStream(sampler_seed, stream_id);
+			}
+			switch(params.dynamic_model){
+			case DynamicModel::AutoRegression1:
+				base_ar = particle_ar[curr_set_id].col(particle_id);
+				switch(params.update_type){
+				case UpdateType::Additive:
+					worker_ssm.additiveAutoRegression1(perturbed_state, perturbed_ar,
+						base_state, base_ar);
+					break;
+				case UpdateType::Compositional:
+					worker_ssm.compositionalAutoRegression1(perturbed_state, perturbed_ar,
+						base_state, base_ar);
+					break;
+				}
+				particle_ar[curr_set_id].col(particle_id) = perturbed_ar;
+				break;
+			case DynamicModel::RandomWalk:
+				switch(params.update_type){
+				case UpdateType::Additive:
+					worker_ssm.additiveRandomWalk(perturbed_state, base_state);
+					break;
+				case UpdateType::Compositional:
+					worker_ssm.compositionalRandomWalk(perturbed_state, base_state);
+					break;
+				}
+				break;
+			}
+			particle_states[curr_set_id].col(particle_id) = perturbed_state;
+		}
+		//! the patches for all particles in this batch are warped and sampled in a single pass
+		const int n_batch_particles = batch_end_id - batch_start_id;
+		if(use_patch_batch){
+			worker_ssm.getPtsBatch(pts_batch.leftCols(n_batch_particles*n_pts),
+				particle_states[curr_set_id].middleCols(batch_start_id, n_batch_particles));
+			worker_am.updatePixValsBatch(pix_vals_batch.topRows(n_batch_particles),
+				pts_batch.leftCols(n_batch_particles*n_pts));
+		}
+		for(int particle_id = batch_start_id; particle_id < batch_end_id; ++particle_id){
+			if(use_patch_batch){
+				worker_am.setCurrPixVals(pix_vals_batch.row(particle_id - batch_start_id).transpose());
+			} else{
+				//! batches have a single particle here so perturbed_state is the one just generated
+				worker_ssm.setState(perturbed_state);
+				worker_am.updatePixVals(worker_ssm.getPts());
+			}
+			worker_am.updateSimilarity(false);
+
+			// a positive number that measures the dissimilarity between the
+			// template and the patch corresponding to this particle
+			double measuremnt_val = max_similarity - worker_am.getSimilarity();
+
+			// convert this dissimilarity to a likelihood proportional to the dissimilarity
+			double measurement_likelihood = 0;
+			switch(params.likelihood_func){
+			case LikelihoodFunc::AM:
+				measurement_likelihood = worker_am.getLikelihood();
+				break;
+			case LikelihoodFunc::Gaussian:
+				measurement_likelihood = measurement_factor * exp(-0.5*measuremnt_val / params.measurement_sigma);
+				break;
+			case LikelihoodFunc::Reciprocal:
+				measurement_likelihood = 1.0 / (1.0 + measuremnt_val);
+				break;
+			}
+			particle_wts[particle_id] = measurement_likelihood;
+		}
+	}
+}
+
+template <class AM, class SSM>
+void PF<AM, SSM >::showParticles(int &pause_after_show){
+	am.getCurrImg().convertTo(curr_img_uchar, CV_8UC1);
+	for(int particle_id = 0; particle_id < params.n_particles; ++particle_id){
+		cv::Point2d corners[4];
+		particle_state = particle_states[curr_set_id].col(particle_id);
+		ssm.setState(particle_state);
+		ssm.getCorners(corners);
+		utils::drawCorners(curr_img_uchar, corners,
+			cv::Scalar(0, 0, 255), cv::format("%d: %5.3e", particle_id + 1, particle_wts[particle_id]));
+		if((particle_id + 1) % params.show_particles == 0){
+			cv::imshow("Particles", curr_img_uchar);
+			int key = cv::waitKey(1 - pause_after_show);
+			if(key == 27){
+				cv::destroyWindow("Particles");
+				params.show_particles = 0;
+				break;
+			} else if(key == 32){
+				pause_after_show = 1 - pause_after_show;
+			}
+			am.getCurrImg().convertTo(curr_img_uchar, CV_8UC1);
+		}
+	}
+}
+
 // uses binary search to find the particle with the smallest
 // index whose cumulative weight is greater than the provided
 // random number supposedly drawn from a uniform distribution 
@@ -351,7 +457,6 @@ void PF<AM, SSM >::binaryMultinomialResampling(){
 	if(params.debug_mode){
 		utils::printMatrixToFile(particle_cum_wts.transpose(), "normalized particle_cum_wts", log_fname, "%e");
 	}
-	double max_wt = std::numeric_limits<double>::lowest();
 	for(int particle_id = 0; particle_id < params.n_particles; ++particle_id){
 		double uniform_rand_num = resample_dist(resample_gen);
 		int lower_id = 0, upper_id = params.n_particles - 1;
@@ -371,26 +476,16 @@ void PF<AM, SSM >::binaryMultinomialResampling(){
 			++iter_id;
 		}
 
+		resample_ids[particle_id] = resample_id;
 		if(params.debug_mode){
 			printf("particle_id: %d resample_id: %d\n", particle_id, resample_id);
-			resample_ids[particle_id] = resample_id;
 			uniform_rand_nums[particle_id] = uniform_rand_num;
 		}
-
-		// place the resampled particle states into the other set so as not to overwrite the current one
-		particle_states[1 - curr_set_id][particle_id] = particle_states[curr_set_id][resample_id];
-		particle_ar[1 - curr_set_id][particle_id] = particle_ar[curr_set_id][resample_id];
-		if(particle_wts[resample_id] >= max_wt){
-			max_wt = particle_wts[resample_id];
-			max_wt_id = particle_id;
-		}
 	}
 	if(params.debug_mode){
 		utils::printMatrixToFile(resample_ids.transpose(), "resample_ids", log_fname, "%d");
 		utils::printMatrixToFile(uniform_rand_nums.transpose(), "uniform_rand_nums", log_fname, "%e");
 	}
-	// make the other particle set the current one
-	curr_set_id = 1 - curr_set_id;
 }
 
 template <class AM, class SSM>
@@ -403,37 +498,59 @@ void PF<AM, SSM >::linearMultinomialResampling(){
 	if(params.debug_mode){
 		utils::printMatrix(particle_cum_wts.transpose(), "normalized particle_cum_wts");
 	}
-	double max_wt = std::numeric_limits<double>::lowest();
 	for(int particle_id = 0; particle_id < params.n_particles; ++particle_id){
 		double uniform_rand_num = resample_dist(resample_gen);
 		int resample_id = 0;
-		while(particle_cum_wts[resample_id] < uniform_rand_num){ ++resample_id; }
-
+		while(resample_id < params.n_particles - 1 &&
+			particle_cum_wts[resample_id] < uniform_rand_num){
+			++resample_id;
+		}
+		resample_ids[particle_id] = resample_id;
 		if(params.debug_mode){
 			utils::printScalar(uniform_rand_num, "uniform_rand_num");
 			utils::printScalar(resample_id, "resample_id", "%d");
 		}
+	}
+}
 
-		// place the resampled particle states into the other set so as not to overwrite the current one
-		particle_states[1 - curr_set_id][particle_id] = particle_states[curr_set_id][resample_id];
-		particle_ar[1 - curr_set_id][particle_id] = particle_ar[curr_set_id][resample_id];
-		if(particle_wts[resample_id] >= max_wt){
-			max_wt = particle_wts[resample_id];
-			max_wt_id = particle_id;
+// divides [0, 1] into N strata of equal size and picks the particle whose cumulative weight
+// first exceeds a point drawn from each; since these points are sorted, all of them can be
+// found in a single pass over the normalized cumulative weights
+template <class AM, class SSM>
+void PF<AM, SSM >::stratifiedResampling(bool systematic){
+	particle_cum_wts /= particle_cum_wts[params.n_particles - 1];
+	if(params.debug_mode){
+		utils::printMatrixToFile(particle_cum_wts.transpose(), "normalized particle_cum_wts", log_fname, "%e");
+	}
+	double strata_size = 1.0 / params.n_particles;
+	double offset = resample_dist(resample_gen);
+	int resample_id = 0;
+	for(int particle_id = 0; particle_id < params.n_particles; ++particle_id){
+		if(!systematic && particle_id > 0){
+			offset = resample_dist(resample_gen);
+		}
+		double uniform_rand_num = (particle_id + offset)*strata_size;
+		while(resample_id < params.n_particles - 1 &&
+			particle_cum_wts[resample_id] < uniform_rand_num){
+			++resample_id;
+		}
+		resample_ids[particle_id] = resample_id;
+		if(params.debug_mode){
+			uniform_rand_nums[particle_id] = uniform_rand_num;
 		}
 	}
-	// make the other particle set the current one
-	curr_set_id = 1 - curr_set_id;
+	if(params.debug_mode){
+		utils::printMatrixToFile(resample_ids.transpose(), "resample_ids", log_fname, "%d");
+		utils::printMatrixToFile(uniform_rand_nums.transpose(), "uniform_rand_nums", log_fname, "%e");
+	}
 }
 
-
-
 template <class AM, class SSM>
 void PF<AM, SSM >::residualResampling() {
 	// normalize the weights
 	particle_wts /= particle_cum_wts[params.n_particles - 1];
 	// vector of particle indies
-	VectorXi particle_idx = VectorXi::LinSpaced(params.n_particles, 0, params.n_particles - 1);
+	particle_idx.setLinSpaced(params.n_particles, 0, params.n_particles - 1);
 	if(params.debug_mode){
 		utils::printMatrix(particle_wts.transpose(), "normalized particle_wts");
 		utils::printMatrix(particle_idx.transpose(), "particle_idx", "%d");
@@ -453,8 +570,7 @@ void PF<AM, SSM >::residualResampling() {
 		int resample_id = particle_idx[particle_id];
 		int particle_copies = static_cast<int>(round(particle_wts[resample_id] * params.n_particles));
 		for(int copy_id = 0; copy_id < particle_copies; ++copy_id) {
-			particle_states[1 - curr_set_id][particles_found] = particle_states[curr_set_id][resample_id];
-			particle_ar[1 - curr_set_id][particles_found] = particle_ar[curr_set_id][resample_id];
+			resample_ids[particles_found] = resample_id;
 			if(++particles_found == params.n_particles) { break; }
 		}
 		if(particles_found == params.n_particles) { break; }
@@ -462,11 +578,25 @@ void PF<AM, SSM >::residualResampling() {
 	int resample_id = particle_idx[0];
 	for(int particle_id = particles_found; particle_id < params.n_particles; ++particle_id) {
 		// duplicate particle with highest weight to get exactly same number again
-		particle_states[1 - curr_set_id][particle_id] = particle_states[curr_set_id][resample_id];
-		particle_ar[1 - curr_set_id][particle_id] = particle_ar[curr_set_id][resample_id];
+		resample_ids[particle_id] = resample_id;
 	}
+}
+
+template <class AM, class SSM>
+void PF<AM, SSM >::gatherResampledParticles(){
+	double max_wt = std::numeric_limits<double>::lowest();
+	for(int particle_id = 0; particle_id < params.n_particles; ++particle_id){
+		int resample_id = resample_ids[particle_id];
+		// place the resampled particle states into the other set so as not to overwrite the current one
+		particle_states[1 - curr_set_id].col(particle_id) = particle_states[curr_set_id].col(resample_id);
+		particle_ar[1 - curr_set_id].col(particle_id) = particle_ar[curr_set_id].col(resample_id);
+		if(particle_wts[resample_id] >= max_wt){
+			max_wt = particle_wts[resample_id];
+			max_wt_id = particle_id;
+		}
+	}
+	// make the other particle set the current one
 	curr_set_id = 1 - curr_set_id;
-	max_wt_id = particle_idx[0];
 }
 
 template <class AM, class SSM>
@@ -474,7 +604,8 @@ void PF<AM, SSM >::updateMeanCorners(){
 	mean_corners.setZero();
 	for(int particle_id = 0; particle_id < params.n_particles; ++particle_id) {
 		// compute running average of corners corresponding to the resampled particle states
-		ssm.setState(particle_states[curr_set_id][particle_id]);
+		particle_state = particle_states[curr_set_id].col(particle_id);
+		ssm.setState(particle_state);
 		mean_corners += (ssm.getCorners() - mean_corners) / (particle_id + 1);
 	}
 }
@@ -19,6 +19,8 @@
 #define PF_SHOW_PARTICLES 0
 #define PF_ENABLE_LEARNING 0
 #define PF_JACOBIAN_AS_SIGMA false
+#define PF_N_THREADS 1
+#define PF_SAMPLER_STREAMS false
 #define PF_DEBUG_MODE false
 
 _MTF_BEGIN_NAMESPACE
@@ -33,7 +35,8 @@ PFParams::PFParams(int _max_iters, int _n_particles, double _epsilon,
 	double _adaptive_resampling_thresh,
 	const vectord &_pix_sigma, double _measurement_sigma,
 	int _show_particles, bool _enable_learning,
-	bool _jacobian_as_sigma, bool _debug_mode) :
+	bool _jacobian_as_sigma, int _n_threads, bool _sampler_streams,
+	bool _debug_mode) :
 	max_iters(_max_iters),
 	n_particles(_n_particles),
 	epsilon(_epsilon),
@@ -50,6 +53,8 @@ PFParams::PFParams(int _max_iters, int _n_particles, double _epsilon,
 	show_particles(_show_particles),
 	enable_learning(_enable_learning),
 	jacobian_as_sigma(_jacobian_as_sigma),
+	n_threads(_n_threads),
+	sampler_streams(_sampler_streams),
 	debug_mode(_debug_mode){
 	ssm_sigma = _ssm_sigma;
 	ssm_mean = _ssm_mean;
@@ -73,6 +78,8 @@ measurement_sigma(PF_MEASUREMENT_SIGMA),
 show_particles(PF_SHOW_PARTICLES),
 enable_learning(PF_ENABLE_LEARNING),
 jacobian_as_sigma(PF_JACOBIAN_AS_SIGMA),
+n_threads(PF_N_THREADS),
+sampler_streams(PF_SAMPLER_STREAMS),
 debug_mode(PF_DEBUG_MODE){
 	if(params){
 		max_iters = params->max_iters;
@@ -94,6 +101,8 @@ debug_mode(PF_DEBUG_MODE){
 		enable_learning = params->enable_learning;
 		measurement_sigma = params->measurement_sigma;
 		jacobian_as_sigma = params->jacobian_as_sigma;
+		n_threads = params->n_threads;
+		sampler_streams = params->sampler_streams;
 		debug_mode = params->debug_mode;
 	}
 }
@@ -222,6 +231,10 @@ const char* PFParams::toString(ResamplingType _resampling_type){
 		return "LinearMultinomial";
 	case ResamplingType::Residual:
 		return "Residual";
+	case ResamplingType::Systematic:
+		return "Systematic";
+	case ResamplingType::Stratified:
+		return "Stratified";
 	default:
 		throw utils::InvalidArgument("Invalid resampling type provided");
 	}
@@ -1,8 +1,6 @@
 #include "mtf/SM/ParallelSM.h"
-#ifdef ENABLE_TBB
-#include "tbb/tbb.h" 
-#endif
 #include "mtf/Utilities/miscUtils.h"
+#include "mtf/Utilities/parallelUtils.h"
 
 _MTF_BEGIN_NAMESPACE
 
@@ -23,6 +21,9 @@ ParallelSM<AM, SSM>::ParallelSM(const vector<SM*> _trackers,
 	printf("auto_reinit: %d\n", params.auto_reinit);
 	printf("reinit_err_thresh: %f\n", params.reinit_err_thresh);
 	printf("reinit_frame_gap: %d\n", params.reinit_frame_gap);
+	printf("n_threads: %d\n", params.n_threads);
+	printf("pin_threads: %d\n", params.pin_threads);
+	printf("reinit_share_frames: %d\n", params.reinit_share_frames);
 
 	printf("n_trackers: %d\n", n_trackers);
 	printf("Search methods: ");
@@ -61,6 +62,8 @@ ParallelSM<AM, SSM>::ParallelSM(const vector<SM*> _trackers,
 			corners_buffer.resize(params.reinit_frame_gap);
 		}
 	}
+	task_arena.reset(new utils::TaskArena(params.n_threads > 0 ? params.n_threads : n_trackers,
+		params.pin_threads));
 }
 template<class AM, class SSM>
 void ParallelSM<AM, SSM>::setImage(const cv::Mat &img){
@@ -74,115 +77,130 @@ void ParallelSM<AM, SSM>::setImage(const cv::Mat &img){
 }
 template<class AM, class SSM>
 void ParallelSM<AM, SSM>::initialize(const cv::Mat &corners)  {
-	for(int tracker_id = 0; tracker_id < n_trackers; ++tracker_id) {
+	runTrackers([&](int tracker_id){
 		trackers[tracker_id]->initialize(corners);
-	}
+	});
 	ssm.initialize(corners);
 	ssm.getCorners(cv_corners_mat);
 	if(params.auto_reinit){
-		curr_img.copyTo(img_buffer[buffer_id]);
-		corners.copyTo(corners_buffer[buffer_id]);
-		if(buffer_id == params.reinit_frame_gap - 1){
-			buffer_filled = true;
-		}
-		buffer_id = (buffer_id + 1) % params.reinit_frame_gap;
+		bufferFrame(corners);
 	}
 }
 template<class AM, class SSM>
 void ParallelSM<AM, SSM>::update()  {
-	mean_corners_cv.setTo(cv::Scalar(0));
-#ifdef ENABLE_TBB
-	parallel_for(tbb::blocked_range<size_t>(0, n_trackers),
-		[&](const tbb::blocked_range<size_t>& r) {
-		for(size_t tracker_id = r.begin(); tracker_id != r.end(); ++tracker_id) {
-#else
-	for(int tracker_id = 0; tracker_id < n_trackers; ++tracker_id) {
-#endif
+	runTrackers([&](int tracker_id){
 		trackers[tracker_id]->update();
-		switch(params.estimation_method) {
-		case PrlEstMethod::MeanOfCorners:
-			mean_corners_cv += (trackers[tracker_id]->getRegion() - mean_corners_cv) / (tracker_id + 1);
-			break;
-		case PrlEstMethod::MeanOfState:
+		if(params.estimation_method == PrlEstMethod::MeanOfState){
+			// each tracker only writes to its own slot
 			ssm_states[tracker_id] = trackers[tracker_id]->getSSM().getState();
-			break;
 		}
-	}
-#ifdef ENABLE_TBB
-		});
-#endif
-		switch(params.estimation_method) {
-		case PrlEstMethod::MeanOfCorners:
-			ssm.setCorners(mean_corners_cv);
-			break;
-		case PrlEstMethod::MeanOfState:
-			ssm.estimateMeanOfSamples(mean_state, ssm_states, n_trackers);
-			ssm.setState(mean_state);
-			ssm.getCorners(mean_corners_cv);
-			break;
+	});
+	// combine the results only after all search methods have finished and in a fixed order
+	// so that the estimate does not depend on the order in which they finish
+	switch(params.estimation_method) {
+	case PrlEstMethod::MeanOfCorners:
+		mean_corners_cv.setTo(cv::Scalar(0));
+		for(int tracker_id = 0; tracker_id < n_trackers; ++tracker_id) {
+			mean_corners_cv += trackers[tracker_id]->getRegion();
 		}
-		if(params.auto_reinit){
-			if(failure_detected){
-				failure_detected = false;
-			} else{
-				ssm.getCorners(cv_corners_mat);
-				for(int tracker_id = 0; tracker_id < n_trackers; ++tracker_id) {
-					double corner_error = utils::getTrackingError<utils::TrackErrT::MCD>(
-						trackers[tracker_id]->getRegion(), cv_corners_mat);
-					if(corner_error > params.reinit_err_thresh){
-						failure_detected = true;
-						break;
-					}
-				}
-				if(failure_detected){
-					printf("Reinitializing trackers...\n");
-					int reinit_buffer_id = buffer_filled ? buffer_id : 0;
-					for(int tracker_id = 0; tracker_id < n_trackers; ++tracker_id) {
-						// initialize tracker on the oldest image in the buffer;
-						trackers[tracker_id]->initialize(img_buffer[reinit_buffer_id],
-							corners_buffer[reinit_buffer_id]);
-						// update tracker on the remaining images in the buffer;
-						int current_buffer_id = (reinit_buffer_id + 1) % params.reinit_frame_gap;
-						while(current_buffer_id != buffer_id){
-							trackers[tracker_id]->update(img_buffer[current_buffer_id]);
-							current_buffer_id = (current_buffer_id + 1) % params.reinit_frame_gap;
-						}
-						// restore the current image
-						trackers[tracker_id]->setImage(curr_img);
-					}
-					update();
-					return;
+		mean_corners_cv /= n_trackers;
+		ssm.setCorners(mean_corners_cv);
+		break;
+	case PrlEstMethod::MeanOfState:
+		ssm.estimateMeanOfSamples(mean_state, ssm_states, n_trackers);
+		ssm.setState(mean_state);
+		ssm.getCorners(mean_corners_cv);
+		break;
+	}
+	if(params.auto_reinit){
+		if(failure_detected){
+			failure_detected = false;
+		} else{
+			ssm.getCorners(cv_corners_mat);
+			for(int tracker_id = 0; tracker_id < n_trackers; ++tracker_id) {
+				double corner_error = utils::getTrackingError<utils::TrackErrT::MCD>(
+					trackers[tracker_id]->getRegion(), cv_corners_mat);
+				if(corner_error > params.reinit_err_thresh){
+					failure_detected = true;
+					break;
 				}
 			}
-		}
-		if(params.reset_to_mean) {
-			for(int tracker_id = 0; tracker_id < n_trackers; ++tracker_id) {
-				trackers[tracker_id]->setRegion(mean_corners_cv);
+			if(failure_detected){
+				printf("Reinitializing trackers...\n");
+				reinitTrackers();
+				update();
+				return;
 			}
 		}
-		ssm.getCorners(cv_corners_mat);
-		if(params.auto_reinit){
-			curr_img.copyTo(img_buffer[buffer_id]);
-			cv_corners_mat.copyTo(corners_buffer[buffer_id]);
-			if(buffer_id == params.reinit_frame_gap - 1){
-				buffer_filled = true;
-			}
-			buffer_id = (buffer_id + 1) % params.reinit_frame_gap;
+	}
+	if(params.reset_to_mean) {
+		for(int tracker_id = 0; tracker_id < n_trackers; ++tracker_id) {
+			trackers[tracker_id]->setRegion(mean_corners_cv);
 		}
+	}
+	ssm.getCorners(cv_corners_mat);
+	if(params.auto_reinit){
+		bufferFrame(cv_corners_mat);
+	}
 }
 
 template<class AM, class SSM>
 void ParallelSM<AM, SSM>::setRegion(const cv::Mat& corners)   {
-	for(int tracker_id = 1; tracker_id < n_trackers; ++tracker_id) {
+	for(int tracker_id = 0; tracker_id < n_trackers; ++tracker_id) {
 		trackers[tracker_id]->setRegion(corners);
 	}
 	ssm.setCorners(corners);
+	ssm.getCorners(cv_corners_mat);
+	if(params.auto_reinit){
+		// the buffer entry for the current frame has already been filled by the last update
+		corners.copyTo(corners_buffer[(buffer_id + params.reinit_frame_gap - 1) % params.reinit_frame_gap]);
+	}
+}
+
+template<class AM, class SSM>
+template<typename FuncT>
+void ParallelSM<AM, SSM>::runTrackers(const FuncT &func){
+	task_arena->run(n_trackers, func);
+}
+
+template<class AM, class SSM>
+void ParallelSM<AM, SSM>::reinitTrackers(){
+	int reinit_buffer_id = buffer_filled ? buffer_id : 0;
+	// search methods only read from the buffer so all of them can be reinitialized concurrently
+	runTrackers([&](int tracker_id){
+		// initialize tracker on the oldest image in the buffer;
+		trackers[tracker_id]->initialize(img_buffer[reinit_buffer_id],
+			corners_buffer[reinit_buffer_id]);
+		// update tracker on the remaining images in the buffer;
+		int current_buffer_id = (reinit_buffer_id + 1) % params.reinit_frame_gap;
+		while(current_buffer_id != buffer_id){
+			trackers[tracker_id]->update(img_buffer[current_buffer_id]);
+			current_buffer_id = (current_buffer_id + 1) % params.reinit_frame_gap;
+		}
+		// restore the current image
+		trackers[tracker_id]->setImage(curr_img);
+	});
+}
+
+template<class AM, class SSM>
+void ParallelSM<AM, SSM>::bufferFrame(const cv::Mat &corners){
+	if(params.reinit_share_frames){
+		// only the header is copied and the pixel data is shared with the input frame
+		img_buffer[buffer_id] = curr_img;
+	} else{
+		// reuses the memory already allocated for this slot once the buffer has been filled
+		curr_img.copyTo(img_buffer[buffer_id]);
+	}
 	corners.copyTo(corners_buffer[buffer_id]);
+	if(buffer_id == params.reinit_frame_gap - 1){
+		buffer_filled = true;
+	}
+	buffer_id = (buffer_id + 1) % params.reinit_frame_gap;
 }
 
 _MTF_END_NAMESPACE
 
 #ifndef HEADER_ONLY_MODE
-#include "mtf/Macros/register.h"
-_REGISTER_TRACKERS(ParallelSM);
+#include "mtf/Macros/register.h"
+_REGISTER_TRACKERS(ParallelSM);
 #endif
\ No newline at end of file
@@ -1,9 +1,6 @@
 #include "mtf/SM/ParallelTracker.h"
 #include "mtf/Utilities/miscUtils.h"
-
-#ifdef ENABLE_TBB
-#include "tbb/tbb.h" 
-#endif
+#include "mtf/Utilities/parallelUtils.h"
 
 _MTF_BEGIN_NAMESPACE
 
@@ -17,6 +14,9 @@ ParallelTracker::ParallelTracker(const vector<TrackerBase*> _trackers,
 	printf("auto_reinit: %d\n", params.auto_reinit);
 	printf("reinit_err_thresh: %f\n", params.reinit_err_thresh);
 	printf("reinit_frame_gap: %d\n", params.reinit_frame_gap);
+	printf("n_threads: %d\n", params.n_threads);
+	printf("pin_threads: %d\n", params.pin_threads);
+	printf("reinit_share_frames: %d\n", params.reinit_share_frames);
 	printf("n_trackers: %d\n", n_trackers);
 	printf("trackers: ");
 	name = "prl: ";
@@ -36,6 +36,8 @@ ParallelTracker::ParallelTracker(const vector<TrackerBase*> _trackers,
 			corners_buffer.resize(params.reinit_frame_gap);
 		}
 	}
+	task_arena.reset(new utils::TaskArena(params.n_threads > 0 ? params.n_threads : n_trackers,
+		params.pin_threads));
 }
 
 void ParallelTracker::setImage(const cv::Mat &img){
@@ -49,92 +51,106 @@ void ParallelTracker::setImage(const cv::Mat &img){
 }
 
 void ParallelTracker::initialize(const cv::Mat &corners)  {
-	for(int tracker_id = 0; tracker_id < n_trackers; tracker_id++) {
+	runTrackers([&](int tracker_id){
 		trackers[tracker_id]->initialize(corners);
-	}
+	});
 	cv_corners_mat = corners;
 	if(params.auto_reinit){
-		curr_img.copyTo(img_buffer[buffer_id]);
-		corners.copyTo(corners_buffer[buffer_id]);
-		if(buffer_id == params.reinit_frame_gap - 1){
-			buffer_filled = true;
-		}
-		buffer_id = (buffer_id + 1) % params.reinit_frame_gap;
+		bufferFrame(corners);
 	}
 }
 
 void ParallelTracker::update()  {
+	runTrackers([&](int tracker_id){
+		trackers[tracker_id]->update();
+	});
+	// the mean is computed only after all trackers have finished and always in the same order
+	// so that it is free of races and does not depend on the order in which they finish
 	mean_corners_cv.setTo(cv::Scalar(0));
-#ifdef ENABLE_TBB
-	parallel_for(tbb::blocked_range<size_t>(0, n_trackers),
-		[&](const tbb::blocked_range<size_t>& r) {
-		for(size_t tracker_id = r.begin(); tracker_id != r.end(); ++tracker_id) {
-#else
 	for(int tracker_id = 0; tracker_id < n_trackers; ++tracker_id) {
-#endif
-		trackers[tracker_id]->update();
-		mean_corners_cv += (trackers[tracker_id]->getRegion() - mean_corners_cv) / (tracker_id + 1);
+		mean_corners_cv += trackers[tracker_id]->getRegion();
 	}
-#ifdef ENABLE_TBB
-		});
-#endif
-		if(params.auto_reinit){
-			if(failure_detected){
-				failure_detected = false;
-			} else{
-				for(int tracker_id = 0; tracker_id < n_trackers; ++tracker_id) {
-					double corner_error = utils::getTrackingError<utils::TrackErrT::MCD>(
-						trackers[tracker_id]->getRegion(), mean_corners_cv);
-					if(corner_error > params.reinit_err_thresh){
-						failure_detected = true;
-						break;
-					}
-				}
-				if(failure_detected){
-					printf("Reinitializing trackers...\n");
+	mean_corners_cv /= n_trackers;
 
-					int reinit_buffer_id = buffer_filled ? buffer_id  : 0;
-					for(int tracker_id = 0; tracker_id < n_trackers; ++tracker_id) {
-						// initialize tracker on the oldest image in the buffer;
-						trackers[tracker_id]->setImage(img_buffer[reinit_buffer_id]);
-						trackers[tracker_id]->initialize(corners_buffer[reinit_buffer_id]);
-
-						// update tracker on the remaining images in the buffer;
-						int current_buffer_id = (reinit_buffer_id + 1) % params.reinit_frame_gap;
-						while(current_buffer_id != buffer_id){
-							trackers[tracker_id]->setImage(img_buffer[current_buffer_id]);
-							trackers[tracker_id]->update();
-							current_buffer_id = (current_buffer_id + 1) % params.reinit_frame_gap;
-						}
-						// restore the current image
-						trackers[tracker_id]->setImage(curr_img);
-					}
-					update();
-					return;
+	if(params.auto_reinit){
+		if(failure_detected){
+			failure_detected = false;
+		} else{
+			for(int tracker_id = 0; tracker_id < n_trackers; ++tracker_id) {
+				double corner_error = utils::getTrackingError<utils::TrackErrT::MCD>(
+					trackers[tracker_id]->getRegion(), mean_corners_cv);
+				if(corner_error > params.reinit_err_thresh){
+					failure_detected = true;
+					break;
 				}
 			}
-		}
-
-		if(params.reset_to_mean) {
-			for(int tracker_id = 0; tracker_id < n_trackers; tracker_id++) {
-				trackers[tracker_id]->setRegion(mean_corners_cv);
+			if(failure_detected){
+				printf("Reinitializing trackers...\n");
+				reinitTrackers();
+				update();
+				return;
 			}
 		}
-		if(params.auto_reinit){
-			curr_img.copyTo(img_buffer[buffer_id]);
-			mean_corners_cv.copyTo(corners_buffer[buffer_id]);
-			if(buffer_id == params.reinit_frame_gap - 1){
-				buffer_filled = true;
-			}
-			buffer_id = (buffer_id + 1) % params.reinit_frame_gap;
+	}
+
+	if(params.reset_to_mean) {
+		for(int tracker_id = 0; tracker_id < n_trackers; tracker_id++) {
+			trackers[tracker_id]->setRegion(mean_corners_cv);
 		}
+	}
+	if(params.auto_reinit){
+		bufferFrame(mean_corners_cv);
+	}
 }
 void ParallelTracker::setRegion(const cv::Mat& corners)   {
-	for(int tracker_id = 1; tracker_id < n_trackers; tracker_id++) {
+	for(int tracker_id = 0; tracker_id < n_trackers; tracker_id++) {
 		trackers[tracker_id]->setRegion(corners);
 	}
 	corners.copyTo(mean_corners_cv);
+	if(params.auto_reinit){
+		// the buffer entry for the current frame has already been filled by the last update
+		corners.copyTo(corners_buffer[(buffer_id + params.reinit_frame_gap - 1) % params.reinit_frame_gap]);
+	}
+}
+
+template<typename FuncT>
+void ParallelTracker::runTrackers(const FuncT &func){
+	task_arena->run(n_trackers, func);
+}
+
+void ParallelTracker::reinitTrackers(){
+	int reinit_buffer_id = buffer_filled ? buffer_id : 0;
+	// trackers only read from the buffer so all of them can be reinitialized concurrently
+	runTrackers([&](int tracker_id){
+		// initialize tracker on the oldest image in the buffer;
+		trackers[tracker_id]->setImage(img_buffer[reinit_buffer_id]);
+		trackers[tracker_id]->initialize(corners_buffer[reinit_buffer_id]);
+
+		// update tracker on the remaining images in the buffer;
+		int current_buffer_id = (reinit_buffer_id + 1) % params.reinit_frame_gap;
+		while(current_buffer_id != buffer_id){
+			trackers[tracker_id]->setImage(img_buffer[current_buffer_id]);
+			trackers[tracker_id]->update();
+			current_buffer_id = (current_buffer_id + 1) % params.reinit_frame_gap;
+		}
+		// restore the current image
+		trackers[tracker_id]->setImage(curr_img);
+	});
+}
+
+void ParallelTracker::bufferFrame(const cv::Mat &corners){
+	if(params.reinit_share_frames){
+		// only the header is copied and the pixel data is shared with the input frame
+		img_buffer[buffer_id] = curr_img;
+	} else{
+		// reuses the memory already allocated for this slot once the buffer has been filled
+		curr_img.copyTo(img_buffer[buffer_id]);
+	}
 	corners.copyTo(corners_buffer[buffer_id]);
+	if(buffer_id == params.reinit_frame_gap - 1){
+		buffer_filled = true;
+	}
+	buffer_id = (buffer_id + 1) % params.reinit_frame_gap;
 }
 
 _MTF_END_NAMESPACE
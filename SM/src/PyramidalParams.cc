@@ -3,10 +3,11 @@
 _MTF_BEGIN_NAMESPACE
 
 PyramidalParams::PyramidalParams(int _no_of_levels, double _scale_factor,
-bool _show_levels) {
+bool _show_levels, const std::shared_ptr<utils::ImagePyramidCache> &_img_pyr_cache) {
 	no_of_levels = _no_of_levels;
 	scale_factor = _scale_factor;
 	show_levels = _show_levels;
+	img_pyr_cache = _img_pyr_cache;
 }
 
 PyramidalParams::PyramidalParams(const PyramidalParams *params) :
@@ -16,6 +17,7 @@ scale_factor(PYRL_SCALE_FACTOR){
 		no_of_levels = params->no_of_levels;
 		scale_factor = params->scale_factor;
 		show_levels = params->show_levels;
+		img_pyr_cache = params->img_pyr_cache;
 	}
 }
 _MTF_END_NAMESPACE
@@ -1,5 +1,6 @@
 #include "mtf/SM/PyramidalSM.h"
 #include "mtf/Utilities/miscUtils.h"
+#include "mtf/Utilities/pyramidUtils.h"
 #include "opencv2/imgproc/imgproc.hpp"
 #include "opencv2/highgui/highgui.hpp"
 
@@ -34,6 +35,10 @@ PyramidalSM<AM,SSM>::PyramidalSM(const vector<SM*> &_trackers,
 	printf("\n");
 	img_pyramid.resize(params.no_of_levels);
 	img_sizes.resize(params.no_of_levels);
+	if(params.img_pyr_cache){
+		printf("Using shared image pyramid cache\n");
+		cached_pyramid.resize(params.no_of_levels);
+	}
 	overall_scale_factor = pow(params.scale_factor, params.no_of_levels - 1);
 }
 template<class AM, class SSM>
@@ -46,8 +51,15 @@ void PyramidalSM<AM,SSM>::setImage(const cv::Mat &img){
 
 	img_pyramid[0] = img;
 	trackers[0]->setImage(img_pyramid[0]);
+	if(params.img_pyr_cache){
+		params.img_pyr_cache->getPyramid(cached_pyramid, img, params.scale_factor);
+	}
 	for(int pyr_level = 1; pyr_level < params.no_of_levels; ++pyr_level){
-		if(img_pyramid[pyr_level].empty()){
+		if(params.img_pyr_cache){
+			// levels are owned by the cache and shared with all other trackers that use the same pyramid
+			img_pyramid[pyr_level] = cached_pyramid[pyr_level];
+			img_sizes[pyr_level] = cv::Size(img_pyramid[pyr_level].cols, img_pyramid[pyr_level].rows);
+		} else if(img_pyramid[pyr_level].empty()){
 			int n_rows = static_cast<int>(img_pyramid[pyr_level - 1].rows*params.scale_factor);
 			int n_cols = static_cast<int>(img_pyramid[pyr_level - 1].cols*params.scale_factor);
 			img_sizes[pyr_level] = cv::Size(n_cols, n_rows);
@@ -79,14 +91,19 @@ void PyramidalSM<AM,SSM>::setImagePyramid(const vector<cv::Mat> &_img_pyramid){
 
 template<class AM, class SSM>
 void PyramidalSM<AM,SSM>::updateImagePyramid(){
-	for(int pyr_level = 1; pyr_level < params.no_of_levels; ++pyr_level){
-		if(params.scale_factor == 0.5){
-			cv::pyrDown(img_pyramid[pyr_level - 1], img_pyramid[pyr_level], img_sizes[pyr_level]);
-		} else{
-			cv::resize(img_pyramid[pyr_level - 1], img_pyramid[pyr_level], img_sizes[pyr_level]);
-			cv::GaussianBlur(img_pyramid[pyr_level], img_pyramid[pyr_level], cv::Size(5, 5), 3);
-		}		
+	if(params.img_pyr_cache){
+		params.img_pyr_cache->getPyramid(cached_pyramid, img_pyramid[0], params.scale_factor);
+		for(int pyr_level = 1; pyr_level < params.no_of_levels; ++pyr_level){
+			// the buffers only change if the cache had to reallocate or discard this pyramid
+			if(cached_pyramid[pyr_level].data != img_pyramid[pyr_level].data){
+				img_pyramid[pyr_level] = cached_pyramid[pyr_level];
+				img_sizes[pyr_level] = cv::Size(img_pyramid[pyr_level].cols, img_pyramid[pyr_level].rows);
+				trackers[pyr_level]->setImage(img_pyramid[pyr_level]);
+			}
+		}
+		return;
 	}
+	utils::buildImagePyramid(img_pyramid, params.scale_factor);
 }
 template<class AM, class SSM> 
 void PyramidalSM<AM,SSM>::initialize(const cv::Mat &corners)  {
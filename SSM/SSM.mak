@@ -69,8 +69,8 @@ ${BUILD_DIR}/IST.o: ${SSM_SRC_DIR}/IST.cc ${SSM_HEADER_DIR}/IST.h ${SSM_HEADER_D
 ${BUILD_DIR}/Translation.o: ${SSM_SRC_DIR}/Translation.cc ${SSM_HEADER_DIR}/Translation.h ${SSM_HEADER_DIR}/ProjectiveBase.h ${SSM_BASE_HEADERS} ${UTILITIES_HEADER_DIR}/warpUtils.h ${UTILITIES_HEADER_DIR}/miscUtils.h ${MACROS_HEADER_DIR}/common.h
 	${CXX} -c ${MTF_PIC_FLAG} ${WARNING_FLAGS} ${OPT_FLAGS} ${PROF_FLAGS} ${MTF_COMPILETIME_FLAGS} ${MTF_INCLUDE_FLAGS} ${TRANS_FLAGS} $< -o $@
 	
-${BUILD_DIR}/SSMEstimator.o: ${SSM_SRC_DIR}/SSMEstimator.cc ${SSM_HEADER_DIR}/SSMEstimator.h ${SSM_HEADER_DIR}/SSMEstimatorParams.h ${MACROS_HEADER_DIR}/common.h ${UTILITIES_HEADER_DIR}/warpUtils.h
-	${CXX} -c ${MTF_PIC_FLAG} ${WARNING_FLAGS} ${OPT_FLAGS} ${PROF_FLAGS} ${MTF_COMPILETIME_FLAGS} ${MTF_INCLUDE_FLAGS} $< -o $@
+${BUILD_DIR}/SSMEstimator.o: ${SSM_SRC_DIR}/SSMEstimator.cc ${SSM_HEADER_DIR}/SSMEstimator.h ${SSM_HEADER_DIR}/SSMEstimatorParams.h ${MACROS_HEADER_DIR}/common.h ${UTILITIES_HEADER_DIR}/warpUtils.h ${UTILITIES_HEADER_DIR}/parallelUtils.h
+	${CXX} -c ${MTF_PIC_FLAG} ${WARNING_FLAGS} ${OPT_FLAGS} ${PROF_FLAGS} ${MTF_COMPILETIME_FLAGS} ${MTF_INCLUDE_FLAGS} ${PRL_FLAGS} $< -o $@
 	
 ${BUILD_DIR}/HomographyEstimator.o: ${SSM_SRC_DIR}/HomographyEstimator.cc ${SSM_HEADER_DIR}/HomographyEstimator.h ${SSM_HEADER_DIR}/SSMEstimator.h  ${SSM_HEADER_DIR}/SSMEstimatorParams.h ${MACROS_HEADER_DIR}/common.h ${UTILITIES_HEADER_DIR}/miscUtils.h
 	${CXX} -c ${MTF_PIC_FLAG} ${WARNING_FLAGS} ${OPT_FLAGS} ${PROF_FLAGS} ${MTF_COMPILETIME_FLAGS} ${MTF_INCLUDE_FLAGS} $< -o $@
@@ -80,7 +80,7 @@ public:
 
 	void generatePerturbation(VectorXd &perturbation) override;
 
-	void getWarpFromState(Matrix3d &warp_mat, const VectorXd& ssm_state) override;
+	void getWarpFromState(Matrix3d &warp_mat, const Ref<const VectorXd> &ssm_state) const override;
 	void getStateFromWarp(VectorXd &state_vec, const Matrix3d& warp_mat) override;
 
 #ifndef DISABLE_SPI
@@ -74,7 +74,7 @@ public:
 	void applyWarpToPts(Matrix2Xd &warped_pts, const Matrix2Xd &orig_pts,
 		const VectorXd &state_update) override;
 
-	void getWarpFromState(Matrix3d &warp_mat, const VectorXd& ssm_state) override;
+	void getWarpFromState(Matrix3d &warp_mat, const Ref<const VectorXd> &ssm_state) const override;
 	void getStateFromWarp(VectorXd &state_vec, const Matrix3d& warp_mat) override;
 
 #ifndef DISABLE_SPI
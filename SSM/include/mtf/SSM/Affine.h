@@ -39,6 +39,9 @@ public:
 		const PixGradT &pix_jacobian) override;
 	void cmptWarpedPixJacobian(MatrixXd &jacobian_prod,
 		const PixGradT &pix_jacobian) override;
+	void cmptWarpedPixJacobianBlock(MatrixXd &jacobian_prod,
+		const PixGradT &pix_jacobian, unsigned int start_id,
+		unsigned int n_block) override;
 
 	void cmptInitPixHessian(MatrixXd &pix_hess_ssm, const PixHessT &pix_hess_coord,
 		const PixGradT &pix_grad) override;
@@ -68,7 +71,7 @@ public:
 	void applyWarpToPts(Matrix2Xd &warped_pts, const Matrix2Xd &orig_pts,
 		const VectorXd &state_update) override;
 
-	void getWarpFromState(Matrix3d &warp_mat, const VectorXd& ssm_state) override;
+	void getWarpFromState(Matrix3d &warp_mat, const Ref<const VectorXd> &ssm_state) const override;
 	void getStateFromWarp(VectorXd &state_vec, const Matrix3d& warp_mat) override;
 
 	void generatePerturbation(VectorXd &perturbation) override;
@@ -79,6 +82,7 @@ public:
 	void additiveAutoRegression1(VectorXd &perturbed_state, VectorXd &perturbed_ar,
 		const VectorXd &base_state, const VectorXd &base_ar, double a = 0.5) override;
 
+	bool supportsPixJacobianBlocks() override{ return true; }
 #ifndef DISABLE_SPI
 	bool supportsSPI() override{ return true; }
 #endif
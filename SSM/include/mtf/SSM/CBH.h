@@ -49,7 +49,7 @@ public:
 		getPixGrad(ssm_grad, pt_id, curr_pts, curr_corners);
 	}
 
-	void getWarpFromState(Matrix3d &warp_mat, const VectorXd& ssm_state) override;
+	void getWarpFromState(Matrix3d &warp_mat, const Ref<const VectorXd> &ssm_state) const override;
 	void getStateFromWarp(VectorXd &state_vec, const Matrix3d& warp_mat) override;
 
 private:
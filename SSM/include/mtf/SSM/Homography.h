@@ -32,9 +32,16 @@ public:
 	void cmptPixJacobian(MatrixXd &jacobian_prod, const PixGradT &am_jacobian) override;
 	void cmptWarpedPixJacobian(MatrixXd &jacobian_prod,
 		const PixGradT &pix_jacobian) override;
+	void cmptWarpedPixJacobianBlock(MatrixXd &jacobian_prod,
+		const PixGradT &pix_jacobian, unsigned int start_id,
+		unsigned int n_block) override;
 
 	void cmptApproxPixJacobian(MatrixXd &jacobian_prod,
 		const PixGradT &pix_jacobian) override;
+	void cmptInitPixJacobianFloat(MatrixXf &jacobian_prod,
+		const PixGradT &pix_jacobian) override;
+	void cmptWarpedPixJacobianFloat(MatrixXf &jacobian_prod,
+		const PixGradT &pix_jacobian) override;
 	void estimateWarpFromCorners(VectorXd &state_update, const CornersT &in_corners,
 		const CornersT &out_corners) override;
 	void cmptInitPixHessian(MatrixXd &pix_hess_ssm, const PixHessT &pix_hess_coord,
@@ -68,9 +75,10 @@ public:
 	void compositionalAutoRegression1(VectorXd &perturbed_state, VectorXd &perturbed_ar,
 		const VectorXd &base_state, const VectorXd &base_ar, double a = 0.5) override;
 
-	void getWarpFromState(Matrix3d &warp_mat, const VectorXd& ssm_state) override;
+	void getWarpFromState(Matrix3d &warp_mat, const Ref<const VectorXd> &ssm_state) const override;
 	void getStateFromWarp(VectorXd &state_vec, const Matrix3d& warp_mat) override;
 
+	bool supportsPixJacobianBlocks() override{ return true; }
 #ifndef DISABLE_SPI
 	bool supportsSPI() override{ return true; }
 #endif
@@ -78,6 +86,13 @@ public:
 private:
 	ParamType params;
 
+	//! shared by the double and single precision pixel Jacobians
+	template<typename JacT>
+	void cmptInitPixJacobianImpl(JacT &dI_dp, const PixGradT &dI_dw);
+	template<typename JacT>
+	void cmptWarpedPixJacobianBlockImpl(JacT &dI_dp, const PixGradT &dI_dw,
+		unsigned int start_id, unsigned int n_block);
+
 	CornersT rand_d;
 	Vector2d rand_t;
 	CornersT disturbed_corners;
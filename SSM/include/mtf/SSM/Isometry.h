@@ -67,7 +67,7 @@ public:
 		const VectorXd &state_update) override;
 	void generatePerturbation(VectorXd &perturbation) override;
 
-	void getWarpFromState(Matrix3d &warp_mat, const VectorXd& ssm_state) override;
+	void getWarpFromState(Matrix3d &warp_mat, const Ref<const VectorXd> &ssm_state) const override;
 	void getStateFromWarp(VectorXd &state_vec, const Matrix3d& warp_mat) override;
 
 #ifndef DISABLE_SPI
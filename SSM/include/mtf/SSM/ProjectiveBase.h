@@ -3,6 +3,7 @@
 
 #include "StateSpaceModel.h"
 
+#include "mtf/Utilities/rngUtils.h"
 #include <boost/random/mersenne_twister.hpp>
 #include <boost/random/normal_distribution.hpp>
 
@@ -32,21 +33,26 @@ public:
 	void applyWarpToPts(Matrix2Xd &warped_pts, const Matrix2Xd &orig_pts,
 		const VectorXd &state_update) override;
 	void applyWarpToPt(double &warped_x, double &warped_y, double x, double y,
-		const ProjWarpT &warp);
+		const ProjWarpT &warp) const;
+	//! the points are transformed by a single matrix product for each state whose warp is affine
+	void applyWarpToPtsBatch(Ref<PtsT> out_pts, const PtsT &in_pts,
+		const Ref<const MatrixXd> &ssm_states) const override;
+	bool supportsWarpBatch() const override{ return true; }
 
 	void getIdentityWarp(VectorXd &identity_warp) override;
 	void composeWarps(VectorXd &composed_state, const VectorXd &state_1,
 		const VectorXd &state_2) override;
 
 	// convert the state vector to the 3x3 warp matrix and vice versa
-	virtual void getWarpFromState(Matrix3d &warp_mat, const VectorXd& ssm_state) = 0;
+	virtual void getWarpFromState(Matrix3d &warp_mat, const Ref<const VectorXd> &ssm_state) const = 0;
 	virtual void getStateFromWarp(VectorXd &state_vec, const Matrix3d& warp_mat) = 0;
 
 	// -------------------------------------------------------------------------- //
 	// --------------------------- Stochastic Sampler --------------------------- //
 	// -------------------------------------------------------------------------- //
 
-	typedef boost::mt11213b SampleGenT;
+	//! Mersenne twister unless setSamplerStream is called after which counter based streams are used
+	typedef utils::StreamableGen<boost::mt11213b> SampleGenT;
 	typedef boost::normal_distribution<double> SampleDistT;
 	typedef SampleDistT::param_type DistParamT;
 
@@ -63,6 +69,8 @@ public:
 
 	VectorXd getSamplerSigma() override;
 	VectorXd getSamplerMean() override;
+	void setSamplerStream(unsigned long long seed, unsigned long long stream_id) override;
+	bool supportsSamplerStreams() const override{ return true; }
 
 	void additiveRandomWalk(VectorXd &perturbed_state,
 		const VectorXd &base_state) override;
@@ -92,6 +100,8 @@ protected:
 
 	// both homogeneous versions are stored too for convenience
 	HomPtsT init_pts_hm, curr_pts_hm;
+	//! reused by getPerturbedPts so that sampling does not allocate per call
+	HomPtsT perturbed_pts_hm;
 	HomCornersT init_corners_hm, curr_corners_hm;
 
 	PtsT norm_pts;
@@ -76,9 +76,9 @@ private:
 
 	char *log_fname;
 
-	void getWarpFromState(Matrix3d &warp_mat, const VectorXd& ssm_state) override;
+	void getWarpFromState(Matrix3d &warp_mat, const Ref<const VectorXd> &ssm_state) const override;
 	void getStateFromWarp(VectorXd &state_vec, const Matrix3d& warp_mat) override;
-	void getLieAlgMatFromState(Matrix3d& lie_alg_mat, const VectorXd& ssm_state);
+	void getLieAlgMatFromState(Matrix3d& lie_alg_mat, const Ref<const VectorXd> &ssm_state) const;
 	void getStateFromLieAlgMat(VectorXd &state_vec,
 		const Matrix3d& lie_alg_mat);
 };
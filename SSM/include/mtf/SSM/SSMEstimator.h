@@ -20,9 +20,15 @@ public:
 	virtual int runKernel(const CvMat* m1, const CvMat* m2, CvMat* model) = 0;
 	virtual bool runLMeDS(const CvMat* m1, const CvMat* m2, CvMat* model,
 		CvMat* mask, double confidence = 0.99, int maxIters = 2000, int maxAttempts = 300);
+	/**
+	hypotheses are generated and scored in batches of n_threads that are evaluated in parallel
+	while the subsets are drawn sequentially so that the result does not depend on the no. of threads;
+	if use_prosac is true, the points must be sorted in decreasing order of match quality and
+	samples are drawn from a progressively growing set of the best points instead of all of them
+	*/
 	virtual bool runRANSAC(const CvMat* m1, const CvMat* m2, CvMat* model,
 		CvMat* mask, double threshold, double confidence = 0.99, int maxIters = 2000,
-		int maxAttempts=300);
+		int maxAttempts = 300, int n_threads = 1, bool use_prosac = false);
 	virtual bool refine(const CvMat*, const CvMat*, CvMat*, int) { return true; }
 	virtual void setSeed(int64 seed);
 
@@ -32,8 +38,11 @@ protected:
 	virtual int findInliers(const CvMat* m1, const CvMat* m2,
 		const CvMat* model, CvMat* error,
 		CvMat* mask, double threshold);
+	//! draws the subset from the first n_sample_pts points or all of them if this is <= 0;
+	//! if include_last is true, the last of these is always included in the subset
 	virtual bool getSubset(const CvMat* m1, const CvMat* m2,
-		CvMat* ms1, CvMat* ms2, int maxAttempts = 1000);
+		CvMat* ms1, CvMat* ms2, int maxAttempts = 1000,
+		int n_sample_pts = 0, bool include_last = false);
 	virtual bool checkSubset(const CvMat* ms1, int count);
 
 	typedef boost::mt19937 BoostRNG;
@@ -23,10 +23,19 @@ struct SSMEstimatorParams{
 	double confidence;
 	bool refine;
 	int lm_max_iters;
+	//! no. of RANSAC hypotheses that are generated and scored in parallel;
+	//! 1 runs them serially and <= 0 uses all the available cores
+	int n_threads;
+	//! draw RANSAC samples from a progressively growing set of the best points (PROSAC);
+	//! this is not read from the configuration since it only works if the points are sorted
+	//! in decreasing order of match quality so it must only be set by a caller that sorts them
+	//! in its own copy of these parameters, as the Feature tracker does if feat_use_prosac is enabled
+	bool use_prosac;
 	
 	SSMEstimatorParams(EstType _method, double _ransac_reproj_thresh, 
 		int _n_model_pts, bool _refine, int _max_iters, int _max_subset_attempts,
-		bool  _use_boost_rng, double _confidence, int _lm_max_iters);
+		bool  _use_boost_rng, double _confidence, int _lm_max_iters,
+		int _n_threads);
 	SSMEstimatorParams(const SSMEstimatorParams *params = nullptr);
 
 	void print() const;
@@ -89,7 +89,7 @@ public:
 	void compositionalRandomWalk(VectorXd &perturbed_state,
 		const VectorXd &base_state) override;
 
-	void getWarpFromState(Matrix3d &warp_mat, const VectorXd& ssm_state) override;
+	void getWarpFromState(Matrix3d &warp_mat, const Ref<const VectorXd> &ssm_state) const override;
 	void getStateFromWarp(VectorXd &state_vec, const Matrix3d& warp_mat) override;
 
 #ifndef DISABLE_SPI
@@ -176,9 +176,30 @@ public:
 	virtual void cmptWarpedPixJacobian(MatrixXd &jacobian_prod, const PixGradT &pixel_grad) {
 		ssm_func_not_implemeted(cmptWarpedPixJacobian);
 	}
+	//! computes the rows of the warped pixel Jacobian corresponding to the n_block points starting at start_id
+	//! and writes them to the first n_block*n_channels rows of jacobian_prod so that the Jacobian
+	//! can be computed and consumed one block at a time without ever being stored in its entirety;
+	//! this is thread safe as long as different threads use different output matrices
+	virtual void cmptWarpedPixJacobianBlock(MatrixXd &jacobian_prod, const PixGradT &pixel_grad,
+		unsigned int start_id, unsigned int n_block) {
+		ssm_func_not_implemeted(cmptWarpedPixJacobianBlock);
+	}
 	virtual void cmptApproxPixJacobian(MatrixXd &jacobian_prod, const PixGradT &pixel_grad) {
 		ssm_func_not_implemeted(cmptApproxPixJacobian);
 	}
+	//! single precision variants used by the SMs when the AM accepts single precision pixel Jacobians
+	//! (see AppearanceModel::supportsFloatJacobian); unless overridden, these convert the double precision
+	//! Jacobians computed in a workspace so only the SSMs that override them halve the memory traffic
+	virtual void cmptInitPixJacobianFloat(MatrixXf &jacobian_prod, const PixGradT &pixel_grad) {
+		pix_jacobian.resize(jacobian_prod.rows(), jacobian_prod.cols());
+		cmptInitPixJacobian(pix_jacobian, pixel_grad);
+		jacobian_prod = pix_jacobian.cast<float>();
+	}
+	virtual void cmptWarpedPixJacobianFloat(MatrixXf &jacobian_prod, const PixGradT &pixel_grad) {
+		pix_jacobian.resize(jacobian_prod.rows(), jacobian_prod.cols());
+		cmptWarpedPixJacobian(pix_jacobian, pixel_grad);
+		jacobian_prod = pix_jacobian.cast<float>();
+	}
 	virtual void cmptInitPixHessian(MatrixXd &pix_hess_ssm, const PixHessT &pix_hess_coord,
 		const PixGradT &pix_grad) {
 		ssm_func_not_implemeted(cmptInitPixHessian);
@@ -229,6 +250,24 @@ public:
 		applyWarpToPts(out_pts, in_pts, ssm_state);
 		return out_pts;
 	}
+	/**
+	batched variant that warps the given points by the state in each column of ssm_states;
+	the points warped by the state in column i are written to columns i*N to (i+1)*N - 1 of out_pts
+	where N is the no. of input points; the current state and points of the SSM are neither used
+	nor modified and no memory is allocated so that many hypotheses can be warped at once,
+	from any no. of threads, without going through setState and getPts for each;
+	only available if supportsWarpBatch returns true
+	*/
+	virtual void applyWarpToPtsBatch(Ref<PtsT> out_pts, const PtsT &in_pts,
+		const Ref<const MatrixXd> &ssm_states) const{
+		ssm_func_not_implemeted(applyWarpToPtsBatch);
+	}
+	//! warps the points corresponding to the identity state so that the points in column block i
+	//! are the ones that getPts would return after calling setState with column i of ssm_states
+	void getPtsBatch(Ref<PtsT> out_pts, const Ref<const MatrixXd> &ssm_states) const{
+		applyWarpToPtsBatch(out_pts, init_pts, ssm_states);
+	}
+	virtual bool supportsWarpBatch() const{ return false; }
 	// return SSM state vector p corresponding to the identity warp, i.e. S(x, p)=x;
 	virtual void getIdentityWarp(VectorXd &p){
 		ssm_func_not_implemeted(applyWarpToPts);
@@ -299,6 +338,16 @@ public:
 	}
 	virtual VectorXd getSamplerSigma(){ ssm_func_not_implemeted(getSamplerSigma); }
 	virtual VectorXd getSamplerMean(){ ssm_func_not_implemeted(getSamplerMean); }
+	/**
+	restarts the sampler at the beginning of the random stream identified by the given seed and ID
+	so that the samples drawn next do not depend on any that were drawn before;
+	this allows samples to be drawn in parallel by different instances in any order with the same result;
+	the sampler keeps using its default generator until this is called for the first time
+	*/
+	virtual void setSamplerStream(unsigned long long seed, unsigned long long stream_id){
+		ssm_func_not_implemeted(setSamplerStream);
+	}
+	virtual bool supportsSamplerStreams() const{ return false; }
 
 
 	// use Random Walk model to generate perturbed sample
@@ -363,6 +412,7 @@ public:
 
 	virtual void setSPIMask(const bool *_spi_mask){ spi_mask = _spi_mask; }
 	virtual void clearSPIMask(){ spi_mask = nullptr; }
+	virtual bool supportsPixJacobianBlocks(){ return false; }
 	virtual bool supportsSPI(){ return false; }// should be overridden by an implementing class once 
 	// it implements SPI functionality for all functions where it makes logical sense
 
@@ -397,6 +447,8 @@ protected:
 	*/
 	bool first_iter;
 	const bool *spi_mask;
+	//! workspace for the default single precision pixel Jacobians
+	MatrixXd pix_jacobian;
 
 private:
 	unsigned int getResX(const SSMParams *params){
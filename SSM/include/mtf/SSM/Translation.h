@@ -113,7 +113,7 @@ public:
 		const vector<cv::Point2f> &in_pts, const vector<cv::Point2f> &out_pts,
 		const EstimatorParams &est_params) override;
 
-	void getWarpFromState(Matrix3d &warp_mat, const VectorXd& ssm_state) override;
+	void getWarpFromState(Matrix3d &warp_mat, const Ref<const VectorXd> &ssm_state) const override;
 	void getStateFromWarp(VectorXd &state_vec, const Matrix3d& warp_mat) override;
 
 protected:
@@ -110,7 +110,7 @@ void ASRT::compositionalUpdate(const VectorXd& state_update){
 }
 
 void ASRT::getWarpFromState(Matrix3d &warp_mat,
-	const VectorXd& ssm_state){
+	const Ref<const VectorXd> &ssm_state) const{
 	validate_ssm_state(ssm_state);
 
 	double tx = ssm_state(0);
@@ -474,7 +474,8 @@ int	ASRT::estimateASRT(const CvMat* in_pts, const CvMat* out_pts,
 		params.max_iters, params.max_subset_attempts);
 	else if(method == CV_RANSAC)
 		result = estimator.runRANSAC(in_pts_hm, out_pts_hm, &matH, tempMask, params.ransac_reproj_thresh,
-		params.confidence, params.max_iters, params.max_subset_attempts);
+		params.confidence, params.max_iters, params.max_subset_attempts,
+		params.n_threads, params.use_prosac);
 	else
 		result = estimator.runKernel(in_pts_hm, out_pts_hm, &matH) > 0;
 
@@ -63,7 +63,7 @@ void AST::compositionalUpdate(const VectorXd& state_update){
 }
 
 void AST::getWarpFromState(Matrix3d &warp_mat,
-	const VectorXd& ssm_state){
+	const Ref<const VectorXd> &ssm_state) const{
 	validate_ssm_state(ssm_state);
 
 	warp_mat = Matrix3d::Identity();
@@ -360,7 +360,8 @@ int	AST::estimateAST(const CvMat* in_pts, const CvMat* out_pts,
 		params.max_iters, params.max_subset_attempts);
 	else if(method == CV_RANSAC)
 		result = estimator.runRANSAC(in_pts_hm, out_pts_hm, &matH, tempMask, params.ransac_reproj_thresh,
-		params.confidence, params.max_iters, params.max_subset_attempts);
+		params.confidence, params.max_iters, params.max_subset_attempts,
+		params.n_threads, params.use_prosac);
 	else
 		result = estimator.runKernel(in_pts_hm, out_pts_hm, &matH) > 0;
 
@@ -115,7 +115,7 @@ void Affine::setState(const VectorXd &ssm_state){
 }
 
 void Affine::getWarpFromState(Matrix3d &warp_mat,
-	const VectorXd& ssm_state){
+	const Ref<const VectorXd> &ssm_state) const{
 	validate_ssm_state(ssm_state);
 
 	warp_mat(0, 0) = 1 + ssm_state(2);
@@ -213,11 +213,20 @@ void Affine::cmptApproxPixJacobian(MatrixXd &dI_dp,
 void Affine::cmptWarpedPixJacobian(MatrixXd &dI_dp,
 	const PixGradT &dI_dx) {
 	validate_ssm_jacobian(dI_dp, dI_dx);
+	cmptWarpedPixJacobianBlock(dI_dp, dI_dx, 0, n_pts);
+}
+
+void Affine::cmptWarpedPixJacobianBlock(MatrixXd &dI_dp,
+	const PixGradT &dI_dx,
+	unsigned int start_id, unsigned int n_block){
+	assert(dI_dp.rows() >= n_block*n_channels && dI_dp.cols() == state_size);
+	assert(dI_dx.rows() == n_pts*n_channels && start_id + n_block <= n_pts);
 	double a = curr_state(2) + 1, b = curr_state(3);
 	double c = curr_state(4), d = curr_state(5) + 1;
 
-	unsigned int ch_pt_id = 0;
-	for(unsigned int pt_id = 0; pt_id < n_pts; ++pt_id){
+	unsigned int ch_pt_id = start_id*n_channels;
+	const unsigned int row_offset = ch_pt_id;
+	for(unsigned int pt_id = start_id; pt_id < start_id + n_block; ++pt_id){
 		spi_pt_check_mc(spi_mask, pt_id, ch_pt_id);
 
 		double x = init_pts(0, pt_id);
@@ -230,12 +239,12 @@ void Affine::cmptWarpedPixJacobian(MatrixXd &dI_dp,
 			double Iyy = Iy * y;
 			double Iyx = Iy * x;
 
-			dI_dp(ch_pt_id, 0) = Ix*a + Iy*c;
-			dI_dp(ch_pt_id, 1) = Ix*b + Iy*d;
-			dI_dp(ch_pt_id, 2) = Ixx*a + Iyx*c;
-			dI_dp(ch_pt_id, 3) = Ixy*a + Iyy*c;
-			dI_dp(ch_pt_id, 4) = Ixx*b + Iyx*d;
-			dI_dp(ch_pt_id, 5) = Ixy*b + Iyy*d;
+			dI_dp(ch_pt_id - row_offset, 0) = Ix*a + Iy*c;
+			dI_dp(ch_pt_id - row_offset, 1) = Ix*b + Iy*d;
+			dI_dp(ch_pt_id - row_offset, 2) = Ixx*a + Iyx*c;
+			dI_dp(ch_pt_id - row_offset, 3) = Ixy*a + Iyy*c;
+			dI_dp(ch_pt_id - row_offset, 4) = Ixx*b + Iyx*d;
+			dI_dp(ch_pt_id - row_offset, 5) = Ixy*b + Iyy*d;
 			++ch_pt_id;
 		}
 	}
@@ -49,16 +49,16 @@ int AffineEstimator::runKernel(const CvMat* m1, const CvMat* m2, CvMat* H) {
 void AffineEstimator::computeReprojError(const CvMat* m1, const CvMat* m2,
 	const CvMat* model, CvMat* _err) {
 	int n_pts = m1->rows * m1->cols;
-	const CvPoint2D64f* M = (const CvPoint2D64f*)m1->data.ptr;
-	const CvPoint2D64f* m = (const CvPoint2D64f*)m2->data.ptr;
+	//! errors for all points are computed together with each row holding the x or y coordinates
+	Map<const Matrix<double, 2, Dynamic> > M((const double*)m1->data.ptr, 2, n_pts);
+	Map<const Matrix<double, 2, Dynamic> > m((const double*)m2->data.ptr, 2, n_pts);
 	const double* H = model->data.db;
-	float* err = _err->data.fl;
+	Map<ArrayXf> err(_err->data.fl, n_pts);
 
-	for(int pt_id = 0; pt_id < n_pts; pt_id++) {
-		double dx = (H[0] * M[pt_id].x + H[1] * M[pt_id].y + H[2]) - m[pt_id].x;
-		double dy = (H[3] * M[pt_id].x + H[4] * M[pt_id].y + H[5]) - m[pt_id].y;
-		err[pt_id] = (float)(dx * dx + dy * dy);
-	}
+	auto Mx = M.row(0).array().transpose();
+	auto My = M.row(1).array().transpose();
+	err = ((H[0] * Mx + H[1] * My + H[2] - m.row(0).array().transpose()).square() +
+		(H[3] * Mx + H[4] * My + H[5] - m.row(1).array().transpose()).square()).cast<float>();
 }
 
 bool AffineEstimator::refine(const CvMat* m1, const CvMat* m2,
@@ -161,7 +161,8 @@ int	estimateAffine(const CvMat* in_pts, const CvMat* out_pts,
 		params.max_iters, params.max_subset_attempts);
 	else if(method == CV_RANSAC)
 		result = estimator.runRANSAC(in_pts_hm, out_pts_hm, &matH, tempMask, params.ransac_reproj_thresh,
-		params.confidence, params.max_iters, params.max_subset_attempts);
+		params.confidence, params.max_iters, params.max_subset_attempts,
+		params.n_threads, params.use_prosac);
 	else
 		result = estimator.runKernel(in_pts_hm, out_pts_hm, &matH) > 0;
 
@@ -121,10 +121,11 @@ void CBH::compositionalUpdate(const VectorXd& state_update){
 }
 
 void CBH::getWarpFromState(Matrix3d &warp_mat,
-	const VectorXd& ssm_state){
+	const Ref<const VectorXd> &ssm_state) const{
 	validate_ssm_state(ssm_state);
 
 	// loop unrolling for maximum speed
+	Matrix24d updated_corners;
 	updated_corners(0, 0) = init_corners(0, 0) + ssm_state(0);
 	updated_corners(1, 0) = init_corners(1, 0) + ssm_state(1);
 
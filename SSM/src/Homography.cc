@@ -92,7 +92,7 @@ void Homography::compositionalUpdate(const VectorXd& state_update){
 }
 
 void Homography::getWarpFromState(Matrix3d &warp_mat,
-	const VectorXd& ssm_state){
+	const Ref<const VectorXd> &ssm_state) const{
 	validate_ssm_state(ssm_state);
 
 	warp_mat(0, 0) = 1 + ssm_state(0);
@@ -155,6 +155,17 @@ void Homography::getCurrPixGrad(Matrix2Xd &dw_dp, int pt_id) {
 }
 
 void Homography::cmptInitPixJacobian(MatrixXd &dI_dp,
+	const PixGradT &dI_dw){
+	cmptInitPixJacobianImpl(dI_dp, dI_dw);
+}
+
+void Homography::cmptInitPixJacobianFloat(MatrixXf &dI_dp,
+	const PixGradT &dI_dw){
+	cmptInitPixJacobianImpl(dI_dp, dI_dw);
+}
+
+template<typename JacT>
+void Homography::cmptInitPixJacobianImpl(JacT &dI_dp,
 	const PixGradT &dI_dw){
 	validate_ssm_jacobian(dI_dp, dI_dw);
 
@@ -231,6 +242,27 @@ void Homography::cmptPixJacobian(MatrixXd &dI_dp,
 void Homography::cmptWarpedPixJacobian(MatrixXd &dI_dp,
 	const PixGradT &dI_dw) {
 	validate_ssm_jacobian(dI_dp, dI_dw);
+	cmptWarpedPixJacobianBlock(dI_dp, dI_dw, 0, n_pts);
+}
+
+void Homography::cmptWarpedPixJacobianFloat(MatrixXf &dI_dp,
+	const PixGradT &dI_dw) {
+	validate_ssm_jacobian(dI_dp, dI_dw);
+	cmptWarpedPixJacobianBlockImpl(dI_dp, dI_dw, 0, n_pts);
+}
+
+void Homography::cmptWarpedPixJacobianBlock(MatrixXd &dI_dp,
+	const PixGradT &dI_dw,
+	unsigned int start_id, unsigned int n_block){
+	cmptWarpedPixJacobianBlockImpl(dI_dp, dI_dw, start_id, n_block);
+}
+
+template<typename JacT>
+void Homography::cmptWarpedPixJacobianBlockImpl(JacT &dI_dp,
+	const PixGradT &dI_dw,
+	unsigned int start_id, unsigned int n_block){
+	assert(dI_dp.rows() >= n_block*n_channels && dI_dp.cols() == state_size);
+	assert(dI_dw.rows() == n_pts*n_channels && start_id + n_block <= n_pts);
 
 	double a00 = curr_warp(0, 0);
 	double a01 = curr_warp(0, 1);
@@ -239,8 +271,9 @@ void Homography::cmptWarpedPixJacobian(MatrixXd &dI_dp,
 	double a20 = curr_warp(2, 0);
 	double a21 = curr_warp(2, 1);
 
-	int ch_pt_id = 0;
-	for(unsigned int pt_id = 0; pt_id < n_pts;  ++pt_id) {
+	int ch_pt_id = start_id*n_channels;
+	const int row_offset = ch_pt_id;
+	for(unsigned int pt_id = start_id; pt_id < start_id + n_block; ++pt_id) {
 		spi_pt_check_mc(spi_mask, pt_id, ch_pt_id);
 
 		double w_x = curr_pts(0, pt_id);
@@ -279,14 +312,14 @@ void Homography::cmptWarpedPixJacobian(MatrixXd &dI_dp,
 			//dI_dp(ch_pt_id, 7) = -(Ixy*(a*x + b*y) +
 			//	Iyy*(c*x + d*y)) * inv_det2;
 
-			dI_dp(ch_pt_id, 0) = Ixx;
-			dI_dp(ch_pt_id, 1) = Ixy;
-			dI_dp(ch_pt_id, 2) = Ix;
-			dI_dp(ch_pt_id, 3) = Iyx;
-			dI_dp(ch_pt_id, 4) = Iyy;
-			dI_dp(ch_pt_id, 5) = Iy;
-			dI_dp(ch_pt_id, 6) = -x*Ixx - y*Iyx;
-			dI_dp(ch_pt_id, 7) = -x*Ixy - y*Iyy;
+			dI_dp(ch_pt_id - row_offset, 0) = Ixx;
+			dI_dp(ch_pt_id - row_offset, 1) = Ixy;
+			dI_dp(ch_pt_id - row_offset, 2) = Ix;
+			dI_dp(ch_pt_id - row_offset, 3) = Iyx;
+			dI_dp(ch_pt_id - row_offset, 4) = Iyy;
+			dI_dp(ch_pt_id - row_offset, 5) = Iy;
+			dI_dp(ch_pt_id - row_offset, 6) = -x*Ixx - y*Iyx;
+			dI_dp(ch_pt_id - row_offset, 7) = -x*Ixy - y*Iyy;
 
 			++ch_pt_id;
 		}
@@ -83,18 +83,18 @@ int HomographyEstimator::runKernel(const CvMat* m1, const CvMat* m2, CvMat* H) {
 
 void HomographyEstimator::computeReprojError(const CvMat* m1, const CvMat* m2,
 	const CvMat* model, CvMat* _err) {
-	int i, count = m1->rows * m1->cols;
-	const CvPoint2D64f* M = (const CvPoint2D64f*)m1->data.ptr;
-	const CvPoint2D64f* m = (const CvPoint2D64f*)m2->data.ptr;
+	int count = m1->rows * m1->cols;
+	//! errors for all points are computed together with each row holding the x or y coordinates
+	Map<const Matrix<double, 2, Dynamic> > M((const double*)m1->data.ptr, 2, count);
+	Map<const Matrix<double, 2, Dynamic> > m((const double*)m2->data.ptr, 2, count);
 	const double* H = model->data.db;
-	float* err = _err->data.fl;
+	Map<ArrayXf> err(_err->data.fl, count);
 
-	for(i = 0; i < count; i++) {
-		double ww = 1. / (H[6] * M[i].x + H[7] * M[i].y + 1.);
-		double dx = (H[0] * M[i].x + H[1] * M[i].y + H[2]) * ww - m[i].x;
-		double dy = (H[3] * M[i].x + H[4] * M[i].y + H[5]) * ww - m[i].y;
-		err[i] = (float)(dx * dx + dy * dy);
-	}
+	auto Mx = M.row(0).array().transpose();
+	auto My = M.row(1).array().transpose();
+	auto ww = (H[6] * Mx + H[7] * My + 1.).inverse();
+	err = (((H[0] * Mx + H[1] * My + H[2]) * ww - m.row(0).array().transpose()).square() +
+		((H[3] * Mx + H[4] * My + H[5]) * ww - m.row(1).array().transpose()).square()).cast<float>();
 }
 
 bool HomographyEstimator::refine(const CvMat* m1, const CvMat* m2,
@@ -199,7 +199,8 @@ int estimateHomography(const CvMat* objectPoints, const CvMat* imagePoints,
 		params.max_iters, params.max_subset_attempts);
 	else if(method == CV_RANSAC)
 		result = estimator.runRANSAC(M, m, &matH, tempMask, params.ransac_reproj_thresh,
-		params.confidence, params.max_iters, params.max_subset_attempts);
+		params.confidence, params.max_iters, params.max_subset_attempts,
+		params.n_threads, params.use_prosac);
 	else
 		result = estimator.runKernel(M, m, &matH) > 0;
 
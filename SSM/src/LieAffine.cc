@@ -118,13 +118,14 @@ void LieAffine::compositionalUpdate(const VectorXd& state_update){
 }
 
 void LieAffine::getWarpFromState(Matrix3d &warp_mat,
-	const VectorXd& ssm_state){
+	const Ref<const VectorXd> &ssm_state) const{
 	validate_ssm_state(ssm_state);
 
 	assert(ssm_state.size() == state_size);
 	//for(int i=0;i<state_size;i++){
 	//	lie_alg_mat += ssm_state(i) * lieAlgBasis[i];
 	//}
+	Matrix3d lie_alg_mat;
 	lie_alg_mat(0, 0) = ssm_state(0) + ssm_state(1);
 	lie_alg_mat(0, 1) = ssm_state(3) - ssm_state(2);
 	lie_alg_mat(0, 2) = ssm_state(4);
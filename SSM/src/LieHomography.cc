@@ -147,7 +147,7 @@ void LieHomography::compositionalUpdate(const VectorXd& state_update){
 }
 
 void LieHomography::getWarpFromState(Matrix3d &warp_mat,
-	const VectorXd& ssm_state){
+	const Ref<const VectorXd> &ssm_state) const{
 	validate_ssm_state(ssm_state);
 
 	assert(ssm_state.size() == state_size);
@@ -160,6 +160,7 @@ void LieHomography::getWarpFromState(Matrix3d &warp_mat,
 		throw mtf::utils::InvalidTrackerState("LieHomography::getWarpFromState :: Invalid state provided");
 	}
 
+	Matrix3d lie_alg_mat;
 	lie_alg_mat(0, 0) = ssm_state(0);
 	lie_alg_mat(0, 1) = ssm_state(1);
 	lie_alg_mat(0, 2) = ssm_state(2);
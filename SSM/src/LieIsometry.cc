@@ -41,13 +41,14 @@ void LieIsometry::compositionalUpdate(const VectorXd& state_update){
 }
 
 void LieIsometry::getWarpFromState(Matrix3d &warp_mat,
-	const VectorXd& ssm_state){
+	const Ref<const VectorXd> &ssm_state) const{
 	validate_ssm_state(ssm_state);
 
 	assert(ssm_state.size() == state_size);
 	//for(int i=0;i<state_size;i++){
 	//	lie_alg_mat += ssm_state(i) * lieAlgBasis[i];
 	//}
+	Matrix3d lie_alg_mat = Matrix3d::Zero();
 	lie_alg_mat(0, 1) = -ssm_state(2);
 	lie_alg_mat(0, 2) = ssm_state(0);
 	lie_alg_mat(1, 0) = ssm_state(2);
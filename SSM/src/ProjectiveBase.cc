@@ -10,6 +10,7 @@ ProjectiveBase::ProjectiveBase(const SSMParams *params) :
 StateSpaceModel(params){
 	init_pts_hm.resize(Eigen::NoChange, n_pts);
 	curr_pts_hm.resize(Eigen::NoChange, n_pts);
+	perturbed_pts_hm.resize(Eigen::NoChange, n_pts);
 	norm_pts.resize(Eigen::NoChange, n_pts);
 	norm_pts_hm.resize(Eigen::NoChange, n_pts);
 	utils::getNormUnitSquarePts(norm_pts, norm_corners, resx, resy);
@@ -150,12 +151,33 @@ void ProjectiveBase::applyWarpToPts(Matrix2Xd &warped_pts, const Matrix2Xd &orig
 }
 
 void ProjectiveBase::applyWarpToPt(double &warped_x, double &warped_y, double x, double y,
-	const ProjWarpT &warp){
+	const ProjWarpT &warp) const{
 	double discr = warp(2, 0)*x + warp(2, 1)*y + warp(2, 2);
 	warped_x = (warp(0, 0)*x + warp(0, 1)*y + warp(0, 2)) / discr;
 	warped_y = (warp(1, 0)*x + warp(1, 1)*y + warp(1, 2)) / discr;
 }
 
+void ProjectiveBase::applyWarpToPtsBatch(Ref<PtsT> out_pts, const PtsT &in_pts,
+	const Ref<const MatrixXd> &ssm_states) const{
+	const int n_in_pts = static_cast<int>(in_pts.cols());
+	const int n_states = static_cast<int>(ssm_states.cols());
+	assert(ssm_states.rows() == state_size && out_pts.cols() == n_in_pts*n_states);
+	ProjWarpT warp;
+	for(int state_id = 0; state_id < n_states; ++state_id){
+		getWarpFromState(warp, ssm_states.col(state_id));
+		auto warped_pts = out_pts.middleCols(state_id*n_in_pts, n_in_pts);
+		if(warp(2, 0) == 0 && warp(2, 1) == 0 && warp(2, 2) == 1){
+			warped_pts.noalias() = warp.topLeftCorner<2, 2>() * in_pts;
+			warped_pts.colwise() += warp.topRightCorner<2, 1>();
+		} else{
+			for(int pt_id = 0; pt_id < n_in_pts; ++pt_id){
+				applyWarpToPt(warped_pts(0, pt_id), warped_pts(1, pt_id),
+					in_pts(0, pt_id), in_pts(1, pt_id), warp);
+			}
+		}
+	}
+}
+
 // -------------------------------------------------------------------------- //
 // --------------------------- Stochastic Sampler --------------------------- //
 // -------------------------------------------------------------------------- //
@@ -250,6 +272,14 @@ VectorXd ProjectiveBase::getSamplerMean(){
 	}
 	return sampler_mean;
 }
+void ProjectiveBase::setSamplerStream(unsigned long long seed, unsigned long long stream_id){
+	for(unsigned int gen_id = 0; gen_id < rand_gen.size(); ++gen_id){
+		//! a different key for each generator keeps the streams for different state parameters independent
+		rand_gen[gen_id].seed(seed + gen_id * 0x9E3779B97F4A7C15ULL, stream_id);
+		//! discard any sample cached by the distribution from the previous stream
+		rand_dist[gen_id].reset();
+	}
+}
 
 // use Random Walk model to generate perturbed sample
 void ProjectiveBase::additiveRandomWalk(VectorXd &perturbed_state,
@@ -298,16 +328,16 @@ void ProjectiveBase::generatePerturbation(VectorXd &perturbation){
 	}
 }
 void ProjectiveBase::generatePerturbedPts(VectorXd &perturbed_pts){
-	VectorXd state_update(state_size);
-	generatePerturbation(state_update);
-	getPerturbedPts(perturbed_pts, state_update);
+	generatePerturbation(state_perturbation);
+	getPerturbedPts(perturbed_pts, state_perturbation);
 }
 
 void ProjectiveBase::getPerturbedPts(VectorXd &perturbed_pts,
 	const VectorXd &state_perturbation){
 	Matrix3d warp_perturbation;
 	getWarpFromState(warp_perturbation, state_perturbation);
-	utils::dehomogenize(curr_warp * warp_perturbation * init_pts_hm, perturbed_pts);
+	perturbed_pts_hm.noalias() = curr_warp * warp_perturbation * init_pts_hm;
+	utils::dehomogenize(perturbed_pts_hm, perturbed_pts);
 }
 
 void ProjectiveBase::estimateMeanOfSamples(VectorXd &sample_mean,
@@ -217,13 +217,14 @@ void SL3::compositionalUpdate(const VectorXd& state_update){
 }
 
 void SL3::getWarpFromState(Matrix3d &warp_mat,
-	const VectorXd& ssm_state){
+	const Ref<const VectorXd> &ssm_state) const{
 	validate_ssm_state(ssm_state);
 	assert(ssm_state.size() == 8);
 	if(!ssm_state.allFinite() || is_unbounded(ssm_state)){
 		utils::printMatrix(ssm_state.transpose(), "ssm_state");
 		throw mtf::utils::InvalidTrackerState("SL3::getWarpFromState::Invalid state provided");
 	}
+	Matrix3d lie_alg_mat;
 	getLieAlgMatFromState(lie_alg_mat, ssm_state);
 	if(!lie_alg_mat.allFinite() || is_unbounded(lie_alg_mat)){
 		utils::printMatrix(ssm_state.transpose(), "ssm_state");
@@ -254,7 +255,7 @@ void SL3::getStateFromWarp(VectorXd &state_vec,
 }
 
 void SL3::getLieAlgMatFromState(Matrix3d& lie_alg_mat,
-	const VectorXd& ssm_state){
+	const Ref<const VectorXd> &ssm_state) const{
 	validate_ssm_state(ssm_state);
 	assert(ssm_state.size() == state_size);
 	lie_alg_mat(0, 0) = ssm_state(0);
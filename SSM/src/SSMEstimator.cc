@@ -1,5 +1,6 @@
 #include "mtf/SSM//SSMEstimator.h"
 #include "mtf/SSM/internal/cv2_q_sort.h"
+#include "mtf/Utilities/parallelUtils.h"
 #include "opencv2/core/core_c.h"
 //#if CV_MAJOR_VERSION < 3
 //#include "opencv2/core/internal.hpp"
@@ -8,10 +9,25 @@
 //#endif
 #include <boost/random/random_device.hpp>
 #include <boost/random/uniform_int_distribution.hpp>
+#include <map>
+#include <memory>
+#include <mutex>
 
 
 _MTF_BEGIN_NAMESPACE
 
+namespace{
+	//! shared by all estimators with the same no. of threads so that these are only created once
+	utils::TaskArena& getEstimatorArena(int n_threads){
+		static std::map<int, std::unique_ptr<utils::TaskArena> > arenas;
+		static std::mutex arenas_mutex;
+		std::lock_guard<std::mutex> lock(arenas_mutex);
+		std::unique_ptr<utils::TaskArena> &arena = arenas[n_threads];
+		if(!arena){ arena.reset(new utils::TaskArena(n_threads)); }
+		return *arena;
+	}
+}
+
 SSMEstimator::SSMEstimator(int _modelPoints, CvSize _modelSize,
 int _maxBasicSolutions, bool _use_boost_rng):
 modelPoints(_modelPoints),
@@ -35,15 +51,13 @@ void SSMEstimator::setSeed(int64 seed) {
 int SSMEstimator::findInliers(const CvMat* m1, const CvMat* m2,
 	const CvMat* model, CvMat* _err,
 	CvMat* _mask, double threshold) {
-	int i, count = _err->rows * _err->cols, goodCount = 0;
-	const float* err = _err->data.fl;
-	uchar* mask = _mask->data.ptr;
+	int count = _err->rows * _err->cols;
+	Map<const ArrayXf> err(_err->data.fl, count);
+	Map<Array<uchar, Dynamic, 1> > mask(_mask->data.ptr, count);
 
 	computeReprojError(m1, m2, model, _err);
-	threshold *= threshold;
-	for(i = 0; i < count; i++)
-		goodCount += mask[i] = err[i] <= threshold;
-	return goodCount;
+	mask = (err <= static_cast<float>(threshold * threshold)).cast<uchar>();
+	return mask.cast<int>().sum();
 }
 
 
@@ -72,11 +86,9 @@ int cvRANSACUpdateNumIters(double p, double ep,
 
 bool SSMEstimator::runRANSAC(const CvMat* m1, const CvMat* m2, CvMat* model,
 	CvMat* mask0, double reprojThreshold,double confidence, int maxIters,
-	int maxAttempts) {
+	int maxAttempts, int n_threads, bool use_prosac) {
 	bool result = false;
 	cv::Ptr<CvMat> mask = cvCloneMat(mask0);
-	cv::Ptr<CvMat> models, err, tmask;
-	cv::Ptr<CvMat> ms1, ms2;
 
 	int iter, niters = maxIters;
 	int count = m1->rows * m1->cols, maxGoodCount = 0;
@@ -85,46 +97,102 @@ bool SSMEstimator::runRANSAC(const CvMat* m1, const CvMat* m2, CvMat* model,
 	if(count < modelPoints)
 		return false;
 
-	models = cvCreateMat(modelSize.height * maxBasicSolutions, modelSize.width, CV_64FC1);
-	err = cvCreateMat(1, count, CV_32FC1);
-	tmask = cvCreateMat(1, count, CV_8UC1);
+	utils::TaskArena *arena = n_threads != 1 && count > modelPoints ?
+		&getEstimatorArena(n_threads) : nullptr;
+	int batchSize = arena ? arena->getNThreads() : 1;
 
-	if(count > modelPoints) {
-		ms1 = cvCreateMat(1, modelPoints, m1->type);
-		ms2 = cvCreateMat(1, modelPoints, m2->type);
-	} else {
-		niters = 1;
-		ms1 = cvCloneMat(m1);
-		ms2 = cvCloneMat(m2);
+	//! buffers for each hypothesis in a batch
+	vector<cv::Ptr<CvMat> > models(batchSize), ms1(batchSize), ms2(batchSize);
+	vector<cv::Ptr<CvMat> > err(batchSize*maxBasicSolutions), tmask(batchSize*maxBasicSolutions);
+	vector<int> nmodels(batchSize), goodCounts(batchSize*maxBasicSolutions);
+	for(int hyp_id = 0; hyp_id < batchSize; ++hyp_id){
+		models[hyp_id] = cvCreateMat(modelSize.height * maxBasicSolutions, modelSize.width, CV_64FC1);
+		if(count > modelPoints) {
+			ms1[hyp_id] = cvCreateMat(1, modelPoints, m1->type);
+			ms2[hyp_id] = cvCreateMat(1, modelPoints, m2->type);
+		} else {
+			niters = 1;
+			ms1[hyp_id] = cvCloneMat(m1);
+			ms2[hyp_id] = cvCloneMat(m2);
+		}
+	}
+	for(int model_id = 0; model_id < batchSize*maxBasicSolutions; ++model_id){
+		err[model_id] = cvCreateMat(1, count, CV_32FC1);
+		tmask[model_id] = cvCreateMat(1, count, CV_8UC1);
+	}
+	auto runHypothesis = [&](int hyp_id){
+		nmodels[hyp_id] = runKernel(ms1[hyp_id], ms2[hyp_id], models[hyp_id]);
+		for(int i = 0; i < nmodels[hyp_id]; i++) {
+			CvMat model_i;
+			cvGetRows(models[hyp_id], &model_i, i * modelSize.height, (i + 1)*modelSize.height);
+			int model_id = hyp_id*maxBasicSolutions + i;
+			goodCounts[model_id] = findInliers(m1, m2, &model_i, err[model_id],
+				tmask[model_id], reprojThreshold);
+		}
+	};
+
+	//! PROSAC state: size of the set of best points from which samples are currently drawn,
+	//! the expected no. of samples from it and the sample at which it is to be grown
+	int prosacN = modelPoints, prosacTnPrime = 1;
+	double prosacTn = maxIters;
+	if(use_prosac){
+		for(int i = 0; i < modelPoints; i++)
+			prosacTn *= (double)(modelPoints - i) / (count - i);
 	}
 
-	for(iter = 0; iter < niters; iter++) {
-		int i, goodCount, nmodels;
+	for(iter = 0; iter < niters;) {
+		int nhyp = MIN(batchSize, niters - iter), hyp_id;
+		bool subsetFailed = false;
 		if(count > modelPoints) {
-			bool found = getSubset(m1, m2, ms1, ms2, maxAttempts);
-			if(!found) {
+			for(hyp_id = 0; hyp_id < nhyp; hyp_id++) {
+				int nSamplePts = 0;
+				bool includeLast = false;
+				if(use_prosac) {
+					int sample_id = iter + hyp_id + 1;
+					while(prosacN < count && sample_id >= prosacTnPrime) {
+						double prosacTnNext = prosacTn * (prosacN + 1) / (prosacN + 1 - modelPoints);
+						prosacTnPrime += (int)ceil(prosacTnNext - prosacTn);
+						prosacTn = prosacTnNext;
+						prosacN++;
+					}
+					nSamplePts = prosacN;
+					includeLast = prosacTnPrime >= sample_id;
+				}
+				if(!getSubset(m1, m2, ms1[hyp_id], ms2[hyp_id], maxAttempts, nSamplePts, includeLast)) {
+					subsetFailed = true;
+					break;
+				}
+			}
+			if(hyp_id == 0) {
 				if(iter == 0)
 					return false;
 				break;
 			}
+			nhyp = hyp_id;
 		}
-
-		nmodels = runKernel(ms1, ms2, models);
-		if(nmodels <= 0)
-			continue;
-		for(i = 0; i < nmodels; i++) {
-			CvMat model_i;
-			cvGetRows(models, &model_i, i * modelSize.height, (i + 1)*modelSize.height);
-			goodCount = findInliers(m1, m2, &model_i, err, tmask, reprojThreshold);
-
-			if(goodCount > MAX(maxGoodCount, modelPoints - 1)) {
-				std::swap(tmask, mask);
-				cvCopy(&model_i, model);
-				maxGoodCount = goodCount;
-				niters = cvRANSACUpdateNumIters(confidence,
-					(double)(count - goodCount) / count, modelPoints, niters);
+		if(arena && nhyp > 1)
+			arena->run(nhyp, runHypothesis);
+		else
+			runHypothesis(0);
+
+		//! hypotheses are accepted in the order they were drawn and only as long as
+		//! the updated no. of iterations has not been reached
+		for(hyp_id = 0; hyp_id < nhyp && iter < niters; hyp_id++, iter++) {
+			for(int i = 0; i < nmodels[hyp_id]; i++) {
+				int model_id = hyp_id*maxBasicSolutions + i, goodCount = goodCounts[model_id];
+				if(goodCount > MAX(maxGoodCount, modelPoints - 1)) {
+					CvMat model_i;
+					cvGetRows(models[hyp_id], &model_i, i * modelSize.height, (i + 1)*modelSize.height);
+					std::swap(tmask[model_id], mask);
+					cvCopy(&model_i, model);
+					maxGoodCount = goodCount;
+					niters = cvRANSACUpdateNumIters(confidence,
+						(double)(count - goodCount) / count, modelPoints, niters);
+				}
 			}
 		}
+		if(subsetFailed)
+			break;
 	}
 
 	//printf("SSMEstimator::runRANSAC :: iter: %d\n", iter);
@@ -217,23 +285,28 @@ CvMat* mask, double confidence, int maxIters, int maxAttempts) {
 
 
 bool SSMEstimator::getSubset(const CvMat* m1, const CvMat* m2,
-	CvMat* ms1, CvMat* ms2, int maxAttempts) {
+	CvMat* ms1, CvMat* ms2, int maxAttempts, int n_sample_pts, bool include_last) {
 	cv::AutoBuffer<int> _idx(modelPoints);
 	int* idx = _idx;
 	int i = 0, j, k, idx_i, iters = 0;
 	int type = CV_MAT_TYPE(m1->type), elemSize = CV_ELEM_SIZE(type);
 	const int *m1ptr = m1->data.i, *m2ptr = m2->data.i;
 	int *ms1ptr = ms1->data.i, *ms2ptr = ms2->data.i;
-	int count = m1->cols * m1->rows;
+	int count = n_sample_pts > 0 ? n_sample_pts : m1->cols * m1->rows;
+	int n_random = include_last ? count - 1 : count;
 
 	assert(CV_IS_MAT_CONT(m1->type & m2->type) && (elemSize % sizeof(int) == 0));
 	elemSize /= sizeof(int);
 
-	boost::random::uniform_int_distribution<int> uni(0, count-1);
+	boost::random::uniform_int_distribution<int> uni(0, n_random - 1);
 
 	for(; iters < maxAttempts; iters++) {
 		for(i = 0; i < modelPoints && iters < maxAttempts;) {
-			idx[i] = idx_i = use_boost_rng ? uni(boost_rng) : cvRandInt(&cv_rng) % count;
+			if(include_last && i == 0)
+				idx_i = count - 1;
+			else
+				idx_i = use_boost_rng ? uni(boost_rng) : cvRandInt(&cv_rng) % n_random;
+			idx[i] = idx_i;
 			for(j = 0; j < i; j++)
 				if(idx_i == idx[j])
 					break;
@@ -11,6 +11,8 @@
 #define SSM_EST_REFINE true
 #define SSM_EST_LM_MAX_ITERS 10
 #define SSM_EST_CONFIDENCE 0.995
+#define SSM_EST_N_THREADS 1
+#define SSM_EST_USE_PROSAC false
 
 _MTF_BEGIN_NAMESPACE
 
@@ -41,7 +43,8 @@ int SSMEstimatorParams::toCV(EstType est_type){
 
 SSMEstimatorParams::SSMEstimatorParams(EstType _method, double _ransac_reproj_thresh,
 	int _n_model_pts, bool _refine, int _max_iters, int _max_subset_attempts,
-	bool  _use_boost_rng, double _confidence, int _lm_max_iters) :
+	bool  _use_boost_rng, double _confidence, int _lm_max_iters,
+	int _n_threads) :
 method(_method),
 ransac_reproj_thresh(_ransac_reproj_thresh),
 n_model_pts(_n_model_pts),
@@ -50,7 +53,9 @@ max_subset_attempts(_max_subset_attempts),
 use_boost_rng(_use_boost_rng),
 confidence(_confidence),
 refine(_refine),
-lm_max_iters(_lm_max_iters){
+lm_max_iters(_lm_max_iters),
+n_threads(_n_threads),
+use_prosac(SSM_EST_USE_PROSAC){
 	if(ransac_reproj_thresh <= 0){
 		ransac_reproj_thresh = 3;
 	}
@@ -66,7 +71,9 @@ max_subset_attempts(SSM_MAX_SUBSET_ATTEMPTS),
 use_boost_rng(SSM_USE_BOOST_RNG),
 confidence(SSM_EST_CONFIDENCE),
 refine(SSM_EST_REFINE),
-lm_max_iters(SSM_EST_LM_MAX_ITERS){
+lm_max_iters(SSM_EST_LM_MAX_ITERS),
+n_threads(SSM_EST_N_THREADS),
+use_prosac(SSM_EST_USE_PROSAC){
 	if(params){
 		method = params->method;
 		ransac_reproj_thresh = params->ransac_reproj_thresh;
@@ -77,6 +84,8 @@ lm_max_iters(SSM_EST_LM_MAX_ITERS){
 		confidence = params->confidence;
 		refine = params->refine;
 		lm_max_iters = params->lm_max_iters;
+		n_threads = params->n_threads;
+		use_prosac = params->use_prosac;
 	}
 	if(ransac_reproj_thresh <= 0){
 		ransac_reproj_thresh = 3;
@@ -93,5 +102,7 @@ void SSMEstimatorParams::print() const{
 	printf("confidence: %f\n", confidence);
 	printf("refine: %d\n", refine);
 	printf("lm_max_iters: %d\n", lm_max_iters);
+	printf("n_threads: %d\n", n_threads);
+	printf("use_prosac: %d\n", use_prosac);
 }
 _MTF_END_NAMESPACE
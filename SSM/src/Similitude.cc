@@ -120,8 +120,8 @@ void Similitude::compositionalUpdate(const VectorXd& state_update){
 	curr_corners.noalias() = curr_warp.topRows<2>() * init_corners_hm;
 }
 
-void Similitude :: getWarpFromState(Matrix3d &warp_mat, 
-	const VectorXd& ssm_state){
+void Similitude :: getWarpFromState(Matrix3d &warp_mat,
+	const Ref<const VectorXd> &ssm_state) const{
 	validate_ssm_state(ssm_state);
 
 	double tx = ssm_state(0);
@@ -552,7 +552,8 @@ int	Similitude::estimateSimilitude(const CvMat* in_pts, const CvMat* out_pts,
 		params.max_iters, params.max_subset_attempts);
 	else if(method == CV_RANSAC)
 		result = estimator.runRANSAC(in_pts_hm, out_pts_hm, &matH, tempMask, params.ransac_reproj_thresh,
-		params.confidence, params.max_iters, params.max_subset_attempts);
+		params.confidence, params.max_iters, params.max_subset_attempts,
+		params.n_threads, params.use_prosac);
 	else
 		result = estimator.runKernel(in_pts_hm, out_pts_hm, &matH) > 0;
 
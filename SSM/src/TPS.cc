@@ -76,7 +76,7 @@ void TPS::compositionalUpdate(const VectorXd& state_update){
 }
 
 void TPS::getWarpFromState(Matrix3d &warp_mat,
-	const VectorXd& ssm_state){
+	const Ref<const VectorXd> &ssm_state) const{
 	validate_ssm_state(ssm_state);
 
 	warp_mat(0, 0) = 1 + ssm_state(0);
@@ -1,4 +1,25 @@
-set(MTF_UTILITIES histUtils warpUtils imgUtils miscUtils graphUtils spiUtils inputUtils preprocUtils objUtils)
+set(MTF_UTILITIES histUtils warpUtils imgUtils miscUtils graphUtils spiUtils inputUtils preprocUtils objUtils simdUtils pyramidUtils parallelUtils)
 addPrefixAndSuffix("${MTF_UTILITIES}" "Utilities/src/" ".cc" MTF_UTILITIES_SRC)
 set(MTF_SRC ${MTF_SRC} ${MTF_UTILITIES_SRC})
 set(MTF_INCLUDE_DIRS ${MTF_INCLUDE_DIRS} Utilities/include)
+option(WITH_SIMD "Enable runtime dispatched SIMD kernels for pixel sampling and AM distances" ON)
+if(NOT WITH_SIMD)
+	set(MTF_DEFINITIONS ${MTF_DEFINITIONS} DISABLE_SIMD)
+endif()
+find_package(Threads REQUIRED)
+set(MTF_LIBS ${MTF_LIBS} ${CMAKE_THREAD_LIBS_INIT})
+option(WITH_TBB "Enable the TBB backend of the parallel executor used by all AMs, SMs and utilities" OFF)
+if(WITH_TBB)
+	find_library(TBB_LIBRARY tbb)
+	if(TBB_LIBRARY)
+		set(MTF_LIBS ${MTF_LIBS} ${TBB_LIBRARY})
+		set(MTF_DEFINITIONS ${MTF_DEFINITIONS} ENABLE_TBB)
+	else()
+		message(STATUS "TBB not found so the parallel executor will be built without it")
+	endif()
+endif()
+option(WITH_ALLOC_CHECK "Forbid heap allocations by Eigen while the templated SMs are updated; only SSD based AMs pass it (needs a Debug build)" OFF)
+if(WITH_ALLOC_CHECK)
+	list(REMOVE_ITEM MTF_DEFINITIONS NDEBUG EIGEN_NO_DEBUG)
+	set(MTF_DEFINITIONS ${MTF_DEFINITIONS} ENABLE_ALLOC_CHECK EIGEN_RUNTIME_NO_MALLOC)
+endif()
@@ -7,31 +7,38 @@ UTILITIES_HEADER_DIR = ${UTILITIES_INCLUDE_DIR}/mtf/Utilities
 
 MTF_INCLUDE_DIRS += ${UTILITIES_INCLUDE_DIR}
 
-UTILITIES = imgUtils warpUtils histUtils miscUtils spiUtils inputUtils preprocUtils objUtils
-UTILITIES_HEADER_ONLY = excpUtils mexUtils
+UTILITIES = imgUtils warpUtils histUtils miscUtils spiUtils inputUtils preprocUtils objUtils simdUtils pyramidUtils parallelUtils
+UTILITIES_HEADER_ONLY = excpUtils mexUtils rngUtils cacheUtils
 MTF_UTIL_OBJS = $(addprefix ${BUILD_DIR}/,$(addsuffix .o, ${UTILITIES}))
 MTF_UTIL_HEADERS = $(addprefix ${UTILITIES_HEADER_DIR}/, $(addsuffix .h, ${UTILITIES} ${UTILITIES_HEADER_ONLY}))
 
 MTF_HEADERS += ${MTF_UTIL_HEADERS}
 MTF_OBJS += ${MTF_UTIL_OBJS}
 
-HIST_FLAGS = 
+PARALLEL_FLAGS = 
 
-htbb ?= 0
+# build the parallel executor used by all AMs, SMs and utilities with TBB support;
+# OpenMP support is enabled with omp=1 and std::thread is always available
+tbb ?= 0
 pip ?= -1
 gip ?= -1
 hip ?= -1
 pbr ?= -1
 graph_utils ?= 1
+simd ?= 1
+# forbid heap allocations by Eigen while the templated SMs are updated; needs assertions so only works with o=0;
+# only SSD based AMs are currently allocation free so other AMs will fail the check
+alloc_check ?= 0
 
 ifeq (${vp}, 1)
 	MTF_LIBS += -lvisp_io -lvisp_sensor
 endif
 
-ifeq (${htbb}, 1)
-HIST_FLAGS += -D ENABLE_HIST_TBB
-MTF_RUNTIME_FLAGS += -D ENABLE_PARALLEL
+ifeq (${tbb}, 1)
+PARALLEL_FLAGS += -D ENABLE_TBB
+MTF_LIBS += -ltbb
 endif
+MTF_LIBS += -pthread
 
 ifeq (${regnet}, 1)
 UTILITIES += netUtils
@@ -43,6 +50,15 @@ MTF_COMPILETIME_FLAGS += -D DISABLE_GRAPH_UTILS
 MTF_RUNTIME_FLAGS += -D DISABLE_GRAPH_UTILS
 endif
 
+ifeq (${simd}, 0)
+MTF_COMPILETIME_FLAGS += -D DISABLE_SIMD
+endif
+
+ifeq (${alloc_check}, 1)
+MTF_COMPILETIME_FLAGS += -D ENABLE_ALLOC_CHECK -D EIGEN_RUNTIME_NO_MALLOC
+MTF_RUNTIME_FLAGS += -D ENABLE_ALLOC_CHECK -D EIGEN_RUNTIME_NO_MALLOC
+endif
+
 ifeq (${pip}, 0)
 MTF_COMPILETIME_FLAGS += -D PIX_INTERP_TYPE=utils::InterpType::Nearest
 else ifeq (${pip}, 1)
@@ -82,14 +98,17 @@ endif
 ${BUILD_DIR}/warpUtils.o: ${UTILITIES_SRC_DIR}/warpUtils.cc ${UTILITIES_HEADER_DIR}/warpUtils.h  ${UTILITIES_HEADER_DIR}/miscUtils.h ${UTILITIES_HEADER_DIR}/excpUtils.h ${MACROS_HEADER_DIR}/common.h
 	${CXX} -c ${MTF_PIC_FLAG} ${WARNING_FLAGS} ${OPT_FLAGS} ${PROF_FLAGS} ${MTF_COMPILETIME_FLAGS} ${MTF_INCLUDE_FLAGS} $< -o $@
 	
-${BUILD_DIR}/imgUtils.o: ${UTILITIES_SRC_DIR}/imgUtils.cc ${UTILITIES_HEADER_DIR}/imgUtils.h ${UTILITIES_HEADER_DIR}/warpUtils.h ${UTILITIES_HEADER_DIR}/excpUtils.h ${MACROS_HEADER_DIR}/common.h
+${BUILD_DIR}/imgUtils.o: ${UTILITIES_SRC_DIR}/imgUtils.cc ${UTILITIES_HEADER_DIR}/imgUtils.h ${UTILITIES_HEADER_DIR}/simdUtils.h ${UTILITIES_HEADER_DIR}/warpUtils.h ${UTILITIES_HEADER_DIR}/excpUtils.h ${MACROS_HEADER_DIR}/common.h
 	${CXX} -c ${MTF_PIC_FLAG} ${WARNING_FLAGS} ${OPT_FLAGS} ${PROF_FLAGS} ${MTF_COMPILETIME_FLAGS} ${MTF_INCLUDE_FLAGS} $< -o $@
 	
-${BUILD_DIR}/histUtils.o: ${UTILITIES_SRC_DIR}/histUtils.cc ${UTILITIES_HEADER_DIR}/histUtils.h ${UTILITIES_HEADER_DIR}/excpUtils.h ${UTILITIES_HEADER_DIR}/miscUtils.h ${MACROS_HEADER_DIR}/common.h 
-	${CXX} -c ${MTF_PIC_FLAG} ${WARNING_FLAGS} ${OPT_FLAGS} ${PROF_FLAGS} ${MTF_COMPILETIME_FLAGS} ${MTF_INCLUDE_FLAGS} ${HIST_FLAGS} $< -o $@	
+${BUILD_DIR}/simdUtils.o: ${UTILITIES_SRC_DIR}/simdUtils.cc ${UTILITIES_HEADER_DIR}/simdUtils.h ${UTILITIES_HEADER_DIR}/imgUtils.h ${UTILITIES_HEADER_DIR}/excpUtils.h ${MACROS_HEADER_DIR}/common.h
+	${CXX} -c ${MTF_PIC_FLAG} ${WARNING_FLAGS} ${OPT_FLAGS} ${PROF_FLAGS} ${MTF_COMPILETIME_FLAGS} ${MTF_INCLUDE_FLAGS} $< -o $@
+	
+${BUILD_DIR}/histUtils.o: ${UTILITIES_SRC_DIR}/histUtils.cc ${UTILITIES_HEADER_DIR}/histUtils.h ${UTILITIES_HEADER_DIR}/parallelUtils.h ${UTILITIES_HEADER_DIR}/excpUtils.h ${UTILITIES_HEADER_DIR}/miscUtils.h ${MACROS_HEADER_DIR}/common.h 
+	${CXX} -c ${MTF_PIC_FLAG} ${WARNING_FLAGS} ${OPT_FLAGS} ${PROF_FLAGS} ${MTF_COMPILETIME_FLAGS} ${MTF_INCLUDE_FLAGS} $< -o $@	
 	
 ${BUILD_DIR}/miscUtils.o: ${UTILITIES_SRC_DIR}/miscUtils.cc ${UTILITIES_HEADER_DIR}/miscUtils.h ${UTILITIES_HEADER_DIR}/excpUtils.h ${MACROS_HEADER_DIR}/common.h 
-	${CXX} -c ${MTF_PIC_FLAG} ${WARNING_FLAGS} ${OPT_FLAGS} ${PROF_FLAGS} ${MTF_COMPILETIME_FLAGS} ${MTF_INCLUDE_FLAGS} ${HIST_FLAGS} $< -o $@
+	${CXX} -c ${MTF_PIC_FLAG} ${WARNING_FLAGS} ${OPT_FLAGS} ${PROF_FLAGS} ${MTF_COMPILETIME_FLAGS} ${MTF_INCLUDE_FLAGS} $< -o $@
 
 ${BUILD_DIR}/netUtils.o: ${UTILITIES_SRC_DIR}/netUtils.cc  ${UTILITIES_HEADER_DIR}/netUtils.h ${MACROS_HEADER_DIR}/common.h  
 	${CXX} -c ${MTF_PIC_FLAG} ${WARNING_FLAGS} ${OPT_FLAGS} ${PROF_FLAGS} ${MTF_COMPILETIME_FLAGS} ${MTF_INCLUDE_FLAGS} ${CAFFE_FLAGS} $< -o $@	
@@ -106,6 +125,12 @@ ${BUILD_DIR}/inputUtils.o: ${UTILITIES_SRC_DIR}/inputUtils.cc ${UTILITIES_HEADER
 ${BUILD_DIR}/preprocUtils.o: ${UTILITIES_SRC_DIR}/preprocUtils.cc ${UTILITIES_HEADER_DIR}/preprocUtils.h ${UTILITIES_HEADER_DIR}/imgUtils.h  ${UTILITIES_HEADER_DIR}/excpUtils.h ${MACROS_HEADER_DIR}/common.h
 	${CXX} -c ${MTF_PIC_FLAG} ${WARNING_FLAGS} ${OPT_FLAGS} ${PROF_FLAGS} ${MTF_COMPILETIME_FLAGS} ${MTF_RUNTIME_FLAGS} ${MTF_INCLUDE_FLAGS} $< -o $@
 	
+${BUILD_DIR}/pyramidUtils.o: ${UTILITIES_SRC_DIR}/pyramidUtils.cc ${UTILITIES_HEADER_DIR}/pyramidUtils.h ${UTILITIES_HEADER_DIR}/parallelUtils.h ${MACROS_HEADER_DIR}/common.h
+	${CXX} -c ${MTF_PIC_FLAG} ${WARNING_FLAGS} ${OPT_FLAGS} ${PROF_FLAGS} ${MTF_COMPILETIME_FLAGS} ${MTF_INCLUDE_FLAGS} $< -o $@
+	
+${BUILD_DIR}/parallelUtils.o: ${UTILITIES_SRC_DIR}/parallelUtils.cc ${UTILITIES_HEADER_DIR}/parallelUtils.h ${MACROS_HEADER_DIR}/common.h
+	${CXX} -c ${MTF_PIC_FLAG} ${WARNING_FLAGS} ${OPT_FLAGS} ${PROF_FLAGS} ${MTF_COMPILETIME_FLAGS} ${MTF_INCLUDE_FLAGS} ${PARALLEL_FLAGS} -pthread $< -o $@
+	
 ${BUILD_DIR}/objUtils.o: ${UTILITIES_SRC_DIR}/objUtils.cc ${UTILITIES_HEADER_DIR}/objUtils.h ${UTILITIES_HEADER_DIR}/inputUtils.h ${UTILITIES_HEADER_DIR}/excpUtils.h ${MACROS_HEADER_DIR}/common.h
 	${CXX} -c ${MTF_PIC_FLAG} ${WARNING_FLAGS} ${OPT_FLAGS} ${PROF_FLAGS} ${MTF_COMPILETIME_FLAGS}  ${MTF_RUNTIME_FLAGS} ${MTF_INCLUDE_FLAGS} $< -o $@
 	
\ No newline at end of file
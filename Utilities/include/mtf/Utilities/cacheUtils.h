@@ -0,0 +1,142 @@
+#ifndef MTF_CACHE_UTILS_H
+#define MTF_CACHE_UTILS_H
+
+#include "mtf/Macros/common.h"
+#include <cstdint>
+#include <string>
+#include <utility>
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+_MTF_BEGIN_NAMESPACE
+namespace utils{
+	//! 64 bit FNV-1a hash of the given bytes; 
+	//! hashes of several buffers can be chained by passing the previous hash as the seed
+	inline uint64_t hashBytes(const void *data, size_t n_bytes,
+		uint64_t seed = 0xCBF29CE484222325ULL){
+		const unsigned char *bytes = static_cast<const unsigned char*>(data);
+		uint64_t hash = seed;
+		for(size_t byte_id = 0; byte_id < n_bytes; ++byte_id){
+			hash ^= bytes[byte_id];
+			hash *= 0x100000001B3ULL;
+		}
+		return hash;
+	}
+	//! rounds up the given offset to a multiple of the alignment
+	//! so that the arrays stored in cache files can be used in place
+	inline uint64_t alignOffset(uint64_t offset, uint64_t alignment = 64){
+		return (offset + alignment - 1) / alignment * alignment;
+	}
+	/**
+	memory mapped view of an entire file that is unmapped when the object is destroyed;
+	the pages are mapped copy on write so the contents can be passed to interfaces
+	that take non const pointers without ever modifying the file itself
+	*/
+	class MappedFile{
+	public:
+		MappedFile() : data(nullptr), size(0){
+#ifdef _WIN32
+			file_handle = mapping_handle = nullptr;
+#endif
+		}
+		~MappedFile(){ close(); }
+		MappedFile(const MappedFile&) = delete;
+		MappedFile& operator=(const MappedFile&) = delete;
+
+		//! returns false if the file does not exist, is empty or cannot be mapped
+		bool open(const std::string &file_path){
+			close();
+#ifdef _WIN32
+			file_handle = CreateFileA(file_path.c_str(), GENERIC_READ, FILE_SHARE_READ,
+				nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+			if(file_handle == INVALID_HANDLE_VALUE){
+				file_handle = nullptr;
+				return false;
+			}
+			LARGE_INTEGER file_size;
+			if(!GetFileSizeEx(file_handle, &file_size) || file_size.QuadPart <= 0){
+				close();
+				return false;
+			}
+			mapping_handle = CreateFileMappingA(file_handle, nullptr, PAGE_WRITECOPY, 0, 0, nullptr);
+			if(!mapping_handle){
+				close();
+				return false;
+			}
+			data = static_cast<char*>(MapViewOfFile(mapping_handle, FILE_MAP_COPY, 0, 0, 0));
+			if(!data){
+				close();
+				return false;
+			}
+			size = static_cast<size_t>(file_size.QuadPart);
+#else
+			int fd = ::open(file_path.c_str(), O_RDONLY);
+			if(fd < 0){ return false; }
+			struct stat file_stat;
+			if(fstat(fd, &file_stat) != 0 || file_stat.st_size <= 0){
+				::close(fd);
+				return false;
+			}
+			void *addr = mmap(nullptr, file_stat.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+			//! the mapping remains valid after the descriptor is closed
+			::close(fd);
+			if(addr == MAP_FAILED){ return false; }
+			data = static_cast<char*>(addr);
+			size = static_cast<size_t>(file_stat.st_size);
+#endif
+			return true;
+		}
+		void close(){
+#ifdef _WIN32
+			if(data){ UnmapViewOfFile(data); }
+			if(mapping_handle){ CloseHandle(mapping_handle); }
+			if(file_handle){ CloseHandle(file_handle); }
+			file_handle = mapping_handle = nullptr;
+#else
+			if(data){ munmap(data, size); }
+#endif
+			data = nullptr;
+			size = 0;
+		}
+		//! exchanges the mappings so that a newly mapped file can replace one still in use only after it has been validated
+		void swap(MappedFile &other){
+			std::swap(data, other.data);
+			std::swap(size, other.size);
+#ifdef _WIN32
+			std::swap(file_handle, other.file_handle);
+			std::swap(mapping_handle, other.mapping_handle);
+#endif
+		}
+		bool isOpen() const{ return data != nullptr; }
+		size_t getSize() const{ return size; }
+		//! pointer to the array of the given type stored at the given offset from the start of the file
+		template<typename ScalarT>
+		ScalarT* getData(uint64_t offset = 0) const{
+			return reinterpret_cast<ScalarT*>(data + offset);
+		}
+		//! checks if an array of the given size and type stored at the given offset lies entirely within the file
+		template<typename ScalarT>
+		bool contains(uint64_t offset, uint64_t n_elements) const{
+			return offset % alignof(ScalarT) == 0 && offset <= size &&
+				n_elements <= (size - offset) / sizeof(ScalarT);
+		}
+
+	private:
+		char *data;
+		size_t size;
+#ifdef _WIN32
+		HANDLE file_handle, mapping_handle;
+#endif
+	};
+}
+_MTF_END_NAMESPACE
+#endif
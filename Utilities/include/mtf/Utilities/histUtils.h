@@ -5,6 +5,8 @@
 
 #include "mtf/Macros/common.h"
 #include "mtf/Utilities/excpUtils.h"
+#include "mtf/Utilities/parallelUtils.h"
+#include <vector>
 
 // precomputed constants for BSpl function
 #define _1_BY_3 0.33333333333
@@ -302,6 +304,126 @@ namespace utils{
 		diff = -(temp * temp) / 2;
 		val = -(diff * temp) / 3;
 	}
+
+	/**
+	lookup table based evaluation of the cubic BSpline function, its cumulative version
+	and their first and second order derivatives;
+	since the bins to which a pixel contributes are offset by integers from its value,
+	only the fractional part of the argument matters and the support [-2, 2] is sampled at
+	n_steps points per unit with each argument being linearly interpolated between the two nearest samples;
+	as the knots of the functions lie on the samples, each function is a single polynomial between
+	any two samples so the error is at most 3 / (8 * n_steps^2) (see getMaxError);
+	this replaces the data dependent branches of the exact functions with a single clamped
+	table lookup and each function has its own table (SoA layout);
+	the exact functions are used if n_steps is 0; the choice is made once in resize by selecting
+	the member functions that are called rather than being checked in every call
+	*/
+	class BSpl3LUT{
+	public:
+		BSpl3LUT() : n_steps(0), step_mult(0), max_idx(0){ selectFuncs(); }
+		//! n_steps: no. of sub bin steps in each unit interval; 0 disables the tables
+		void resize(unsigned int n_steps);
+		unsigned int getNSteps() const{ return n_steps; }
+		bool isExact() const{ return n_steps == 0; }
+		//! upper bound on the absolute difference between any of the interpolated functions and the exact one
+		double getMaxError() const{ return n_steps ? 3.0 / (8.0 * n_steps * n_steps) : 0; }
+
+		double bSpl3(double x) const{ return (this->*bspl3_func)(x); }
+		double bSpl3Grad(double x) const{ return (this->*bspl3_grad_func)(x); }
+		double bSpl3Hess(double x) const{ return (this->*bspl3_hess_func)(x); }
+		void bSpl3WithGrad(double &_val, double &_diff, double x) const{
+			(this->*bspl3_with_grad_func)(_val, _diff, x);
+		}
+		double cumBSpl3(double x) const{ return (this->*cum_bspl3_func)(x); }
+		double cumBSpl3Hess(double x) const{ return (this->*cum_bspl3_hess_func)(x); }
+		void cumBSpl3WithGrad(double &_val, double &_diff, double x) const{
+			(this->*cum_bspl3_with_grad_func)(_val, _diff, x);
+		}
+
+	private:
+		typedef double(BSpl3LUT::*FuncPtr)(double) const;
+		typedef void(BSpl3LUT::*FuncWithGradPtr)(double &, double &, double) const;
+
+		unsigned int n_steps;
+		double step_mult;
+		int max_idx;
+		std::vector<double> val, grad, hess;
+		std::vector<double> cum_val, cum_grad, cum_hess;
+		FuncPtr bspl3_func, bspl3_grad_func, bspl3_hess_func;
+		FuncPtr cum_bspl3_func, cum_bspl3_hess_func;
+		FuncWithGradPtr bspl3_with_grad_func, cum_bspl3_with_grad_func;
+
+		//! points the public functions to either the exact functions or the table lookups
+		void selectFuncs();
+		//! index of the sample at or before x and the fractional distance of x from it
+		//! with arguments outside [-2, 2] mapped to the end points
+		int getIdx(double x, double &frac) const{
+			double pos = (x + 2)*step_mult;
+			if(pos <= 0){
+				frac = 0;
+				return 0;
+			}
+			int idx = static_cast<int>(pos);
+			if(idx >= max_idx){
+				frac = 1;
+				return max_idx - 1;
+			}
+			frac = pos - idx;
+			return idx;
+		}
+		static double interp(const std::vector<double> &table, int idx, double frac){
+			return table[idx] + frac*(table[idx + 1] - table[idx]);
+		}
+		double lutBSpl3(double x) const{
+			double frac;
+			int idx = getIdx(x, frac);
+			return interp(val, idx, frac);
+		}
+		double lutBSpl3Grad(double x) const{
+			double frac;
+			int idx = getIdx(x, frac);
+			return interp(grad, idx, frac);
+		}
+		double lutBSpl3Hess(double x) const{
+			double frac;
+			int idx = getIdx(x, frac);
+			return interp(hess, idx, frac);
+		}
+		void lutBSpl3WithGrad(double &_val, double &_diff, double x) const{
+			double frac;
+			int idx = getIdx(x, frac);
+			_val = interp(val, idx, frac);
+			_diff = interp(grad, idx, frac);
+		}
+		double lutCumBSpl3(double x) const{
+			double frac;
+			int idx = getIdx(x, frac);
+			return interp(cum_val, idx, frac);
+		}
+		double lutCumBSpl3Hess(double x) const{
+			double frac;
+			int idx = getIdx(x, frac);
+			return interp(cum_hess, idx, frac);
+		}
+		void lutCumBSpl3WithGrad(double &_val, double &_diff, double x) const{
+			double frac;
+			int idx = getIdx(x, frac);
+			_val = interp(cum_val, idx, frac);
+			_diff = interp(cum_grad, idx, frac);
+		}
+		double exactBSpl3(double x) const{ return utils::bSpl3(x); }
+		double exactBSpl3Grad(double x) const{ return utils::bSpl3Grad(x); }
+		double exactBSpl3Hess(double x) const{ return utils::bSpl3Hess(x); }
+		void exactBSpl3WithGrad(double &_val, double &_diff, double x) const{
+			utils::bSpl3WithGrad(_val, _diff, x);
+		}
+		double exactCumBSpl3(double x) const{ return utils::cumBSpl3(x); }
+		double exactCumBSpl3Hess(double x) const{ return utils::cumBSpl3Hess(x); }
+		void exactCumBSpl3WithGrad(double &_val, double &_diff, double x) const{
+			utils::cumBSpl3WithGrad(_val, _diff, x);
+		}
+	};
+
 	/**
 	computes histogram using the Dirac delta function to determine the bins to which each pixel contributes,
 	i.e. each pixel has a unit contribution to the bin corresponding to the floor (or nearest integer) of its value;
@@ -601,8 +723,102 @@ namespace utils{
 		int n_pix, double hist_norm_mult
 		);
 
+	//---------------------------------------------------------------------------------------------------//
+	//------------------------ Thread private histograms for parallel accumulation ----------------------//
+	//---------------------------------------------------------------------------------------------------//
+
+	/**
+	accumulates histograms and any other quantities that are summed over the pixels (e.g. their gradients)
+	in parallel without any shared writes; the pixels are divided into a fixed number of contiguous parts
+	each of which is accumulated into its own buffer by a single thread; the buffers are then added up
+	pairwise in a fixed order (tree reduction) so that the result depends only on the number of parts
+	and not on the scheduling or the number of threads actually used;
+	each buffer starts at a cache line boundary to avoid false sharing between threads;
+	the parts are processed in parallel by the TaskArena passed to accumulate or serially if none is passed
+	*/
+	class ParallelHist{
+	public:
+		ParallelHist() : n_vals(0), n_parts(0), stride(0), offset(0){}
+		//! n_vals: no. of values accumulated in each buffer; n_parts: no. of parts the pixels are divided into
+		void resize(unsigned int n_vals, unsigned int n_parts);
+		unsigned int getNVals() const{ return n_vals; }
+		unsigned int getNParts() const{ return n_parts; }
+		/**
+		calls accum_func(buffer, start_id, end_id) for each part with a zeroed buffer and the range [start_id, end_id)
+		of pixels assigned to it and returns the sum of all the buffers which remains valid till the next call
+		*/
+		template<typename AccumFuncT>
+		const double* accumulate(unsigned int n_pix, const AccumFuncT &accum_func,
+			TaskArena *task_arena = nullptr);
+
+	private:
+		unsigned int n_vals, n_parts;
+		//! no. of values between the starts of consecutive buffers
+		unsigned int stride;
+		//! no. of values skipped at the start of the storage to align the first buffer
+		unsigned int offset;
+		std::vector<double> storage;
+
+		double* getBuffer(unsigned int part_id){ return storage.data() + offset + part_id*stride; }
+		unsigned int getStartId(unsigned int part_id, unsigned int n_pix) const{
+			return static_cast<unsigned int>(static_cast<unsigned long long>(n_pix)*part_id / n_parts);
+		}
+		//! adds all the buffers to the first one in a fixed pairwise order
+		void reduce();
+	};
+	template<typename AccumFuncT>
+	const double* ParallelHist::accumulate(unsigned int n_pix, const AccumFuncT &accum_func,
+		TaskArena *task_arena){
+		assert(n_parts > 0);
+		auto accumPart = [&](int part_id){
+			double *buffer = getBuffer(part_id);
+			std::fill(buffer, buffer + n_vals, 0.0);
+			accum_func(buffer, getStartId(part_id, n_pix), getStartId(part_id + 1, n_pix));
+		};
+		if(task_arena){
+			task_arena->run(n_parts, accumPart);
+		} else{
+			for(unsigned int part_id = 0; part_id < n_parts; ++part_id){ accumPart(part_id); }
+		}
+		reduce();
+		return getBuffer(0);
+	}
+	/**
+	versions of the histogram functions above that accumulate the pixels in parallel using hist_accum
+	which must have been resized to hold 2*n_bins + n_bins*n_bins values, that is both the marginal
+	histograms followed by the joint histogram; the per pixel outputs of getBSplJointHist are written directly
+	*/
+	void getDiracJointHist(MatrixXd &joint_hist, VectorXd &hist1, VectorXd &hist2,
+		const VectorXd &pix_vals1, const VectorXd &pix_vals2,
+		double hist_pre_seed, double joint_hist_pre_seed, int n_pix, int n_bins,
+		ParallelHist &hist_accum, TaskArena *task_arena);
+	void getBilinearJointHist(MatrixXd &joint_hist, VectorXd &hist1, VectorXd &hist2,
+		const VectorXd &pix_vals1, const VectorXd &pix_vals2,
+		double hist_pre_seed, double joint_hist_pre_seed, int n_pix, int n_bins,
+		ParallelHist &hist_accum, TaskArena *task_arena);
+	//! only the first histogram is computed here so hist_accum only needs n_bins + n_bins*n_bins values
+	void getBSplJointHist(MatrixXd &joint_hist, VectorXd &hist1,
+		MatrixXd &hist1_mat, MatrixX2i &bspl_ids1,
+		const VectorXd &pix_vals1, const MatrixX2i &bspl_ids2,
+		const MatrixXd &hist2_mat, const MatrixX2i &std_bspl_ids,
+		double hist_pre_seed, double joint_hist_pre_seed, int n_pix,
+		ParallelHist &hist_accum, TaskArena *task_arena);
+	//! hist_accum only needs to hold n_bins values here
+	void getBSplHistWithGrad(VectorXd &hist, MatrixXd &hist_mat,
+		MatrixXd &hist_grad, MatrixX2i &bspl_ids,
+		const VectorXd &pix_vals, const MatrixX2i &std_bspl_ids,
+		double pre_seed, int n_pix, double hist_norm_mult,
+		ParallelHist &hist_accum, TaskArena *task_arena);
+
 	// histogram validation functions for debugging
 
+	/**
+	compares the lookup table based BSpline functions with the exact ones at n_samples uniformly spaced
+	points in [-2, 2] and prints the maximum absolute difference for each function along with
+	the bound given by BSpl3LUT::getMaxError; returns the largest of these differences
+	*/
+	double validateBSpl3LUT(const BSpl3LUT &bspl_lut, unsigned int n_samples = 100000);
+
 	void validateJointHist(const MatrixXd &joint_hist, 
 		const VectorXd &hist1, const VectorXd &hist2);
 
@@ -216,6 +216,48 @@ namespace utils{
 	// of this surface thus eliminating the need for finite difference approximations
 	void getImgHess(PixHessT &img_hess, const EigImgT &img,
 		const PtsT &pts, unsigned int n_pix, unsigned int h, unsigned int w);
+	/**
+	computes the pixel values along with the warp of the image gradient and, optionally, Hessian
+	at the given points in a single pass so that the neighbourhood of each point is fetched from
+	memory only once rather than once each for the values, gradient and Hessian;
+	the results are identical to those of getPixVals, getImgGrad and getImgHess above;
+	either of img_grad and img_hess can be null if it is not needed
+	*/
+	void getPixValsGradHess(VectorXd &pix_vals, PixGradT *img_grad, PixHessT *img_hess,
+		const EigImgT &img, const PtsT &pts, double grad_eps, double hess_eps,
+		unsigned int n_pix, unsigned int h, unsigned int w,
+		double norm_mult = 1, double norm_add = 0);
+
+	/******* functions using image derivatives precomputed once per frame ***********/
+
+	//! first order derivatives of the image computed using central differences;
+	//! the outputs are of float type with the same number of channels as the image
+	void getImgDerivatives(cv::Mat &img_dx, cv::Mat &img_dy, const cv::Mat &img);
+	//! second order derivatives of the image computed using central differences
+	void getImgSecondDerivatives(cv::Mat &img_dxx, cv::Mat &img_dxy, cv::Mat &img_dyy,
+		const cv::Mat &img);
+	//! the following functions use bilinear interpolation of the precomputed derivatives
+	//! rather than finite differences of interpolated pixel values;
+	//! derivatives at points lying outside the image are taken to be zero
+	//! warp of the image gradient
+	void getImgGrad(PixGradT &img_grad, const cv::Mat &img_dx, const cv::Mat &img_dy,
+		const PtsT &pts, unsigned int n_pix, unsigned int h, unsigned int w,
+		double pix_mult_factor = 1.0);
+	//! gradient of the warped image obtained using the chain rule with the Jacobian of the warp
+	//! estimated from the warped offset points
+	void getWarpedImgGrad(PixGradT &warped_img_grad, const cv::Mat &img_dx, const cv::Mat &img_dy,
+		const GradPtsT &warped_offset_pts, double grad_eps, unsigned int n_pix,
+		unsigned int h, unsigned int w, double pix_mult_factor = 1.0);
+	//! warp of the image hessian
+	void getImgHess(PixHessT &img_hess, const cv::Mat &img_dxx, const cv::Mat &img_dxy,
+		const cv::Mat &img_dyy, const PtsT &pts, unsigned int n_pix,
+		unsigned int h, unsigned int w, double pix_mult_factor = 1.0);
+	//! hessian of the warped image obtained using the chain rule with the first and second order
+	//! derivatives of the warp estimated from the warped offset points
+	void getWarpedImgHess(PixHessT &warped_img_hess, const cv::Mat &img_dx, const cv::Mat &img_dy,
+		const cv::Mat &img_dxx, const cv::Mat &img_dxy, const cv::Mat &img_dyy,
+		const PtsT &warped_pts, const HessPtsT &warped_offset_pts, double hess_eps,
+		unsigned int n_pix, unsigned int h, unsigned int w, double pix_mult_factor = 1.0);
 
 	namespace sc{
 
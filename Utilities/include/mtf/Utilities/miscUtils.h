@@ -330,6 +330,49 @@ namespace utils{
 	}
 	void drawCorners(cv::Mat &img, const cv::Point2d(&cv_corners)[4],
 		const cv::Scalar corners_col, const std::string label);
+	/**
+	computes alpha * J^T * J for an N x S Jacobian J and writes it to prod or,
+	if accumulate is true, adds it to prod; this is the main part of the first order Hessian
+	in Gauss Newton type methods; kernels with the state size known at compile time are
+	used for the state sizes of all the SSMs with a fixed number of parameters
+	which operate on blocks of rows that fit in the L1 cache and compute only half of the symmetric product
+	*/
+	void getJacobianProduct(MatrixXd &prod, const MatrixXd &jacobian,
+		double alpha = 1, bool accumulate = false);
+	//! product of a single precision Jacobian where the product of each block of its rows is computed
+	//! in single precision but the products of all the blocks are summed in double precision
+	void getJacobianProduct(MatrixXd &prod, const MatrixXf &jacobian,
+		double alpha = 1, bool accumulate = false);
+	//! computes alpha * v * J for a 1 x N vector v and a single precision N x S Jacobian J in the same way
+	void getJacobianVecProduct(RowVectorXd &prod, const RowVectorXd &vec, const MatrixXf &jacobian,
+		double alpha = 1, bool accumulate = false);
+	/**
+	forbids Eigen from allocating any heap memory while it is in scope if enable is true
+	so that every such allocation fails an assertion at the point where it is made;
+	this does nothing unless MTF is compiled with alloc_check=1 (WITH_ALLOC_CHECK=ON)
+	and assertions enabled; the underlying flag is shared by all threads so trackers
+	that are updated in parallel cannot be checked this way;
+	SMs only enable it from the second frame onwards since some of their workspaces are sized in the first one
+	*/
+	class AllocGuard{
+	public:
+		explicit AllocGuard(bool enable = true){
+#ifdef ENABLE_ALLOC_CHECK
+			// set_is_malloc_allowed returns the new value rather than the previous one
+			prev_allowed = Eigen::internal::is_malloc_allowed();
+			Eigen::internal::set_is_malloc_allowed(!enable);
+#endif
+		}
+		~AllocGuard(){
+#ifdef ENABLE_ALLOC_CHECK
+			Eigen::internal::set_is_malloc_allowed(prev_allowed);
+#endif
+		}
+	private:
+#ifdef ENABLE_ALLOC_CHECK
+		bool prev_allowed;
+#endif
+	};
 	// mask a vector, i.e. retain only those entries where the given mask is true
 	void maskVector(VectorXd &masked_vec, const VectorXd &in_vec,
 		const VectorXb &mask, int masked_size, int in_size);
@@ -0,0 +1,112 @@
+#ifndef MTF_PARALLEL_UTILS_H
+#define MTF_PARALLEL_UTILS_H
+
+#include "mtf/Macros/common.h"
+#include <memory>
+#include <vector>
+#include <functional>
+
+_MTF_BEGIN_NAMESPACE
+namespace utils{
+	/**
+	libraries that can be used for running the tasks of a TaskArena;
+	OpenMP and TBB are only available if parallelUtils.cc is compiled with ENABLE_OMP and ENABLE_TBB respectively
+	and fall back to Threads otherwise; Threads uses a pool of std::thread workers and is always available;
+	Default uses the process wide backend set with TaskArena::setDefaultBackend
+	*/
+	enum class ParallelBackend{ Default, Serial, OpenMP, TBB, Threads };
+	/**
+	executor used by all the parallel code in the AMs, SMs and utilities;
+	the worker threads are shared by all arenas in the process with the same backend, no. of threads and pinning
+	so creating one for each tracker does not create more threads;
+	tasks are run serially in the calling thread if it is already running a task of any arena
+	or is inside an OpenMP parallel region so nested parallel loops, e.g. the pixel loops of an AM whose tracker
+	is one of several running in parallel, do not oversubscribe the cores;
+	the layout of this class does not depend on the backend so it can be used in headers too
+	*/
+	class TaskArena{
+	public:
+		typedef std::shared_ptr<TaskArena> Ptr;
+		/**
+		n_threads <= 0 uses all the available cores;
+		if pin_threads is true, each thread is bound to a different core while it is in the arena (TBB and Threads on Linux only);
+		grain_size is the no. of iterations of parallelFor and parallelReduce that are run as one task;
+		grain_size <= 0 divides the iterations evenly among the threads
+		*/
+		TaskArena(int _n_threads = 0, bool pin_threads = false,
+			ParallelBackend _backend = ParallelBackend::Default, int _grain_size = 0);
+		~TaskArena();
+		int getNThreads() const{ return n_threads; }
+		int getGrainSize() const{ return grain_size; }
+		//! backend actually in use which is Serial if there is only one thread
+		ParallelBackend getBackend() const{ return backend; }
+		//! runs func(task_id) for all task_id in [0, n_tasks) and returns after all of them have finished
+		template<typename FuncT>
+		void run(int n_tasks, const FuncT &func){
+			execute(n_tasks, [&](int task_id){ func(task_id); });
+		}
+		/**
+		divides [begin, end) into contiguous chunks and calls func(chunk_begin, chunk_end) for each;
+		the chunks depend only on the range, the no. of threads and the grain size
+		*/
+		template<typename FuncT>
+		void parallelFor(int begin, int end, const FuncT &func){
+			if(end <= begin){ return; }
+			int n_chunks = getNChunks(end - begin);
+			if(n_chunks == 1){
+				func(begin, end);
+				return;
+			}
+			execute(n_chunks, [&](int chunk_id){
+				func(getChunkStart(begin, end, n_chunks, chunk_id),
+					getChunkStart(begin, end, n_chunks, chunk_id + 1));
+			});
+		}
+		/**
+		computes map_func(chunk_begin, chunk_end) for the same chunks as parallelFor and combines the results
+		with reduce_func in the order of the chunks so that the result does not depend on the scheduling
+		*/
+		template<typename ValT, typename MapFuncT, typename ReduceFuncT>
+		ValT parallelReduce(int begin, int end, const ValT &identity,
+			const MapFuncT &map_func, const ReduceFuncT &reduce_func){
+			if(end <= begin){ return identity; }
+			int n_chunks = getNChunks(end - begin);
+			if(n_chunks == 1){ return reduce_func(identity, map_func(begin, end)); }
+			std::vector<ValT> chunk_vals(n_chunks, identity);
+			execute(n_chunks, [&](int chunk_id){
+				chunk_vals[chunk_id] = map_func(getChunkStart(begin, end, n_chunks, chunk_id),
+					getChunkStart(begin, end, n_chunks, chunk_id + 1));
+			});
+			ValT val = identity;
+			for(int chunk_id = 0; chunk_id < n_chunks; ++chunk_id){
+				val = reduce_func(val, chunk_vals[chunk_id]);
+			}
+			return val;
+		}
+		//! true if the calling thread is running a task of some arena or is inside an OpenMP parallel region
+		static bool inParallelRegion();
+		static int getNCores();
+		//! backend used by arenas created with ParallelBackend::Default after this is called
+		static void setDefaultBackend(ParallelBackend _backend);
+		static ParallelBackend getDefaultBackend();
+		static const char* toString(ParallelBackend _backend);
+
+	private:
+		struct Pool;
+		int n_threads, grain_size;
+		ParallelBackend backend;
+		std::shared_ptr<Pool> pool;
+
+		//! runs task_func(task_id) for all task_id in [0, n_tasks) using the backend
+		void execute(int n_tasks, const std::function<void(int)> &task_func);
+		int getNChunks(int n_iters) const{
+			int n_chunks = grain_size > 0 ? (n_iters + grain_size - 1) / grain_size : n_threads;
+			return n_chunks < n_iters ? n_chunks : n_iters;
+		}
+		static int getChunkStart(int begin, int end, int n_chunks, int chunk_id){
+			return begin + static_cast<int>(static_cast<long long>(end - begin)*chunk_id / n_chunks);
+		}
+	};
+}
+_MTF_END_NAMESPACE
+#endif
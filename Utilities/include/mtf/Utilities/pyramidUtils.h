@@ -0,0 +1,82 @@
+#ifndef MTF_PYRAMID_UTILS_H
+#define MTF_PYRAMID_UTILS_H
+
+#include "mtf/Macros/common.h"
+#include "opencv2/core/core.hpp"
+#include <map>
+#include <tuple>
+#include <mutex>
+#include <memory>
+
+_MTF_BEGIN_NAMESPACE
+namespace utils{
+	class TaskArena;
+	/**
+	builds levels 1 to img_pyramid.size() - 1 from level 0 which must already be set;
+	a scale factor of 0.5 uses cv::pyrDown while any other one uses resize followed by Gaussian blurring;
+	if roi is non empty, only the part of each level that corresponds to this region of level 0
+	is recomputed and the remaining pixels are left as they were;
+	the Mat of each level is reused as long as its size and type do not change
+	*/
+	void buildImagePyramid(vector<cv::Mat> &img_pyramid, double scale_factor,
+		const cv::Rect &roi = cv::Rect(), int blur_size = 5, double blur_sigma = 3);
+
+	/**
+	frame scoped cache of image pyramids that can be shared between all the trackers
+	running on the same frame so that each pyramid is only built once per frame
+	regardless of how many trackers use it;
+	pyramids are keyed by the source image buffer, its type and the scale and blur parameters;
+	the owner must call update() once for every new frame before any of the trackers are updated;
+	all functions are thread safe
+	*/
+	class ImagePyramidCache{
+	public:
+		typedef std::shared_ptr<ImagePyramidCache> Ptr;
+		//! pyramids are only built within roi_margin pixels of the ROI set with setROI;
+		//! a negative value always builds complete pyramids;
+		//! n_threads is the no. of threads used for building several pyramids at the same time
+		ImagePyramidCache(int roi_margin = -1, int n_threads = 0);
+		/**
+		marks all pyramids as stale and optionally restricts them to the given ROI in the source images;
+		if prebuild is true, all pyramids that were used in the last frame are then
+		built in parallel with each other so that the trackers only need to retrieve them;
+		pyramids that were not used since the last call are discarded
+		*/
+		void update(int frame_id, const cv::Rect &roi = cv::Rect(), bool prebuild = true);
+		/**
+		fills img_pyramid with img_pyramid.size() levels of the pyramid of img for the current frame
+		and builds it if this has not already been done;
+		the returned levels point to buffers owned by the cache that are reused in subsequent frames
+		so their data pointers only change if the size or type of the source image does;
+		if there is no current frame yet, the pyramid is built every time this is called
+		*/
+		void getPyramid(vector<cv::Mat> &img_pyramid, const cv::Mat &img, double scale_factor,
+			int blur_size = 5, double blur_sigma = 3);
+		int getFrameID() const{ return frame_id; }
+		//! bounding box of all the given regions in the format returned by TrackerBase::getRegion
+		static cv::Rect getBoundingBox(const vector<cv::Mat> &regions);
+
+	private:
+		typedef std::tuple<const uchar*, int, double, int, double> KeyT;
+		struct Entry{
+			cv::Mat img;
+			double scale_factor;
+			int blur_size;
+			double blur_sigma;
+			vector<cv::Mat> levels;
+			//! frame for which the levels were last built and the one in which they were last used
+			int built_frame_id, used_frame_id;
+			std::mutex mutex;
+		};
+		std::map<KeyT, std::shared_ptr<Entry> > entries;
+		std::mutex entries_mutex;
+		int frame_id;
+		cv::Rect roi;
+		int roi_margin;
+		std::shared_ptr<TaskArena> task_arena;
+
+		void buildEntry(Entry &entry, int n_levels, int curr_frame_id, const cv::Rect &curr_roi);
+	};
+}
+_MTF_END_NAMESPACE
+#endif
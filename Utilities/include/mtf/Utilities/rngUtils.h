@@ -0,0 +1,122 @@
+#ifndef MTF_RNG_UTILS_H
+#define MTF_RNG_UTILS_H
+
+#include "mtf/Macros/common.h"
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+
+_MTF_BEGIN_NAMESPACE
+namespace utils{
+	/**
+	counter based random number generator (Philox4x32-10) where each block of 4 outputs is a bijective
+	function of a 128 bit counter under a 64 bit key so that there is no state to carry over between samples;
+	the upper half of the counter identifies the stream and the lower half the position within it
+	so independent streams can be obtained simply by using different stream IDs (e.g. particle indices)
+	which makes the samples independent of the order in which they are drawn or the thread drawing them;
+	satisfies the UniformRandomNumberGenerator requirements so it can be used with the Boost and STL distributions
+	Salmon, J. K. et al., Parallel random numbers: as easy as 1, 2, 3, SC 2011
+	*/
+	class Philox4x32{
+	public:
+		typedef uint32_t result_type;
+
+		explicit Philox4x32(uint64_t key = 0, uint64_t stream_id = 0){ seed(key, stream_id); }
+		//! key is generated from a seed sequence for compatibility with the Boost engines
+		template<class SeedSeq>
+		explicit Philox4x32(SeedSeq &seed_seq){ seed(seed_seq); }
+
+		void seed(uint64_t key, uint64_t stream_id = 0){
+			key_lo = static_cast<uint32_t>(key);
+			key_hi = static_cast<uint32_t>(key >> 32);
+			setStream(stream_id);
+		}
+		template<class SeedSeq>
+		void seed(SeedSeq &seed_seq){
+			uint32_t key[2];
+			seed_seq.generate(key, key + 2);
+			seed(static_cast<uint64_t>(key[0]) | (static_cast<uint64_t>(key[1]) << 32));
+		}
+		//! restarts the generator at the beginning of the given stream without changing the key
+		void setStream(uint64_t stream_id){
+			ctr[0] = ctr[1] = 0;
+			ctr[2] = static_cast<uint32_t>(stream_id);
+			ctr[3] = static_cast<uint32_t>(stream_id >> 32);
+			out_id = 4;
+		}
+		result_type operator()(){
+			if(out_id == 4){
+				generateBlock();
+				out_id = 0;
+			}
+			return out[out_id++];
+		}
+		void discard(unsigned long long n_vals){
+			for(unsigned long long val_id = 0; val_id < n_vals; ++val_id){ (*this)(); }
+		}
+		static constexpr result_type min(){ return 0; }
+		static constexpr result_type max(){ return std::numeric_limits<result_type>::max(); }
+
+	private:
+		uint32_t key_lo, key_hi;
+		uint32_t ctr[4], out[4];
+		unsigned int out_id;
+
+		void generateBlock(){
+			uint32_t x0 = ctr[0], x1 = ctr[1], x2 = ctr[2], x3 = ctr[3];
+			uint32_t k0 = key_lo, k1 = key_hi;
+			for(int round_id = 0; round_id < 10; ++round_id){
+				uint64_t prod0 = static_cast<uint64_t>(0xD2511F53u) * x0;
+				uint64_t prod1 = static_cast<uint64_t>(0xCD9E8D57u) * x2;
+				x0 = static_cast<uint32_t>(prod1 >> 32) ^ x1 ^ k0;
+				x1 = static_cast<uint32_t>(prod1);
+				x2 = static_cast<uint32_t>(prod0 >> 32) ^ x3 ^ k1;
+				x3 = static_cast<uint32_t>(prod0);
+				k0 += 0x9E3779B9u;
+				k1 += 0xBB67AE85u;
+			}
+			out[0] = x0;
+			out[1] = x1;
+			out[2] = x2;
+			out[3] = x3;
+			//! only the lower half of the counter is incremented so the stream ID is never changed
+			if(++ctr[0] == 0){ ++ctr[1]; }
+		}
+	};
+	/**
+	draws from DefaultGenT until a stream is selected with seed(key, stream_id) and from a
+	Philox4x32 stream after that so that samplers keep their usual generator unless
+	they explicitly opt in to counter based streams;
+	DefaultGenT must produce 32 bit values and be constructible from a seed sequence
+	*/
+	template<class DefaultGenT>
+	class StreamableGen{
+	public:
+		typedef uint32_t result_type;
+		static_assert(std::is_same<typename DefaultGenT::result_type, result_type>::value,
+			"StreamableGen requires a 32 bit default generator");
+
+		StreamableGen() : use_stream(false){}
+		template<class SeedSeq>
+		explicit StreamableGen(SeedSeq &seed_seq) : default_gen(seed_seq), use_stream(false){}
+
+		//! switches to the given Philox stream
+		void seed(uint64_t key, uint64_t stream_id){
+			stream_gen.seed(key, stream_id);
+			use_stream = true;
+		}
+		result_type operator()(){
+			return use_stream ? stream_gen() : static_cast<result_type>(default_gen());
+		}
+		bool usingStream() const{ return use_stream; }
+		static constexpr result_type min(){ return 0; }
+		static constexpr result_type max(){ return std::numeric_limits<result_type>::max(); }
+
+	private:
+		DefaultGenT default_gen;
+		Philox4x32 stream_gen;
+		bool use_stream;
+	};
+}
+_MTF_END_NAMESPACE
+#endif
@@ -0,0 +1,52 @@
+#ifndef MTF_SIMD_UTILS_H
+#define MTF_SIMD_UTILS_H
+
+#include "mtf/Macros/common.h"
+
+_MTF_BEGIN_NAMESPACE
+namespace utils{
+	namespace simd{
+		//! instruction sets for which vectorized kernels are available
+		enum class ISA{ Scalar, AVX2, AVX512 };
+		const char* toString(ISA isa);
+		//! best instruction set supported by both the build and the CPU we are running on;
+		//! detected once using CPUID and cached thereafter
+		ISA getSupportedISA();
+		//! instruction set actually used by the kernels below;
+		//! defaults to the supported one but can be lowered for debugging or benchmarking
+		ISA getActiveISA();
+		//! returns the ISA that was actually set which is the lower of the requested and supported ones
+		ISA setActiveISA(ISA isa);
+
+		/**
+		bilinear interpolation with constant border over a single channel float image;
+		gives results that are bit-identical to getPixVal<Linear, Constant> since
+		all arithmetic is done in double precision in exactly the same order
+		*/
+		void getPixValsLinear(VectorXd &pix_vals, const EigImgT &img, const PtsT &pts,
+			unsigned int n_pix, unsigned int h, unsigned int w,
+			double norm_mult = 1, double norm_add = 0, double overflow_val = 128.0);
+		//! same as above with the points stored as n_pix interleaved x, y pairs
+		void getPixValsLinear(double *pix_vals, const EigImgT &img, const double *pts,
+			unsigned int n_pix, unsigned int h, unsigned int w,
+			double norm_mult = 1, double norm_add = 0, double overflow_val = 128.0);
+
+		/**
+		distance kernels used by the AM distance functors;
+		the vectorized versions accumulate in several partial sums so their results can differ
+		from the scalar ones in the last few bits;
+		if worst_dist is positive, the partial distance is returned as soon as it exceeds worst_dist
+		which is checked once for every dist_block_size elements
+		*/
+		const size_t dist_block_size = 32;
+		//! sum of squared differences
+		double getSSD(const double *a, const double *b, size_t size, double worst_dist = -1);
+		//! sum of absolute differences
+		double getSAD(const double *a, const double *b, size_t size, double worst_dist = -1);
+		double getDotProduct(const double *a, const double *b, size_t size);
+		//! sum of (2*a*b + c) / (a*a + b*b + c) over all elements
+		double getSPSS(const double *a, const double *b, size_t size, double c);
+	}
+}
+_MTF_END_NAMESPACE
+#endif
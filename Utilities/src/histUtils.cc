@@ -1,9 +1,6 @@
 #include "mtf/Utilities/histUtils.h"
 #include "mtf/Utilities/miscUtils.h"
 
-#ifdef ENABLE_HIST_TBB
-#include "tbb/tbb.h" 
-#endif
 
 _MTF_BEGIN_NAMESPACE
 
@@ -20,9 +17,6 @@ namespace utils{
 			hist(vals[val_id]) += 1;
 		}
 	}
-#ifdef ENABLE_HIST_TBB
-#include "histUtilsTBB.cc"
-#else
 	void getDiracHist(
 		// output arguments
 		VectorXd &hist, VectorXi &pix_vals_int,
@@ -343,7 +337,6 @@ namespace utils{
 			}
 		}
 	}
-#endif
 	// assumes that the histogram for the second image has already been computed 
 	// along with the floors of its pixel values
 	void getDiracJointHist(
@@ -998,9 +991,237 @@ namespace utils{
 		}
 	}
 
+	void BSpl3LUT::resize(unsigned int _n_steps){
+		n_steps = _n_steps;
+		step_mult = n_steps;
+		max_idx = 4 * n_steps;
+		unsigned int n_samples = n_steps ? max_idx + 1 : 0;
+		val.resize(n_samples);
+		grad.resize(n_samples);
+		hess.resize(n_samples);
+		cum_val.resize(n_samples);
+		cum_grad.resize(n_samples);
+		cum_hess.resize(n_samples);
+		for(unsigned int idx = 0; idx < n_samples; ++idx){
+			double x = static_cast<double>(idx) / step_mult - 2;
+			val[idx] = utils::bSpl3(x);
+			grad[idx] = utils::bSpl3Grad(x);
+			hess[idx] = utils::bSpl3Hess(x);
+			utils::cumBSpl3WithGrad(cum_val[idx], cum_grad[idx], x);
+			cum_hess[idx] = utils::cumBSpl3Hess(x);
+		}
+		selectFuncs();
+	}
+	void BSpl3LUT::selectFuncs(){
+		if(n_steps){
+			bspl3_func = &BSpl3LUT::lutBSpl3;
+			bspl3_grad_func = &BSpl3LUT::lutBSpl3Grad;
+			bspl3_hess_func = &BSpl3LUT::lutBSpl3Hess;
+			bspl3_with_grad_func = &BSpl3LUT::lutBSpl3WithGrad;
+			cum_bspl3_func = &BSpl3LUT::lutCumBSpl3;
+			cum_bspl3_hess_func = &BSpl3LUT::lutCumBSpl3Hess;
+			cum_bspl3_with_grad_func = &BSpl3LUT::lutCumBSpl3WithGrad;
+		} else{
+			bspl3_func = &BSpl3LUT::exactBSpl3;
+			bspl3_grad_func = &BSpl3LUT::exactBSpl3Grad;
+			bspl3_hess_func = &BSpl3LUT::exactBSpl3Hess;
+			bspl3_with_grad_func = &BSpl3LUT::exactBSpl3WithGrad;
+			cum_bspl3_func = &BSpl3LUT::exactCumBSpl3;
+			cum_bspl3_hess_func = &BSpl3LUT::exactCumBSpl3Hess;
+			cum_bspl3_with_grad_func = &BSpl3LUT::exactCumBSpl3WithGrad;
+		}
+	}
+
+	void ParallelHist::resize(unsigned int _n_vals, unsigned int _n_parts){
+		if(_n_parts == 0){
+			throw InvalidArgument("ParallelHist :: No. of parts must be positive");
+		}
+		//! no. of doubles in a 64 byte cache line
+		const unsigned int line_size = 64 / sizeof(double);
+		n_vals = _n_vals;
+		n_parts = _n_parts;
+		stride = ((n_vals + line_size - 1) / line_size)*line_size;
+		storage.resize(stride*n_parts + line_size);
+		size_t misalignment = reinterpret_cast<size_t>(storage.data()) % 64;
+		offset = misalignment ? static_cast<unsigned int>((64 - misalignment) / sizeof(double)) : 0;
+	}
+	void ParallelHist::reduce(){
+		for(unsigned int step = 1; step < n_parts; step *= 2){
+			for(unsigned int part_id = 0; part_id + step < n_parts; part_id += 2 * step){
+				double *dst = getBuffer(part_id);
+				const double *src = getBuffer(part_id + step);
+				for(unsigned int val_id = 0; val_id < n_vals; ++val_id){
+					dst[val_id] += src[val_id];
+				}
+			}
+		}
+	}
+	void getDiracJointHist(
+		// output arguments
+		MatrixXd &joint_hist, VectorXd &hist1, VectorXd &hist2,
+		// input arguments
+		const VectorXd &pix_vals1, const VectorXd &pix_vals2,
+		double hist_pre_seed, double joint_hist_pre_seed, int n_pix, int n_bins,
+		ParallelHist &hist_accum, TaskArena *task_arena
+		) {
+		assert(pix_vals1.size() == n_pix && pix_vals2.size() == n_pix);
+		assert(hist_accum.getNVals() == static_cast<unsigned int>(n_bins*(n_bins + 2)));
+		const double *hist_sums = hist_accum.accumulate(n_pix,
+			[&](double *hist_data, unsigned int start_id, unsigned int end_id){
+			VectorXdM part_hist1(hist_data, n_bins), part_hist2(hist_data + n_bins, n_bins);
+			MatrixXdM part_joint_hist(hist_data + 2 * n_bins, n_bins, n_bins);
+			for(unsigned int pix = start_id; pix < end_id; pix++) {
+				int pix1_int = static_cast<int>(pix_vals1(pix));
+				int pix2_int = static_cast<int>(pix_vals2(pix));
+				part_hist1(pix1_int) += 1;
+				part_hist2(pix2_int) += 1;
+				part_joint_hist(pix1_int, pix2_int) += 1;
+			}
+		}, task_arena);
+		hist1 = Map<const VectorXd>(hist_sums, n_bins).array() + hist_pre_seed;
+		hist2 = Map<const VectorXd>(hist_sums + n_bins, n_bins).array() + hist_pre_seed;
+		joint_hist = Map<const MatrixXd>(hist_sums + 2 * n_bins, n_bins, n_bins).array() + joint_hist_pre_seed;
+	}
+	void getBilinearJointHist(
+		// output arguments
+		MatrixXd &joint_hist, VectorXd &hist1, VectorXd &hist2,
+		// input arguments
+		const VectorXd &pix_vals1, const VectorXd &pix_vals2,
+		double hist_pre_seed, double joint_hist_pre_seed, int n_pix, int n_bins,
+		ParallelHist &hist_accum, TaskArena *task_arena
+		) {
+		assert(pix_vals1.size() == n_pix && pix_vals2.size() == n_pix);
+		assert(hist_accum.getNVals() == static_cast<unsigned int>(n_bins*(n_bins + 2)));
+		const double *hist_sums = hist_accum.accumulate(n_pix,
+			[&](double *hist_data, unsigned int start_id, unsigned int end_id){
+			VectorXdM part_hist1(hist_data, n_bins), part_hist2(hist_data + n_bins, n_bins);
+			MatrixXdM part_joint_hist(hist_data + 2 * n_bins, n_bins, n_bins);
+			for(unsigned int pix = start_id; pix < end_id; pix++) {
+				int pix1_int = static_cast<int>(pix_vals1(pix));
+				int pix2_int = static_cast<int>(pix_vals2(pix));
+
+				double r_wt = pix_vals1(pix) - pix1_int;
+				double l_wt = 1.0 - r_wt;
+
+				double b_wt = pix_vals2(pix) - pix2_int;
+				double t_wt = 1 - b_wt;
+
+				part_hist1(pix1_int) += l_wt;
+				part_hist2(pix2_int) += t_wt;
+				part_joint_hist(pix1_int, pix2_int) += l_wt*t_wt;
+
+				if(r_wt != 0){
+					part_hist1(pix1_int + 1) += r_wt;
+					part_joint_hist(pix1_int + 1, pix2_int) += r_wt*t_wt;
+					if(b_wt != 0){
+						part_joint_hist(pix1_int + 1, pix2_int + 1) += r_wt*b_wt;
+					}
+				}
+				if(b_wt != 0){
+					part_hist2(pix2_int + 1) += b_wt;
+					part_joint_hist(pix1_int, pix2_int + 1) += l_wt*b_wt;
+				}
+			}
+		}, task_arena);
+		hist1 = Map<const VectorXd>(hist_sums, n_bins).array() + hist_pre_seed;
+		hist2 = Map<const VectorXd>(hist_sums + n_bins, n_bins).array() + hist_pre_seed;
+		joint_hist = Map<const MatrixXd>(hist_sums + 2 * n_bins, n_bins, n_bins).array() + joint_hist_pre_seed;
+	}
+	void getBSplJointHist(
+		// output arguments
+		MatrixXd &joint_hist, VectorXd &hist1,
+		MatrixXd &hist1_mat, MatrixX2i &bspl_ids1,
+		// input arguments
+		const VectorXd &pix_vals1, const MatrixX2i &bspl_ids2,
+		const MatrixXd &hist2_mat, const MatrixX2i &std_bspl_ids,
+		double hist_pre_seed, double joint_hist_pre_seed, int n_pix,
+		ParallelHist &hist_accum, TaskArena *task_arena
+		) {
+		assert(pix_vals1.size() == n_pix);
+		int n_bins = static_cast<int>(hist1.size());
+		assert(hist_accum.getNVals() == static_cast<unsigned int>(n_bins*(n_bins + 1)));
+		const double *hist_sums = hist_accum.accumulate(n_pix,
+			[&](double *hist_data, unsigned int start_id, unsigned int end_id){
+			VectorXdM part_hist1(hist_data, n_bins);
+			MatrixXdM part_joint_hist(hist_data + n_bins, n_bins, n_bins);
+			hist1_mat.middleCols(start_id, end_id - start_id).setZero();
+			for(unsigned int pix = start_id; pix < end_id; pix++) {
+				bspl_ids1.row(pix) = std_bspl_ids.row(static_cast<int>(pix_vals1(pix)));
+				double curr_diff = bspl_ids1(pix, 0) - pix_vals1(pix);
+				for(int id1 = bspl_ids1(pix, 0); id1 <= bspl_ids1(pix, 1); id1++) {
+					part_hist1(id1) += hist1_mat(id1, pix) = bSpl3(curr_diff++);
+					for(int id2 = bspl_ids2(pix, 0); id2 <= bspl_ids2(pix, 1); id2++) {
+						part_joint_hist(id1, id2) += hist1_mat(id1, pix) * hist2_mat(id2, pix);
+					}
+				}
+			}
+		}, task_arena);
+		hist1 = Map<const VectorXd>(hist_sums, n_bins).array() + hist_pre_seed;
+		joint_hist = Map<const MatrixXd>(hist_sums + n_bins, n_bins, n_bins).array() + joint_hist_pre_seed;
+	}
+	void getBSplHistWithGrad(
+		// output arguments
+		VectorXd &hist, MatrixXd &hist_mat,
+		MatrixXd &hist_grad, MatrixX2i &bspl_ids,
+		// input arguments
+		const VectorXd &pix_vals, const MatrixX2i &std_bspl_ids,
+		double pre_seed, int n_pix, double hist_norm_mult,
+		ParallelHist &hist_accum, TaskArena *task_arena
+		) {
+		assert(hist.size() == std_bspl_ids.rows());
+		assert(hist_accum.getNVals() == static_cast<unsigned int>(hist.size()));
+		int n_bins = static_cast<int>(hist.size());
+		const double *hist_sums = hist_accum.accumulate(n_pix,
+			[&](double *hist_data, unsigned int start_id, unsigned int end_id){
+			VectorXdM part_hist(hist_data, n_bins);
+			hist_mat.middleCols(start_id, end_id - start_id).setZero();
+			hist_grad.middleCols(start_id, end_id - start_id).setZero();
+			for(unsigned int pix = start_id; pix < end_id; pix++) {
+				bspl_ids.row(pix) = std_bspl_ids.row(static_cast<int>(pix_vals(pix)));
+				double curr_diff = bspl_ids(pix, 0) - pix_vals(pix);
+				for(int id = bspl_ids(pix, 0); id <= bspl_ids(pix, 1); id++) {
+					bSpl3WithGrad(hist_mat(id, pix), hist_grad(id, pix), curr_diff);
+					hist_grad(id, pix) *= -hist_norm_mult;
+					part_hist(id) += hist_mat(id, pix);
+					++curr_diff;
+				}
+			}
+		}, task_arena);
+		hist = (Map<const VectorXd>(hist_sums, n_bins).array() + pre_seed) * hist_norm_mult;
+	}
+
 
 #define VALIDATE_PREC 1e-6
 
+	double validateBSpl3LUT(const BSpl3LUT &bspl_lut, unsigned int n_samples){
+		const char* func_names[] = { "bSpl3", "bSpl3Grad", "bSpl3Hess", "cumBSpl3", "cumBSpl3Grad", "cumBSpl3Hess" };
+		double max_diff[6] = { 0, 0, 0, 0, 0, 0 };
+		for(unsigned int sample_id = 0; sample_id < n_samples; ++sample_id){
+			double x = 4.0 * (sample_id + 0.5) / n_samples - 2;
+			double exact_val, exact_grad, lut_val, lut_grad;
+			// the exact function leaves its outputs unchanged for arguments outside its support
+			exact_val = exact_grad = 0;
+			utils::bSpl3WithGrad(exact_val, exact_grad, x);
+			bspl_lut.bSpl3WithGrad(lut_val, lut_grad, x);
+			max_diff[0] = std::max(max_diff[0], fabs(lut_val - exact_val));
+			max_diff[1] = std::max(max_diff[1], fabs(lut_grad - exact_grad));
+			max_diff[2] = std::max(max_diff[2], fabs(bspl_lut.bSpl3Hess(x) - utils::bSpl3Hess(x)));
+			utils::cumBSpl3WithGrad(exact_val, exact_grad, x);
+			bspl_lut.cumBSpl3WithGrad(lut_val, lut_grad, x);
+			max_diff[3] = std::max(max_diff[3], fabs(lut_val - exact_val));
+			max_diff[4] = std::max(max_diff[4], fabs(lut_grad - exact_grad));
+			max_diff[5] = std::max(max_diff[5], fabs(bspl_lut.cumBSpl3Hess(x) - utils::cumBSpl3Hess(x)));
+		}
+		printf("BSpline LUT with %u steps per unit: maximum absolute differences from exact functions (bound: %15.12f):\n",
+			bspl_lut.getNSteps(), bspl_lut.getMaxError());
+		double overall_max_diff = 0;
+		for(int func_id = 0; func_id < 6; ++func_id){
+			printf("\t%s: %15.12f\n", func_names[func_id], max_diff[func_id]);
+			overall_max_diff = std::max(overall_max_diff, max_diff[func_id]);
+		}
+		return overall_max_diff;
+	}
+
 	void validateJointHist(const MatrixXd &joint_hist,
 		const VectorXd &hist1, const VectorXd &hist2){
 
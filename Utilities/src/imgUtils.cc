@@ -1,12 +1,10 @@
 #include "mtf/Utilities/imgUtils.h"
 #include "mtf/Utilities/miscUtils.h"
 #include "mtf/Utilities/warpUtils.h"
+#include "mtf/Utilities/simdUtils.h"
 #include "opencv2/highgui/highgui.hpp"
 #include<opencv2/imgproc/imgproc.hpp>
 
-#ifdef USE_TBB
-#include "tbb/tbb.h" 
-#endif
 
 _MTF_BEGIN_NAMESPACE
 
@@ -156,9 +154,6 @@ namespace utils{
 		return  biCubic(bicubic_coeff, dx, dy);
 	}
 
-#ifdef USE_TBB
-#include "imgUtils_tbb.cc"
-#else
 
 	template<typename PtsT>
 	void getPixVals(VectorXd &pix_vals,
@@ -167,6 +162,11 @@ namespace utils{
 		//printf("n_pix: %d\t pix_vals.size(): %l\t pts.cols(): %l", n_pix, pix_vals.size(),  pts.cols());
 		assert(pix_vals.size() == n_pix && pts.cols() == n_pix);
 
+		// the default interpolation uses the vectorized kernel selected at runtime
+		if(PIX_INTERP_TYPE == InterpType::Linear && PIX_BORDER_TYPE == BorderType::Constant){
+			simd::getPixValsLinear(pix_vals, img, pts, n_pix, h, w, norm_mult, norm_add);
+			return;
+		}
 		for(unsigned int i = 0; i < n_pix; i++){
 			pix_vals(i) = norm_mult * getPixVal<PIX_INTERP_TYPE, PIX_BORDER_TYPE>(img, pts(0, i), pts(1, i), h, w) + norm_add;
 		}
@@ -365,7 +365,6 @@ namespace utils{
 		}
 	}
 
-#endif
 	// mapped version
 	template<InterpType mapping_type>
 	void getImgGrad(PixGradT &img_grad, const EigImgT &img,
@@ -450,6 +449,118 @@ namespace utils{
 		//printMatrixToFile(img_hess, "img_hess", "./log/mtf_log.txt", "%e", "a");
 	}
 
+	void getPixValsGradHess(VectorXd &pix_vals, PixGradT *img_grad, PixHessT *img_hess,
+		const EigImgT &img, const PtsT &pts, double grad_eps, double hess_eps,
+		unsigned int n_pix, unsigned int h, unsigned int w,
+		double norm_mult, double norm_add){
+		assert(pix_vals.size() == n_pix && pts.cols() == n_pix);
+		assert(!img_grad || img_grad->rows() == n_pix);
+		assert(!img_hess || img_hess->cols() == n_pix);
+
+		if(!img_grad && !img_hess){
+			getPixVals(pix_vals, img, pts, n_pix, h, w, norm_mult, norm_add);
+			return;
+		}
+		double grad_mult_factor = norm_mult / (2 * grad_eps);
+		double hess_eps2 = 2 * hess_eps;
+		double hess_mult_factor = norm_mult / (hess_eps2 * hess_eps2);
+
+		if(PIX_INTERP_TYPE == InterpType::Linear && GRAD_INTERP_TYPE == InterpType::Linear &&
+			HESS_INTERP_TYPE == InterpType::Linear && PIX_BORDER_TYPE == BorderType::Constant){
+			/**
+			the taps needed by each point are laid out tap by tap for a block of points so that
+			all of them can be interpolated by a single call to the vectorized kernel;
+			the first tap is the point itself followed by the 4 gradient and the 8 Hessian taps
+			*/
+			const unsigned int max_block_size = 64, max_taps = 13;
+			double tap_offsets[2 * max_taps] = { 0, 0 };
+			unsigned int n_taps = 1;
+			auto addTap = [&](double x_offset, double y_offset){
+				tap_offsets[2 * n_taps] = x_offset;
+				tap_offsets[2 * n_taps + 1] = y_offset;
+				++n_taps;
+			};
+			if(img_grad){
+				addTap(grad_eps, 0); addTap(-grad_eps, 0);
+				addTap(0, grad_eps); addTap(0, -grad_eps);
+			}
+			const unsigned int hess_tap_id = n_taps;
+			if(img_hess){
+				addTap(hess_eps2, 0); addTap(-hess_eps2, 0);
+				addTap(0, hess_eps2); addTap(0, -hess_eps2);
+				addTap(hess_eps, hess_eps); addTap(-hess_eps, -hess_eps);
+				addTap(hess_eps, -hess_eps); addTap(-hess_eps, hess_eps);
+			}
+			double tap_pts[2 * max_taps * max_block_size], tap_vals[max_taps * max_block_size];
+			for(unsigned int start_id = 0; start_id < n_pix; start_id += max_block_size){
+				const unsigned int block_size = std::min(max_block_size, n_pix - start_id);
+				for(unsigned int tap_id = 0; tap_id < n_taps; ++tap_id){
+					double *curr_tap_pts = tap_pts + 2 * tap_id * block_size;
+					for(unsigned int pt_id = 0; pt_id < block_size; ++pt_id){
+						curr_tap_pts[2 * pt_id] = pts(0, start_id + pt_id) + tap_offsets[2 * tap_id];
+						curr_tap_pts[2 * pt_id + 1] = pts(1, start_id + pt_id) + tap_offsets[2 * tap_id + 1];
+					}
+				}
+				simd::getPixValsLinear(tap_vals, img, tap_pts, n_taps*block_size, h, w);
+				for(unsigned int pt_id = 0; pt_id < block_size; ++pt_id){
+					auto tapVal = [&](unsigned int tap_id){ return tap_vals[tap_id*block_size + pt_id]; };
+					const unsigned int pix_id = start_id + pt_id;
+					pix_vals(pix_id) = norm_mult * tapVal(0) + norm_add;
+					if(img_grad){
+						(*img_grad)(pix_id, 0) = (tapVal(1) - tapVal(2))*grad_mult_factor;
+						(*img_grad)(pix_id, 1) = (tapVal(3) - tapVal(4))*grad_mult_factor;
+					}
+					if(img_hess){
+						double curr_pix_val = tapVal(0);
+						(*img_hess)(0, pix_id) = (tapVal(hess_tap_id) + tapVal(hess_tap_id + 1) -
+							2 * curr_pix_val) * hess_mult_factor;
+						(*img_hess)(3, pix_id) = (tapVal(hess_tap_id + 2) + tapVal(hess_tap_id + 3) -
+							2 * curr_pix_val) * hess_mult_factor;
+						(*img_hess)(1, pix_id) = (*img_hess)(2, pix_id) =
+							((tapVal(hess_tap_id + 4) + tapVal(hess_tap_id + 5)) -
+							(tapVal(hess_tap_id + 6) + tapVal(hess_tap_id + 7))) * hess_mult_factor;
+					}
+				}
+			}
+			return;
+		}
+		for(unsigned int pix_id = 0; pix_id < n_pix; ++pix_id){
+			double curr_x = pts(0, pix_id), curr_y = pts(1, pix_id);
+
+			pix_vals(pix_id) = norm_mult * getPixVal<PIX_INTERP_TYPE, PIX_BORDER_TYPE>(img, curr_x, curr_y, h, w) + norm_add;
+
+			if(img_grad){
+				double pix_val_inc = getPixVal<GRAD_INTERP_TYPE, PIX_BORDER_TYPE>(img, curr_x + grad_eps, curr_y, h, w);
+				double pix_val_dec = getPixVal<GRAD_INTERP_TYPE, PIX_BORDER_TYPE>(img, curr_x - grad_eps, curr_y, h, w);
+				(*img_grad)(pix_id, 0) = (pix_val_inc - pix_val_dec)*grad_mult_factor;
+
+				pix_val_inc = getPixVal<GRAD_INTERP_TYPE, PIX_BORDER_TYPE>(img, curr_x, curr_y + grad_eps, h, w);
+				pix_val_dec = getPixVal<GRAD_INTERP_TYPE, PIX_BORDER_TYPE>(img, curr_x, curr_y - grad_eps, h, w);
+				(*img_grad)(pix_id, 1) = (pix_val_inc - pix_val_dec)*grad_mult_factor;
+			}
+			if(img_hess){
+				double curr_pix_val = getPixVal<HESS_INTERP_TYPE, PIX_BORDER_TYPE>(img, curr_x, curr_y, h, w);
+
+				double ix_pix_val = getPixVal<HESS_INTERP_TYPE, PIX_BORDER_TYPE>(img, curr_x + hess_eps2, curr_y, h, w);
+				double dx_pix_val = getPixVal<HESS_INTERP_TYPE, PIX_BORDER_TYPE>(img, curr_x - hess_eps2, curr_y, h, w);
+				(*img_hess)(0, pix_id) = (ix_pix_val + dx_pix_val - 2 * curr_pix_val) * hess_mult_factor;
+
+				double iy_pix_val = getPixVal<HESS_INTERP_TYPE, PIX_BORDER_TYPE>(img, curr_x, curr_y + hess_eps2, h, w);
+				double dy_pix_val = getPixVal<HESS_INTERP_TYPE, PIX_BORDER_TYPE>(img, curr_x, curr_y - hess_eps2, h, w);
+				(*img_hess)(3, pix_id) = (iy_pix_val + dy_pix_val - 2 * curr_pix_val) * hess_mult_factor;
+
+				double inc_x = curr_x + hess_eps, dec_x = curr_x - hess_eps;
+				double inc_y = curr_y + hess_eps, dec_y = curr_y - hess_eps;
+				double ixiy_pix_val = getPixVal<HESS_INTERP_TYPE, PIX_BORDER_TYPE>(img, inc_x, inc_y, h, w);
+				double dxdy_pix_val = getPixVal<HESS_INTERP_TYPE, PIX_BORDER_TYPE>(img, dec_x, dec_y, h, w);
+				double ixdy_pix_val = getPixVal<HESS_INTERP_TYPE, PIX_BORDER_TYPE>(img, inc_x, dec_y, h, w);
+				double iydx_pix_val = getPixVal<HESS_INTERP_TYPE, PIX_BORDER_TYPE>(img, dec_x, inc_y, h, w);
+				(*img_hess)(1, pix_id) = (*img_hess)(2, pix_id) =
+					((ixiy_pix_val + dxdy_pix_val) - (ixdy_pix_val + iydx_pix_val)) * hess_mult_factor;
+			}
+		}
+	}
+
 	// convenience functions for mapping
 	void getWarpedImgGrad(PixGradT &warped_img_grad, const EigImgT &img,
 		bool weighted_mapping, const VectorXd &intensity_map, const Matrix8Xd &warped_offset_pts,
@@ -522,6 +633,199 @@ namespace utils{
 		}
 	}
 
+	/****************************************************************/
+	/**************** Precomputed Image Derivatives *****************/
+	/****************************************************************/
+
+	void getImgDerivatives(cv::Mat &img_dx, cv::Mat &img_dy, const cv::Mat &img){
+		// aperture size of 1 gives the central difference kernel [-1 0 1] without any smoothing
+		cv::Sobel(img, img_dx, CV_32F, 1, 0, 1, 0.5, 0, cv::BORDER_REPLICATE);
+		cv::Sobel(img, img_dy, CV_32F, 0, 1, 1, 0.5, 0, cv::BORDER_REPLICATE);
+	}
+	void getImgSecondDerivatives(cv::Mat &img_dxx, cv::Mat &img_dxy, cv::Mat &img_dyy,
+		const cv::Mat &img){
+		cv::Sobel(img, img_dxx, CV_32F, 2, 0, 1, 1, 0, cv::BORDER_REPLICATE);
+		cv::Sobel(img, img_dxy, CV_32F, 1, 1, 1, 0.25, 0, cv::BORDER_REPLICATE);
+		cv::Sobel(img, img_dyy, CV_32F, 0, 2, 1, 1, 0, cv::BORDER_REPLICATE);
+	}
+	namespace{
+		// offsets and weights of the four neighbours used for bilinear interpolation at (x, y)
+		// in a continuous float image with the given number of channels;
+		// returns false if the point or any of its neighbours lies outside the image
+		inline bool getBilinearNeighbors(int offsets[4], double wts[4], double x, double y,
+			unsigned int h, unsigned int w, unsigned int n_channels){
+			if(checkOverflow(x, y, h, w)){
+				return false;
+			}
+			int lx = static_cast<int>(x);
+			int ly = static_cast<int>(y);
+			double dx = x - lx;
+			double dy = y - ly;
+			int ux = dx == 0 ? lx : lx + 1;
+			int uy = dy == 0 ? ly : ly + 1;
+			if(checkOverflow(ux, uy, h, w)){
+				return false;
+			}
+			offsets[0] = (ly*w + lx)*n_channels;
+			offsets[1] = (ly*w + ux)*n_channels;
+			offsets[2] = (uy*w + lx)*n_channels;
+			offsets[3] = (uy*w + ux)*n_channels;
+			wts[0] = (1 - dx)*(1 - dy);
+			wts[1] = dx*(1 - dy);
+			wts[2] = (1 - dx)*dy;
+			wts[3] = dx*dy;
+			return true;
+		}
+		inline double interpolate(const float *data, const int offsets[4], const double wts[4]){
+			return data[offsets[0]] * wts[0] + data[offsets[1]] * wts[1] +
+				data[offsets[2]] * wts[2] + data[offsets[3]] * wts[3];
+		}
+	}
+	void getImgGrad(PixGradT &img_grad, const cv::Mat &img_dx, const cv::Mat &img_dy,
+		const PtsT &pts, unsigned int n_pix, unsigned int h, unsigned int w,
+		double pix_mult_factor){
+		const unsigned int n_channels = img_dx.channels();
+		assert(img_grad.rows() == n_pix*n_channels && pts.cols() == n_pix);
+		assert(img_dx.isContinuous() && img_dy.isContinuous());
+
+		const float *dx_data = img_dx.ptr<float>(), *dy_data = img_dy.ptr<float>();
+		int offsets[4];
+		double wts[4];
+		unsigned int ch_pix_id = 0;
+		for(unsigned int pix_id = 0; pix_id < n_pix; ++pix_id){
+			if(!getBilinearNeighbors(offsets, wts, pts(0, pix_id), pts(1, pix_id), h, w, n_channels)){
+				for(unsigned int channel_id = 0; channel_id < n_channels; ++channel_id){
+					img_grad.row(ch_pix_id++).setZero();
+				}
+				continue;
+			}
+			for(unsigned int channel_id = 0; channel_id < n_channels; ++channel_id){
+				img_grad(ch_pix_id, 0) = interpolate(dx_data + channel_id, offsets, wts)*pix_mult_factor;
+				img_grad(ch_pix_id, 1) = interpolate(dy_data + channel_id, offsets, wts)*pix_mult_factor;
+				++ch_pix_id;
+			}
+		}
+	}
+	void getWarpedImgGrad(PixGradT &warped_img_grad, const cv::Mat &img_dx, const cv::Mat &img_dy,
+		const GradPtsT &warped_offset_pts, double grad_eps, unsigned int n_pix,
+		unsigned int h, unsigned int w, double pix_mult_factor){
+		const unsigned int n_channels = img_dx.channels();
+		assert(warped_img_grad.rows() == n_pix*n_channels && warped_offset_pts.cols() == n_pix);
+		assert(img_dx.isContinuous() && img_dy.isContinuous());
+
+		const float *dx_data = img_dx.ptr<float>(), *dy_data = img_dy.ptr<float>();
+		double jac_mult_factor = 1.0 / (2 * grad_eps);
+		int offsets[4];
+		double wts[4];
+		unsigned int ch_pix_id = 0;
+		for(unsigned int pix_id = 0; pix_id < n_pix; ++pix_id){
+			// the warped location itself lies midway between the two offset points along each axis
+			double x = (warped_offset_pts(0, pix_id) + warped_offset_pts(2, pix_id)) / 2.0;
+			double y = (warped_offset_pts(1, pix_id) + warped_offset_pts(3, pix_id)) / 2.0;
+			if(!getBilinearNeighbors(offsets, wts, x, y, h, w, n_channels)){
+				for(unsigned int channel_id = 0; channel_id < n_channels; ++channel_id){
+					warped_img_grad.row(ch_pix_id++).setZero();
+				}
+				continue;
+			}
+			// Jacobian of the warped point w.r.t. the unwarped x and y coordinates
+			double dwx_dx = (warped_offset_pts(0, pix_id) - warped_offset_pts(2, pix_id))*jac_mult_factor;
+			double dwy_dx = (warped_offset_pts(1, pix_id) - warped_offset_pts(3, pix_id))*jac_mult_factor;
+			double dwx_dy = (warped_offset_pts(4, pix_id) - warped_offset_pts(6, pix_id))*jac_mult_factor;
+			double dwy_dy = (warped_offset_pts(5, pix_id) - warped_offset_pts(7, pix_id))*jac_mult_factor;
+			for(unsigned int channel_id = 0; channel_id < n_channels; ++channel_id){
+				double img_dx_val = interpolate(dx_data + channel_id, offsets, wts);
+				double img_dy_val = interpolate(dy_data + channel_id, offsets, wts);
+				warped_img_grad(ch_pix_id, 0) = (img_dx_val*dwx_dx + img_dy_val*dwy_dx)*pix_mult_factor;
+				warped_img_grad(ch_pix_id, 1) = (img_dx_val*dwx_dy + img_dy_val*dwy_dy)*pix_mult_factor;
+				++ch_pix_id;
+			}
+		}
+	}
+	void getImgHess(PixHessT &img_hess, const cv::Mat &img_dxx, const cv::Mat &img_dxy,
+		const cv::Mat &img_dyy, const PtsT &pts, unsigned int n_pix,
+		unsigned int h, unsigned int w, double pix_mult_factor){
+		const unsigned int n_channels = img_dxx.channels();
+		assert(img_hess.cols() == n_pix*n_channels && pts.cols() == n_pix);
+		assert(img_dxx.isContinuous() && img_dxy.isContinuous() && img_dyy.isContinuous());
+
+		const float *dxx_data = img_dxx.ptr<float>(), *dxy_data = img_dxy.ptr<float>(),
+			*dyy_data = img_dyy.ptr<float>();
+		int offsets[4];
+		double wts[4];
+		unsigned int ch_pix_id = 0;
+		for(unsigned int pix_id = 0; pix_id < n_pix; ++pix_id){
+			if(!getBilinearNeighbors(offsets, wts, pts(0, pix_id), pts(1, pix_id), h, w, n_channels)){
+				for(unsigned int channel_id = 0; channel_id < n_channels; ++channel_id){
+					img_hess.col(ch_pix_id++).setZero();
+				}
+				continue;
+			}
+			for(unsigned int channel_id = 0; channel_id < n_channels; ++channel_id){
+				img_hess(0, ch_pix_id) = interpolate(dxx_data + channel_id, offsets, wts)*pix_mult_factor;
+				img_hess(3, ch_pix_id) = interpolate(dyy_data + channel_id, offsets, wts)*pix_mult_factor;
+				img_hess(1, ch_pix_id) = img_hess(2, ch_pix_id) =
+					interpolate(dxy_data + channel_id, offsets, wts)*pix_mult_factor;
+				++ch_pix_id;
+			}
+		}
+	}
+	void getWarpedImgHess(PixHessT &warped_img_hess, const cv::Mat &img_dx, const cv::Mat &img_dy,
+		const cv::Mat &img_dxx, const cv::Mat &img_dxy, const cv::Mat &img_dyy,
+		const PtsT &warped_pts, const HessPtsT &warped_offset_pts, double hess_eps,
+		unsigned int n_pix, unsigned int h, unsigned int w, double pix_mult_factor){
+		const unsigned int n_channels = img_dx.channels();
+		assert(warped_img_hess.cols() == n_pix*n_channels && warped_pts.cols() == n_pix);
+		assert(img_dx.isContinuous() && img_dy.isContinuous() && img_dxx.isContinuous() &&
+			img_dxy.isContinuous() && img_dyy.isContinuous());
+
+		const float *dx_data = img_dx.ptr<float>(), *dy_data = img_dy.ptr<float>();
+		const float *dxx_data = img_dxx.ptr<float>(), *dxy_data = img_dxy.ptr<float>(),
+			*dyy_data = img_dyy.ptr<float>();
+		// the offset points lie at +-2*hess_eps along x and y and at +-hess_eps along the two diagonals
+		double hess_eps2 = 2 * hess_eps;
+		double jac_mult_factor = 1.0 / (2 * hess_eps2);
+		double hess_mult_factor = 1.0 / (hess_eps2 * hess_eps2);
+		int offsets[4];
+		double wts[4];
+		unsigned int ch_pix_id = 0;
+		for(unsigned int pix_id = 0; pix_id < n_pix; ++pix_id){
+			if(!getBilinearNeighbors(offsets, wts, warped_pts(0, pix_id), warped_pts(1, pix_id),
+				h, w, n_channels)){
+				for(unsigned int channel_id = 0; channel_id < n_channels; ++channel_id){
+					warped_img_hess.col(ch_pix_id++).setZero();
+				}
+				continue;
+			}
+			const double *offset_pts = warped_offset_pts.col(pix_id).data();
+			double wx = warped_pts(0, pix_id), wy = warped_pts(1, pix_id);
+			// first and second order derivatives of the warp w.r.t. the unwarped coordinates
+			Vector2d dw_dx((offset_pts[0] - offset_pts[2])*jac_mult_factor,
+				(offset_pts[1] - offset_pts[3])*jac_mult_factor);
+			Vector2d dw_dy((offset_pts[4] - offset_pts[6])*jac_mult_factor,
+				(offset_pts[5] - offset_pts[7])*jac_mult_factor);
+			Vector2d d2w_dx2((offset_pts[0] + offset_pts[2] - 2 * wx)*hess_mult_factor,
+				(offset_pts[1] + offset_pts[3] - 2 * wy)*hess_mult_factor);
+			Vector2d d2w_dy2((offset_pts[4] + offset_pts[6] - 2 * wx)*hess_mult_factor,
+				(offset_pts[5] + offset_pts[7] - 2 * wy)*hess_mult_factor);
+			Vector2d d2w_dxdy(((offset_pts[8] + offset_pts[10]) - (offset_pts[12] + offset_pts[14]))*hess_mult_factor,
+				((offset_pts[9] + offset_pts[11]) - (offset_pts[13] + offset_pts[15]))*hess_mult_factor);
+			for(unsigned int channel_id = 0; channel_id < n_channels; ++channel_id){
+				Vector2d img_grad(interpolate(dx_data + channel_id, offsets, wts),
+					interpolate(dy_data + channel_id, offsets, wts));
+				Matrix2d img_hess;
+				img_hess(0, 0) = interpolate(dxx_data + channel_id, offsets, wts);
+				img_hess(1, 1) = interpolate(dyy_data + channel_id, offsets, wts);
+				img_hess(0, 1) = img_hess(1, 0) = interpolate(dxy_data + channel_id, offsets, wts);
+				warped_img_hess(0, ch_pix_id) = (dw_dx.dot(img_hess*dw_dx) + img_grad.dot(d2w_dx2))*pix_mult_factor;
+				warped_img_hess(3, ch_pix_id) = (dw_dy.dot(img_hess*dw_dy) + img_grad.dot(d2w_dy2))*pix_mult_factor;
+				warped_img_hess(1, ch_pix_id) = warped_img_hess(2, ch_pix_id) =
+					(dw_dx.dot(img_hess*dw_dy) + img_grad.dot(d2w_dxdy))*pix_mult_factor;
+				++ch_pix_id;
+			}
+		}
+	}
+
 	namespace sc{
 
 		//! ----------------------------------------------- !//
@@ -17,6 +17,7 @@
 #include <sstream>
 #endif
 #include <ctime>
+#include <type_traits>
 
 #define mat_to_pt(vert, id) cv::Point2d(vert.at<double>(0, id), vert.at<double>(1, id))
 #define eig_to_pt(vert, id) cv::Point2d(vert(0, id), vert(1, id))
@@ -35,6 +36,110 @@ namespace utils{
 		putText(img, label, corners[0],
 			cv::FONT_HERSHEY_SIMPLEX, 0.5, corners_col);
 	}
+	namespace{
+		//! no. of rows of the Jacobian processed together so that these stay in the L1 cache
+		const int jac_prod_block_size = 256;
+
+		template<int state_size, typename ProdT, typename BlockT>
+		inline void addJacobianBlockProduct(ProdT &jac_prod, const BlockT &jac_block){
+			for(int col1 = 0; col1 < state_size; ++col1){
+				for(int col2 = 0; col2 <= col1; ++col2){
+					jac_prod(col1, col2) += jac_block.col(col1).dot(jac_block.col(col2));
+				}
+			}
+		}
+		//! the product of each block of rows is computed with the scalar type of the Jacobian
+		//! while the products of all the blocks are always summed in double precision
+		template<int state_size, typename JacScalarT>
+		void getJacobianProduct(MatrixXd &prod,
+			const Matrix<JacScalarT, Dynamic, Dynamic> &jacobian, double alpha, bool accumulate){
+			typedef Matrix<double, state_size, state_size> ProdT;
+			typedef Matrix<JacScalarT, state_size, state_size> BlockProdT;
+			typedef Matrix<JacScalarT, Dynamic, state_size> JacT;
+			const int n_rows = static_cast<int>(jacobian.rows());
+			Map<const JacT> jac(jacobian.data(), n_rows, state_size);
+			ProdT jac_prod = ProdT::Zero();
+			for(int start_id = 0; start_id < n_rows; start_id += jac_prod_block_size){
+				const int block_size = std::min(jac_prod_block_size, n_rows - start_id);
+				if(std::is_same<double, JacScalarT>::value){
+					addJacobianBlockProduct<state_size>(jac_prod, jac.middleRows(start_id, block_size));
+				} else{
+					BlockProdT block_prod = BlockProdT::Zero();
+					addJacobianBlockProduct<state_size>(block_prod, jac.middleRows(start_id, block_size));
+					jac_prod += block_prod.template cast<double>();
+				}
+			}
+			jac_prod.template triangularView<StrictlyUpper>() = jac_prod.transpose();
+			if(accumulate){
+				prod.noalias() += alpha*jac_prod;
+			} else{
+				prod.noalias() = alpha*jac_prod;
+			}
+		}
+		template<typename JacScalarT>
+		void getJacobianProduct(MatrixXd &prod,
+			const Matrix<JacScalarT, Dynamic, Dynamic> &jacobian, double alpha, bool accumulate){
+			assert(prod.rows() == jacobian.cols() && prod.cols() == jacobian.cols());
+			switch(jacobian.cols()){
+			case 2:
+				getJacobianProduct<2>(prod, jacobian, alpha, accumulate);
+				break;
+			case 3:
+				getJacobianProduct<3>(prod, jacobian, alpha, accumulate);
+				break;
+			case 4:
+				getJacobianProduct<4>(prod, jacobian, alpha, accumulate);
+				break;
+			case 5:
+				getJacobianProduct<5>(prod, jacobian, alpha, accumulate);
+				break;
+			case 6:
+				getJacobianProduct<6>(prod, jacobian, alpha, accumulate);
+				break;
+			case 8:
+				getJacobianProduct<8>(prod, jacobian, alpha, accumulate);
+				break;
+			default:
+				if(std::is_same<double, JacScalarT>::value){
+					if(accumulate){
+						prod.noalias() += alpha*jacobian.template cast<double>().transpose()*jacobian.template cast<double>();
+					} else{
+						prod.noalias() = alpha*jacobian.template cast<double>().transpose()*jacobian.template cast<double>();
+					}
+					break;
+				}
+				if(!accumulate){ prod.setZero(); }
+				for(int start_id = 0; start_id < jacobian.rows(); start_id += jac_prod_block_size){
+					const int block_size = std::min<int>(jac_prod_block_size, jacobian.rows() - start_id);
+					prod.noalias() += alpha*(jacobian.middleRows(start_id, block_size).transpose()*
+						jacobian.middleRows(start_id, block_size)).template cast<double>();
+				}
+			}
+		}
+	}
+	void getJacobianProduct(MatrixXd &prod, const MatrixXd &jacobian,
+		double alpha, bool accumulate){
+		getJacobianProduct<double>(prod, jacobian, alpha, accumulate);
+	}
+	void getJacobianProduct(MatrixXd &prod, const MatrixXf &jacobian,
+		double alpha, bool accumulate){
+		getJacobianProduct<float>(prod, jacobian, alpha, accumulate);
+	}
+	void getJacobianVecProduct(RowVectorXd &prod, const RowVectorXd &vec, const MatrixXf &jacobian,
+		double alpha, bool accumulate){
+		assert(vec.size() == jacobian.rows() && prod.size() == jacobian.cols());
+		typedef Matrix<float, 1, Dynamic, RowMajor, 1, jac_prod_block_size> VecBlockT;
+		const int n_rows = static_cast<int>(jacobian.rows());
+		if(!accumulate){ prod.setZero(); }
+		for(int start_id = 0; start_id < n_rows; start_id += jac_prod_block_size){
+			const int block_size = std::min(jac_prod_block_size, n_rows - start_id);
+			const VecBlockT vec_block = vec.segment(start_id, block_size).cast<float>();
+			for(int col_id = 0; col_id < jacobian.cols(); ++col_id){
+				prod(col_id) += alpha*static_cast<double>(
+					vec_block.dot(jacobian.col(col_id).segment(start_id, block_size).transpose()));
+			}
+		}
+	}
 	// mask a vector, i.e. retain only those entries where the given mask is true
 	void maskVector(VectorXd &masked_vec, const VectorXd &in_vec,
 		const VectorXb &mask, int masked_size, int in_size){
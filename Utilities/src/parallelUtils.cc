@@ -0,0 +1,324 @@
+#include "mtf/Utilities/parallelUtils.h"
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <exception>
+#include <map>
+#include <tuple>
+#include <cstdio>
+
+#ifdef ENABLE_OMP
+#include <omp.h>
+#endif
+#ifdef ENABLE_TBB
+//! needed by older versions of TBB for observers that are local to a task arena
+#define TBB_PREVIEW_LOCAL_OBSERVER 1
+#include "tbb/tbb.h"
+#include "tbb/task_scheduler_observer.h"
+#endif
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+_MTF_BEGIN_NAMESPACE
+namespace utils{
+	namespace{
+		//! no. of arena tasks that the calling thread is currently running
+		thread_local int parallel_depth = 0;
+		struct DepthGuard{
+			DepthGuard(){ ++parallel_depth; }
+			~DepthGuard(){ --parallel_depth; }
+		};
+		//! backend used by default which is the fastest one that is available
+		ParallelBackend getBuiltinBackend(){
+#ifdef ENABLE_TBB
+			return ParallelBackend::TBB;
+#elif defined ENABLE_OMP
+			return ParallelBackend::OpenMP;
+#else
+			return ParallelBackend::Threads;
+#endif
+		}
+		ParallelBackend default_backend = getBuiltinBackend();
+		std::mutex default_backend_mutex;
+
+#ifdef __linux__
+		//! binds the given thread to the given core and optionally saves its original affinity in saved_mask
+		void pinThread(pthread_t thread, int core_id, cpu_set_t *saved_mask = nullptr){
+			if(saved_mask){
+				CPU_ZERO(saved_mask);
+				pthread_getaffinity_np(thread, sizeof(cpu_set_t), saved_mask);
+			}
+			cpu_set_t cpu_set;
+			CPU_ZERO(&cpu_set);
+			CPU_SET(core_id % TaskArena::getNCores(), &cpu_set);
+			pthread_setaffinity_np(thread, sizeof(cpu_set_t), &cpu_set);
+		}
+		void restoreThreadAffinity(pthread_t thread, const cpu_set_t &saved_mask){
+			if(CPU_COUNT(&saved_mask) > 0){
+				pthread_setaffinity_np(thread, sizeof(cpu_set_t), &saved_mask);
+			}
+		}
+#endif
+
+#ifdef ENABLE_TBB
+		/**
+		binds the thread occupying each slot of the arena to the core with the same index
+		and restores its original affinity when it leaves so that the
+		calling thread is only pinned while it is taking part in the arena
+		*/
+		class ThreadPinner : public tbb::task_scheduler_observer{
+		public:
+			ThreadPinner(tbb::task_arena &arena) : tbb::task_scheduler_observer(arena){
+				observe(true);
+			}
+			~ThreadPinner(){ observe(false); }
+#ifdef __linux__
+			void on_scheduler_entry(bool) override{
+				pinThread(pthread_self(), tbb::this_task_arena::current_thread_index(), &getSavedMask());
+			}
+			void on_scheduler_exit(bool) override{
+				restoreThreadAffinity(pthread_self(), getSavedMask());
+			}
+		private:
+			static cpu_set_t& getSavedMask(){
+				static thread_local cpu_set_t saved_mask;
+				return saved_mask;
+			}
+#endif
+		};
+#endif
+	}
+	/**
+	worker threads of one backend and thread count that are shared by all the arenas using them;
+	only one job runs on a pool at a time and any other arena that wants to use it meanwhile
+	runs its tasks serially instead of waiting
+	*/
+	struct TaskArena::Pool{
+		typedef std::tuple<ParallelBackend, int, bool> KeyT;
+
+		Pool(ParallelBackend _backend, int _n_threads, bool _pin_threads) :
+			backend(_backend), n_threads(_n_threads), pin_threads(_pin_threads),
+			job(nullptr), job_n_tasks(0), next_task(0), job_id(0), n_active(0), stop(false){
+#ifdef ENABLE_TBB
+			if(backend == ParallelBackend::TBB){
+				arena.reset(new tbb::task_arena(n_threads));
+				if(pin_threads){
+					arena->initialize();
+					thread_pinner.reset(new ThreadPinner(*arena));
+				}
+			}
+#endif
+			if(backend == ParallelBackend::Threads){
+				//! the calling thread takes part in each job so it needs one less worker
+				for(int worker_id = 1; worker_id < n_threads; ++worker_id){
+					workers.push_back(std::thread(&Pool::workerLoop, this));
+#ifdef __linux__
+					//! the workers only ever run the jobs of this pool so they stay pinned
+					if(pin_threads){ pinThread(workers.back().native_handle(), worker_id); }
+#endif
+				}
+			}
+		}
+		~Pool(){
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				stop = true;
+			}
+			job_cv.notify_all();
+			for(std::thread &worker : workers){ worker.join(); }
+		}
+		//! returns the pool with the given configuration creating it if no arena is using one
+		static std::shared_ptr<Pool> get(ParallelBackend backend, int n_threads, bool pin_threads){
+			static std::map<KeyT, std::weak_ptr<Pool> > pools;
+			static std::mutex pools_mutex;
+			std::lock_guard<std::mutex> lock(pools_mutex);
+			std::weak_ptr<Pool> &pool_ref = pools[KeyT(backend, n_threads, pin_threads)];
+			std::shared_ptr<Pool> pool = pool_ref.lock();
+			if(!pool){
+				pool.reset(new Pool(backend, n_threads, pin_threads));
+				pool_ref = pool;
+			}
+			return pool;
+		}
+		//! returns false without running anything if another job is using the pool
+		bool execute(int n_tasks, const std::function<void(int)> &task_func){
+			std::unique_lock<std::mutex> job_lock(job_mutex, std::try_to_lock);
+			if(!job_lock.owns_lock()){ return false; }
+			std::exception_ptr error;
+			std::mutex error_mutex;
+			auto runTask = [&](int task_id){
+				DepthGuard depth_guard;
+				try{
+					task_func(task_id);
+				} catch(...){
+					std::lock_guard<std::mutex> lock(error_mutex);
+					if(!error){ error = std::current_exception(); }
+				}
+			};
+			switch(backend){
+#ifdef ENABLE_OMP
+			case ParallelBackend::OpenMP:
+#pragma omp parallel for num_threads(n_threads) schedule(dynamic, 1)
+				for(int task_id = 0; task_id < n_tasks; ++task_id){ runTask(task_id); }
+				break;
+#endif
+#ifdef ENABLE_TBB
+			case ParallelBackend::TBB:
+				arena->execute([&](){
+					tbb::parallel_for(0, n_tasks, [&](int task_id){ runTask(task_id); });
+				});
+				break;
+#endif
+			case ParallelBackend::Threads:{
+#ifdef __linux__
+				//! the calling thread takes the first core while it is running the job
+				cpu_set_t saved_mask;
+				if(pin_threads){ pinThread(pthread_self(), 0, &saved_mask); }
+				runJob(n_tasks, runTask);
+				if(pin_threads){ restoreThreadAffinity(pthread_self(), saved_mask); }
+#else
+				runJob(n_tasks, runTask);
+#endif
+				break;
+			}
+			default:
+				for(int task_id = 0; task_id < n_tasks; ++task_id){ runTask(task_id); }
+			}
+			if(error){ std::rethrow_exception(error); }
+			return true;
+		}
+
+	private:
+		ParallelBackend backend;
+		int n_threads;
+		//! not supported with OpenMP whose threads are not owned by the pool
+		bool pin_threads;
+		//! held by the thread running the current job
+		std::mutex job_mutex;
+		//! protects the job data that is read by the workers when they wake up
+		std::mutex mutex;
+		std::condition_variable job_cv, done_cv;
+		const std::function<void(int)> *job;
+		int job_n_tasks;
+		std::atomic<int> next_task;
+		unsigned long long job_id;
+		//! no. of workers that have joined the current job and not finished it
+		int n_active;
+		bool stop;
+		std::vector<std::thread> workers;
+#ifdef ENABLE_TBB
+		std::unique_ptr<tbb::task_arena> arena;
+		std::unique_ptr<ThreadPinner> thread_pinner;
+#endif
+		void runTasks(const std::function<void(int)> &task_func, int n_tasks){
+			for(int task_id = next_task++; task_id < n_tasks; task_id = next_task++){
+				task_func(task_id);
+			}
+		}
+		void runJob(int n_tasks, const std::function<void(int)> &task_func){
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				job = &task_func;
+				job_n_tasks = n_tasks;
+				next_task = 0;
+				++job_id;
+			}
+			job_cv.notify_all();
+			runTasks(task_func, n_tasks);
+			//! workers that woke up too late to get a task find none left so the job can be cleared once the others finish
+			std::unique_lock<std::mutex> lock(mutex);
+			done_cv.wait(lock, [&](){ return n_active == 0; });
+			job = nullptr;
+		}
+		void workerLoop(){
+			unsigned long long seen_job_id = 0;
+			std::unique_lock<std::mutex> lock(mutex);
+			for(;;){
+				job_cv.wait(lock, [&](){ return stop || job_id != seen_job_id; });
+				if(stop){ return; }
+				seen_job_id = job_id;
+				if(!job){ continue; }
+				const std::function<void(int)> &task_func = *job;
+				int n_tasks = job_n_tasks;
+				++n_active;
+				lock.unlock();
+				runTasks(task_func, n_tasks);
+				lock.lock();
+				if(--n_active == 0){ done_cv.notify_all(); }
+			}
+		}
+	};
+
+	TaskArena::TaskArena(int _n_threads, bool pin_threads,
+		ParallelBackend _backend, int _grain_size) :
+		n_threads(_n_threads > 0 ? _n_threads : getNCores()),
+		grain_size(_grain_size), backend(_backend){
+		if(backend == ParallelBackend::Default){
+			backend = getDefaultBackend();
+		}
+#ifndef ENABLE_OMP
+		if(backend == ParallelBackend::OpenMP){
+			printf("TaskArena :: OpenMP support is not enabled so using Threads instead\n");
+			backend = ParallelBackend::Threads;
+		}
+#endif
+#ifndef ENABLE_TBB
+		if(backend == ParallelBackend::TBB){
+			printf("TaskArena :: TBB support is not enabled so using Threads instead\n");
+			backend = ParallelBackend::Threads;
+		}
+#endif
+		if(n_threads == 1){
+			backend = ParallelBackend::Serial;
+		}
+		if(backend != ParallelBackend::Serial){
+			pool = Pool::get(backend, n_threads, pin_threads);
+		}
+	}
+	TaskArena::~TaskArena(){}
+
+	void TaskArena::execute(int n_tasks, const std::function<void(int)> &task_func){
+		if(n_tasks > 1 && pool && !inParallelRegion() && pool->execute(n_tasks, task_func)){
+			return;
+		}
+		for(int task_id = 0; task_id < n_tasks; ++task_id){ task_func(task_id); }
+	}
+	bool TaskArena::inParallelRegion(){
+#ifdef ENABLE_OMP
+		if(omp_in_parallel()){ return true; }
+#endif
+		return parallel_depth > 0;
+	}
+	int TaskArena::getNCores(){
+		int n_cores = static_cast<int>(std::thread::hardware_concurrency());
+		return n_cores > 0 ? n_cores : 1;
+	}
+	void TaskArena::setDefaultBackend(ParallelBackend _backend){
+		std::lock_guard<std::mutex> lock(default_backend_mutex);
+		default_backend = _backend == ParallelBackend::Default ? getBuiltinBackend() : _backend;
+	}
+	ParallelBackend TaskArena::getDefaultBackend(){
+		std::lock_guard<std::mutex> lock(default_backend_mutex);
+		return default_backend;
+	}
+	const char* TaskArena::toString(ParallelBackend _backend){
+		switch(_backend){
+		case ParallelBackend::Default:
+			return "Default";
+		case ParallelBackend::Serial:
+			return "Serial";
+		case ParallelBackend::OpenMP:
+			return "OpenMP";
+		case ParallelBackend::TBB:
+			return "TBB";
+		case ParallelBackend::Threads:
+			return "Threads";
+		default:
+			return "Invalid";
+		}
+	}
+}
+_MTF_END_NAMESPACE
@@ -0,0 +1,156 @@
+#include "mtf/Utilities/pyramidUtils.h"
+#include "mtf/Utilities/parallelUtils.h"
+#include "opencv2/imgproc/imgproc.hpp"
+#include <cmath>
+#include <algorithm>
+
+_MTF_BEGIN_NAMESPACE
+namespace utils{
+	void buildImagePyramid(vector<cv::Mat> &img_pyramid, double scale_factor,
+		const cv::Rect &roi, int blur_size, double blur_sigma){
+		bool use_roi = roi.area() > 0;
+		cv::Rect src_roi = roi & cv::Rect(0, 0, img_pyramid[0].cols, img_pyramid[0].rows);
+		for(unsigned int pyr_level = 1; pyr_level < img_pyramid.size(); ++pyr_level){
+			const cv::Mat &src = img_pyramid[pyr_level - 1];
+			cv::Mat &dst = img_pyramid[pyr_level];
+			cv::Size dst_size(static_cast<int>(src.cols*scale_factor),
+				static_cast<int>(src.rows*scale_factor));
+			dst.create(dst_size, src.type());
+			if(!use_roi){
+				if(scale_factor == 0.5){
+					cv::pyrDown(src, dst, dst_size);
+				} else{
+					cv::resize(src, dst, dst_size);
+					cv::GaussianBlur(dst, dst, cv::Size(blur_size, blur_size), blur_sigma);
+				}
+				continue;
+			}
+			if(src_roi.area() <= 0){ continue; }
+			// part of this level that covers the ROI in the previous one rounded outwards to whole pixels
+			int x0 = static_cast<int>(floor(src_roi.x*scale_factor));
+			int y0 = static_cast<int>(floor(src_roi.y*scale_factor));
+			int x1 = std::min(static_cast<int>(ceil((src_roi.x + src_roi.width)*scale_factor)), dst.cols);
+			int y1 = std::min(static_cast<int>(ceil((src_roi.y + src_roi.height)*scale_factor)), dst.rows);
+			cv::Rect dst_roi(x0, y0, x1 - x0, y1 - y0);
+			if(dst_roi.area() <= 0){
+				src_roi = dst_roi;
+				continue;
+			}
+			// part of the previous level that maps to it
+			int src_x0 = static_cast<int>(floor(x0 / scale_factor));
+			int src_y0 = static_cast<int>(floor(y0 / scale_factor));
+			int src_x1 = std::min(static_cast<int>(ceil(x1 / scale_factor)), src.cols);
+			int src_y1 = std::min(static_cast<int>(ceil(y1 / scale_factor)), src.rows);
+			cv::Mat src_patch = src(cv::Rect(src_x0, src_y0, src_x1 - src_x0, src_y1 - src_y0));
+			cv::Mat dst_patch = dst(dst_roi);
+			if(scale_factor == 0.5){
+				cv::pyrDown(src_patch, dst_patch, dst_roi.size());
+			} else{
+				cv::resize(src_patch, dst_patch, dst_roi.size());
+				cv::GaussianBlur(dst_patch, dst_patch, cv::Size(blur_size, blur_size), blur_sigma);
+			}
+			src_roi = dst_roi;
+		}
+	}
+
+	ImagePyramidCache::ImagePyramidCache(int _roi_margin, int n_threads) :
+		frame_id(-1), roi_margin(_roi_margin),
+		task_arena(new TaskArena(n_threads)){}
+
+	void ImagePyramidCache::update(int _frame_id, const cv::Rect &_roi, bool prebuild){
+		vector<std::shared_ptr<Entry> > active_entries;
+		{
+			std::lock_guard<std::mutex> lock(entries_mutex);
+			int last_frame_id = frame_id;
+			frame_id = _frame_id;
+			if(roi_margin >= 0 && _roi.area() > 0){
+				roi = cv::Rect(_roi.x - roi_margin, _roi.y - roi_margin,
+					_roi.width + 2 * roi_margin, _roi.height + 2 * roi_margin);
+			} else{
+				roi = cv::Rect();
+			}
+			for(auto entry_it = entries.begin(); entry_it != entries.end();){
+				if(entry_it->second->used_frame_id != last_frame_id){
+					// source buffer was not used in the last frame so is probably no longer valid
+					entry_it = entries.erase(entry_it);
+				} else{
+					active_entries.push_back(entry_it->second);
+					++entry_it;
+				}
+			}
+		}
+		if(!prebuild || active_entries.empty()){ return; }
+		int curr_frame_id = frame_id;
+		cv::Rect curr_roi = roi;
+		task_arena->run(static_cast<int>(active_entries.size()), [&](int entry_id){
+			Entry &entry = *active_entries[entry_id];
+			std::lock_guard<std::mutex> lock(entry.mutex);
+			if(entry.built_frame_id != curr_frame_id){
+				buildEntry(entry, static_cast<int>(entry.levels.size()), curr_frame_id, curr_roi);
+			}
+		});
+	}
+
+	void ImagePyramidCache::getPyramid(vector<cv::Mat> &img_pyramid, const cv::Mat &img,
+		double scale_factor, int blur_size, double blur_sigma){
+		int n_levels = static_cast<int>(img_pyramid.size());
+		if(n_levels == 0){ return; }
+		std::shared_ptr<Entry> entry;
+		int curr_frame_id;
+		cv::Rect curr_roi;
+		{
+			std::lock_guard<std::mutex> lock(entries_mutex);
+			std::shared_ptr<Entry> &entry_ref = entries[KeyT(img.data, img.type(),
+				scale_factor, blur_size, blur_sigma)];
+			if(!entry_ref){
+				entry_ref.reset(new Entry);
+				entry_ref->scale_factor = scale_factor;
+				entry_ref->blur_size = blur_size;
+				entry_ref->blur_sigma = blur_sigma;
+				entry_ref->built_frame_id = entry_ref->used_frame_id = -1;
+			}
+			entry = entry_ref;
+			curr_frame_id = frame_id;
+			curr_roi = roi;
+		}
+		std::lock_guard<std::mutex> lock(entry->mutex);
+		entry->img = img;
+		entry->used_frame_id = curr_frame_id;
+		int n_built_levels = static_cast<int>(entry->levels.size());
+		if(curr_frame_id < 0 || entry->built_frame_id != curr_frame_id || n_built_levels < n_levels){
+			buildEntry(*entry, std::max(n_levels, n_built_levels), curr_frame_id, curr_roi);
+		}
+		for(int pyr_level = 0; pyr_level < n_levels; ++pyr_level){
+			img_pyramid[pyr_level] = entry->levels[pyr_level];
+		}
+	}
+
+	void ImagePyramidCache::buildEntry(Entry &entry, int n_levels, int curr_frame_id,
+		const cv::Rect &curr_roi){
+		// the ROI can only be used if all levels already hold valid data from a previous frame
+		bool full_build = entry.built_frame_id < 0 || static_cast<int>(entry.levels.size()) < n_levels ||
+			entry.levels[0].size() != entry.img.size() || entry.levels[0].type() != entry.img.type();
+		entry.levels.resize(n_levels);
+		entry.levels[0] = entry.img;
+		buildImagePyramid(entry.levels, entry.scale_factor, full_build ? cv::Rect() : curr_roi,
+			entry.blur_size, entry.blur_sigma);
+		entry.built_frame_id = curr_frame_id;
+	}
+
+	cv::Rect ImagePyramidCache::getBoundingBox(const vector<cv::Mat> &regions){
+		if(regions.empty()){ return cv::Rect(); }
+		double min_x = regions[0].at<double>(0, 0), max_x = min_x;
+		double min_y = regions[0].at<double>(1, 0), max_y = min_y;
+		for(const cv::Mat &region : regions){
+			for(int corner_id = 0; corner_id < region.cols; ++corner_id){
+				double x = region.at<double>(0, corner_id), y = region.at<double>(1, corner_id);
+				if(x < min_x){ min_x = x; } else if(x > max_x){ max_x = x; }
+				if(y < min_y){ min_y = y; } else if(y > max_y){ max_y = y; }
+			}
+		}
+		int x0 = static_cast<int>(floor(min_x)), y0 = static_cast<int>(floor(min_y));
+		return cv::Rect(x0, y0, static_cast<int>(ceil(max_x)) - x0 + 1,
+			static_cast<int>(ceil(max_y)) - y0 + 1);
+	}
+}
+_MTF_END_NAMESPACE
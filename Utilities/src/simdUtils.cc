@@ -0,0 +1,517 @@
+#include "mtf/Utilities/simdUtils.h"
+#include "mtf/Utilities/imgUtils.h"
+#include "mtf/Utilities/excpUtils.h"
+
+#include <cmath>
+
+// the vectorized kernels are compiled for their respective instruction sets using
+// function level target attributes so that the rest of the library (and hence the
+// minimum CPU requirement) is unaffected; the one actually used is selected at runtime
+#if !defined(DISABLE_SIMD) && defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define MTF_SIMD_X86
+#include <immintrin.h>
+#endif
+
+_MTF_BEGIN_NAMESPACE
+namespace utils{
+	namespace simd{
+		const char* toString(ISA isa){
+			switch(isa){
+			case ISA::Scalar:
+				return "Scalar";
+			case ISA::AVX2:
+				return "AVX2";
+			case ISA::AVX512:
+				return "AVX512";
+			default:
+				throw InvalidArgument("Invalid SIMD instruction set provided");
+			}
+		}
+		ISA getSupportedISA(){
+#ifdef MTF_SIMD_X86
+			// __builtin_cpu_supports also verifies that the OS saves the extended register state
+			static const ISA supported_isa = __builtin_cpu_supports("avx512f") ? ISA::AVX512 :
+				__builtin_cpu_supports("avx2") ? ISA::AVX2 : ISA::Scalar;
+			return supported_isa;
+#else
+			return ISA::Scalar;
+#endif
+		}
+		namespace{
+			ISA& activeISA(){
+				static ISA active_isa = getSupportedISA();
+				return active_isa;
+			}
+		}
+		ISA getActiveISA(){ return activeISA(); }
+		ISA setActiveISA(ISA isa){
+			ISA supported_isa = getSupportedISA();
+			activeISA() = static_cast<int>(isa) < static_cast<int>(supported_isa) ? isa : supported_isa;
+			return activeISA();
+		}
+
+		namespace{
+			void getPixValsLinearScalar(double *pix_vals, const EigImgT &img, const double *pts,
+				unsigned int start_id, unsigned int n_pix, unsigned int h, unsigned int w,
+				double norm_mult, double norm_add, double overflow_val){
+				for(unsigned int pix_id = start_id; pix_id < n_pix; ++pix_id){
+					pix_vals[pix_id] = norm_mult * getPixVal<InterpType::Linear, BorderType::Constant>(
+						img, pts[2 * pix_id], pts[2 * pix_id + 1], h, w, overflow_val) + norm_add;
+				}
+			}
+		}
+#ifdef MTF_SIMD_X86
+		/**
+		the operations in both kernels mirror getPixVal<Linear, Constant> one for one:
+		points are tested against the image extents in double precision,
+		truncated to get the lower neighbours, the upper ones are only used if the
+		fractional part is nonzero and the four products are summed left to right;
+		fused multiply-add must not be used for the results to be bit-identical
+		*/
+#pragma GCC push_options
+#pragma GCC optimize ("fp-contract=off")
+		namespace{
+			__attribute__((target("avx2")))
+			void getPixValsLinearAVX2(double *pix_vals, const float *img_data, const double *pts,
+				unsigned int n_pix, unsigned int h, unsigned int w,
+				double norm_mult, double norm_add, double overflow_val){
+				const __m256d zero = _mm256_setzero_pd(), one = _mm256_set1_pd(1.0);
+				const __m256d w_d = _mm256_set1_pd(w), h_d = _mm256_set1_pd(h);
+				const __m256d overflow = _mm256_set1_pd(overflow_val);
+				const __m256d mult = _mm256_set1_pd(norm_mult), add = _mm256_set1_pd(norm_add);
+				const __m128i w_i = _mm_set1_epi32(static_cast<int>(w));
+				for(unsigned int pix_id = 0; pix_id < n_pix; pix_id += 4){
+					// points are stored as interleaved x, y pairs
+					__m256d pts_01 = _mm256_loadu_pd(pts + 2 * pix_id);
+					__m256d pts_23 = _mm256_loadu_pd(pts + 2 * pix_id + 4);
+					__m256d x = _mm256_permute4x64_pd(_mm256_unpacklo_pd(pts_01, pts_23), 0xD8);
+					__m256d y = _mm256_permute4x64_pd(_mm256_unpackhi_pd(pts_01, pts_23), 0xD8);
+
+					__m256d valid = _mm256_and_pd(
+						_mm256_and_pd(_mm256_cmp_pd(x, zero, _CMP_GE_OQ), _mm256_cmp_pd(x, w_d, _CMP_LT_OQ)),
+						_mm256_and_pd(_mm256_cmp_pd(y, zero, _CMP_GE_OQ), _mm256_cmp_pd(y, h_d, _CMP_LT_OQ)));
+					__m128i lx = _mm256_cvttpd_epi32(x), ly = _mm256_cvttpd_epi32(y);
+					__m256d lx_d = _mm256_cvtepi32_pd(lx), ly_d = _mm256_cvtepi32_pd(ly);
+					__m256d dx = _mm256_sub_pd(x, lx_d), dy = _mm256_sub_pd(y, ly_d);
+					__m256d inc_x = _mm256_and_pd(_mm256_cmp_pd(dx, zero, _CMP_NEQ_UQ), one);
+					__m256d inc_y = _mm256_and_pd(_mm256_cmp_pd(dy, zero, _CMP_NEQ_UQ), one);
+					valid = _mm256_and_pd(valid, _mm256_and_pd(
+						_mm256_cmp_pd(_mm256_add_pd(lx_d, inc_x), w_d, _CMP_LT_OQ),
+						_mm256_cmp_pd(_mm256_add_pd(ly_d, inc_y), h_d, _CMP_LT_OQ)));
+
+					// invalid lanes gather the first pixel so that no out of bounds access can occur
+					__m128i valid_i = _mm256_cvttpd_epi32(_mm256_and_pd(valid, one));
+					__m128i inc_x_i = _mm256_cvttpd_epi32(_mm256_and_pd(valid, inc_x));
+					__m128i inc_y_i = _mm_mullo_epi32(_mm256_cvttpd_epi32(_mm256_and_pd(valid, inc_y)), w_i);
+					__m128i idx_l = _mm_mullo_epi32(_mm_add_epi32(_mm_mullo_epi32(ly, w_i), lx), valid_i);
+					__m128i idx_u = _mm_add_epi32(idx_l, inc_y_i);
+
+					__m256d pix_ll = _mm256_cvtps_pd(_mm_i32gather_ps(img_data, idx_l, 4));
+					__m256d pix_lu = _mm256_cvtps_pd(_mm_i32gather_ps(img_data, _mm_add_epi32(idx_l, inc_x_i), 4));
+					__m256d pix_ul = _mm256_cvtps_pd(_mm_i32gather_ps(img_data, idx_u, 4));
+					__m256d pix_uu = _mm256_cvtps_pd(_mm_i32gather_ps(img_data, _mm_add_epi32(idx_u, inc_x_i), 4));
+
+					__m256d dx_c = _mm256_sub_pd(one, dx), dy_c = _mm256_sub_pd(one, dy);
+					__m256d pix_val = _mm256_mul_pd(_mm256_mul_pd(pix_ll, dx_c), dy_c);
+					pix_val = _mm256_add_pd(pix_val, _mm256_mul_pd(_mm256_mul_pd(pix_lu, dx), dy_c));
+					pix_val = _mm256_add_pd(pix_val, _mm256_mul_pd(_mm256_mul_pd(pix_ul, dx_c), dy));
+					pix_val = _mm256_add_pd(pix_val, _mm256_mul_pd(_mm256_mul_pd(pix_uu, dx), dy));
+					pix_val = _mm256_blendv_pd(overflow, pix_val, valid);
+					_mm256_storeu_pd(pix_vals + pix_id, _mm256_add_pd(_mm256_mul_pd(mult, pix_val), add));
+				}
+			}
+			__attribute__((target("avx512f,avx2")))
+			void getPixValsLinearAVX512(double *pix_vals, const float *img_data, const double *pts,
+				unsigned int n_pix, unsigned int h, unsigned int w,
+				double norm_mult, double norm_add, double overflow_val){
+				const __m512d zero = _mm512_setzero_pd(), one = _mm512_set1_pd(1.0);
+				const __m512d w_d = _mm512_set1_pd(w), h_d = _mm512_set1_pd(h);
+				const __m512d overflow = _mm512_set1_pd(overflow_val);
+				const __m512d mult = _mm512_set1_pd(norm_mult), add = _mm512_set1_pd(norm_add);
+				const __m256i w_i = _mm256_set1_epi32(static_cast<int>(w));
+				const __m512i x_perm = _mm512_setr_epi64(0, 2, 4, 6, 8, 10, 12, 14);
+				const __m512i y_perm = _mm512_setr_epi64(1, 3, 5, 7, 9, 11, 13, 15);
+				for(unsigned int pix_id = 0; pix_id < n_pix; pix_id += 8){
+					__m512d pts_0 = _mm512_loadu_pd(pts + 2 * pix_id);
+					__m512d pts_1 = _mm512_loadu_pd(pts + 2 * pix_id + 8);
+					__m512d x = _mm512_permutex2var_pd(pts_0, x_perm, pts_1);
+					__m512d y = _mm512_permutex2var_pd(pts_0, y_perm, pts_1);
+
+					__mmask8 valid = _mm512_cmp_pd_mask(x, zero, _CMP_GE_OQ) &
+						_mm512_cmp_pd_mask(x, w_d, _CMP_LT_OQ) &
+						_mm512_cmp_pd_mask(y, zero, _CMP_GE_OQ) &
+						_mm512_cmp_pd_mask(y, h_d, _CMP_LT_OQ);
+					__m256i lx = _mm512_cvttpd_epi32(x), ly = _mm512_cvttpd_epi32(y);
+					__m512d lx_d = _mm512_cvtepi32_pd(lx), ly_d = _mm512_cvtepi32_pd(ly);
+					__m512d dx = _mm512_sub_pd(x, lx_d), dy = _mm512_sub_pd(y, ly_d);
+					__mmask8 has_ux = _mm512_cmp_pd_mask(dx, zero, _CMP_NEQ_UQ);
+					__mmask8 has_uy = _mm512_cmp_pd_mask(dy, zero, _CMP_NEQ_UQ);
+					valid &= _mm512_cmp_pd_mask(_mm512_mask_add_pd(lx_d, has_ux, lx_d, one), w_d, _CMP_LT_OQ) &
+						_mm512_cmp_pd_mask(_mm512_mask_add_pd(ly_d, has_uy, ly_d, one), h_d, _CMP_LT_OQ);
+
+					__m256i valid_i = _mm512_cvttpd_epi32(_mm512_maskz_mov_pd(valid, one));
+					__m256i inc_x_i = _mm512_cvttpd_epi32(_mm512_maskz_mov_pd(valid & has_ux, one));
+					__m256i inc_y_i = _mm256_mullo_epi32(
+						_mm512_cvttpd_epi32(_mm512_maskz_mov_pd(valid & has_uy, one)), w_i);
+					__m256i idx_l = _mm256_mullo_epi32(_mm256_add_epi32(_mm256_mullo_epi32(ly, w_i), lx), valid_i);
+					__m256i idx_u = _mm256_add_epi32(idx_l, inc_y_i);
+
+					__m512d pix_ll = _mm512_cvtps_pd(_mm256_i32gather_ps(img_data, idx_l, 4));
+					__m512d pix_lu = _mm512_cvtps_pd(_mm256_i32gather_ps(img_data, _mm256_add_epi32(idx_l, inc_x_i), 4));
+					__m512d pix_ul = _mm512_cvtps_pd(_mm256_i32gather_ps(img_data, idx_u, 4));
+					__m512d pix_uu = _mm512_cvtps_pd(_mm256_i32gather_ps(img_data, _mm256_add_epi32(idx_u, inc_x_i), 4));
+
+					__m512d dx_c = _mm512_sub_pd(one, dx), dy_c = _mm512_sub_pd(one, dy);
+					__m512d pix_val = _mm512_mul_pd(_mm512_mul_pd(pix_ll, dx_c), dy_c);
+					pix_val = _mm512_add_pd(pix_val, _mm512_mul_pd(_mm512_mul_pd(pix_lu, dx), dy_c));
+					pix_val = _mm512_add_pd(pix_val, _mm512_mul_pd(_mm512_mul_pd(pix_ul, dx_c), dy));
+					pix_val = _mm512_add_pd(pix_val, _mm512_mul_pd(_mm512_mul_pd(pix_uu, dx), dy));
+					pix_val = _mm512_mask_blend_pd(valid, overflow, pix_val);
+					_mm512_storeu_pd(pix_vals + pix_id, _mm512_add_pd(_mm512_mul_pd(mult, pix_val), add));
+				}
+			}
+		}
+#pragma GCC pop_options
+#endif
+		namespace{
+			//! these mirror the original functors one for one so that the results are unchanged when SIMD is unavailable
+			double getSSDScalar(const double *a, const double *b, size_t size,
+				double worst_dist, double result){
+				double diff0, diff1, diff2, diff3;
+				const double* last = a + size;
+				const double* lastgroup = last - 3;
+				while(a < lastgroup){
+					diff0 = (a[0] - b[0]);
+					diff1 = (a[1] - b[1]);
+					diff2 = (a[2] - b[2]);
+					diff3 = (a[3] - b[3]);
+					result += diff0 * diff0 + diff1 * diff1 + diff2 * diff2 + diff3 * diff3;
+					a += 4;
+					b += 4;
+					if((worst_dist > 0) && (result > worst_dist)){
+						return result;
+					}
+				}
+				while(a < last){
+					diff0 = (*a++ - *b++);
+					result += diff0 * diff0;
+				}
+				return result;
+			}
+			double getSADScalar(const double *a, const double *b, size_t size,
+				double worst_dist, double result){
+				const double* last = a + size;
+				const double* lastgroup = last - 3;
+				while(a < lastgroup){
+					result += fabs(a[0] - b[0]) + fabs(a[1] - b[1]) + fabs(a[2] - b[2]) + fabs(a[3] - b[3]);
+					a += 4;
+					b += 4;
+					if((worst_dist > 0) && (result > worst_dist)){
+						return result;
+					}
+				}
+				while(a < last){
+					result += fabs(*a++ - *b++);
+				}
+				return result;
+			}
+			double getDotProductScalar(const double *a, const double *b, size_t size, double result){
+				const double* last = a + size;
+				const double* lastgroup = last - 3;
+				while(a < lastgroup){
+					result += a[0] * b[0] + a[1] * b[1] + a[2] * b[2] + a[3] * b[3];
+					a += 4;
+					b += 4;
+				}
+				while(a < last){
+					result += *a++ * *b++;
+				}
+				return result;
+			}
+			double getSPSSScalar(const double *a, const double *b, size_t size, double c, double result){
+				const double* last = a + size;
+				const double* lastgroup = last - 3;
+				while(a < lastgroup){
+					result += ((2 * a[0] * b[0] + c) / (a[0] * a[0] + b[0] * b[0] + c)) +
+						((2 * a[1] * b[1] + c) / (a[1] * a[1] + b[1] * b[1] + c)) +
+						((2 * a[2] * b[2] + c) / (a[2] * a[2] + b[2] * b[2] + c)) +
+						((2 * a[3] * b[3] + c) / (a[3] * a[3] + b[3] * b[3] + c));
+					a += 4;
+					b += 4;
+				}
+				while(a < last){
+					result += (2 * (*a) * (*b) + c) / ((*a) * (*a) + (*b) * (*b) + c);
+					a++;
+					b++;
+				}
+				return result;
+			}
+		}
+#ifdef MTF_SIMD_X86
+		/**
+		each block of dist_block_size elements is split among four independent accumulators
+		to hide the latency of the additions; the accumulators are only reduced to a scalar 
+		at block boundaries and only when early abandoning is enabled
+		*/
+		namespace{
+			__attribute__((target("avx2")))
+			inline double getSumAVX2(__m256d sum0, __m256d sum1, __m256d sum2, __m256d sum3){
+				__m256d sum = _mm256_add_pd(_mm256_add_pd(sum0, sum1), _mm256_add_pd(sum2, sum3));
+				__m128d sum_half = _mm_add_pd(_mm256_castpd256_pd128(sum), _mm256_extractf128_pd(sum, 1));
+				return _mm_cvtsd_f64(_mm_add_sd(sum_half, _mm_unpackhi_pd(sum_half, sum_half)));
+			}
+			__attribute__((target("avx512f,avx2")))
+			inline double getSumAVX512(__m512d sum0, __m512d sum1, __m512d sum2, __m512d sum3){
+				return _mm512_reduce_add_pd(_mm512_add_pd(_mm512_add_pd(sum0, sum1), _mm512_add_pd(sum2, sum3)));
+			}
+			__attribute__((target("avx2")))
+			double getSSDAVX2(const double *a, const double *b, size_t size, double worst_dist){
+				__m256d sum0 = _mm256_setzero_pd(), sum1 = sum0, sum2 = sum0, sum3 = sum0;
+				for(size_t block_start = 0; block_start < size; block_start += dist_block_size){
+					for(size_t id = block_start; id < block_start + dist_block_size; id += 16){
+						__m256d diff0 = _mm256_sub_pd(_mm256_loadu_pd(a + id), _mm256_loadu_pd(b + id));
+						__m256d diff1 = _mm256_sub_pd(_mm256_loadu_pd(a + id + 4), _mm256_loadu_pd(b + id + 4));
+						__m256d diff2 = _mm256_sub_pd(_mm256_loadu_pd(a + id + 8), _mm256_loadu_pd(b + id + 8));
+						__m256d diff3 = _mm256_sub_pd(_mm256_loadu_pd(a + id + 12), _mm256_loadu_pd(b + id + 12));
+						sum0 = _mm256_add_pd(sum0, _mm256_mul_pd(diff0, diff0));
+						sum1 = _mm256_add_pd(sum1, _mm256_mul_pd(diff1, diff1));
+						sum2 = _mm256_add_pd(sum2, _mm256_mul_pd(diff2, diff2));
+						sum3 = _mm256_add_pd(sum3, _mm256_mul_pd(diff3, diff3));
+					}
+					if(worst_dist > 0){
+						double result = getSumAVX2(sum0, sum1, sum2, sum3);
+						if(result > worst_dist){ return result; }
+					}
+				}
+				return getSumAVX2(sum0, sum1, sum2, sum3);
+			}
+			__attribute__((target("avx2")))
+			double getSADAVX2(const double *a, const double *b, size_t size, double worst_dist){
+				const __m256d sign_mask = _mm256_set1_pd(-0.0);
+				__m256d sum0 = _mm256_setzero_pd(), sum1 = sum0, sum2 = sum0, sum3 = sum0;
+				for(size_t block_start = 0; block_start < size; block_start += dist_block_size){
+					for(size_t id = block_start; id < block_start + dist_block_size; id += 16){
+						__m256d diff0 = _mm256_sub_pd(_mm256_loadu_pd(a + id), _mm256_loadu_pd(b + id));
+						__m256d diff1 = _mm256_sub_pd(_mm256_loadu_pd(a + id + 4), _mm256_loadu_pd(b + id + 4));
+						__m256d diff2 = _mm256_sub_pd(_mm256_loadu_pd(a + id + 8), _mm256_loadu_pd(b + id + 8));
+						__m256d diff3 = _mm256_sub_pd(_mm256_loadu_pd(a + id + 12), _mm256_loadu_pd(b + id + 12));
+						sum0 = _mm256_add_pd(sum0, _mm256_andnot_pd(sign_mask, diff0));
+						sum1 = _mm256_add_pd(sum1, _mm256_andnot_pd(sign_mask, diff1));
+						sum2 = _mm256_add_pd(sum2, _mm256_andnot_pd(sign_mask, diff2));
+						sum3 = _mm256_add_pd(sum3, _mm256_andnot_pd(sign_mask, diff3));
+					}
+					if(worst_dist > 0){
+						double result = getSumAVX2(sum0, sum1, sum2, sum3);
+						if(result > worst_dist){ return result; }
+					}
+				}
+				return getSumAVX2(sum0, sum1, sum2, sum3);
+			}
+			__attribute__((target("avx2")))
+			double getDotProductAVX2(const double *a, const double *b, size_t size){
+				__m256d sum0 = _mm256_setzero_pd(), sum1 = sum0, sum2 = sum0, sum3 = sum0;
+				for(size_t id = 0; id < size; id += 16){
+					sum0 = _mm256_add_pd(sum0, _mm256_mul_pd(_mm256_loadu_pd(a + id), _mm256_loadu_pd(b + id)));
+					sum1 = _mm256_add_pd(sum1, _mm256_mul_pd(_mm256_loadu_pd(a + id + 4), _mm256_loadu_pd(b + id + 4)));
+					sum2 = _mm256_add_pd(sum2, _mm256_mul_pd(_mm256_loadu_pd(a + id + 8), _mm256_loadu_pd(b + id + 8)));
+					sum3 = _mm256_add_pd(sum3, _mm256_mul_pd(_mm256_loadu_pd(a + id + 12), _mm256_loadu_pd(b + id + 12)));
+				}
+				return getSumAVX2(sum0, sum1, sum2, sum3);
+			}
+			__attribute__((target("avx2")))
+			double getSPSSAVX2(const double *a, const double *b, size_t size, double c){
+				const __m256d two = _mm256_set1_pd(2.0), c_vec = _mm256_set1_pd(c);
+				__m256d sum0 = _mm256_setzero_pd(), sum1 = sum0;
+				for(size_t id = 0; id < size; id += 8){
+					__m256d a0 = _mm256_loadu_pd(a + id), b0 = _mm256_loadu_pd(b + id);
+					__m256d a1 = _mm256_loadu_pd(a + id + 4), b1 = _mm256_loadu_pd(b + id + 4);
+					__m256d num0 = _mm256_add_pd(_mm256_mul_pd(two, _mm256_mul_pd(a0, b0)), c_vec);
+					__m256d num1 = _mm256_add_pd(_mm256_mul_pd(two, _mm256_mul_pd(a1, b1)), c_vec);
+					__m256d den0 = _mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(a0, a0), _mm256_mul_pd(b0, b0)), c_vec);
+					__m256d den1 = _mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(a1, a1), _mm256_mul_pd(b1, b1)), c_vec);
+					sum0 = _mm256_add_pd(sum0, _mm256_div_pd(num0, den0));
+					sum1 = _mm256_add_pd(sum1, _mm256_div_pd(num1, den1));
+				}
+				const __m256d zero = _mm256_setzero_pd();
+				return getSumAVX2(sum0, sum1, zero, zero);
+			}
+			__attribute__((target("avx512f,avx2")))
+			double getSSDAVX512(const double *a, const double *b, size_t size, double worst_dist){
+				__m512d sum0 = _mm512_setzero_pd(), sum1 = sum0, sum2 = sum0, sum3 = sum0;
+				for(size_t id = 0; id < size; id += dist_block_size){
+					__m512d diff0 = _mm512_sub_pd(_mm512_loadu_pd(a + id), _mm512_loadu_pd(b + id));
+					__m512d diff1 = _mm512_sub_pd(_mm512_loadu_pd(a + id + 8), _mm512_loadu_pd(b + id + 8));
+					__m512d diff2 = _mm512_sub_pd(_mm512_loadu_pd(a + id + 16), _mm512_loadu_pd(b + id + 16));
+					__m512d diff3 = _mm512_sub_pd(_mm512_loadu_pd(a + id + 24), _mm512_loadu_pd(b + id + 24));
+					sum0 = _mm512_fmadd_pd(diff0, diff0, sum0);
+					sum1 = _mm512_fmadd_pd(diff1, diff1, sum1);
+					sum2 = _mm512_fmadd_pd(diff2, diff2, sum2);
+					sum3 = _mm512_fmadd_pd(diff3, diff3, sum3);
+					if(worst_dist > 0){
+						double result = getSumAVX512(sum0, sum1, sum2, sum3);
+						if(result > worst_dist){ return result; }
+					}
+				}
+				return getSumAVX512(sum0, sum1, sum2, sum3);
+			}
+			__attribute__((target("avx512f,avx2")))
+			double getSADAVX512(const double *a, const double *b, size_t size, double worst_dist){
+				__m512d sum0 = _mm512_setzero_pd(), sum1 = sum0, sum2 = sum0, sum3 = sum0;
+				for(size_t id = 0; id < size; id += dist_block_size){
+					sum0 = _mm512_add_pd(sum0, _mm512_abs_pd(_mm512_sub_pd(_mm512_loadu_pd(a + id), _mm512_loadu_pd(b + id))));
+					sum1 = _mm512_add_pd(sum1, _mm512_abs_pd(_mm512_sub_pd(_mm512_loadu_pd(a + id + 8), _mm512_loadu_pd(b + id + 8))));
+					sum2 = _mm512_add_pd(sum2, _mm512_abs_pd(_mm512_sub_pd(_mm512_loadu_pd(a + id + 16), _mm512_loadu_pd(b + id + 16))));
+					sum3 = _mm512_add_pd(sum3, _mm512_abs_pd(_mm512_sub_pd(_mm512_loadu_pd(a + id + 24), _mm512_loadu_pd(b + id + 24))));
+					if(worst_dist > 0){
+						double result = getSumAVX512(sum0, sum1, sum2, sum3);
+						if(result > worst_dist){ return result; }
+					}
+				}
+				return getSumAVX512(sum0, sum1, sum2, sum3);
+			}
+			__attribute__((target("avx512f,avx2")))
+			double getDotProductAVX512(const double *a, const double *b, size_t size){
+				__m512d sum0 = _mm512_setzero_pd(), sum1 = sum0, sum2 = sum0, sum3 = sum0;
+				for(size_t id = 0; id < size; id += dist_block_size){
+					sum0 = _mm512_fmadd_pd(_mm512_loadu_pd(a + id), _mm512_loadu_pd(b + id), sum0);
+					sum1 = _mm512_fmadd_pd(_mm512_loadu_pd(a + id + 8), _mm512_loadu_pd(b + id + 8), sum1);
+					sum2 = _mm512_fmadd_pd(_mm512_loadu_pd(a + id + 16), _mm512_loadu_pd(b + id + 16), sum2);
+					sum3 = _mm512_fmadd_pd(_mm512_loadu_pd(a + id + 24), _mm512_loadu_pd(b + id + 24), sum3);
+				}
+				return getSumAVX512(sum0, sum1, sum2, sum3);
+			}
+			__attribute__((target("avx512f,avx2")))
+			double getSPSSAVX512(const double *a, const double *b, size_t size, double c){
+				const __m512d two = _mm512_set1_pd(2.0), c_vec = _mm512_set1_pd(c);
+				__m512d sum0 = _mm512_setzero_pd(), sum1 = sum0;
+				for(size_t id = 0; id < size; id += 16){
+					__m512d a0 = _mm512_loadu_pd(a + id), b0 = _mm512_loadu_pd(b + id);
+					__m512d a1 = _mm512_loadu_pd(a + id + 8), b1 = _mm512_loadu_pd(b + id + 8);
+					__m512d num0 = _mm512_fmadd_pd(two, _mm512_mul_pd(a0, b0), c_vec);
+					__m512d num1 = _mm512_fmadd_pd(two, _mm512_mul_pd(a1, b1), c_vec);
+					__m512d den0 = _mm512_fmadd_pd(a0, a0, _mm512_fmadd_pd(b0, b0, c_vec));
+					__m512d den1 = _mm512_fmadd_pd(a1, a1, _mm512_fmadd_pd(b1, b1, c_vec));
+					sum0 = _mm512_add_pd(sum0, _mm512_div_pd(num0, den0));
+					sum1 = _mm512_add_pd(sum1, _mm512_div_pd(num1, den1));
+				}
+				return _mm512_reduce_add_pd(_mm512_add_pd(sum0, sum1));
+			}
+		}
+#endif
+		//! the vectorized kernels handle the largest multiple of dist_block_size elements and the scalar ones the rest
+		double getSSD(const double *a, const double *b, size_t size, double worst_dist){
+			size_t n_vec = 0;
+			double result = 0;
+#ifdef MTF_SIMD_X86
+			switch(getActiveISA()){
+			case ISA::AVX512:
+				n_vec = size - size % dist_block_size;
+				result = getSSDAVX512(a, b, n_vec, worst_dist);
+				break;
+			case ISA::AVX2:
+				n_vec = size - size % dist_block_size;
+				result = getSSDAVX2(a, b, n_vec, worst_dist);
+				break;
+			default:
+				break;
+			}
+			if((worst_dist > 0) && (result > worst_dist)){
+				return result;
+			}
+#endif
+			return getSSDScalar(a + n_vec, b + n_vec, size - n_vec, worst_dist, result);
+		}
+		double getSAD(const double *a, const double *b, size_t size, double worst_dist){
+			size_t n_vec = 0;
+			double result = 0;
+#ifdef MTF_SIMD_X86
+			switch(getActiveISA()){
+			case ISA::AVX512:
+				n_vec = size - size % dist_block_size;
+				result = getSADAVX512(a, b, n_vec, worst_dist);
+				break;
+			case ISA::AVX2:
+				n_vec = size - size % dist_block_size;
+				result = getSADAVX2(a, b, n_vec, worst_dist);
+				break;
+			default:
+				break;
+			}
+			if((worst_dist > 0) && (result > worst_dist)){
+				return result;
+			}
+#endif
+			return getSADScalar(a + n_vec, b + n_vec, size - n_vec, worst_dist, result);
+		}
+		double getDotProduct(const double *a, const double *b, size_t size){
+			size_t n_vec = 0;
+			double result = 0;
+#ifdef MTF_SIMD_X86
+			switch(getActiveISA()){
+			case ISA::AVX512:
+				n_vec = size - size % dist_block_size;
+				result = getDotProductAVX512(a, b, n_vec);
+				break;
+			case ISA::AVX2:
+				n_vec = size - size % dist_block_size;
+				result = getDotProductAVX2(a, b, n_vec);
+				break;
+			default:
+				break;
+			}
+#endif
+			return getDotProductScalar(a + n_vec, b + n_vec, size - n_vec, result);
+		}
+		double getSPSS(const double *a, const double *b, size_t size, double c){
+			size_t n_vec = 0;
+			double result = 0;
+#ifdef MTF_SIMD_X86
+			switch(getActiveISA()){
+			case ISA::AVX512:
+				n_vec = size - size % dist_block_size;
+				result = getSPSSAVX512(a, b, n_vec, c);
+				break;
+			case ISA::AVX2:
+				n_vec = size - size % dist_block_size;
+				result = getSPSSAVX2(a, b, n_vec, c);
+				break;
+			default:
+				break;
+			}
+#endif
+			return getSPSSScalar(a + n_vec, b + n_vec, size - n_vec, c, result);
+		}
+		void getPixValsLinear(VectorXd &pix_vals, const EigImgT &img, const PtsT &pts,
+			unsigned int n_pix, unsigned int h, unsigned int w,
+			double norm_mult, double norm_add, double overflow_val){
+			assert(pix_vals.size() == n_pix && pts.cols() == n_pix);
+			getPixValsLinear(pix_vals.data(), img, pts.data(), n_pix, h, w,
+				norm_mult, norm_add, overflow_val);
+		}
+		void getPixValsLinear(double *pix_vals, const EigImgT &img, const double *pts,
+			unsigned int n_pix, unsigned int h, unsigned int w,
+			double norm_mult, double norm_add, double overflow_val){
+			assert(img.rows() == h && img.cols() == w);
+			unsigned int n_vec_pix = 0;
+#ifdef MTF_SIMD_X86
+			switch(getActiveISA()){
+			case ISA::AVX512:
+				n_vec_pix = n_pix - n_pix % 8;
+				getPixValsLinearAVX512(pix_vals, img.data(), pts,
+					n_vec_pix, h, w, norm_mult, norm_add, overflow_val);
+				break;
+			case ISA::AVX2:
+				n_vec_pix = n_pix - n_pix % 4;
+				getPixValsLinearAVX2(pix_vals, img.data(), pts,
+					n_vec_pix, h, w, norm_mult, norm_add, overflow_val);
+				break;
+			default:
+				break;
+			}
+#endif
+			getPixValsLinearScalar(pix_vals, img, pts, n_vec_pix, n_pix,
+				h, w, norm_mult, norm_add, overflow_val);
+		}
+	}
+}
+_MTF_END_NAMESPACE
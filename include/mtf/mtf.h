@@ -32,6 +32,7 @@
 #ifndef DISABLE_GRID
 #include "mtf/SM/GridTracker.h"
 #include "mtf/SM/GridTrackerCV.h"
+#include "mtf/SM/GridTrackerBatch.h"
 #ifndef DISABLE_TEMPLATED_SM
 #include "mtf/SM/RKLT.h"
 #include "mtf/SM/GridTrackerFlow.h"
@@ -181,6 +182,7 @@ treat source files as headers so no linking is needed
 #endif
 
 #include "boost/filesystem/operations.hpp"
+#include "mtf/Utilities/pyramidUtils.h"
 
 #include <memory>
 
@@ -223,6 +225,7 @@ typedef std::unique_ptr<IALKParams> IALKParams_;
 typedef std::unique_ptr<FCSDParams> FCSDParams_;
 typedef std::unique_ptr<PFParams> PFParams_;
 typedef std::unique_ptr<NNParams> NNParams_;
+typedef utils::ImagePyramidCache::Ptr ImagePyramidCache_;
 #ifndef DISABLE_FLANN
 typedef std::unique_ptr<FLANNParams> FLANNParams_;
 #else
@@ -254,6 +257,7 @@ FALKParams_ getFALKParams();
 IALKParams_ getIALKParams();
 PFParams_ getPFParams();
 NNParams_ getNNParams();
+ImagePyramidCache_ getImagePyramidCache();
 #ifndef DISABLE_FLANN
 FLANNParams_ getFLANNParams();
 #else
@@ -556,7 +560,8 @@ TrackerBase *getTracker(const char *sm_type,
 	}
 	//! pyramidal SM
 	else if(!strcmp(sm_type, "pysm") || !strcmp(sm_type, "pyrs")) {
-		PyramidalParams pyr_params(pyr_no_of_levels, pyr_scale_factor, pyr_show_levels);
+		PyramidalParams pyr_params(pyr_no_of_levels, pyr_scale_factor, pyr_show_levels,
+			getImagePyramidCache());
 		vector<SMType*> trackers;
 		trackers.resize(pyr_params.no_of_levels);
 		if(pyr_scale_res){
@@ -633,7 +638,8 @@ TrackerBase *getTracker(const char *sm_type,
 		}
 		ParallelParams prl_params(
 			static_cast<ParallelParams::PrlEstMethod>(prl_estimation_method),
-			prl_reset_to_mean, prl_auto_reinit, prl_reinit_err_thresh, prl_reinit_frame_gap);
+			prl_reset_to_mean, prl_auto_reinit, prl_reinit_err_thresh, prl_reinit_frame_gap,
+			prl_n_threads, prl_pin_threads, prl_reinit_share_frames);
 		return new ParallelSM<AMType, SSMType>(trackers, &prl_params, ssm_params);
 	}
 #endif
@@ -654,6 +660,9 @@ TrackerBase *getTracker(const char *sm_type,
 		nn_index_type = 0;
 		nn_fgnn_index_type = nn_fgnn_index_type == 0 ? 2 : nn_fgnn_index_type;
 		return getTracker<AMType, SSMType>("nn", am_params, ssm_params);
+	} else if(!strcmp(sm_type, "hnsw")){// Hierarchical Navigable Small World graph based NN
+		nn_index_type = 9;
+		return getTracker<AMType, SSMType>("nn", am_params, ssm_params);
 	} else if(!strcmp(sm_type, "nn1k")){// NN with 1000 samples
 		nn_n_samples = 1000;
 		return new NN<AMType, SSMType>(getNNParams().get(), getFLANNParams().get(), am_params, ssm_params);
@@ -731,8 +740,8 @@ TrackerBase *getTracker(const char *sm_type,
 			getDetectorParams(detector_type), getDescriptorParams(descriptor_type),
 			grid_res, grid_res, grid_patch_size, grid_patch_size, grid_reset_at_each_frame,
 			feat_rebuild_index, max_iters, epsilon, enable_pyr, feat_use_cv_flann,
-			feat_max_dist_ratio, feat_min_matches, uchar_input, feat_show_keypoints,
-			feat_show_matches, feat_debug_mode);
+			feat_max_dist_ratio, feat_min_matches, uchar_input, feat_detect_in_roi,
+			feat_use_prosac, feat_show_keypoints, feat_show_matches, feat_debug_mode);
 		typename SSMType::ParamType _ssm_params(ssm_params);
 		_ssm_params.resx = feat_params.getResX();
 		_ssm_params.resy = feat_params.getResY();
@@ -756,6 +765,34 @@ TrackerBase *getTracker(const char *sm_type,
 			_ssm_params.resx = grid_params.getResX();
 			_ssm_params.resy = grid_params.getResY();
 			return new GridTrackerCV<SSMType>(&grid_params, getSSMEstParams().get(), &_ssm_params);
+		} else if(!strcmp(grid_sm, "batch")){
+			GridTrackerBatchParams::AMType grid_am_type;
+			if(!strcmp(grid_am, "ssd")){
+				grid_am_type = GridTrackerBatchParams::AMType::SSD;
+			} else if(!strcmp(grid_am, "zncc") || !strcmp(grid_am, "ncc")){
+				grid_am_type = GridTrackerBatchParams::AMType::ZNCC;
+			} else{
+				throw utils::InvalidArgument(
+					cv::format("GridTrackerBatch :: Invalid patch AM provided: %s", grid_am));
+			}
+			GridTrackerBatchParams::SSMType grid_ssm_type;
+			if(!strcmp(grid_ssm, "trans") || !strcmp(grid_ssm, "2")){
+				grid_ssm_type = GridTrackerBatchParams::SSMType::Translation;
+			} else if(!strcmp(grid_ssm, "ist") || !strcmp(grid_ssm, "3s")){
+				grid_ssm_type = GridTrackerBatchParams::SSMType::IST;
+			} else{
+				throw utils::InvalidArgument(
+					cv::format("GridTrackerBatch :: Invalid patch SSM provided: %s", grid_ssm));
+			}
+			GridTrackerBatchParams grid_params(
+				grid_res, grid_res, grid_patch_size, grid_patch_size,
+				grid_patch_res, grid_patch_res, grid_am_type, grid_ssm_type,
+				grid_reset_at_each_frame, grid_patch_centroid_inside,
+				max_iters, epsilon, grid_show_trackers, debug_mode);
+			typename SSMType::ParamType _ssm_params(ssm_params);
+			_ssm_params.resx = grid_params.getResX();
+			_ssm_params.resy = grid_params.getResY();
+			return new GridTrackerBatch<SSMType>(&grid_params, getSSMEstParams().get(), &_ssm_params);
 		}
 #ifndef DISABLE_TEMPLATED_SM
 		else if(!strcmp(grid_sm, "flow")){
@@ -790,7 +827,7 @@ TrackerBase *getTracker(const char *sm_type,
 			GridTrackerParams grid_params(
 				grid_res, grid_res, grid_patch_size, grid_patch_size,
 				grid_reset_at_each_frame, grid_dyn_patch_size, grid_patch_centroid_inside,
-				grid_fb_err_thresh, grid_fb_reinit, grid_use_tbb, max_iters, epsilon, enable_pyr,
+				grid_fb_err_thresh, grid_fb_reinit, grid_n_threads, max_iters, epsilon, enable_pyr,
 				grid_show_trackers, grid_show_tracker_edges, debug_mode);
 			typename SSMType::ParamType _ssm_params(ssm_params);
 			_ssm_params.resx = grid_params.getResX();
@@ -833,10 +870,12 @@ TrackerBase *getTracker(const char *sm_type,
 		}
 		ParallelParams prl_params(
 			static_cast<ParallelParams::PrlEstMethod>(prl_estimation_method),
-			prl_reset_to_mean, prl_auto_reinit, prl_reinit_err_thresh, prl_reinit_frame_gap);
+			prl_reset_to_mean, prl_auto_reinit, prl_reinit_err_thresh, prl_reinit_frame_gap,
+			prl_n_threads, prl_pin_threads, prl_reinit_share_frames);
 		return new ParallelTracker(trackers, &prl_params);
 	} else if(!strcmp(sm_type, "pyr") || !strcmp(sm_type, "pyrt")) { // pyramidal tracker
-		PyramidalParams pyr_params(pyr_no_of_levels, pyr_scale_factor, pyr_show_levels);
+		PyramidalParams pyr_params(pyr_no_of_levels, pyr_scale_factor, pyr_show_levels,
+			getImagePyramidCache());
 		vector<TrackerBase*> trackers;
 		trackers.resize(pyr_params.no_of_levels);
 		if(pyr_scale_res){
@@ -928,6 +967,7 @@ inline TrackerBase *getTracker(const char *sm_type, const char *am_type,
 #ifdef DISABLE_TEMPLATED_SM
 	enable_nt = 1;
 #endif
+	utils::TaskArena::setDefaultBackend(static_cast<utils::ParallelBackend>(parallel_backend));
 	// check for 3rd party trackers
 	TrackerBase *third_party_tracker = getTracker(sm_type);
 	if(third_party_tracker)
@@ -1117,7 +1157,8 @@ inline IlluminationModel *getILM(const char *ilm_type){
 inline AMParams_ getAMParams(const char *am_type, const char *ilm_type){
 	AMParams_ am_params(new AMParams(resx, resy, grad_eps, hess_eps,
 		uchar_input, likelihood_alpha, likelihood_beta, dist_from_likelihood,
-		learning_rate, getILM(ilm_type)));
+		learning_rate, getILM(ilm_type), img_deriv_cache, float_jac,
+		am_n_threads, am_grain_size));
 	if(!strcmp(am_type, "ssd") || !strcmp(am_type, "mcssd") || !strcmp(am_type, "ssd3")){
 		return AMParams_(new SSDParams(am_params.get(), ssd_show_template));
 	} else if(!strcmp(am_type, "sad") || !strcmp(am_type, "mcsad") || !strcmp(am_type, "sad3")){
@@ -1148,7 +1189,7 @@ inline AMParams_ getAMParams(const char *am_type, const char *ilm_type){
 			lkld_spacing, lkld_spacing, lkld_n_bins, lkld_pre_seed, lkld_pou, debug_mode));
 	} else if(!strcmp(am_type, "mi") || !strcmp(am_type, "mcmi") || !strcmp(am_type, "mi3")){
 		return AMParams_(new MIParams(am_params.get(), mi_n_bins, mi_pre_seed, mi_pou,
-			getPixMapper(pix_mapper), debug_mode));
+			getPixMapper(pix_mapper), mi_lut_steps, debug_mode));
 	} else if(!strcmp(am_type, "spss") || !strcmp(am_type, "mcspss") || !strcmp(am_type, "spss3")){
 		return AMParams_(new SPSSParams(am_params.get(), spss_k,
 			getPixMapper(pix_mapper)));
@@ -1158,7 +1199,7 @@ inline AMParams_ getAMParams(const char *am_type, const char *ilm_type){
 		return AMParams_(new NCCParams(am_params.get(), ncc_fast_hess));
 	} else if(!strcmp(am_type, "ccre") || !strcmp(am_type, "mcccre") || !strcmp(am_type, "ccre3")){
 		return AMParams_(new CCREParams(am_params.get(), ccre_n_bins, ccre_pou, ccre_pre_seed,
-			ccre_symmetrical_grad, ccre_n_blocks, debug_mode));
+			ccre_symmetrical_grad, ccre_n_blocks, ccre_lut_steps, debug_mode));
 	} else if(!strcmp(am_type, "riu") || !strcmp(am_type, "mcriu") || !strcmp(am_type, "riu3")){
 		return AMParams_(new RIUParams(am_params.get(), debug_mode));
 	} else if(!strcmp(am_type, "ngf")){
@@ -1371,7 +1412,8 @@ inline nt::SearchMethod *getSM(const char *sm_type,
 inline SSMEstParams_ getSSMEstParams(){
 	return SSMEstParams_(new SSMEstimatorParams(static_cast<SSMEstimatorParams::EstType>(est_method),
 		est_ransac_reproj_thresh, est_n_model_pts, est_refine, est_max_iters,
-		est_max_subset_attempts, est_use_boost_rng, est_confidence, est_lm_max_iters));
+		est_max_subset_attempts, est_use_boost_rng, est_confidence, est_lm_max_iters,
+		est_n_threads));
 }
 
 
@@ -1415,7 +1457,8 @@ inline FCLKParams_ getFCLKParams(){
 		static_cast<FCLKParams::HessType>(fc_hess_type), sec_ord_hess,
 		fc_chained_warp, leven_marq, lm_delta_init, lm_delta_update,
 		enable_learning, fc_write_ssm_updates, fc_show_grid,
-		fc_show_patch, fc_patch_resize_factor, fc_debug_mode));
+		fc_show_patch, fc_patch_resize_factor, fc_fused_gn,
+		fc_debug_mode));
 }
 inline ICLKParams_ getICLKParams(){
 	return 	ICLKParams_(new ICLKParams(max_iters, epsilon,
@@ -1457,7 +1500,17 @@ inline PFParams_ getPFParams(){
 		pf_update_distr_wts, pf_min_distr_wt,
 		pf_adaptive_resampling_thresh, pf_pix_sigma,
 		pf_measurement_sigma, pf_show_particles,
-		enable_learning, pf_jacobian_as_sigma, pf_debug_mode));
+		enable_learning, pf_jacobian_as_sigma, pf_n_threads, pf_sampler_streams,
+		pf_debug_mode));
+}
+/**
+cache shared by all the pyramidal trackers created here if pyr_shared_cache is enabled;
+the application must call update() on it once in every frame before updating the trackers
+*/
+inline ImagePyramidCache_ getImagePyramidCache(){
+	if(!pyr_shared_cache){ return nullptr; }
+	static ImagePyramidCache_ img_pyr_cache(new utils::ImagePyramidCache(pyr_cache_roi_margin));
+	return img_pyr_cache;
 }
 inline NNParams_ getNNParams(){
 	string saved_index_dir = cv::format("log/NN/%s/%s",
@@ -1474,14 +1527,26 @@ inline NNParams_ getNNParams(){
 		nn_gnn_max_steps,
 		nn_gnn_cmpt_dist_thresh,
 		nn_gnn_random_start,
+		static_cast<gnn::GNNParams::BuildType>(nn_gnn_build_type),
+		nn_gnn_nnd_max_iters,
+		nn_gnn_nnd_sample_rate,
+		nn_gnn_nnd_delta,
+		nn_gnn_nnd_target_recall,
+		nn_gnn_n_threads,
 		nn_gnn_verbose);
 
+	hnsw::HNSWParams hnsw_params(
+		nn_hnsw_M,
+		nn_hnsw_ef_construction,
+		nn_hnsw_ef_search,
+		nn_hnsw_verbose);
+
 	return NNParams_(new NNParams(
-		&gnn_params, nn_n_samples, nn_max_iters,
+		&gnn_params, &hnsw_params, nn_n_samples, nn_max_iters,
 		epsilon, nn_ssm_sigma, nn_ssm_mean, nn_pix_sigma,
 		nn_additive_update, nn_show_samples, nn_add_samples_gap,
 		nn_n_samples_to_add, nn_remove_samples, nn_load_index, nn_save_index,
-		saved_index_dir, debug_mode));
+		saved_index_dir, nn_n_threads, nn_sampler_streams, debug_mode));
 }
 
 //! params for NN SM
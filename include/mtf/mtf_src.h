@@ -12,6 +12,7 @@
 #include "../SM/src/IALK.cc"
 #include "../SM/src/PF.cc"
 #include "../SM/src/GNN.cc"
+#include "../SM/src/HNSW.cc"
 //! composite search methods
 #include "../SM/src/RKLT.cc"
 #include "../SM/src/CascadeSM.cc"
@@ -25,6 +26,7 @@
 #ifndef DISABLE_GRID
 #include "../SM/src/GridTracker.cc"
 #include "../SM/src/GridTrackerCV.cc"
+#include "../SM/src/GridTrackerBatch.cc"
 #ifndef DISABLE_TEMPLATED_SM
 #include "../SM/src/GridTrackerFlow.cc"
 #endif
@@ -127,6 +129,8 @@
 //! utilities
 #include "../Utilities/src/histUtils.cc"
 #include "../Utilities/src/imgUtils.cc"
+#include "../Utilities/src/simdUtils.cc"
+#include "../Utilities/src/pyramidUtils.cc"
 #include "../Utilities/src/warpUtils.cc"
 #include "../Utilities/src/miscUtils.cc"
 #include "../Utilities/src/graphUtils.cc"
@@ -144,6 +148,8 @@
 #include "../SM/src/FALKParams.cc"
 #include "../SM/src/IALKParams.cc"
 #include "../SM/src/PFParams.cc"
+#include "../SM/src/GNNParams.cc"
+#include "../SM/src/HNSWParams.cc"
 #ifndef DISABLE_FLANN
 #include "../SM/src/NNParams.cc"
 #include "../SM/src/FLANNParams.cc"